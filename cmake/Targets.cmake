@@ -79,3 +79,79 @@ target_compile_definitions(IskurScenePacker PRIVATE
 )
 target_link_options(IskurScenePacker PRIVATE "/SUBSYSTEM:CONSOLE")
 enable_ipo_for_target(IskurScenePacker)
+
+# Iskur reference tracer (standard library only, also builds standalone from its own CMakeLists.txt)
+add_executable(IskurReferenceTracer
+  code/tools/IskurReferenceTracer/main.cpp
+  code/tools/IskurReferenceTracer/PackReader.cpp
+  code/tools/IskurReferenceTracer/PackReader.h
+  code/tools/IskurReferenceTracer/TextureDecode.cpp
+  code/tools/IskurReferenceTracer/TextureDecode.h
+  code/tools/IskurReferenceTracer/TracerCommon.h
+  code/tools/IskurReferenceTracer/TracerMath.h
+  code/common/IskurPackFormat.h
+)
+target_link_libraries(IskurReferenceTracer PRIVATE
+  common_settings
+)
+target_compile_definitions(IskurReferenceTracer PRIVATE
+  ISKUR_ROOT="${CMAKE_CURRENT_SOURCE_DIR}"
+)
+target_link_options(IskurReferenceTracer PRIVATE "/SUBSYSTEM:CONSOLE")
+enable_ipo_for_target(IskurReferenceTracer)
+
+# Iskur microbenchmarks (CPU kernels of the packer and renderer, no GPU device). The packer kernels also build standalone from
+# their own CMakeLists.txt; the renderer kernels need the engine sources and are only built here.
+file(GLOB ISKUR_MICROBENCH_SOURCES
+  code/tools/IskurMicrobench/*.cpp
+  code/tools/IskurMicrobench/*.h
+  code/common/*.cpp
+  code/common/*.h
+  code/renderer/Culling.cpp
+  code/renderer/PostProcessGraph.cpp
+  code/renderer/RenderGraph.cpp
+  code/renderer/RuntimeState.cpp
+  code/renderer/SceneFileLoader.cpp
+  code/renderer/Timings.cpp
+  data/shaders/*CPUGPU.h
+)
+add_executable(IskurMicrobench ${ISKUR_MICROBENCH_SOURCES})
+target_precompile_headers(IskurMicrobench PRIVATE ${PCH_HEADER})
+target_link_libraries(IskurMicrobench PRIVATE
+  engine_settings
+  meshoptimizer
+)
+target_compile_definitions(IskurMicrobench PRIVATE
+  ISKUR_MICROBENCH_RENDERER
+)
+target_link_options(IskurMicrobench PRIVATE "/SUBSYSTEM:CONSOLE")
+enable_ipo_for_target(IskurMicrobench)
+
+# Iskur render graph tests (CPU checks of placement, barriers and validation, no GPU device and no precompiled header)
+add_executable(IskurRenderGraphTests
+  code/tools/IskurRenderGraphTests/main.cpp
+  code/renderer/PostProcessGraph.cpp
+  code/renderer/PostProcessGraph.h
+  code/renderer/RenderGraph.cpp
+  code/renderer/RenderGraph.h
+  code/common/Asserts.cpp
+  code/common/Log.cpp
+  code/common/Profiler.cpp
+  code/common/UtfConversion.cpp
+)
+target_link_libraries(IskurRenderGraphTests PRIVATE
+  common_settings
+)
+target_link_options(IskurRenderGraphTests PRIVATE "/SUBSYSTEM:CONSOLE")
+add_test(NAME RenderGraph COMMAND IskurRenderGraphTests)
+
+# Iskur timeline analyzer (standard library only, also builds standalone from its own CMakeLists.txt)
+add_executable(IskurTimelineAnalyzer
+  code/tools/IskurTimelineAnalyzer/main.cpp
+  code/common/JsonUtils.h
+  code/common/TimelineFormat.h
+)
+target_link_libraries(IskurTimelineAnalyzer PRIVATE
+  common_settings
+)
+target_link_options(IskurTimelineAnalyzer PRIVATE "/SUBSYSTEM:CONSOLE")
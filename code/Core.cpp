@@ -29,12 +29,22 @@ void Core::OnUpdate()
     const f32 elapsedSeconds = duration<f32>(currentTime - lastTime).count();
     lastTime = currentTime;
 
+    if (m_Renderer.IsBenchmarkRunning())
+    {
+        m_Renderer.ApplyBenchmarkCamera();
+        return;
+    }
     m_Renderer.GetCamera().Update(elapsedSeconds);
 }
 
 void Core::OnRender()
 {
     m_Renderer.Render();
+
+    if (m_Renderer.IsBenchmarkFinished())
+    {
+        m_Window.Terminate();
+    }
 }
 
 void Core::OnTerminate()
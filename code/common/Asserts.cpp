@@ -94,6 +94,8 @@ void IE_Assert(bool condition)
 {
     if (!condition)
     {
+        // Callers log the reason right before asserting; make sure it reaches the sinks.
+        Log::Flush();
         abort();
     }
 }
@@ -119,6 +121,7 @@ void IE_Check(HRESULT hr)
     if (FAILED(hr))
     {
         LogHrFailure(hr, true);
+        Log::Flush();
         abort();
     }
 }
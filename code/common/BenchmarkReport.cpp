@@ -0,0 +1,166 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "BenchmarkReport.h"
+
+#include "JsonUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <string_view>
+
+namespace
+{
+// Quotes a CSV field when it contains a separator, quote or line break.
+void AppendCsvField(String& out, const String& text)
+{
+    if (text.find_first_of(",\"\r\n") == String::npos)
+    {
+        out += text;
+        return;
+    }
+    out.push_back('"');
+    for (const char c : text)
+    {
+        if (c == '"')
+        {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+f64 NearestRank(const Vector<f64>& sorted, const f64 percentile)
+{
+    const size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<f64>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+bool WriteTextFile(const std::filesystem::path& path, const String& text)
+{
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    return file.good();
+}
+} // namespace
+
+void BenchmarkReport_Reset(BenchmarkReport& report, const u32 frameCount)
+{
+    report.frameCount = frameCount;
+    report.series.clear();
+}
+
+void BenchmarkReport_SetSample(BenchmarkReport& report, const char* group, const char* name, const u32 frame, const f64 ms)
+{
+    if (frame >= report.frameCount)
+    {
+        return;
+    }
+
+    const std::string_view groupKey = group ? group : "";
+    const std::string_view nameKey = name ? name : "";
+    auto it = std::find_if(report.series.begin(), report.series.end(), [&](const BenchmarkSeries& s) { return s.group == groupKey && s.name == nameKey; });
+    if (it == report.series.end())
+    {
+        BenchmarkSeries& series = report.series.emplace_back();
+        series.group = groupKey;
+        series.name = nameKey;
+        series.samples.assign(report.frameCount, std::numeric_limits<f64>::quiet_NaN());
+        it = report.series.end() - 1;
+    }
+    it->samples[frame] = ms;
+}
+
+BenchmarkSeriesStats BenchmarkReport_ComputeStats(const BenchmarkSeries& series)
+{
+    Vector<f64> sorted;
+    sorted.reserve(series.samples.size());
+    for (const f64 sample : series.samples)
+    {
+        if (!std::isnan(sample))
+        {
+            sorted.push_back(sample);
+        }
+    }
+
+    BenchmarkSeriesStats stats{};
+    if (sorted.empty())
+    {
+        return stats;
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    f64 sum = 0.0;
+    for (const f64 sample : sorted)
+    {
+        sum += sample;
+    }
+    stats.sampleCount = static_cast<u32>(sorted.size());
+    stats.mean = sum / static_cast<f64>(sorted.size());
+    stats.min = sorted.front();
+    stats.p50 = NearestRank(sorted, 0.50);
+    stats.p95 = NearestRank(sorted, 0.95);
+    stats.p99 = NearestRank(sorted, 0.99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+bool BenchmarkReport_WriteCsv(const BenchmarkReport& report, const std::filesystem::path& path)
+{
+    String csv = "frame";
+    for (const BenchmarkSeries& series : report.series)
+    {
+        csv.push_back(',');
+        AppendCsvField(csv, series.group + "/" + series.name);
+    }
+    csv.push_back('\n');
+
+    for (u32 frame = 0; frame < report.frameCount; ++frame)
+    {
+        csv += std::format("{}", frame);
+        for (const BenchmarkSeries& series : report.series)
+        {
+            csv.push_back(',');
+            if (!std::isnan(series.samples[frame]))
+            {
+                csv += std::format("{:.4f}", series.samples[frame]);
+            }
+        }
+        csv.push_back('\n');
+    }
+    return WriteTextFile(path, csv);
+}
+
+bool BenchmarkReport_WriteJson(const BenchmarkReport& report, const std::filesystem::path& path)
+{
+    String json = "{\n  \"scene\": ";
+    AppendJsonString(json, report.scene);
+    json += ",\n  \"cameraPath\": ";
+    AppendJsonString(json, report.cameraPath);
+    json += std::format(",\n  \"fixedStepMs\": {:.4f}, \"warmupFrames\": {}, \"frames\": {},\n  \"series\": [", report.fixedStepMs, report.warmupFrames, report.frameCount);
+    for (size_t i = 0; i < report.series.size(); ++i)
+    {
+        const BenchmarkSeries& series = report.series[i];
+        const BenchmarkSeriesStats stats = BenchmarkReport_ComputeStats(series);
+        json += i == 0 ? "\n    {\"group\": " : ",\n    {\"group\": ";
+        AppendJsonString(json, series.group);
+        json += ", \"name\": ";
+        AppendJsonString(json, series.name);
+        json += std::format(", \"samples\": {}, \"meanMs\": {:.4f}, \"minMs\": {:.4f}, \"p50Ms\": {:.4f}, \"p95Ms\": {:.4f}, \"p99Ms\": {:.4f}, \"maxMs\": {:.4f}}}", stats.sampleCount,
+                            stats.mean, stats.min, stats.p50, stats.p95, stats.p99, stats.max);
+    }
+    json += report.series.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return WriteTextFile(path, json);
+}
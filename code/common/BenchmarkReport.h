@@ -0,0 +1,53 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <filesystem>
+
+#include "Types.h"
+
+// Per-frame timings of a benchmark run: one series per timing (e.g. group "cpu", name "Culling") with one sample per measured frame.
+// Frames a timing did not run in stay empty and are left out of its statistics.
+struct BenchmarkSeries
+{
+    String group;
+    String name;
+    Vector<f64> samples; // NaN when the timing has no sample for that frame
+};
+
+struct BenchmarkReport
+{
+    String scene;
+    String cameraPath;
+    f64 fixedStepMs = 0.0;
+    u32 warmupFrames = 0;
+    u32 frameCount = 0;
+    Vector<BenchmarkSeries> series;
+};
+
+// Exact statistics over all samples of a series; percentiles use the nearest-rank definition.
+struct BenchmarkSeriesStats
+{
+    u32 sampleCount = 0;
+    f64 mean = 0.0;
+    f64 min = 0.0;
+    f64 p50 = 0.0;
+    f64 p95 = 0.0;
+    f64 p99 = 0.0;
+    f64 max = 0.0;
+};
+
+// Clears the series and sizes the report for frameCount measured frames.
+void BenchmarkReport_Reset(BenchmarkReport& report, u32 frameCount);
+// Series are created on first use and keep that order in the outputs; out-of-range frames are ignored.
+void BenchmarkReport_SetSample(BenchmarkReport& report, const char* group, const char* name, u32 frame, f64 ms);
+
+BenchmarkSeriesStats BenchmarkReport_ComputeStats(const BenchmarkSeries& series);
+
+// One row per frame and one "group/name" column per series, empty cells for missing samples.
+bool BenchmarkReport_WriteCsv(const BenchmarkReport& report, const std::filesystem::path& path);
+// Run settings plus the statistics of every series.
+bool BenchmarkReport_WriteJson(const BenchmarkReport& report, const std::filesystem::path& path);
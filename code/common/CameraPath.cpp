@@ -0,0 +1,145 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+// Tangent of one channel at key i, in units per second. Interior keys use the Catmull-Rom central difference over the
+// neighbouring keys, the end keys a one-sided difference.
+f32 ComputeTangent(const Vector<CameraPathKey>& keys, const size_t i, f32 (*channel)(const CameraPathKey&))
+{
+    const size_t prev = i > 0 ? i - 1 : i;
+    const size_t next = i + 1 < keys.size() ? i + 1 : i;
+    const f32 dt = keys[next].time - keys[prev].time;
+    return dt > 0.0f ? (channel(keys[next]) - channel(keys[prev])) / dt : 0.0f;
+}
+
+f32 EvaluateChannel(const Vector<CameraPathKey>& keys, const size_t i, const f32 s, f32 (*channel)(const CameraPathKey&))
+{
+    const f32 dt = keys[i + 1].time - keys[i].time;
+    const f32 s2 = s * s;
+    const f32 s3 = s2 * s;
+    const f32 h00 = 2.0f * s3 - 3.0f * s2 + 1.0f;
+    const f32 h10 = s3 - 2.0f * s2 + s;
+    const f32 h01 = -2.0f * s3 + 3.0f * s2;
+    const f32 h11 = s3 - s2;
+    return h00 * channel(keys[i]) + h10 * dt * ComputeTangent(keys, i, channel) + h01 * channel(keys[i + 1]) + h11 * dt * ComputeTangent(keys, i + 1, channel);
+}
+
+CameraPathPose PoseFromKey(const CameraPathKey& key)
+{
+    CameraPathPose pose{};
+    std::copy(std::begin(key.position), std::end(key.position), pose.position);
+    pose.yaw = key.yaw;
+    pose.pitch = key.pitch;
+    return pose;
+}
+} // namespace
+
+bool CameraPath_Parse(std::istream& stream, CameraPath& outPath, String& error)
+{
+    outPath.keys.clear();
+
+    String line;
+    u32 lineNumber = 0;
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        const size_t first = line.find_first_not_of(" \t");
+        if (first == String::npos || line[first] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream lineStream(line);
+        CameraPathKey key{};
+        if (!(lineStream >> key.time >> key.position[0] >> key.position[1] >> key.position[2] >> key.yaw >> key.pitch))
+        {
+            error = std::format("line {}: expected 'time pos_x pos_y pos_z yaw pitch'", lineNumber);
+            return false;
+        }
+        if (!outPath.keys.empty())
+        {
+            const CameraPathKey& prev = outPath.keys.back();
+            if (key.time <= prev.time)
+            {
+                error = std::format("line {}: key time {} does not follow {}", lineNumber, key.time, prev.time);
+                return false;
+            }
+            while (key.yaw - prev.yaw > 180.0f)
+            {
+                key.yaw -= 360.0f;
+            }
+            while (key.yaw - prev.yaw < -180.0f)
+            {
+                key.yaw += 360.0f;
+            }
+        }
+        outPath.keys.push_back(key);
+    }
+
+    if (outPath.keys.empty())
+    {
+        error = "no keyframes";
+        return false;
+    }
+    return true;
+}
+
+bool CameraPath_Load(const std::filesystem::path& path, CameraPath& outPath, String& error)
+{
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        error = "file could not be opened";
+        return false;
+    }
+    return CameraPath_Parse(file, outPath, error);
+}
+
+f32 CameraPath_GetDuration(const CameraPath& path)
+{
+    return path.keys.empty() ? 0.0f : path.keys.back().time - path.keys.front().time;
+}
+
+CameraPathPose CameraPath_Evaluate(const CameraPath& path, const f32 time)
+{
+    const Vector<CameraPathKey>& keys = path.keys;
+    if (keys.empty())
+    {
+        return {};
+    }
+    if (keys.size() == 1 || time <= keys.front().time)
+    {
+        return PoseFromKey(keys.front());
+    }
+    if (time >= keys.back().time)
+    {
+        return PoseFromKey(keys.back());
+    }
+
+    // Index of the key that starts the segment containing time.
+    const auto it = std::upper_bound(keys.begin(), keys.end(), time, [](const f32 t, const CameraPathKey& key) { return t < key.time; });
+    const size_t i = static_cast<size_t>(it - keys.begin()) - 1;
+    const f32 s = (time - keys[i].time) / (keys[i + 1].time - keys[i].time);
+
+    CameraPathPose pose{};
+    pose.position[0] = EvaluateChannel(keys, i, s, [](const CameraPathKey& k) { return k.position[0]; });
+    pose.position[1] = EvaluateChannel(keys, i, s, [](const CameraPathKey& k) { return k.position[1]; });
+    pose.position[2] = EvaluateChannel(keys, i, s, [](const CameraPathKey& k) { return k.position[2]; });
+    pose.yaw = EvaluateChannel(keys, i, s, [](const CameraPathKey& k) { return k.yaw; });
+    pose.pitch = std::clamp(EvaluateChannel(keys, i, s, [](const CameraPathKey& k) { return k.pitch; }), -89.9f, 89.9f);
+    return pose;
+}
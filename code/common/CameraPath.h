@@ -0,0 +1,47 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <filesystem>
+#include <istream>
+
+#include "Types.h"
+
+// Camera flythrough used by the benchmark mode. A path is a text file with one keyframe per line:
+//
+//     # time pos_x pos_y pos_z yaw pitch
+//     0.0  -8.5 1.6 0.2  0.0  0.0
+//     4.0   8.0 1.6 0.2 20.0 -5.0
+//
+// Times are seconds and strictly increasing, angles are degrees like in data/camera_presets.txt. The pose is a Catmull-Rom spline
+// through the keys; yaw is unwrapped on load so consecutive keys always turn the short way round.
+struct CameraPathKey
+{
+    f32 time = 0.0f;
+    f32 position[3] = {};
+    f32 yaw = 0.0f;
+    f32 pitch = 0.0f;
+};
+
+struct CameraPath
+{
+    Vector<CameraPathKey> keys;
+};
+
+struct CameraPathPose
+{
+    f32 position[3] = {};
+    f32 yaw = 0.0f;
+    f32 pitch = 0.0f;
+};
+
+// Both return false and describe the first offending line in error when the path is unusable.
+bool CameraPath_Parse(std::istream& stream, CameraPath& outPath, String& error);
+bool CameraPath_Load(const std::filesystem::path& path, CameraPath& outPath, String& error);
+
+f32 CameraPath_GetDuration(const CameraPath& path);
+// Times outside the keys clamp to the first and last pose.
+CameraPathPose CameraPath_Evaluate(const CameraPath& path, f32 time);
@@ -5,9 +5,20 @@
 
 #include "CommandLineArguments.h"
 
+#include <cstdlib>
+
 #include "StringUtils.h"
 #include "UtfConversion.h"
 
+namespace
+{
+u32 ParseU32(const char* text)
+{
+    const unsigned long value = std::strtoul(text, nullptr, 10);
+    return static_cast<u32>(value > UINT32_MAX ? UINT32_MAX : value);
+}
+} // namespace
+
 void ProcessCommandLineArguments(i32 argc, char** argv)
 {
     CommandLineArguments& args = const_cast<CommandLineArguments&>(GetCommandLineArguments());
@@ -24,6 +35,27 @@ void ProcessCommandLineArguments(i32 argc, char** argv)
             {
                 args.gpuValidation = true;
             }
+            else if (option == "--capture-frames" && i + 1 < argc)
+            {
+                args.captureFrames = ParseU32(argv[++i]);
+            }
+            else if (option == "--benchmark" && i + 2 < argc)
+            {
+                args.sceneFile = argv[++i];
+                args.benchmarkPath = argv[++i];
+            }
+            else if (option == "--benchmark-frames" && i + 1 < argc)
+            {
+                args.benchmarkFrames = ParseU32(argv[++i]);
+            }
+            else if (option == "--benchmark-warmup" && i + 1 < argc)
+            {
+                args.benchmarkWarmupFrames = ParseU32(argv[++i]);
+            }
+            else if (option == "--benchmark-out" && i + 1 < argc)
+            {
+                args.benchmarkOutput = argv[++i];
+            }
         }
     }
 }
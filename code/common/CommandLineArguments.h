@@ -11,6 +11,13 @@ struct CommandLineArguments
 {
     String sceneFile;
     bool gpuValidation = false;
+    u32 captureFrames = 0; // keeps a rolling frame timeline of this many frames, written on exit
+
+    // --benchmark <scene> <path> plays the camera path in the scene, writes the timings and exits.
+    String benchmarkPath;
+    u32 benchmarkFrames = 0; // 0 plays the whole path once
+    u32 benchmarkWarmupFrames = 120;
+    String benchmarkOutput; // output file stem, data/profiles/benchmark_<scene>_<path> by default
 };
 
 void ProcessCommandLineArguments(i32 argc, char** argv);
@@ -5,23 +5,24 @@
 
 #pragma once
 
-#include <DirectXMath.h>
-
-#include "common/Types.h"
+#include <cstdint>
 
+// Scene pack file (.ikp), written by IskurScenePacker and read by the engine and IskurReferenceTracer.
+// Only <cstdint> types and plain float arrays are used here so the tracer builds on any platform.
 namespace IEPack
 {
 inline constexpr char PACK_FILE_EXTENSION[] = ".ikp";
 
-constexpr u32 PACK_VERSION_LATEST = 19;
+constexpr std::uint32_t PACK_VERSION_LATEST = 20;
 
-constexpr u32 FourCC(char a, char b, char c, char d)
+constexpr std::uint32_t FourCC(char a, char b, char c, char d)
 {
-    return static_cast<u32>(static_cast<u8>(a)) | (static_cast<u32>(static_cast<u8>(b)) << 8) | (static_cast<u32>(static_cast<u8>(c)) << 16) | (static_cast<u32>(static_cast<u8>(d)) << 24);
+    return static_cast<std::uint32_t>(static_cast<std::uint8_t>(a)) | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(b)) << 8) |
+           (static_cast<std::uint32_t>(static_cast<std::uint8_t>(c)) << 16) | (static_cast<std::uint32_t>(static_cast<std::uint8_t>(d)) << 24);
 }
 
 // Chunk IDs
-enum : u32
+enum : std::uint32_t
 {
     CH_PRIM = FourCC('P', 'R', 'I', 'M'),
     CH_VERT = FourCC('V', 'E', 'R', 'T'),
@@ -46,7 +47,7 @@ enum : u32
 };
 
 // Material flags
-enum : u32
+enum : std::uint32_t
 {
     MATF_ALPHA_MASK = 1u << 0,
     MATF_ALPHA_BLEND = 1u << 1,
@@ -58,97 +59,103 @@ enum : u32
 // Chunk table entry (no crc/flags)
 struct ChunkRecord
 {
-    u32 id;
-    u64 offset;
-    u64 size;
+    std::uint32_t id;
+    std::uint64_t offset;
+    std::uint64_t size;
 };
 
 struct PackHeader
 {
     char magic[9];
-    u32 version;
-    u32 primCount;
-    u32 chunkCount;
-    u32 reserved0;
-    u64 chunkTableOffset;
-    u64 primTableOffset;
-    u64 verticesOffset;
-    u64 indicesOffset;
-    u64 meshletsOffset;
-    u64 mlVertsOffset;
-    u64 mlTrisOffset;
-    u64 mlBoundsOffset;
+    std::uint32_t version;
+    std::uint32_t primCount;
+    std::uint32_t chunkCount;
+    std::uint32_t reserved0;
+    std::uint64_t chunkTableOffset;
+    std::uint64_t primTableOffset;
+    std::uint64_t verticesOffset;
+    std::uint64_t indicesOffset;
+    std::uint64_t meshletsOffset;
+    std::uint64_t mlVertsOffset;
+    std::uint64_t mlTrisOffset;
+    std::uint64_t mlBoundsOffset;
 };
 
 struct PrimRecord
 {
-    u32 meshIndex, primIndex, materialIndex;
-    u32 vertexCount, indexCount, meshletCount;
-    u64 vertexByteOffset, indexByteOffset, meshletsByteOffset, mlVertsByteOffset, mlTrisByteOffset, mlBoundsByteOffset;
-    u32 mlVertsCount, mlTrisByteCount;
-    u32 ommIndexOffset, ommIndexCount;
-    u32 ommDescOffset, ommDescCount;
-    u64 ommDataByteOffset;
-    u32 ommDataByteSize, ommFormat;
+    std::uint32_t meshIndex, primIndex, materialIndex;
+    std::uint32_t vertexCount, indexCount, meshletCount;
+    std::uint64_t vertexByteOffset, indexByteOffset, meshletsByteOffset, mlVertsByteOffset, mlTrisByteOffset, mlBoundsByteOffset;
+    std::uint32_t mlVertsCount, mlTrisByteCount;
+    std::uint32_t ommIndexOffset, ommIndexCount;
+    std::uint32_t ommDescOffset, ommDescCount;
+    std::uint64_t ommDataByteOffset;
+    std::uint32_t ommDataByteSize, ommFormat;
 
     // Primitive-local bounding sphere (object space).
-    DirectX::XMFLOAT3 localBoundsCenter;
-    f32 localBoundsRadius;
+    float localBoundsCenter[3];
+    float localBoundsRadius;
+
+    // Primitive-local bounding box (object space): the tighter of the AABB and a PCA-fitted OBB.
+    // The rotation quaternion maps box axes to object axes; identity means the box is axis-aligned.
+    float localBoxCenter[3];
+    float localBoxHalfExtents[3];
+    float localBoxRotation[4]; // x, y, z, w
 };
-static_assert(sizeof(PrimRecord) == 128);
+static_assert(sizeof(PrimRecord) == 168);
 
 struct OpacityMicromapDescRecord
 {
-    u32 dataByteOffset;
-    u32 dataByteSize;
-    u32 subdivisionLevel;
-    u32 reserved;
+    std::uint32_t dataByteOffset;
+    std::uint32_t dataByteSize;
+    std::uint32_t subdivisionLevel;
+    std::uint32_t reserved;
 };
 static_assert(sizeof(OpacityMicromapDescRecord) == 16);
 
 // Texture table entry
 struct TextureRecord
 {
-    u32 imageIndex;
-    u32 format;
-    u32 dimension;
-    u32 miscFlags;
-    u32 miscFlags2;
-    u32 width;
-    u32 height;
-    u32 depth;
-    u32 arraySize;
-    u32 mipLevels;
-    u32 subresourceOffset;
-    u32 subresourceCount;
-    u64 byteOffset, byteSize;
+    std::uint32_t imageIndex;
+    std::uint32_t format;
+    std::uint32_t dimension;
+    std::uint32_t miscFlags;
+    std::uint32_t miscFlags2;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t depth;
+    std::uint32_t arraySize;
+    std::uint32_t mipLevels;
+    std::uint32_t subresourceOffset;
+    std::uint32_t subresourceCount;
+    std::uint64_t byteOffset, byteSize;
 };
 
 struct TextureSubresourceRecord
 {
-    u64 byteOffset;
-    u64 byteSize;
-    u32 rowPitch;
-    u32 slicePitch;
+    std::uint64_t byteOffset;
+    std::uint64_t byteSize;
+    std::uint32_t rowPitch;
+    std::uint32_t slicePitch;
 };
 
 // On-disk Material
 struct MaterialRecord
 {
     // Texture indices into TXHD (or -1 for none)
-    i32 baseColorTx, normalTx, metallicRoughTx, occlusionTx, emissiveTx;
+    std::int32_t baseColorTx, normalTx, metallicRoughTx, occlusionTx, emissiveTx;
     // Sampler indices into SAMP (UINT32_MAX for none)
-    u32 baseColorSampler, normalSampler, metallicRoughSampler, occlusionSampler, emissiveSampler;
+    std::uint32_t baseColorSampler, normalSampler, metallicRoughSampler, occlusionSampler, emissiveSampler;
 
-    f32 baseColorFactor[4], emissiveFactor[3], metallicFactor, roughnessFactor, normalScale, occlusionStrength, alphaCutoff;
-    u32 flags; // MATF_ALPHA_* | MATF_DOUBLE_SIDED
+    float baseColorFactor[4], emissiveFactor[3], metallicFactor, roughnessFactor, normalScale, occlusionStrength, alphaCutoff;
+    std::uint32_t flags; // MATF_ALPHA_* | MATF_DOUBLE_SIDED
 };
 
 struct InstanceRecord
 {
-    u32 primIndex;             // global prim index into PRIM table
-    u32 materialIndex;         // final resolved material for this instance
-    DirectX::XMFLOAT4X4 world; // row-major 3x4
+    std::uint32_t primIndex;     // global prim index into PRIM table
+    std::uint32_t materialIndex; // final resolved material for this instance
+    float world[4][4];           // row-major 3x4, XMFLOAT4X4 layout
 };
 
 #pragma pack(pop)
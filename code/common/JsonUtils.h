@@ -0,0 +1,59 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Header-only and standard library only, so IskurTimelineAnalyzer can share it without the engine headers.
+
+// Appends text as a quoted JSON string. Control characters are escaped rather than dropped, so every report names
+// the same scope the same way.
+inline void AppendJsonString(std::string& out, std::string_view text)
+{
+    out.push_back('"');
+    for (const char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                constexpr char hexDigits[] = "0123456789abcdef";
+                out += "\\u00";
+                out.push_back(hexDigits[static_cast<unsigned char>(c) >> 4]);
+                out.push_back(hexDigits[static_cast<unsigned char>(c) & 0xF]);
+            }
+            else
+            {
+                out.push_back(c);
+            }
+            break;
+        }
+    }
+    out.push_back('"');
+}
+
+// Null names are written as an empty string.
+inline void AppendJsonString(std::string& out, const char* text)
+{
+    AppendJsonString(out, std::string_view(text ? text : ""));
+}
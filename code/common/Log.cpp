@@ -0,0 +1,431 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "Log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+#include "Asserts.h"
+#include "Profiler.h"
+
+namespace
+{
+constexpr u32 kRecordCount = 1024; // power of two
+constexpr u32 kRecordTextSize = 464;
+constexpr DWORD kIdleWaitMs = 50;
+// Set in enqueuePos by Shutdown. Claims compare-exchange the position without it, so none can succeed once the ring is closed.
+constexpr u64 kEnqueueClosedBit = 1ull << 63;
+
+struct Record
+{
+    std::atomic<u64> sequence{0};
+    u64 fileTime = 0;
+    LogLevel level = LogLevel_Info;
+    u32 length = 0;
+    String overflow; // holds the text instead of `text` when it does not fit
+    char text[kRecordTextSize];
+};
+
+// Bounded MPSC ring: a record is free for enqueue position p when its sequence equals p, and holds a published line for
+// dequeue position p when its sequence equals p + 1. Producers claim positions with a CAS, the single consumer frees records
+// by moving their sequence one lap ahead.
+struct Logger
+{
+    Array<Record, kRecordCount> records;
+    alignas(64) std::atomic<u64> enqueuePos{0};
+    alignas(64) std::atomic<u64> consumedPos{0};
+    alignas(64) std::atomic<u64> droppedCount{0};
+    std::atomic<bool> consumerSleeping{false};
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopRequested{false};
+
+    HANDLE wakeEvent = nullptr;
+    std::thread thread;
+
+    LogDesc desc{};
+    FILE* file = nullptr;
+    u64 fileBytes = 0;
+    String line;
+};
+
+Logger g_Logger;
+thread_local String t_FormatBuffer;
+
+const char* GetLevelTag(const LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel_Debug:
+        return "DEBUG";
+    case LogLevel_Info:
+        return "INFO";
+    case LogLevel_Warn:
+        return "WARN";
+    case LogLevel_Error:
+        return "ERROR";
+    case LogLevel_Fatal:
+        return "FATAL";
+    default:
+        return "?";
+    }
+}
+
+u64 GetFileTimeNow()
+{
+    FILETIME fileTime{};
+    GetSystemTimePreciseAsFileTime(&fileTime);
+    return (static_cast<u64>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+}
+
+void BuildLine(String& out, const u64 fileTime, const LogLevel level, const std::string_view message)
+{
+    FILETIME utc{};
+    utc.dwLowDateTime = static_cast<DWORD>(fileTime);
+    utc.dwHighDateTime = static_cast<DWORD>(fileTime >> 32);
+    FILETIME local{};
+    SYSTEMTIME st{};
+    FileTimeToLocalFileTime(&utc, &local);
+    FileTimeToSystemTime(&local, &st);
+
+    out.clear();
+    std::format_to(std::back_inserter(out), "[{:02}:{:02}:{:02}.{:03}][{}]", st.wHour, st.wMinute, st.wSecond, st.wMilliseconds, GetLevelTag(level));
+    if (!message.empty() && message.front() != '[')
+    {
+        out.push_back(' ');
+    }
+    out.append(message);
+    out.push_back('\n');
+}
+
+std::filesystem::path GetRotatedPath(const std::filesystem::path& path, const u32 index)
+{
+    std::filesystem::path rotated = path.parent_path() / path.stem();
+    rotated += std::format(".{}", index);
+    rotated += path.extension();
+    return rotated;
+}
+
+void OpenLogFile(Logger& logger)
+{
+    std::error_code ec;
+    if (logger.desc.filePath.has_parent_path())
+    {
+        std::filesystem::create_directories(logger.desc.filePath.parent_path(), ec);
+    }
+    logger.file = _wfopen(logger.desc.filePath.c_str(), L"wb");
+    logger.fileBytes = 0;
+    if (!logger.file)
+    {
+        OutputDebugStringA(std::format("[LOG] Could not open {}, the file sink is disabled.\n", logger.desc.filePath.generic_string()).c_str());
+    }
+}
+
+void RotateLogFile(Logger& logger)
+{
+    fclose(logger.file);
+    logger.file = nullptr;
+
+    std::error_code ec;
+    if (logger.desc.maxRotatedFiles > 0)
+    {
+        std::filesystem::remove(GetRotatedPath(logger.desc.filePath, logger.desc.maxRotatedFiles), ec);
+        for (u32 i = logger.desc.maxRotatedFiles; i > 1; --i)
+        {
+            std::filesystem::rename(GetRotatedPath(logger.desc.filePath, i - 1), GetRotatedPath(logger.desc.filePath, i), ec);
+        }
+        std::filesystem::rename(logger.desc.filePath, GetRotatedPath(logger.desc.filePath, 1), ec);
+    }
+    OpenLogFile(logger);
+}
+
+void WriteLineToSinks(Logger& logger, const String& line)
+{
+    if (logger.desc.debugger)
+    {
+        OutputDebugStringA(line.c_str());
+    }
+    if (logger.desc.console)
+    {
+        fwrite(line.data(), 1, line.size(), stdout);
+    }
+    if (logger.file)
+    {
+        if (logger.fileBytes > 0 && logger.fileBytes + line.size() > logger.desc.maxFileBytes)
+        {
+            RotateLogFile(logger);
+        }
+        if (logger.file)
+        {
+            fwrite(line.data(), 1, line.size(), logger.file);
+            logger.fileBytes += line.size();
+        }
+    }
+}
+
+void WriteSynchronous(const LogLevel level, const std::string_view message)
+{
+    String line;
+    BuildLine(line, GetFileTimeNow(), level, message);
+    OutputDebugStringA(line.c_str());
+}
+
+// Returns the number of lines written.
+u32 DrainRecords(Logger& logger)
+{
+    u32 written = 0;
+    u64 pos = logger.consumedPos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Record& record = logger.records[pos & (kRecordCount - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            break;
+        }
+
+        const std::string_view message = record.overflow.empty() ? std::string_view(record.text, record.length) : std::string_view(record.overflow);
+        BuildLine(logger.line, record.fileTime, record.level, message);
+        WriteLineToSinks(logger, logger.line);
+        record.overflow.clear();
+        record.sequence.store(pos + kRecordCount, std::memory_order_release);
+        ++pos;
+        ++written;
+    }
+
+    const u64 dropped = logger.droppedCount.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+    {
+        BuildLine(logger.line, GetFileTimeNow(), LogLevel_Warn, std::format("[LOG] {} debug/info lines were dropped because the log queue was full.", dropped));
+        WriteLineToSinks(logger, logger.line);
+        ++written;
+    }
+
+    if (written > 0)
+    {
+        if (logger.desc.console)
+        {
+            fflush(stdout);
+        }
+        if (logger.file)
+        {
+            fflush(logger.file);
+        }
+        logger.consumedPos.store(pos, std::memory_order_release);
+        logger.consumedPos.notify_all();
+    }
+    return written;
+}
+
+void RunConsumer(Logger& logger)
+{
+    Profiler::SetThreadName("Log Writer");
+    for (;;)
+    {
+        if (DrainRecords(logger) > 0)
+        {
+            continue;
+        }
+        if (logger.stopRequested.load(std::memory_order_acquire))
+        {
+            // The ring was closed before the stop request, so the claimed count is final. Producers that claimed a record
+            // before that still publish it; keep draining until all of them have.
+            if (logger.consumedPos.load(std::memory_order_relaxed) == (logger.enqueuePos.load(std::memory_order_acquire) & ~kEnqueueClosedBit))
+            {
+                break;
+            }
+            SwitchToThread();
+            continue;
+        }
+
+        // Pairs with the fence in PublishRecord: either the producer sees the flag and signals, or the drain below sees its record.
+        logger.consumerSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (DrainRecords(logger) == 0)
+        {
+            WaitForSingleObject(logger.wakeEvent, kIdleWaitMs);
+        }
+        logger.consumerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+// Claims a record for the calling thread. Returns nullptr when the line was dropped, or with outClosed set when the logger
+// shut down in the meantime and the caller has to write the line itself.
+Record* ClaimRecord(Logger& logger, const LogLevel level, u64& outPos, bool& outClosed)
+{
+    outClosed = false;
+    u64 pos = logger.enqueuePos.load(std::memory_order_acquire);
+    for (;;)
+    {
+        if (pos & kEnqueueClosedBit)
+        {
+            outClosed = true;
+            return nullptr;
+        }
+
+        Record& record = logger.records[pos & (kRecordCount - 1)];
+        const i64 diff = static_cast<i64>(record.sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0)
+        {
+            if (logger.enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                outPos = pos;
+                return &record;
+            }
+        }
+        else if (diff < 0)
+        {
+            if (level < LogLevel_Warn)
+            {
+                logger.droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            SetEvent(logger.wakeEvent);
+            SwitchToThread();
+            pos = logger.enqueuePos.load(std::memory_order_acquire);
+        }
+        else
+        {
+            pos = logger.enqueuePos.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void PublishRecord(Logger& logger, Record& record, const u64 pos)
+{
+    record.sequence.store(pos + 1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (logger.consumerSleeping.load(std::memory_order_relaxed) && logger.consumerSleeping.exchange(false, std::memory_order_relaxed))
+    {
+        SetEvent(logger.wakeEvent);
+    }
+}
+
+void Enqueue(const LogLevel level, const std::string_view message)
+{
+    Logger& logger = g_Logger;
+    if (!logger.running.load(std::memory_order_acquire))
+    {
+        WriteSynchronous(level, message);
+        return;
+    }
+
+    u64 pos = 0;
+    bool closed = false;
+    Record* record = ClaimRecord(logger, level, pos, closed);
+    if (!record)
+    {
+        if (closed)
+        {
+            WriteSynchronous(level, message);
+        }
+        return;
+    }
+
+    record->fileTime = GetFileTimeNow();
+    record->level = level;
+    if (message.size() <= kRecordTextSize)
+    {
+        memcpy(record->text, message.data(), message.size());
+        record->length = static_cast<u32>(message.size());
+    }
+    else
+    {
+        record->overflow.assign(message);
+        record->length = 0;
+    }
+    PublishRecord(logger, *record, pos);
+
+    if (level == LogLevel_Fatal)
+    {
+        Log::Flush();
+    }
+}
+} // namespace
+
+namespace Log
+{
+void Init(const LogDesc& desc)
+{
+    Logger& logger = g_Logger;
+    IE_Assert(!logger.running.load(std::memory_order_relaxed));
+
+    logger.desc = desc;
+    if (!logger.desc.filePath.empty())
+    {
+        OpenLogFile(logger);
+    }
+
+    const u64 pos = logger.enqueuePos.load(std::memory_order_relaxed) & ~kEnqueueClosedBit;
+    logger.enqueuePos.store(pos, std::memory_order_relaxed);
+    for (u32 i = 0; i < kRecordCount; ++i)
+    {
+        logger.records[(pos + i) & (kRecordCount - 1)].sequence.store(pos + i, std::memory_order_relaxed);
+    }
+    logger.consumedPos.store(pos, std::memory_order_relaxed);
+    logger.stopRequested.store(false, std::memory_order_relaxed);
+    logger.wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    logger.thread = std::thread([&logger] { RunConsumer(logger); });
+    logger.running.store(true, std::memory_order_release);
+}
+
+void Flush()
+{
+    Logger& logger = g_Logger;
+    if (!logger.running.load(std::memory_order_acquire) || logger.thread.get_id() == std::this_thread::get_id())
+    {
+        return;
+    }
+
+    const u64 target = logger.enqueuePos.load(std::memory_order_acquire) & ~kEnqueueClosedBit;
+    SetEvent(logger.wakeEvent);
+    u64 consumed = logger.consumedPos.load(std::memory_order_acquire);
+    while (consumed < target)
+    {
+        logger.consumedPos.wait(consumed, std::memory_order_acquire);
+        consumed = logger.consumedPos.load(std::memory_order_acquire);
+    }
+}
+
+void Shutdown()
+{
+    Logger& logger = g_Logger;
+    if (!logger.running.exchange(false, std::memory_order_acq_rel))
+    {
+        return;
+    }
+
+    // Producers that read `running` before the exchange may still be claiming. Closing the ring first makes their claims
+    // fail (they fall back to a synchronous write), so the consumer below drains a fixed set of records and never strands one.
+    logger.enqueuePos.fetch_or(kEnqueueClosedBit, std::memory_order_acq_rel);
+    logger.stopRequested.store(true, std::memory_order_release);
+    SetEvent(logger.wakeEvent);
+    logger.thread.join();
+
+    CloseHandle(logger.wakeEvent);
+    logger.wakeEvent = nullptr;
+    if (logger.file)
+    {
+        fclose(logger.file);
+        logger.file = nullptr;
+    }
+}
+
+void Write(const LogLevel level, const std::string_view message)
+{
+    Enqueue(level, message);
+}
+
+void WriteFormatted(const LogLevel level, const std::string_view fmt, const std::format_args args)
+{
+    // Each thread keeps its own buffer, so formatting stops allocating once the buffer has grown to the longest line.
+    String& buffer = t_FormatBuffer;
+    buffer.clear();
+    std::vformat_to(std::back_inserter(buffer), fmt, args);
+    Enqueue(level, buffer);
+}
+} // namespace Log
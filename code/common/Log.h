@@ -7,92 +7,131 @@
 
 #include <Windows.h>
 
+#include <filesystem>
 #include <format>
+#include <string_view>
 #include <utility>
 
 #include "Types.h"
 
-inline void IE_LogNoNewline(const String& msg)
+enum LogLevel : u8
 {
-    OutputDebugStringA(msg.c_str());
-}
-
-template <typename... Args> inline void IE_LogNoNewline(std::format_string<Args...> fmt, Args&&... args)
+    LogLevel_Debug,
+    LogLevel_Info,
+    LogLevel_Warn,
+    LogLevel_Error,
+    LogLevel_Fatal,
+
+    LogLevel_Count
+};
+
+// Messages below this level are compiled out: their arguments are neither formatted nor queued.
+#ifndef IE_LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define IE_LOG_MIN_LEVEL LogLevel_Debug
+#else
+#define IE_LOG_MIN_LEVEL LogLevel_Info
+#endif
+#endif
+
+struct LogDesc
 {
-    IE_LogNoNewline(std::format(fmt, std::forward<Args>(args)...));
-}
-
-inline String IE_BuildLogPrefix(const char* tag)
+    std::filesystem::path filePath{}; // empty disables the file sink
+    u64 maxFileBytes = 8ull * 1024ull * 1024ull;
+    u32 maxRotatedFiles = 3; // older files are kept as <stem>.1<ext>, <stem>.2<ext>, ...
+    bool debugger = true;
+    bool console = false;
+};
+
+// Callers format into a lock-free ring buffer and a background thread writes the lines to the sinks. Until Init (and after
+// Shutdown) lines go straight to the debugger on the calling thread. When the ring is full, debug and info lines are dropped
+// and counted, while warnings and errors wait for room; fatal lines are flushed before returning.
+namespace Log
 {
-    SYSTEMTIME st{};
-    GetLocalTime(&st);
-    return std::format("[{:02}:{:02}:{:02}.{:03}][{}]", st.wHour, st.wMinute, st.wSecond, st.wMilliseconds, tag);
-}
+void Init(const LogDesc& desc);
+// Returns once every line queued before the call has reached the sinks.
+void Flush();
+void Shutdown();
 
-inline void IE_LogTagged(const char* tag, const String& msg)
-{
-    const String prefix = IE_BuildLogPrefix(tag);
-    IE_LogNoNewline(prefix);
-    if (!msg.empty() && msg.front() != '[')
-    {
-        IE_LogNoNewline(" ");
-    }
-    IE_LogNoNewline(msg);
-    IE_LogNoNewline("\n");
-}
+void Write(LogLevel level, std::string_view message);
+void WriteFormatted(LogLevel level, std::string_view fmt, std::format_args args);
+} // namespace Log
 
-template <typename... Args> inline void IE_LogTagged(const char* tag, std::format_string<Args...> fmt, Args&&... args)
+template <typename... Args> inline void IE_LogWrite(const LogLevel level, std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged(tag, std::format(fmt, std::forward<Args>(args)...));
+    Log::WriteFormatted(level, fmt.get(), std::make_format_args(args...));
 }
 
 inline void IE_LogDebug(const String& msg)
 {
-    IE_LogTagged("DEBUG", msg);
+    if constexpr (LogLevel_Debug >= IE_LOG_MIN_LEVEL)
+    {
+        Log::Write(LogLevel_Debug, msg);
+    }
 }
 
 template <typename... Args> inline void IE_LogDebug(std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged("DEBUG", fmt, std::forward<Args>(args)...);
+    if constexpr (LogLevel_Debug >= IE_LOG_MIN_LEVEL)
+    {
+        IE_LogWrite(LogLevel_Debug, fmt, std::forward<Args>(args)...);
+    }
 }
 
 inline void IE_LogInfo(const String& msg)
 {
-    IE_LogTagged("INFO", msg);
+    if constexpr (LogLevel_Info >= IE_LOG_MIN_LEVEL)
+    {
+        Log::Write(LogLevel_Info, msg);
+    }
 }
 
 template <typename... Args> inline void IE_LogInfo(std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged("INFO", fmt, std::forward<Args>(args)...);
+    if constexpr (LogLevel_Info >= IE_LOG_MIN_LEVEL)
+    {
+        IE_LogWrite(LogLevel_Info, fmt, std::forward<Args>(args)...);
+    }
 }
 
 inline void IE_LogWarn(const String& msg)
 {
-    IE_LogTagged("WARN", msg);
+    if constexpr (LogLevel_Warn >= IE_LOG_MIN_LEVEL)
+    {
+        Log::Write(LogLevel_Warn, msg);
+    }
 }
 
 template <typename... Args> inline void IE_LogWarn(std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged("WARN", fmt, std::forward<Args>(args)...);
+    if constexpr (LogLevel_Warn >= IE_LOG_MIN_LEVEL)
+    {
+        IE_LogWrite(LogLevel_Warn, fmt, std::forward<Args>(args)...);
+    }
 }
 
 inline void IE_LogError(const String& msg)
 {
-    IE_LogTagged("ERROR", msg);
+    if constexpr (LogLevel_Error >= IE_LOG_MIN_LEVEL)
+    {
+        Log::Write(LogLevel_Error, msg);
+    }
 }
 
 template <typename... Args> inline void IE_LogError(std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged("ERROR", fmt, std::forward<Args>(args)...);
+    if constexpr (LogLevel_Error >= IE_LOG_MIN_LEVEL)
+    {
+        IE_LogWrite(LogLevel_Error, fmt, std::forward<Args>(args)...);
+    }
 }
 
 inline void IE_LogFatal(const String& msg)
 {
-    IE_LogTagged("FATAL", msg);
+    Log::Write(LogLevel_Fatal, msg);
 }
 
 template <typename... Args> inline void IE_LogFatal(std::format_string<Args...> fmt, Args&&... args)
 {
-    IE_LogTagged("FATAL", fmt, std::forward<Args>(args)...);
+    IE_LogWrite(LogLevel_Fatal, fmt, std::forward<Args>(args)...);
 }
-
@@ -0,0 +1,335 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "Profiler.h"
+
+#include "JsonUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <mutex>
+
+namespace
+{
+enum class EventType : u8
+{
+    Begin,
+    End,
+    Counter,
+};
+
+struct Event
+{
+    const char* name;
+    i64 timeNs;
+    f64 value;
+    EventType type;
+};
+
+// Written only by its owning thread; the exporter reads the first `count` events once the capture has ended.
+struct ThreadBuffer
+{
+    static constexpr u32 kCapacity = 1u << 16;
+
+    Vector<Event> events;
+    std::atomic<u32> count = 0;
+    std::atomic<u32> epoch = 0;
+    u32 dropped = 0;
+    u32 threadIndex = 0;
+    String threadName;
+    bool inUse = false;
+};
+
+// Events a thread recorded before it exited, copied out of its buffer so the buffer can be reused right away.
+struct ArchivedThreadEvents
+{
+    Vector<Event> events;
+    u32 epoch = 0;
+    u32 dropped = 0;
+    u32 threadIndex = 0;
+    String threadName;
+};
+
+struct ProfilerState
+{
+    std::mutex mutex; // guards the buffer list, the archive and thread names, never taken while recording
+    Vector<UniquePtr<ThreadBuffer>> buffers;
+    Vector<ArchivedThreadEvents> archived;
+    u32 nextThreadIndex = 0;
+    std::atomic<bool> capturing = false;
+    std::atomic<u32> epoch = 0;
+    i64 captureStartNs = 0;
+    i64 captureEndNs = 0;
+};
+
+ProfilerState g_Profiler;
+
+i64 NowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Called with the mutex held when the owning thread exits. Only the events recorded so far are archived, so threads that
+// come and go during a capture reuse a few full-size buffers instead of each allocating its own.
+void ReleaseThreadBuffer(ThreadBuffer& buffer)
+{
+    const u32 epoch = g_Profiler.epoch.load(std::memory_order_acquire);
+    std::erase_if(g_Profiler.archived, [epoch](const ArchivedThreadEvents& archive) { return archive.epoch != epoch; });
+
+    const u32 count = buffer.count.load(std::memory_order_relaxed);
+    if (buffer.epoch.load(std::memory_order_relaxed) == epoch && (count > 0 || buffer.dropped > 0))
+    {
+        ArchivedThreadEvents& archive = g_Profiler.archived.emplace_back();
+        archive.events.assign(buffer.events.begin(), buffer.events.begin() + count);
+        archive.epoch = epoch;
+        archive.dropped = buffer.dropped;
+        archive.threadIndex = buffer.threadIndex;
+        archive.threadName = std::move(buffer.threadName);
+    }
+
+    buffer.count.store(0, std::memory_order_relaxed);
+    buffer.dropped = 0;
+    buffer.inUse = false;
+}
+
+// Returns the buffer to the pool when its thread exits, so short-lived worker threads do not grow the list.
+struct ThreadBufferHandle
+{
+    ThreadBuffer* buffer = nullptr;
+    const char* name = nullptr;
+
+    ~ThreadBufferHandle()
+    {
+        if (buffer)
+        {
+            std::lock_guard lock(g_Profiler.mutex);
+            ReleaseThreadBuffer(*buffer);
+        }
+    }
+};
+
+thread_local ThreadBufferHandle t_Buffer;
+
+ThreadBuffer* AcquireThreadBuffer()
+{
+    std::lock_guard lock(g_Profiler.mutex);
+    const u32 epoch = g_Profiler.epoch.load(std::memory_order_acquire);
+
+    ThreadBuffer* buffer = nullptr;
+    for (const UniquePtr<ThreadBuffer>& candidate : g_Profiler.buffers)
+    {
+        if (!candidate->inUse)
+        {
+            buffer = candidate.get();
+            break;
+        }
+    }
+    if (!buffer)
+    {
+        g_Profiler.buffers.push_back(IE_MakeUniquePtr<ThreadBuffer>());
+        buffer = g_Profiler.buffers.back().get();
+        buffer->events.resize(ThreadBuffer::kCapacity);
+    }
+
+    // A fresh index per thread keeps a reused buffer from merging its new thread into the archived one's track.
+    buffer->inUse = true;
+    buffer->threadIndex = ++g_Profiler.nextThreadIndex;
+    buffer->count.store(0, std::memory_order_relaxed);
+    buffer->dropped = 0;
+    buffer->epoch.store(epoch, std::memory_order_relaxed);
+    buffer->threadName = t_Buffer.name ? t_Buffer.name : std::format("Thread {}", buffer->threadIndex);
+    return buffer;
+}
+
+void Record(const EventType type, const char* name, const f64 value)
+{
+    if (!g_Profiler.capturing.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    ThreadBuffer* buffer = t_Buffer.buffer;
+    if (!buffer)
+    {
+        buffer = AcquireThreadBuffer();
+        t_Buffer.buffer = buffer;
+    }
+
+    const u32 epoch = g_Profiler.epoch.load(std::memory_order_acquire);
+    if (buffer->epoch.load(std::memory_order_relaxed) != epoch)
+    {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped = 0;
+        buffer->epoch.store(epoch, std::memory_order_relaxed);
+    }
+
+    const u32 index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= ThreadBuffer::kCapacity)
+    {
+        buffer->dropped++;
+        return;
+    }
+
+    buffer->events[index] = {name, NowNs(), value, type};
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+} // namespace
+
+namespace Profiler
+{
+void SetThreadName(const char* name)
+{
+    t_Buffer.name = name;
+    if (t_Buffer.buffer)
+    {
+        std::lock_guard lock(g_Profiler.mutex);
+        t_Buffer.buffer->threadName = name;
+    }
+}
+
+void BeginScope(const char* name)
+{
+    Record(EventType::Begin, name, 0.0);
+}
+
+void EndScope()
+{
+    Record(EventType::End, nullptr, 0.0);
+}
+
+void Counter(const char* name, const f64 value)
+{
+    Record(EventType::Counter, name, value);
+}
+
+void BeginCapture()
+{
+    g_Profiler.captureStartNs = NowNs();
+    g_Profiler.epoch.fetch_add(1, std::memory_order_acq_rel);
+    g_Profiler.capturing.store(true, std::memory_order_release);
+}
+
+void EndCapture()
+{
+    g_Profiler.capturing.store(false, std::memory_order_release);
+    g_Profiler.captureEndNs = NowNs();
+}
+
+bool IsCapturing()
+{
+    return g_Profiler.capturing.load(std::memory_order_relaxed);
+}
+
+bool WriteChromeTrace(const std::filesystem::path& path)
+{
+    const i64 startNs = g_Profiler.captureStartNs;
+    const u32 epoch = g_Profiler.epoch.load(std::memory_order_acquire);
+    auto ToUs = [&](const i64 timeNs) { return static_cast<f64>(timeNs - startNs) * 1e-3; };
+
+    String json;
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto BeginEvent = [&]() {
+        if (!first)
+        {
+            json += ",\n";
+        }
+        first = false;
+    };
+
+    auto WriteThread = [&](const u32 threadIndex, const String& threadName, const Event* events, const u32 count) {
+        BeginEvent();
+        json += std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", threadIndex);
+        AppendJsonString(json, threadName.c_str());
+        json += "}}";
+
+        // Ends without a matching begin come from scopes opened before the capture started.
+        Vector<const char*> openScopes;
+        for (u32 i = 0; i < count; ++i)
+        {
+            const Event& event = events[i];
+            switch (event.type)
+            {
+            case EventType::Begin:
+                openScopes.push_back(event.name);
+                BeginEvent();
+                json += "{\"name\":";
+                AppendJsonString(json, event.name);
+                json += std::format(",\"ph\":\"B\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", ToUs(event.timeNs), threadIndex);
+                break;
+            case EventType::End:
+                if (openScopes.empty())
+                {
+                    break;
+                }
+                openScopes.pop_back();
+                BeginEvent();
+                json += std::format("{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", ToUs(event.timeNs), threadIndex);
+                break;
+            case EventType::Counter:
+                BeginEvent();
+                json += "{\"name\":";
+                AppendJsonString(json, event.name);
+                json += std::format(",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"args\":{{\"value\":{}}}}}", ToUs(event.timeNs), event.value);
+                break;
+            }
+        }
+
+        while (!openScopes.empty())
+        {
+            openScopes.pop_back();
+            BeginEvent();
+            json += std::format("{{\"ph\":\"E\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}", ToUs(g_Profiler.captureEndNs), threadIndex);
+        }
+    };
+
+    u32 droppedTotal = 0;
+    {
+        std::lock_guard lock(g_Profiler.mutex);
+        for (const UniquePtr<ThreadBuffer>& buffer : g_Profiler.buffers)
+        {
+            if (buffer->epoch.load(std::memory_order_relaxed) != epoch)
+            {
+                continue;
+            }
+
+            const u32 count = buffer->count.load(std::memory_order_acquire);
+            if (count == 0)
+            {
+                continue;
+            }
+            droppedTotal += buffer->dropped;
+            WriteThread(buffer->threadIndex, buffer->threadName, buffer->events.data(), count);
+        }
+
+        for (const ArchivedThreadEvents& archive : g_Profiler.archived)
+        {
+            if (archive.epoch != epoch)
+            {
+                continue;
+            }
+
+            droppedTotal += archive.dropped;
+            if (!archive.events.empty())
+            {
+                WriteThread(archive.threadIndex, archive.threadName, archive.events.data(), static_cast<u32>(archive.events.size()));
+            }
+        }
+    }
+    json += std::format("\n],\"otherData\":{{\"droppedEvents\":{}}}}}\n", droppedTotal);
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return file.good();
+}
+} // namespace Profiler
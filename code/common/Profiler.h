@@ -0,0 +1,47 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <filesystem>
+
+#include "Types.h"
+
+// Scoped CPU profiler shared by the engine and the tools. Events are only recorded while a capture is active; each thread
+// appends to its own buffer without locking, and a finished capture is exported as Chrome trace / Perfetto JSON.
+namespace Profiler
+{
+// Names passed to the profiler must be stable literals, they are stored by pointer.
+void SetThreadName(const char* name);
+void BeginScope(const char* name);
+void EndScope();
+void Counter(const char* name, f64 value);
+
+void BeginCapture();
+void EndCapture();
+bool IsCapturing();
+// Call between captures; scopes still open when the capture ended are closed at its end time.
+bool WriteChromeTrace(const std::filesystem::path& path);
+
+class Scope
+{
+  public:
+    explicit Scope(const char* name)
+    {
+        BeginScope(name);
+    }
+    ~Scope()
+    {
+        EndScope();
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+} // namespace Profiler
+
+#define IE_PROFILE_CONCAT_INNER(a, b) a##b
+#define IE_PROFILE_CONCAT(a, b) IE_PROFILE_CONCAT_INNER(a, b)
+#define IE_PROFILE_SCOPE(name) const Profiler::Scope IE_PROFILE_CONCAT(ieProfileScope, __LINE__)(name)
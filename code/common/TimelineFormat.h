@@ -0,0 +1,66 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <cstdint>
+
+// Frame timeline capture file (.iktl), written by the engine and read by IskurTimelineAnalyzer.
+// Only <cstdint> types are used here so the analyzer builds on any platform.
+//
+// Layout: TimelineHeader, FrameRecord[frameCount], CpuScopeRecord[cpuScopeCount], GpuPassRecord[gpuPassCount], then nameCount names
+// stored as a u16 length followed by the UTF-8 bytes. All times are nanoseconds relative to the capture origin, on the CPU clock;
+// GPU timestamps are converted with the queue's clock calibration so both timelines can be compared directly.
+namespace IETimeline
+{
+inline constexpr char TIMELINE_FILE_EXTENSION[] = ".iktl";
+inline constexpr char TIMELINE_MAGIC[8] = {'I', 'S', 'K', 'U', 'R', 'T', 'L', '\0'};
+
+constexpr std::uint32_t TIMELINE_VERSION_LATEST = 1;
+
+#pragma pack(push, 1)
+
+struct TimelineHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t frameCount;
+    std::uint32_t cpuScopeCount;
+    std::uint32_t gpuPassCount;
+    std::uint32_t nameCount;
+    std::uint32_t reserved0;
+    std::uint64_t gpuTimestampFrequency; // ticks/sec of the GPU queue, for reference
+};
+
+struct FrameRecord
+{
+    std::uint64_t frame; // capture frame serial, monotonic across scene switches
+    std::int64_t cpuBeginNs;
+    std::int64_t cpuEndNs;
+    std::uint32_t firstCpuScope;
+    std::uint32_t cpuScopeCount;
+    std::uint32_t firstGpuPass;
+    std::uint32_t gpuPassCount; // 0 when the GPU results were not read back before the capture was written
+};
+
+// Stored in begin order, so a nested scope follows its parent with a greater depth.
+struct CpuScopeRecord
+{
+    std::uint32_t nameIndex;
+    std::uint32_t depth;
+    std::int64_t beginNs;
+    std::int64_t endNs;
+};
+
+struct GpuPassRecord
+{
+    std::uint32_t nameIndex;
+    std::uint32_t reserved0;
+    std::int64_t beginNs;
+    std::int64_t endNs;
+};
+
+#pragma pack(pop)
+} // namespace IETimeline
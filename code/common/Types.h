@@ -10,7 +10,9 @@
 #include <memory>
 #include <string>
 #include <vector>
+#ifdef _WIN32
 #include <wrl/client.h>
+#endif
 
 using namespace DirectX;
 
@@ -31,7 +33,9 @@ template <class T, class Alloc = std::allocator<T>> using Vector = std::vector<T
 template <class T, std::size_t N> using Array = std::array<T, N>;
 using String = std::string;
 
+#ifdef _WIN32
 template <typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+#endif
 
 template <typename T> using SharedPtr = std::shared_ptr<T>;
 template <typename T> using WeakPtr = std::weak_ptr<T>;
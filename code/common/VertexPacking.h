@@ -0,0 +1,141 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "Types.h"
+
+#include <DirectXPackedVector.h>
+#include <algorithm>
+#include <cmath>
+
+// Vertex attribute encodings written by the scene packer (see Vertex in shaders/CPUGPU.h).
+
+inline f32 SignNotZeroF(f32 v)
+{
+    return (v >= 0.0f) ? 1.0f : -1.0f;
+}
+
+inline XMFLOAT3 NormalizeSafe(const XMFLOAT3& n)
+{
+    const f32 len2 = n.x * n.x + n.y * n.y + n.z * n.z;
+    if (len2 <= 1e-20f)
+        return XMFLOAT3(0.0f, 0.0f, 1.0f);
+    const f32 invLen = 1.0f / std::sqrt(len2);
+    return XMFLOAT3(n.x * invLen, n.y * invLen, n.z * invLen);
+}
+
+inline u32 PackNormalOctSnorm16(const XMFLOAT3& inNormal)
+{
+    XMFLOAT3 n = NormalizeSafe(inNormal);
+    const f32 invL1 = 1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
+    f32 ex = n.x * invL1;
+    f32 ey = n.y * invL1;
+    if (n.z < 0.0f)
+    {
+        const f32 ox = (1.0f - std::abs(ey)) * SignNotZeroF(ex);
+        const f32 oy = (1.0f - std::abs(ex)) * SignNotZeroF(ey);
+        ex = ox;
+        ey = oy;
+    }
+
+    const auto toSnorm16 = [](f32 v) -> i16 {
+        v = std::clamp(v, -1.0f, 1.0f);
+        int q = static_cast<int>(std::lround(v * 32767.0f));
+        q = std::clamp(q, -32767, 32767);
+        return static_cast<i16>(q);
+    };
+
+    const u16 qx = static_cast<u16>(toSnorm16(ex));
+    const u16 qy = static_cast<u16>(toSnorm16(ey));
+    return static_cast<u32>(qx) | (static_cast<u32>(qy) << 16);
+}
+
+inline XMFLOAT3 UnpackNormalOctSnorm16(u32 packed)
+{
+    const i16 qx = static_cast<i16>(packed & 0xFFFFu);
+    const i16 qy = static_cast<i16>((packed >> 16) & 0xFFFFu);
+
+    f32 ex = static_cast<f32>(qx) / 32767.0f;
+    f32 ey = static_cast<f32>(qy) / 32767.0f;
+    ex = std::max(-1.0f, ex);
+    ey = std::max(-1.0f, ey);
+
+    f32 x = ex;
+    f32 y = ey;
+    f32 z = 1.0f - std::abs(x) - std::abs(y);
+    if (z < 0.0f)
+    {
+        const f32 ox = (1.0f - std::abs(y)) * SignNotZeroF(x);
+        const f32 oy = (1.0f - std::abs(x)) * SignNotZeroF(y);
+        x = ox;
+        y = oy;
+    }
+    return NormalizeSafe(XMFLOAT3(x, y, z));
+}
+
+inline u32 PackTexCoordHalf2(const XMFLOAT2& uv)
+{
+    const u16 ux = DirectX::PackedVector::XMConvertFloatToHalf(uv.x);
+    const u16 uy = DirectX::PackedVector::XMConvertFloatToHalf(uv.y);
+    return static_cast<u32>(ux) | (static_cast<u32>(uy) << 16);
+}
+
+inline XMFLOAT2 UnpackTexCoordHalf2(u32 packed)
+{
+    const u16 ux = static_cast<u16>(packed & 0xFFFFu);
+    const u16 uy = static_cast<u16>((packed >> 16) & 0xFFFFu);
+    return XMFLOAT2(DirectX::PackedVector::XMConvertHalfToFloat(ux), DirectX::PackedVector::XMConvertHalfToFloat(uy));
+}
+
+struct PackedColorRGBA16Unorm
+{
+    u32 lo;
+    u32 hi;
+};
+
+inline PackedColorRGBA16Unorm PackColorRGBA16Unorm(const XMFLOAT4& color)
+{
+    const auto toUnorm16 = [](f32 v) -> u32 {
+        const f32 c = std::clamp(v, 0.0f, 1.0f);
+        const int q = static_cast<int>(std::lround(c * 65535.0f));
+        return static_cast<u32>(std::clamp(q, 0, 65535));
+    };
+
+    const u32 r = toUnorm16(color.x);
+    const u32 g = toUnorm16(color.y);
+    const u32 b = toUnorm16(color.z);
+    const u32 a = toUnorm16(color.w);
+    return PackedColorRGBA16Unorm{r | (g << 16), b | (a << 16)};
+}
+
+inline u32 PackTangentR10G10B10A2(const XMFLOAT3& inTangent, f32 handedness)
+{
+    XMFLOAT3 t = inTangent;
+    const f32 len2 = t.x * t.x + t.y * t.y + t.z * t.z;
+    if (len2 <= 1e-20f)
+    {
+        t = XMFLOAT3(1.0f, 0.0f, 0.0f);
+    }
+    else
+    {
+        const f32 invLen = 1.0f / std::sqrt(len2);
+        t.x *= invLen;
+        t.y *= invLen;
+        t.z *= invLen;
+    }
+
+    const auto toUnorm10 = [](f32 v) -> u32 {
+        const f32 u = std::clamp(v * 0.5f + 0.5f, 0.0f, 1.0f);
+        const int q = static_cast<int>(std::lround(u * 1023.0f));
+        return static_cast<u32>(std::clamp(q, 0, 1023));
+    };
+
+    const u32 x = toUnorm10(t.x);
+    const u32 y = toUnorm10(t.y);
+    const u32 z = toUnorm10(t.z);
+    const u32 a2 = (handedness < 0.0f) ? 0u : 3u;
+    return x | (y << 10) | (z << 20) | (a2 << 30);
+}
@@ -16,6 +16,10 @@ extern "C"
 
 i32 WINAPI WinMain(const HINSTANCE hInstance, HINSTANCE, LPSTR, const i32 nShowCmd)
 {
+    LogDesc logDesc;
+    logDesc.filePath = "data/logs/IskurEngine.log";
+    Log::Init(logDesc);
+
     IE_Check(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
 
     ProcessCommandLineArguments(__argc, __argv);
@@ -35,5 +39,7 @@ i32 WINAPI WinMain(const HINSTANCE hInstance, HINSTANCE, LPSTR, const i32 nShowC
 
     CoUninitialize();
 
+    Log::Shutdown();
+
     return 0;
 }
@@ -5,6 +5,7 @@
 
 #include "AutoExposure.h"
 
+#include "GpuMemory.h"
 #include "PipelineHelpers.h"
 #include "RenderDevice.h"
 #include "RuntimeState.h"
@@ -14,8 +15,8 @@ namespace
 {
 void ReleaseTextureDescriptors(BindlessHeaps& bindlessHeaps, Texture& texture)
 {
-    bindlessHeaps.FreeCbvSrvUav(texture.srvIndex);
-    bindlessHeaps.FreeCbvSrvUav(texture.uavIndex);
+    bindlessHeaps.FreeCbvSrvUav(texture.srvIndex, texture.srvGeneration);
+    bindlessHeaps.FreeCbvSrvUav(texture.uavIndex, texture.uavGeneration);
     texture.srvIndex = UINT32_MAX;
     texture.uavIndex = UINT32_MAX;
 }
@@ -31,6 +32,7 @@ void CreateExposureTexture(const ComPtr<ID3D12Device14>& device, BindlessHeaps&
                                              IID_PPV_ARGS(&outTexture.resource)));
     outTexture.state = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     outTexture.SetName(name);
+    GpuMemory::Track(outTexture.Get(), GpuMemoryCategory_Other);
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
     srvDesc.Format = desc.Format;
@@ -38,11 +40,13 @@ void CreateExposureTexture(const ComPtr<ID3D12Device14>& device, BindlessHeaps&
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     srvDesc.Texture2D.MipLevels = 1;
     outTexture.srvIndex = bindlessHeaps.CreateSRV(outTexture.resource, srvDesc);
+    outTexture.srvGeneration = bindlessHeaps.GetGeneration(outTexture.srvIndex);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
     uavDesc.Format = desc.Format;
     uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
     outTexture.uavIndex = bindlessHeaps.CreateUAV(outTexture.resource, uavDesc);
+    outTexture.uavGeneration = bindlessHeaps.GetGeneration(outTexture.uavIndex);
 }
 } // namespace
 
@@ -53,8 +57,8 @@ void AutoExposure::CreateResources(RenderDevice& renderDevice, BindlessHeaps& bi
 
     if (m_Resources.histogramBuffer)
     {
-        bindlessHeaps.FreeCbvSrvUav(m_Resources.histogramBuffer->srvIndex);
-        bindlessHeaps.FreeCbvSrvUav(m_Resources.histogramBuffer->uavIndex);
+        bindlessHeaps.FreeCbvSrvUav(m_Resources.histogramBuffer->srvIndex, m_Resources.histogramBuffer->srvGeneration);
+        bindlessHeaps.FreeCbvSrvUav(m_Resources.histogramBuffer->uavIndex, m_Resources.histogramBuffer->uavGeneration);
         m_Resources.histogramBuffer->srvIndex = UINT32_MAX;
         m_Resources.histogramBuffer->uavIndex = UINT32_MAX;
     }
@@ -94,21 +98,33 @@ void AutoExposure::InvalidateDescriptorIndices()
     m_Resources.finalExposureTexture.uavIndex = UINT32_MAX;
 }
 
-void AutoExposure::CreatePipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines)
+void AutoExposure::QueueShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
 {
-    Shader::ReloadOrCreate(m_Resources.clearUintShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/clear_uint.cs.hlsl", globalDefines);
-    PipelineHelpers::CreateComputePipeline(device, m_Resources.clearUintShader, m_Resources.clearUintRootSig, m_Resources.clearUintPso);
+    shaderQueue.Add(m_Resources.clearUintShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/clear_uint.cs.hlsl", globalDefines);
+    shaderQueue.Add(m_Resources.histogramShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/histogram.cs.hlsl", globalDefines);
+    shaderQueue.Add(m_Resources.exposureShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/exposure.cs.hlsl", globalDefines);
+    shaderQueue.Add(m_Resources.adaptExposureShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/adapt_exposure.cs.hlsl", globalDefines);
+}
 
-    Shader::ReloadOrCreate(m_Resources.histogramShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/histogram.cs.hlsl", globalDefines);
-    PipelineHelpers::CreateComputePipeline(device, m_Resources.histogramShader, m_Resources.histogramRootSig, m_Resources.histogramPso);
+void AutoExposure::CreatePipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_Resources.clearUintShader, &m_Resources.histogramShader, &m_Resources.exposureShader, &m_Resources.adaptExposureShader}))
+    {
+        return;
+    }
 
-    Shader::ReloadOrCreate(m_Resources.exposureShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/exposure.cs.hlsl", globalDefines);
+    PipelineHelpers::CreateComputePipeline(device, m_Resources.clearUintShader, m_Resources.clearUintRootSig, m_Resources.clearUintPso);
+    PipelineHelpers::CreateComputePipeline(device, m_Resources.histogramShader, m_Resources.histogramRootSig, m_Resources.histogramPso);
     PipelineHelpers::CreateComputePipeline(device, m_Resources.exposureShader, m_Resources.exposureRootSig, m_Resources.exposurePso);
-
-    Shader::ReloadOrCreate(m_Resources.adaptExposureShader, IE_SHADER_TYPE_COMPUTE, "systems/exposure/adapt_exposure.cs.hlsl", globalDefines);
     PipelineHelpers::CreateComputePipeline(device, m_Resources.adaptExposureShader, m_Resources.adaptExposureRootSig, m_Resources.adaptExposurePso);
 }
 
+void AutoExposure::CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const
+{
+    outObjects.insert(outObjects.end(), {m_Resources.clearUintRootSig, m_Resources.clearUintPso, m_Resources.histogramRootSig, m_Resources.histogramPso, m_Resources.exposureRootSig,
+                                         m_Resources.exposurePso, m_Resources.adaptExposureRootSig, m_Resources.adaptExposurePso});
+}
+
 void AutoExposure::Pass(const ComPtr<ID3D12GraphicsCommandList7>& cmd, GpuTimers& gpuTimers, const BindlessHeaps& bindlessHeaps, GpuResource& hdrTexture, u32 hdrSrvIndex, u32 depthSrvIndex,
                         const XMUINT2& renderSize, f32 frameTimeMs)
 {
@@ -21,7 +21,9 @@ class AutoExposure
 {
   public:
     void CreateResources(RenderDevice& renderDevice, BindlessHeaps& bindlessHeaps);
-    void CreatePipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines);
+    void QueueShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void CreatePipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue);
+    void CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const;
     void InvalidateDescriptorIndices();
 
     void Pass(const ComPtr<ID3D12GraphicsCommandList7>& cmd, GpuTimers& gpuTimers, const BindlessHeaps& bindlessHeaps, GpuResource& hdrTexture, u32 hdrSrvIndex, u32 depthSrvIndex,
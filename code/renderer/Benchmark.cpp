@@ -0,0 +1,151 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "Benchmark.h"
+
+#include <cmath>
+
+#include "Constants.h"
+
+bool Benchmark::Start(const BenchmarkDesc& desc)
+{
+    m_Desc = desc;
+    m_Phase = Phase::Finished;
+
+    String error;
+    if (!CameraPath_Load(desc.cameraPath, m_Path, error))
+    {
+        IE_LogError("Benchmark camera path '{}' is unusable: {}.", desc.cameraPath.generic_string(), error);
+        return false;
+    }
+
+    // Playing the whole path covers both of its end keys.
+    u32 frameCount = desc.frameCount;
+    if (frameCount == 0)
+    {
+        frameCount = static_cast<u32>(std::ceil(CameraPath_GetDuration(m_Path) / kFixedStepSeconds)) + 1;
+    }
+
+    BenchmarkReport_Reset(m_Report, frameCount);
+    m_Report.scene = desc.scene;
+    m_Report.cameraPath = desc.cameraPath.generic_string();
+    m_Report.fixedStepMs = static_cast<f64>(kFixedStepSeconds) * 1000.0;
+    m_Report.warmupFrames = desc.warmupFrames;
+
+    m_Phase = Phase::Loading;
+    m_PhaseFrame = 0;
+    IE_LogInfo("Benchmark: {} warmup and {} measured frames of '{}' in '{}'.", desc.warmupFrames, frameCount, m_Report.cameraPath, desc.scene);
+    return true;
+}
+
+bool Benchmark::IsActive() const
+{
+    return m_Phase != Phase::Idle && m_Phase != Phase::Finished;
+}
+
+bool Benchmark::IsFinished() const
+{
+    return m_Phase == Phase::Finished;
+}
+
+CameraPathPose Benchmark::GetCameraPose() const
+{
+    const f32 start = m_Path.keys.empty() ? 0.0f : m_Path.keys.front().time;
+    switch (m_Phase)
+    {
+    case Phase::Measure:
+        return CameraPath_Evaluate(m_Path, start + static_cast<f32>(m_PhaseFrame) * kFixedStepSeconds);
+    case Phase::Drain:
+    case Phase::Finished:
+        return CameraPath_Evaluate(m_Path, start + static_cast<f32>(m_Report.frameCount - 1) * kFixedStepSeconds);
+    default:
+        return CameraPath_Evaluate(m_Path, start);
+    }
+}
+
+void Benchmark::RecordGpuFrame(const u64 frameSerial, const TimingState& gpu)
+{
+    if ((m_Phase != Phase::Measure && m_Phase != Phase::Drain) || frameSerial < m_FirstMeasuredSerial)
+    {
+        return;
+    }
+
+    const u64 frame = frameSerial - m_FirstMeasuredSerial;
+    if (frame >= m_Report.frameCount)
+    {
+        return;
+    }
+    for (u32 i = 0; i < gpu.lastCount; ++i)
+    {
+        BenchmarkReport_SetSample(m_Report, "gpu", gpu.last[i].name, static_cast<u32>(frame), gpu.last[i].ms);
+    }
+}
+
+void Benchmark::EndFrame(const u64 frameSerial, const bool sceneReady, const f64 cpuFrameMs, const TimingState& cpu)
+{
+    switch (m_Phase)
+    {
+    case Phase::Loading:
+        // The scene load resets the renderer's frame index, so the jitter sequence restarts from the first frame counted here.
+        if (sceneReady)
+        {
+            m_Phase = m_Desc.warmupFrames > 0 ? Phase::Warmup : Phase::Measure;
+            m_PhaseFrame = 0;
+            m_FirstMeasuredSerial = frameSerial + 1;
+        }
+        break;
+
+    case Phase::Warmup:
+        if (++m_PhaseFrame >= m_Desc.warmupFrames)
+        {
+            m_Phase = Phase::Measure;
+            m_PhaseFrame = 0;
+            m_FirstMeasuredSerial = frameSerial + 1;
+        }
+        break;
+
+    case Phase::Measure:
+        BenchmarkReport_SetSample(m_Report, "frame", "Frame", m_PhaseFrame, cpuFrameMs);
+        for (u32 i = 0; i < cpu.lastCount; ++i)
+        {
+            BenchmarkReport_SetSample(m_Report, "cpu", cpu.last[i].name, m_PhaseFrame, cpu.last[i].ms);
+        }
+        if (++m_PhaseFrame >= m_Report.frameCount)
+        {
+            m_Phase = Phase::Drain;
+            m_PhaseFrame = 0;
+        }
+        break;
+
+    case Phase::Drain:
+        // Keep rendering until the GPU timers of the last measured frame have been read back.
+        if (++m_PhaseFrame > IE_Constants::frameInFlightCount)
+        {
+            m_Phase = Phase::Finished;
+            WriteReport();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Benchmark::WriteReport() const
+{
+    std::filesystem::path csvPath = m_Desc.outputStem;
+    csvPath += ".csv";
+    std::filesystem::path jsonPath = m_Desc.outputStem;
+    jsonPath += ".json";
+
+    if (BenchmarkReport_WriteCsv(m_Report, csvPath) && BenchmarkReport_WriteJson(m_Report, jsonPath))
+    {
+        IE_LogInfo("Benchmark results written to {} and {}.", csvPath.generic_string(), jsonPath.generic_string());
+    }
+    else
+    {
+        IE_LogError("Benchmark results could not be written to {}.", m_Desc.outputStem.generic_string());
+    }
+}
@@ -0,0 +1,64 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <filesystem>
+
+#include "Timings.h"
+#include "common/BenchmarkReport.h"
+#include "common/CameraPath.h"
+#include "common/Types.h"
+
+struct BenchmarkDesc
+{
+    String scene;
+    std::filesystem::path cameraPath;
+    u32 warmupFrames = 0;
+    u32 frameCount = 0;                 // 0 plays the whole camera path once
+    std::filesystem::path outputStem{}; // .csv and .json are appended
+};
+
+// Deterministic benchmark run: once the scene is loaded, the camera holds the path's first pose for the warmup frames, then
+// plays the path back with a fixed timestep for the measured frames. Per-frame CPU and GPU pass timings are written as CSV and
+// JSON when the last measured frame's GPU results are in.
+class Benchmark
+{
+  public:
+    static constexpr f32 kFixedStepSeconds = 1.0f / 60.0f;
+
+    // Returns false and leaves the benchmark finished when the camera path cannot be used.
+    bool Start(const BenchmarkDesc& desc);
+
+    bool IsActive() const;
+    bool IsFinished() const;
+
+    CameraPathPose GetCameraPose() const;
+
+    // GPU results arrive frameInFlightCount frames late; frameSerial is the frame the timers were recorded in.
+    void RecordGpuFrame(u64 frameSerial, const TimingState& gpu);
+    // Ends the frame with the given serial and advances the run.
+    void EndFrame(u64 frameSerial, bool sceneReady, f64 cpuFrameMs, const TimingState& cpu);
+
+  private:
+    enum class Phase : u8
+    {
+        Idle,
+        Loading,
+        Warmup,
+        Measure,
+        Drain,
+        Finished,
+    };
+
+    void WriteReport() const;
+
+    BenchmarkDesc m_Desc{};
+    CameraPath m_Path{};
+    BenchmarkReport m_Report{};
+    Phase m_Phase = Phase::Idle;
+    u32 m_PhaseFrame = 0;
+    u64 m_FirstMeasuredSerial = 0;
+};
@@ -5,31 +5,7 @@
 
 #include "BindlessHeaps.h"
 
-namespace
-{
-u32 AllocateDescriptorIndex(Array<u32, BindlessHeapType_Count>& nextIndex, Array<Vector<u32>, BindlessHeapType_Count>& freeIndices, const BindlessHeapType heapType, const u32 capacity)
-{
-    if (!freeIndices[heapType].empty())
-    {
-        const u32 index = freeIndices[heapType].back();
-        freeIndices[heapType].pop_back();
-        return index;
-    }
-
-    IE_Assert(nextIndex[heapType] < capacity);
-    return nextIndex[heapType]++;
-}
-
-void FreeDescriptorIndex(Array<Vector<u32>, BindlessHeapType_Count>& freeIndices, const BindlessHeapType heapType, const u32 index)
-{
-    if (index == UINT32_MAX)
-    {
-        return;
-    }
-
-    freeIndices[heapType].push_back(index);
-}
-} // namespace
+#include <algorithm>
 
 void BindlessHeaps::Init(const ComPtr<ID3D12Device14>& device)
 {
@@ -57,47 +33,135 @@ void BindlessHeaps::Init(const ComPtr<ID3D12Device14>& device)
         .Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
     };
     createHeap(BindlessHeapType_Sampler, samplerDescriptorHeapDesc, L"Sampler Heap");
+
+    m_Generations.assign(m_Capacity[BindlessHeapType_CbvSrvUav], 0);
+    m_NextGeneration = 1;
+    IE_Check(m_Device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
+    m_NextFenceValue = 1;
 }
 
 u32 BindlessHeaps::CreateSRV(const ComPtr<ID3D12Resource>& resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc)
 {
-    D3D12_CPU_DESCRIPTOR_HANDLE handle = m_Heaps[BindlessHeapType_CbvSrvUav]->GetCPUDescriptorHandleForHeapStart();
-    const u32 index = AllocateDescriptorIndex(m_NextIndex, m_FreeIndices, BindlessHeapType_CbvSrvUav, m_Capacity[BindlessHeapType_CbvSrvUav]);
-    handle.ptr += static_cast<size_t>(index) * m_HandleSize[BindlessHeapType_CbvSrvUav];
-    m_Device->CreateShaderResourceView(resource.Get(), &srvDesc, handle);
+    const u32 index = AllocateCbvSrvUavRange(1);
+    WriteSRV(index, m_Generations[index], resource, srvDesc);
     return index;
 }
 
 u32 BindlessHeaps::CreateUAV(const ComPtr<ID3D12Resource>& resource, const D3D12_UNORDERED_ACCESS_VIEW_DESC& uavDesc)
 {
-    D3D12_CPU_DESCRIPTOR_HANDLE handle = m_Heaps[BindlessHeapType_CbvSrvUav]->GetCPUDescriptorHandleForHeapStart();
-    const u32 index = AllocateDescriptorIndex(m_NextIndex, m_FreeIndices, BindlessHeapType_CbvSrvUav, m_Capacity[BindlessHeapType_CbvSrvUav]);
-    handle.ptr += static_cast<size_t>(index) * m_HandleSize[BindlessHeapType_CbvSrvUav];
-    m_Device->CreateUnorderedAccessView(resource.Get(), nullptr, &uavDesc, handle);
+    const u32 index = AllocateCbvSrvUavRange(1);
+    m_Device->CreateUnorderedAccessView(resource.Get(), nullptr, &uavDesc, GetCpuHandle(BindlessHeapType_CbvSrvUav, index));
     return index;
 }
 
 u32 BindlessHeaps::CreateSampler(const D3D12_SAMPLER_DESC& samplerDesc)
 {
-    D3D12_CPU_DESCRIPTOR_HANDLE handle = m_Heaps[BindlessHeapType_Sampler]->GetCPUDescriptorHandleForHeapStart();
-    const u32 index = AllocateDescriptorIndex(m_NextIndex, m_FreeIndices, BindlessHeapType_Sampler, m_Capacity[BindlessHeapType_Sampler]);
-    handle.ptr += static_cast<size_t>(index) * m_HandleSize[BindlessHeapType_Sampler];
-    m_Device->CreateSampler(&samplerDesc, handle);
+    IE_Assert(m_NextIndex[BindlessHeapType_Sampler] < m_Capacity[BindlessHeapType_Sampler]);
+    const u32 index = m_NextIndex[BindlessHeapType_Sampler]++;
+    m_Device->CreateSampler(&samplerDesc, GetCpuHandle(BindlessHeapType_Sampler, index));
     return index;
 }
 
-void BindlessHeaps::FreeCbvSrvUav(const u32 index)
+void BindlessHeaps::FreeCbvSrvUav(const u32 index, const u32 generation)
+{
+    FreeCbvSrvUavRange(index, 1, generation);
+}
+
+u32 BindlessHeaps::AllocateCbvSrvUavRange(const u32 count)
+{
+    IE_Assert(count > 0);
+    Reclaim();
+
+    // Best fit, so single slots come out of the gaps singles left behind instead of splitting the ranges tables need.
+    u32 best = UINT32_MAX;
+    for (u32 i = 0; i < m_FreeRanges.size(); ++i)
+    {
+        const u32 rangeCount = m_FreeRanges[i].count;
+        if (rangeCount >= count && (best == UINT32_MAX || rangeCount < m_FreeRanges[best].count))
+        {
+            best = i;
+            if (rangeCount == count)
+            {
+                break;
+            }
+        }
+    }
+
+    u32 first = UINT32_MAX;
+    if (best != UINT32_MAX)
+    {
+        Range& range = m_FreeRanges[best];
+        first = range.first;
+        range.first += count;
+        range.count -= count;
+        if (range.count == 0)
+        {
+            m_FreeRanges.erase(m_FreeRanges.begin() + best);
+        }
+    }
+    else
+    {
+        IE_Assert(count <= m_Capacity[BindlessHeapType_CbvSrvUav] - m_NextIndex[BindlessHeapType_CbvSrvUav]);
+        first = m_NextIndex[BindlessHeapType_CbvSrvUav];
+        m_NextIndex[BindlessHeapType_CbvSrvUav] += count;
+    }
+
+    MarkLive(first, count);
+    return first;
+}
+
+void BindlessHeaps::WriteSRV(const u32 index, const u32 generation, const ComPtr<ID3D12Resource>& resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc)
 {
-    FreeDescriptorIndex(m_FreeIndices, BindlessHeapType_CbvSrvUav, index);
+    IE_Assert(IsLive(index, generation));
+    m_Device->CreateShaderResourceView(resource.Get(), &srvDesc, GetCpuHandle(BindlessHeapType_CbvSrvUav, index));
+}
+
+void BindlessHeaps::FreeCbvSrvUavRange(const u32 first, const u32 count, const u32 generation)
+{
+    if (first == UINT32_MAX || count == 0)
+    {
+        return;
+    }
+
+    MarkFree(first, count, generation);
+    m_PendingRanges.push_back({first, count});
+}
+
+void BindlessHeaps::Submit(ID3D12CommandQueue* queue)
+{
+    if (m_PendingRanges.empty())
+    {
+        return;
+    }
+
+    RetiredBatch& batch = m_RetiredBatches.emplace_back();
+    batch.fenceValue = m_NextFenceValue++;
+    batch.ranges.swap(m_PendingRanges);
+    IE_Check(queue->Signal(m_Fence.Get(), batch.fenceValue));
 }
 
 void BindlessHeaps::ResetAll()
 {
-    m_NextIndex.fill(0);
-    for (Vector<u32>& freeIndices : m_FreeIndices)
+    for (u32& generation : m_Generations)
     {
-        freeIndices.clear();
+        generation += generation & 1u;
     }
+
+    m_NextIndex.fill(0);
+    m_FreeRanges.clear();
+    m_PendingRanges.clear();
+    m_RetiredBatches.clear();
+}
+
+u32 BindlessHeaps::GetGeneration(const u32 index) const
+{
+    IE_Assert(index < m_Generations.size() && (m_Generations[index] & 1u) != 0);
+    return m_Generations[index];
+}
+
+bool BindlessHeaps::IsLive(const u32 index, const u32 generation) const
+{
+    return index < m_Generations.size() && m_Generations[index] == generation && (generation & 1u) != 0;
 }
 
 const Array<ID3D12DescriptorHeap*, BindlessHeapType_Count>& BindlessHeaps::GetDescriptorHeaps() const
@@ -105,3 +169,80 @@ const Array<ID3D12DescriptorHeap*, BindlessHeapType_Count>& BindlessHeaps::GetDe
     return m_DescriptorHeaps;
 }
 
+void BindlessHeaps::MarkLive(const u32 first, const u32 count)
+{
+    // Odd and never reused (short of 2^31 allocations), so no earlier generation of any slot can match it.
+    const u32 generation = m_NextGeneration;
+    m_NextGeneration += 2;
+    for (u32 index = first; index < first + count; ++index)
+    {
+        IE_Assert((m_Generations[index] & 1u) == 0);
+        m_Generations[index] = generation;
+    }
+}
+
+void BindlessHeaps::MarkFree(const u32 first, const u32 count, const u32 generation)
+{
+    IE_Assert(first < m_Generations.size() && count <= m_Generations.size() - first);
+    for (u32 index = first; index < first + count; ++index)
+    {
+        // A mismatch is a double free, an index whose slot was reallocated, or a stale index kept across a ResetAll.
+        IE_Assert(IsLive(index, generation));
+        m_Generations[index]++;
+    }
+}
+
+void BindlessHeaps::Reclaim()
+{
+    if (m_RetiredBatches.empty())
+    {
+        return;
+    }
+
+    const size_t sortedCount = m_FreeRanges.size();
+    const u64 completed = m_Fence->GetCompletedValue();
+    while (!m_RetiredBatches.empty() && m_RetiredBatches.front().fenceValue <= completed)
+    {
+        RetiredBatch& batch = m_RetiredBatches.front();
+        m_FreeRanges.insert(m_FreeRanges.end(), batch.ranges.begin(), batch.ranges.end());
+        m_RetiredBatches.pop_front();
+    }
+    if (m_FreeRanges.size() == sortedCount)
+    {
+        return;
+    }
+
+    const auto byFirst = [](const Range& a, const Range& b) { return a.first < b.first; };
+    std::sort(m_FreeRanges.begin() + sortedCount, m_FreeRanges.end(), byFirst);
+    std::inplace_merge(m_FreeRanges.begin(), m_FreeRanges.begin() + sortedCount, m_FreeRanges.end(), byFirst);
+
+    size_t last = 0;
+    for (size_t i = 1; i < m_FreeRanges.size(); ++i)
+    {
+        Range& merged = m_FreeRanges[last];
+        if (merged.first + merged.count == m_FreeRanges[i].first)
+        {
+            merged.count += m_FreeRanges[i].count;
+        }
+        else
+        {
+            m_FreeRanges[++last] = m_FreeRanges[i];
+        }
+    }
+    m_FreeRanges.resize(last + 1);
+
+    // A free range that ends at the top of the used slots goes back to the bump allocator.
+    const Range& top = m_FreeRanges.back();
+    if (top.first + top.count == m_NextIndex[BindlessHeapType_CbvSrvUav])
+    {
+        m_NextIndex[BindlessHeapType_CbvSrvUav] = top.first;
+        m_FreeRanges.pop_back();
+    }
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE BindlessHeaps::GetCpuHandle(const BindlessHeapType heapType, const u32 index) const
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE handle = m_Heaps[heapType]->GetCPUDescriptorHandleForHeapStart();
+    handle.ptr += static_cast<size_t>(index) * m_HandleSize[heapType];
+    return handle;
+}
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <deque>
+
 enum BindlessHeapType : u32
 {
     BindlessHeapType_CbvSrvUav = 0,
@@ -12,6 +14,11 @@ enum BindlessHeapType : u32
     BindlessHeapType_Count,
 };
 
+// Shader-visible heaps indexed directly from shaders. A freed CBV/SRV/UAV slot is retired with the next submission and only
+// handed out again once the GPU has passed it, so a frame in flight never reads a descriptor that was rewritten under it.
+// Reclaimed slots are merged with their free neighbours, so single slots and ranges are served from the same free list.
+// Every allocation stamps its slots with a generation no earlier allocation used. Holders keep it next to the index and pass
+// it back to free or rewrite the slot, so an index that outlived its slot, including one kept across ResetAll, asserts.
 class BindlessHeaps
 {
   public:
@@ -20,19 +27,59 @@ class BindlessHeaps
     u32 CreateSRV(const ComPtr<ID3D12Resource>& resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc);
     u32 CreateUAV(const ComPtr<ID3D12Resource>& resource, const D3D12_UNORDERED_ACCESS_VIEW_DESC& uavDesc);
     u32 CreateSampler(const D3D12_SAMPLER_DESC& samplerDesc);
-    void FreeCbvSrvUav(u32 index);
+    void FreeCbvSrvUav(u32 index, u32 generation);
+
+    // Contiguous slots, e.g. for a table indexed as first + i. A range shares one generation, is written slot by slot and is
+    // freed as a whole.
+    u32 AllocateCbvSrvUavRange(u32 count);
+    void WriteSRV(u32 index, u32 generation, const ComPtr<ID3D12Resource>& resource, const D3D12_SHADER_RESOURCE_VIEW_DESC& srvDesc);
+    void FreeCbvSrvUavRange(u32 first, u32 count, u32 generation);
+
+    // The generation of the allocation that holds the slot; read it right after creating a view or allocating a range.
+    u32 GetGeneration(u32 index) const;
+    // False once the allocation the generation came from was freed or reset.
+    bool IsLive(u32 index, u32 generation) const;
+
+    // Closes the batch of frees made since the last call. Call right after ExecuteCommandLists on the queue that reads the heaps.
+    void Submit(ID3D12CommandQueue* queue);
+    // Frees every slot at once, retired or not; the GPU must be idle.
     void ResetAll();
 
     const Array<ID3D12DescriptorHeap*, BindlessHeapType_Count>& GetDescriptorHeaps() const;
 
   private:
+    struct Range
+    {
+        u32 first = 0;
+        u32 count = 0;
+    };
+
+    struct RetiredBatch
+    {
+        u64 fenceValue = 0;
+        Vector<Range> ranges;
+    };
+
+    void MarkLive(u32 first, u32 count);
+    void MarkFree(u32 first, u32 count, u32 generation);
+    void Reclaim();
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(BindlessHeapType heapType, u32 index) const;
+
     ComPtr<ID3D12Device14> m_Device;
 
     Array<u32, BindlessHeapType_Count> m_NextIndex{};
     Array<u32, BindlessHeapType_Count> m_Capacity{};
     Array<u32, BindlessHeapType_Count> m_HandleSize{};
-    Array<Vector<u32>, BindlessHeapType_Count> m_FreeIndices{};
     Array<ComPtr<ID3D12DescriptorHeap>, BindlessHeapType_Count> m_Heaps{};
     Array<ID3D12DescriptorHeap*, BindlessHeapType_Count> m_DescriptorHeaps{};
-};
 
+    // CBV/SRV/UAV slot bookkeeping; an odd generation means the slot is allocated. m_FreeRanges is sorted by first slot and
+    // never holds two adjacent ranges.
+    Vector<u32> m_Generations;
+    u32 m_NextGeneration = 1;
+    Vector<Range> m_FreeRanges;
+    Vector<Range> m_PendingRanges;
+    std::deque<RetiredBatch> m_RetiredBatches;
+    ComPtr<ID3D12Fence> m_Fence;
+    u64 m_NextFenceValue = 1;
+};
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include "GpuMemory.h"
 #include "GpuResource.h"
 
 struct Buffer : public GpuResource
@@ -12,6 +13,8 @@ struct Buffer : public GpuResource
     ComPtr<D3D12MA::Allocation> allocation;
     u32 srvIndex = UINT32_MAX;
     u32 uavIndex = UINT32_MAX;
+    u32 srvGeneration = 0; // BindlessHeaps generations of the views, passed back when they are freed
+    u32 uavGeneration = 0;
     u32 numElements = 0;
 };
 
@@ -28,6 +31,8 @@ struct BufferCreateDesc
     u32 sizeInBytes = 0;
     D3D12_HEAP_TYPE heapType = D3D12_HEAP_TYPE_DEFAULT;
     D3D12_RESOURCE_FLAGS resourceFlags = D3D12_RESOURCE_FLAG_NONE;
+    // Other is reported as Upload or Readback for those heaps.
+    GpuMemoryCategory memoryCategory = GpuMemoryCategory_Other;
 
     // Views
     ViewKind viewKind = ViewKind::None;
@@ -186,6 +186,14 @@ void Camera::Update(f32 elapsedSeconds)
     m_MouseOffset = {0.f, 0.f};
 }
 
+void Camera::SetPose(const XMFLOAT3& position, const f32 yaw, const f32 pitch)
+{
+    m_Position = position;
+    m_Yaw = yaw;
+    m_Pitch = IE_Clamp(pitch, -89.9f, 89.9f);
+    m_Front = ComputeFrontFromYawPitch(m_Yaw, m_Pitch);
+}
+
 void Camera::BuildFrameData()
 {
     XMVECTOR pos = XMLoadFloat3(&m_Position);
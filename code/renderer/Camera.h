@@ -44,6 +44,8 @@ class Camera
     void ResetHistory();
 
     void Update(f32 elapsedSeconds);
+    // Places the camera directly, bypassing input; angles are degrees.
+    void SetPose(const XMFLOAT3& position, f32 yaw, f32 pitch);
     void BuildFrameData();
 
     const FrameData& GetFrameData() const;
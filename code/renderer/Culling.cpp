@@ -8,8 +8,105 @@
 #include "RuntimeState.h"
 #include "Timings.h"
 
+#include <bit>
+#include <cstring>
+
 namespace
 {
+// Draw sort key layout (64 bits):
+//  FrontToBack: [63..44] view depth | [43..20] primitive index | [19..0] material index
+//  ByPrimitive: [63..40] primitive index | [39..20] material index | [19..0] view depth
+constexpr u32 kSortDepthBits = 20u;
+constexpr u32 kSortPrimBits = 24u;
+constexpr u32 kSortMaterialBits = 20u;
+static_assert(kSortDepthBits + kSortPrimBits + kSortMaterialBits == 64u);
+
+constexpr u64 kSortDepthMask = (1ull << kSortDepthBits) - 1ull;
+constexpr u64 kSortPrimMask = (1ull << kSortPrimBits) - 1ull;
+constexpr u64 kSortMaterialMask = (1ull << kSortMaterialBits) - 1ull;
+
+u64 QuantizeViewDepth(const f32 viewZ)
+{
+    // RH view space: visible geometry has negative z. Non-negative floats order like their bit patterns,
+    // so dropping the low mantissa bits gives a monotonic, roughly logarithmic depth quantization.
+    const f32 depth = IE_Max(-viewZ, 0.0f);
+    return (static_cast<u64>(std::bit_cast<u32>(depth)) >> (31u - kSortDepthBits)) & kSortDepthMask;
+}
+
+u64 BuildDrawSortKey(const DrawSortMode mode, const f32 viewZ, const u32 primIndex, const u32 materialIndex)
+{
+    const u64 depth = QuantizeViewDepth(viewZ);
+    const u64 prim = static_cast<u64>(primIndex) & kSortPrimMask;
+    const u64 material = static_cast<u64>(materialIndex) & kSortMaterialMask;
+
+    switch (mode)
+    {
+    case DrawSortMode_FrontToBack:
+        return (depth << (kSortPrimBits + kSortMaterialBits)) | (prim << kSortMaterialBits) | material;
+    case DrawSortMode_ByPrimitive:
+        return (prim << (kSortMaterialBits + kSortDepthBits)) | (material << kSortDepthBits) | depth;
+    default:
+        return 0ull;
+    }
+}
+
+// LSD radix sort on 8-bit digits. All digit histograms are built in a single pass and
+// passes where every key shares the same digit are skipped, so narrow key ranges stay cheap.
+void RadixSortDrawEntries(Vector<DrawSortEntry>& entries, Vector<DrawSortEntry>& scratch)
+{
+    constexpr u32 kDigitBits = 8u;
+    constexpr u32 kDigitCount = 1u << kDigitBits;
+    constexpr u32 kPassCount = 64u / kDigitBits;
+
+    const u32 count = static_cast<u32>(entries.size());
+    if (count < 2u)
+    {
+        return;
+    }
+
+    Array<Array<u32, kDigitCount>, kPassCount> histograms{};
+    for (const DrawSortEntry& entry : entries)
+    {
+        for (u32 pass = 0; pass < kPassCount; ++pass)
+        {
+            ++histograms[pass][(entry.key >> (pass * kDigitBits)) & (kDigitCount - 1u)];
+        }
+    }
+
+    scratch.resize(count);
+    DrawSortEntry* src = entries.data();
+    DrawSortEntry* dst = scratch.data();
+    for (u32 pass = 0; pass < kPassCount; ++pass)
+    {
+        Array<u32, kDigitCount>& histogram = histograms[pass];
+        const u32 firstDigit = static_cast<u32>((src[0].key >> (pass * kDigitBits)) & (kDigitCount - 1u));
+        if (histogram[firstDigit] == count)
+        {
+            continue;
+        }
+
+        u32 offset = 0;
+        for (u32 digit = 0; digit < kDigitCount; ++digit)
+        {
+            const u32 digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for (u32 i = 0; i < count; ++i)
+        {
+            const u32 digit = static_cast<u32>((src[i].key >> (pass * kDigitBits)) & (kDigitCount - 1u));
+            dst[histogram[digit]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != entries.data())
+    {
+        entries.swap(scratch);
+    }
+}
+
 f32 ComputeMaxWorldScale(const XMFLOAT4X4& world)
 {
     const f32 rowX = IE_Sqrt(world._11 * world._11 + world._12 * world._12 + world._13 * world._13);
@@ -68,13 +165,8 @@ bool IsSphereVisibleViewFrustum(const XMFLOAT3& viewCenter, const f32 radius, co
     return true;
 }
 
-bool IsPrimitiveInFrustum(const Primitive& prim, const XMFLOAT4X4& world, const f32 maxWorldScale, const XMFLOAT4X4& view, const f32 nearPlane, const f32 tanHalfX, const f32 tanHalfY)
+XMFLOAT3 ComputeViewBoundsCenter(const Primitive& prim, const XMFLOAT4X4& world, const XMFLOAT4X4& view)
 {
-    if (prim.localBoundsRadius <= 0.0f)
-    {
-        return true;
-    }
-
     XMFLOAT3 worldCenterRow{};
     {
         const XMMATRIX worldM = XMLoadFloat4x4(&world);
@@ -82,19 +174,54 @@ bool IsPrimitiveInFrustum(const Primitive& prim, const XMFLOAT4X4& world, const
         XMStoreFloat3(&worldCenterRow, XMVector3TransformCoord(localCenter, worldM));
     }
 
+    XMFLOAT3 viewCenter{};
+    {
+        const XMMATRIX viewM = XMLoadFloat4x4(&view);
+        const XMVECTOR worldCenter = XMLoadFloat3(&worldCenterRow);
+        XMStoreFloat3(&viewCenter, XMVector3TransformCoord(worldCenter, viewM));
+    }
+    return viewCenter;
+}
+
+bool IsPrimitiveInFrustum(const Primitive& prim, const XMFLOAT3& viewCenter, const f32 maxWorldScale, const f32 nearPlane, const f32 tanHalfX, const f32 tanHalfY)
+{
+    if (prim.localBoundsRadius <= 0.0f)
+    {
+        return true;
+    }
+
     const f32 worldRadius = prim.localBoundsRadius * maxWorldScale;
     if (worldRadius <= 0.0f)
     {
         return true;
     }
 
-    XMFLOAT3 viewCenter{};
+    return IsSphereVisibleViewFrustum(viewCenter, worldRadius, nearPlane, tanHalfX, tanHalfY);
+}
+
+// Oriented box vs the same near + side planes as the sphere test, in view space. A plane rejects the box when the
+// center distance exceeds the box's projected extent sum(|n . halfAxis_i|). The four side planes are evaluated
+// together, one plane per SIMD lane.
+bool IsPrimitiveBoxInFrustum(const Primitive& prim, const XMFLOAT4X4& world, const XMFLOAT4X4& view, const f32 nearPlane, const f32 tanHalfX, const f32 tanHalfY)
+{
+    // Rows 0..2: box half-axes in view space, row 3: box center in view space.
+    const XMMATRIX boxToView = XMMatrixMultiply(XMMatrixMultiply(XMLoadFloat4x4(&prim.localBoxToObject), XMLoadFloat4x4(&world)), XMLoadFloat4x4(&view));
+
+    const XMVECTOR absAxesSum = XMVectorAdd(XMVectorAbs(boxToView.r[0]), XMVectorAdd(XMVectorAbs(boxToView.r[1]), XMVectorAbs(boxToView.r[2])));
+    if (XMVectorGetZ(boxToView.r[3]) + nearPlane > XMVectorGetZ(absAxesSum))
     {
-        const XMMATRIX viewM = XMLoadFloat4x4(&view);
-        const XMVECTOR worldCenter = XMLoadFloat3(&worldCenterRow);
-        XMStoreFloat3(&viewCenter, XMVector3TransformCoord(worldCenter, viewM));
+        return false;
     }
-    return IsSphereVisibleViewFrustum(viewCenter, worldRadius, nearPlane, tanHalfX, tanHalfY);
+
+    // Unnormalized side plane normals (right, left, top, bottom), matching IsSphereVisibleViewFrustum.
+    const XMVECTOR planeX = XMVectorSet(1.0f, -1.0f, 0.0f, 0.0f);
+    const XMVECTOR planeY = XMVectorSet(0.0f, 0.0f, 1.0f, -1.0f);
+    const XMVECTOR planeZ = XMVectorSet(tanHalfX, tanHalfX, tanHalfY, tanHalfY);
+    const auto dotPlanes = [&](const XMVECTOR v) { return XMVectorMultiplyAdd(planeZ, XMVectorSplatZ(v), XMVectorMultiplyAdd(planeY, XMVectorSplatY(v), XMVectorMultiply(planeX, XMVectorSplatX(v)))); };
+
+    const XMVECTOR centerDist = dotPlanes(boxToView.r[3]);
+    const XMVECTOR projectedExtent = XMVectorAdd(XMVectorAbs(dotPlanes(boxToView.r[0])), XMVectorAdd(XMVectorAbs(dotPlanes(boxToView.r[1])), XMVectorAbs(dotPlanes(boxToView.r[2]))));
+    return !XMComparisonAnyTrue(XMVector4GreaterR(centerDist, projectedExtent));
 }
 } // namespace
 
@@ -104,16 +231,22 @@ void Culling::Reset()
     {
         for (u32 cm = 0; cm < CullMode_Count; ++cm)
         {
+            m_VisibleBuckets[am][cm].clear();
             m_PrimitiveBuckets[am][cm].clear();
         }
     }
+    m_DrawInstances.clear();
+    m_PrimGroupSlots.clear();
     m_RTInstances.clear();
     m_PrevInstanceWorlds.clear();
     m_RasterSubmittedCount = 0;
     m_RasterCulledCount = 0;
+    m_RasterBoxCulledCount = 0;
     g_Stats.cpuFrustumCullTotalInstances = 0;
     g_Stats.cpuFrustumCullRasterSubmitted = 0;
     g_Stats.cpuFrustumCullRasterCulled = 0;
+    g_Stats.cpuFrustumCullBoxCulled = 0;
+    g_Stats.rasterDrawGroups = 0;
 }
 
 void Culling::Build(const BuildParams& params)
@@ -130,9 +263,16 @@ void Culling::Build(const BuildParams& params)
     {
         for (u32 cm = 0; cm < CullMode_Count; ++cm)
         {
+            m_VisibleBuckets[am][cm].clear();
             m_PrimitiveBuckets[am][cm].clear();
         }
     }
+    m_DrawInstances.clear();
+
+    if (m_PrimGroupSlots.size() != primitives.size())
+    {
+        m_PrimGroupSlots.assign(primitives.size(), UINT32_MAX);
+    }
 
     m_RTInstances.clear();
     if (params.updateInstances)
@@ -152,9 +292,11 @@ void Culling::Build(const BuildParams& params)
 
     m_RasterSubmittedCount = 0;
     m_RasterCulledCount = 0;
+    m_RasterBoxCulledCount = 0;
 
     const f32 tanHalfY = std::tan(IE_ToRadians(params.frustumCullFovDeg) * 0.5f);
     const f32 tanHalfX = tanHalfY * params.aspectRatio;
+    const bool sortDraws = params.drawSortMode != DrawSortMode_None;
 
     IE_Assert(m_PrevInstanceWorlds.size() == instances.size());
     IE_Assert(params.nearPlane > 0.0f);
@@ -176,7 +318,15 @@ void Culling::Build(const BuildParams& params)
 
         const Primitive& prim = primitives[inst.primIndex];
         const f32 maxWorldScale = ComputeMaxWorldScale(inst.world);
-        const bool rasterVisible = !params.cpuFrustumCullingEnabled || IsPrimitiveInFrustum(prim, inst.world, maxWorldScale, view, params.nearPlane, tanHalfX, tanHalfY);
+        const bool needsViewCenter = params.cpuFrustumCullingEnabled || sortDraws;
+        const XMFLOAT3 viewCenter = needsViewCenter ? ComputeViewBoundsCenter(prim, inst.world, view) : XMFLOAT3{0.0f, 0.0f, 0.0f};
+        bool rasterVisible = !params.cpuFrustumCullingEnabled || IsPrimitiveInFrustum(prim, viewCenter, maxWorldScale, params.nearPlane, tanHalfX, tanHalfY);
+        if (rasterVisible && params.cpuFrustumCullingEnabled && prim.localBoundsRadius > 0.0f && !IsPrimitiveBoxInFrustum(prim, inst.world, view, params.nearPlane, tanHalfX, tanHalfY))
+        {
+            // The sphere is loose for long, thin meshes; refine survivors with the tighter box.
+            rasterVisible = false;
+            m_RasterBoxCulledCount++;
+        }
 
         if (rasterVisible)
         {
@@ -185,27 +335,16 @@ void Culling::Build(const BuildParams& params)
             XMFLOAT4X4 worldInv{};
             XMStoreFloat4x4(&worldInv, MworldInv);
 
-            PrimitiveConstants pc{};
-            pc.world = inst.world;
-            pc.prevWorld = prevWorld;
-            pc.worldInv = worldInv;
-            pc.meshletCount = prim.meshletCount;
-            pc.materialIdx = inst.materialIndex;
-            pc.verticesBufferIndex = prim.vertices->srvIndex;
-            pc.meshletsBufferIndex = prim.meshlets->srvIndex;
-            pc.meshletVerticesBufferIndex = prim.mlVerts->srvIndex;
-            pc.meshletTrianglesBufferIndex = prim.mlTris->srvIndex;
-            pc.meshletBoundsBufferIndex = prim.mlBounds->srvIndex;
-            pc.materialsBufferIndex = params.materialsBufferSrvIndex;
-            pc.debugMeshletColorEnabled = params.debugMeshletColorEnabled ? 1u : 0u;
-            pc.maxWorldScale = maxWorldScale;
-            pc.worldSign = ComputeWorldSign(inst.world);
-            pc.allowBackfaceConeCull = mat.doubleSided ? 0u : 1u;
-
-            PrimitiveRenderData prd{};
-            prd.primIndex = inst.primIndex;
-            prd.primConstants = pc;
-            m_PrimitiveBuckets[am][cm].push_back(prd);
+            VisibleInstance visible{};
+            visible.primIndex = inst.primIndex;
+            visible.sortKey = sortDraws ? BuildDrawSortKey(params.drawSortMode, viewCenter.z, inst.primIndex, inst.materialIndex) : 0ull;
+            visible.drawInstance.world = inst.world;
+            visible.drawInstance.prevWorld = prevWorld;
+            visible.drawInstance.worldInv = worldInv;
+            visible.drawInstance.materialIdx = inst.materialIndex;
+            visible.drawInstance.maxWorldScale = maxWorldScale;
+            visible.drawInstance.worldSign = ComputeWorldSign(inst.world);
+            m_VisibleBuckets[am][cm].push_back(visible);
             m_RasterSubmittedCount++;
         }
         else
@@ -213,9 +352,10 @@ void Culling::Build(const BuildParams& params)
             m_RasterCulledCount++;
         }
 
-        if (params.updateInstances)
+        if (params.updateInstances && std::memcmp(&inst.world, &prevWorld, sizeof(XMFLOAT4X4)) != 0)
         {
             Raytracing::RTInstance rti{};
+            rti.instanceIndex = i;
             rti.primIndex = inst.primIndex;
             rti.materialIndex = inst.materialIndex;
             rti.alphaMode = mat.alphaMode;
@@ -229,15 +369,127 @@ void Culling::Build(const BuildParams& params)
     g_Stats.cpuFrustumCullTotalInstances = static_cast<u32>(instances.size());
     g_Stats.cpuFrustumCullRasterSubmitted = m_RasterSubmittedCount;
     g_Stats.cpuFrustumCullRasterCulled = m_RasterCulledCount;
+    g_Stats.cpuFrustumCullBoxCulled = m_RasterBoxCulledCount;
+
+    CPU_MARKER_END(*params.cpuTimers);
 
+    CPU_MARKER_BEGIN(*params.cpuTimers, "Draw List Sort and Instancing");
+    m_DrawInstances.reserve(m_RasterSubmittedCount);
+    for (u32 am = 0; am < AlphaMode_Count; ++am)
+    {
+        for (u32 cm = 0; cm < CullMode_Count; ++cm)
+        {
+            const Vector<VisibleInstance>& bucket = m_VisibleBuckets[am][cm];
+            if (sortDraws)
+            {
+                SortBucket(bucket);
+            }
+            BuildDrawGroups(params, bucket, sortDraws, static_cast<CullMode>(cm), m_PrimitiveBuckets[am][cm]);
+        }
+    }
+    g_Stats.rasterDrawGroups = 0;
+    for (const PrimitiveBucketRow& row : m_PrimitiveBuckets)
+    {
+        for (const Vector<PrimitiveRenderData>& groups : row)
+        {
+            g_Stats.rasterDrawGroups += static_cast<u32>(groups.size());
+        }
+    }
     CPU_MARKER_END(*params.cpuTimers);
 }
 
+void Culling::SortBucket(const Vector<VisibleInstance>& bucket)
+{
+    // Sort compact (key, index) pairs; the large instance records are only moved once, when grouped.
+    const u32 count = static_cast<u32>(bucket.size());
+    m_SortEntries.resize(count);
+    for (u32 i = 0; i < count; ++i)
+    {
+        m_SortEntries[i].key = bucket[i].sortKey;
+        m_SortEntries[i].index = i;
+    }
+    RadixSortDrawEntries(m_SortEntries, m_SortScratch);
+}
+
+void Culling::BuildDrawGroups(const BuildParams& params, const Vector<VisibleInstance>& bucket, const bool sorted, const CullMode cullMode, Vector<PrimitiveRenderData>& outGroups)
+{
+    const u32 count = static_cast<u32>(bucket.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    const Vector<Primitive>& primitives = *params.primitives;
+    auto visibleAt = [&](const u32 i) -> const VisibleInstance& { return bucket[sorted ? m_SortEntries[i].index : i]; };
+
+    // One group per primitive, emitted in order of its first instance so front-to-back order survives at group granularity.
+    for (u32 i = 0; i < count; ++i)
+    {
+        const u32 primIndex = visibleAt(i).primIndex;
+        u32& slot = m_PrimGroupSlots[primIndex];
+        if (slot == UINT32_MAX)
+        {
+            slot = static_cast<u32>(outGroups.size());
+            PrimitiveRenderData& group = outGroups.emplace_back();
+            group.primIndex = primIndex;
+            group.instanceCount = 0;
+        }
+        outGroups[slot].instanceCount++;
+    }
+
+    const u32 groupCount = static_cast<u32>(outGroups.size());
+    m_GroupCursors.resize(groupCount);
+    u32 nextInstance = static_cast<u32>(m_DrawInstances.size());
+    for (u32 g = 0; g < groupCount; ++g)
+    {
+        PrimitiveRenderData& group = outGroups[g];
+        const Primitive& prim = primitives[group.primIndex];
+
+        PrimitiveConstants& pc = group.primConstants;
+        pc = {};
+        pc.meshletCount = prim.meshletCount;
+        pc.verticesBufferIndex = prim.vertices->srvIndex;
+        pc.meshletsBufferIndex = prim.meshlets->srvIndex;
+        pc.meshletVerticesBufferIndex = prim.mlVerts->srvIndex;
+        pc.meshletTrianglesBufferIndex = prim.mlTris->srvIndex;
+        pc.meshletBoundsBufferIndex = prim.mlBounds->srvIndex;
+        pc.materialsBufferIndex = params.materialsBufferSrvIndex;
+        pc.debugMeshletColorEnabled = params.debugMeshletColorEnabled ? 1u : 0u;
+        pc.instancesBufferIndex = UINT32_MAX; // Bound by the renderer once the instance buffer is uploaded.
+        pc.firstInstance = nextInstance;
+        pc.allowBackfaceConeCull = cullMode == CullMode_Back ? 1u : 0u;
+        pc.firstMeshlet = prim.firstMeshlet;
+        pc.baseVertex = prim.baseVertex;
+        pc.meshletVertexOffset = prim.meshletVertexOffset;
+        pc.meshletTriangleOffset = prim.meshletTriangleOffset;
+
+        m_GroupCursors[g] = nextInstance;
+        nextInstance += group.instanceCount;
+    }
+
+    m_DrawInstances.resize(nextInstance);
+    for (u32 i = 0; i < count; ++i)
+    {
+        const VisibleInstance& visible = visibleAt(i);
+        m_DrawInstances[m_GroupCursors[m_PrimGroupSlots[visible.primIndex]]++] = visible.drawInstance;
+    }
+
+    for (const PrimitiveRenderData& group : outGroups)
+    {
+        m_PrimGroupSlots[group.primIndex] = UINT32_MAX;
+    }
+}
+
 const PrimitiveBuckets& Culling::GetPrimitiveBuckets() const
 {
     return m_PrimitiveBuckets;
 }
 
+const Vector<DrawInstance>& Culling::GetDrawInstances() const
+{
+    return m_DrawInstances;
+}
+
 const Vector<Raytracing::RTInstance>& Culling::GetRTInstances() const
 {
     return m_RTInstances;
@@ -13,6 +13,13 @@ struct CpuTimers;
 
 using PrimitiveBucketRow = Array<Vector<PrimitiveRenderData>, CullMode_Count>;
 using PrimitiveBuckets = Array<PrimitiveBucketRow, AlphaMode_Count>;
+using VisibleInstanceBuckets = Array<Array<Vector<VisibleInstance>, CullMode_Count>, AlphaMode_Count>;
+
+struct DrawSortEntry
+{
+    u64 key;
+    u32 index;
+};
 
 struct BuildParams
 {
@@ -26,6 +33,7 @@ struct BuildParams
     bool cpuFrustumCullingEnabled = false;
     bool updateInstances = false;
     bool debugMeshletColorEnabled = false;
+    DrawSortMode drawSortMode = DrawSortMode_None;
     u32 materialsBufferSrvIndex = 0u;
     CpuTimers* cpuTimers = nullptr;
 };
@@ -36,12 +44,23 @@ class Culling
     void Reset();
     void Build(const BuildParams& params);
     const PrimitiveBuckets& GetPrimitiveBuckets() const;
+    const Vector<DrawInstance>& GetDrawInstances() const;
     const Vector<Raytracing::RTInstance>& GetRTInstances() const;
 
   private:
+    void SortBucket(const Vector<VisibleInstance>& bucket);
+    void BuildDrawGroups(const BuildParams& params, const Vector<VisibleInstance>& bucket, bool sorted, CullMode cullMode, Vector<PrimitiveRenderData>& outGroups);
+
+    VisibleInstanceBuckets m_VisibleBuckets{};
     PrimitiveBuckets m_PrimitiveBuckets{};
+    Vector<DrawInstance> m_DrawInstances;
+    Vector<DrawSortEntry> m_SortEntries;
+    Vector<DrawSortEntry> m_SortScratch;
+    Vector<u32> m_PrimGroupSlots;
+    Vector<u32> m_GroupCursors;
     Vector<XMFLOAT4X4> m_PrevInstanceWorlds;
     Vector<Raytracing::RTInstance> m_RTInstances;
     u32 m_RasterSubmittedCount = 0;
     u32 m_RasterCulledCount = 0;
+    u32 m_RasterBoxCulledCount = 0;
 };
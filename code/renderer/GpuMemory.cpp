@@ -0,0 +1,202 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "GpuMemory.h"
+
+#include <atomic>
+#include <psapi.h>
+
+namespace
+{
+// {5C0F2A4E-7D6B-4E8A-9B43-1F6C2D8E7A91}
+constexpr GUID kMemoryTagGuid = {0x5c0f2a4e, 0x7d6b, 0x4e8a, {0x9b, 0x43, 0x1f, 0x6c, 0x2d, 0x8e, 0x7a, 0x91}};
+
+struct CategoryCounters
+{
+    std::atomic<u64> bytes{0};
+    std::atomic<u64> peakBytes{0};
+    std::atomic<u32> resourceCount{0};
+};
+
+Array<CategoryCounters, GpuMemoryCategory_Count> g_Counters;
+
+void AddBytes(const GpuMemoryCategory category, const u64 bytes)
+{
+    CategoryCounters& counters = g_Counters[category];
+    const u64 total = counters.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    counters.resourceCount.fetch_add(1, std::memory_order_relaxed);
+
+    u64 peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (total > peak && !counters.peakBytes.compare_exchange_weak(peak, total, std::memory_order_relaxed))
+    {
+    }
+}
+
+void RemoveBytes(const GpuMemoryCategory category, const u64 bytes)
+{
+    CategoryCounters& counters = g_Counters[category];
+    counters.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    counters.resourceCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Owned by the resource through SetPrivateDataInterface; its last release happens when the resource is destroyed.
+class MemoryTag final : public IUnknown
+{
+  public:
+    MemoryTag(const GpuMemoryCategory category, const u64 bytes) : m_Category(category), m_Bytes(bytes)
+    {
+        AddBytes(m_Category, m_Bytes);
+    }
+
+    ~MemoryTag()
+    {
+        RemoveBytes(m_Category, m_Bytes);
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (!object)
+        {
+            return E_POINTER;
+        }
+        if (riid == __uuidof(IUnknown))
+        {
+            *object = static_cast<IUnknown*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return m_RefCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refCount = m_RefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        if (refCount == 0)
+        {
+            delete this;
+        }
+        return refCount;
+    }
+
+  private:
+    std::atomic<ULONG> m_RefCount{1};
+    GpuMemoryCategory m_Category;
+    u64 m_Bytes;
+};
+
+GpuMemory::SegmentBudget ToSegmentBudget(const D3D12MA::Budget& budget)
+{
+    return {budget.UsageBytes, budget.BudgetBytes, budget.Stats.BlockBytes, budget.Stats.AllocationBytes};
+}
+
+f64 ToMiB(const u64 bytes)
+{
+    return static_cast<f64>(bytes) / (1024.0 * 1024.0);
+}
+} // namespace
+
+namespace GpuMemory
+{
+const char* GetCategoryName(const GpuMemoryCategory category)
+{
+    switch (category)
+    {
+    case GpuMemoryCategory_Geometry:
+        return "Geometry";
+    case GpuMemoryCategory_Textures:
+        return "Textures";
+    case GpuMemoryCategory_AccelerationStructures:
+        return "Acceleration Structures";
+    case GpuMemoryCategory_Scratch:
+        return "Scratch";
+    case GpuMemoryCategory_RenderTargets:
+        return "Render Targets";
+    case GpuMemoryCategory_Upload:
+        return "Upload";
+    case GpuMemoryCategory_Readback:
+        return "Readback";
+    case GpuMemoryCategory_Other:
+        return "Other";
+    default:
+        return "Unknown";
+    }
+}
+
+void Track(ID3D12Resource* resource, const GpuMemoryCategory category, u64 sizeInBytes)
+{
+    IE_Assert(resource != nullptr && category < GpuMemoryCategory_Count);
+    if (sizeInBytes == 0)
+    {
+        ComPtr<ID3D12Device> device;
+        IE_Check(resource->GetDevice(IID_PPV_ARGS(&device)));
+        const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+        sizeInBytes = device->GetResourceAllocationInfo(0, 1, &desc).SizeInBytes;
+    }
+
+    MemoryTag* tag = new MemoryTag(category, sizeInBytes);
+    IE_Check(resource->SetPrivateDataInterface(kMemoryTagGuid, tag));
+    tag->Release();
+}
+
+void Track(ID3D12Heap* heap, const GpuMemoryCategory category)
+{
+    IE_Assert(heap != nullptr && category < GpuMemoryCategory_Count);
+    MemoryTag* tag = new MemoryTag(category, heap->GetDesc().SizeInBytes);
+    IE_Check(heap->SetPrivateDataInterface(kMemoryTagGuid, tag));
+    tag->Release();
+}
+
+Snapshot Query(D3D12MA::Allocator* allocator)
+{
+    Snapshot snapshot{};
+    for (u32 c = 0; c < GpuMemoryCategory_Count; ++c)
+    {
+        CategoryStats& stats = snapshot.categories[c];
+        stats.bytes = g_Counters[c].bytes.load(std::memory_order_relaxed);
+        stats.peakBytes = g_Counters[c].peakBytes.load(std::memory_order_relaxed);
+        stats.resourceCount = g_Counters[c].resourceCount.load(std::memory_order_relaxed);
+        snapshot.trackedBytes += stats.bytes;
+    }
+
+    if (allocator)
+    {
+        D3D12MA::Budget local{};
+        D3D12MA::Budget nonLocal{};
+        allocator->GetBudget(&local, &nonLocal);
+        snapshot.local = ToSegmentBudget(local);
+        snapshot.nonLocal = ToSegmentBudget(nonLocal);
+    }
+
+    PROCESS_MEMORY_COUNTERS_EX counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+    {
+        snapshot.processPrivateBytes = counters.PrivateUsage;
+        snapshot.processWorkingSetBytes = counters.WorkingSetSize;
+    }
+    return snapshot;
+}
+
+void LogSnapshot(const Snapshot& snapshot, const char* context)
+{
+    IE_LogInfo("GPU memory ({}): {:.1f} MiB tracked", context, ToMiB(snapshot.trackedBytes));
+    for (u32 c = 0; c < GpuMemoryCategory_Count; ++c)
+    {
+        const CategoryStats& stats = snapshot.categories[c];
+        IE_LogInfo("  {:<24} {:>9.1f} MiB in {:>5} resources (peak {:.1f} MiB)", GetCategoryName(static_cast<GpuMemoryCategory>(c)), ToMiB(stats.bytes), stats.resourceCount,
+                   ToMiB(stats.peakBytes));
+    }
+    IE_LogInfo("  Video memory: {:.1f} / {:.1f} MiB budget, D3D12MA {:.1f} MiB in {:.1f} MiB of blocks", ToMiB(snapshot.local.usageBytes), ToMiB(snapshot.local.budgetBytes),
+               ToMiB(snapshot.local.allocationBytes), ToMiB(snapshot.local.blockBytes));
+    IE_LogInfo("  System memory: {:.1f} / {:.1f} MiB budget, D3D12MA {:.1f} MiB in {:.1f} MiB of blocks", ToMiB(snapshot.nonLocal.usageBytes), ToMiB(snapshot.nonLocal.budgetBytes),
+               ToMiB(snapshot.nonLocal.allocationBytes), ToMiB(snapshot.nonLocal.blockBytes));
+    IE_LogInfo("  Process: {:.1f} MiB private, {:.1f} MiB working set", ToMiB(snapshot.processPrivateBytes), ToMiB(snapshot.processWorkingSetBytes));
+}
+} // namespace GpuMemory
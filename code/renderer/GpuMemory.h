@@ -0,0 +1,63 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "common/Types.h"
+
+enum GpuMemoryCategory : u8
+{
+    GpuMemoryCategory_Geometry,
+    GpuMemoryCategory_Textures,
+    GpuMemoryCategory_AccelerationStructures,
+    GpuMemoryCategory_Scratch,
+    GpuMemoryCategory_RenderTargets,
+    GpuMemoryCategory_Upload,
+    GpuMemoryCategory_Readback,
+    GpuMemoryCategory_Other,
+
+    GpuMemoryCategory_Count
+};
+
+// Per-category accounting of GPU resource memory. A tracked resource carries a small COM object as private data; the runtime
+// releases it together with the resource, so sizes leave their category without any bookkeeping at the release sites.
+namespace GpuMemory
+{
+struct CategoryStats
+{
+    u64 bytes = 0;
+    u64 peakBytes = 0;
+    u32 resourceCount = 0;
+};
+
+struct SegmentBudget
+{
+    u64 usageBytes = 0;      // whole process, as reported by DXGI
+    u64 budgetBytes = 0;     // what the OS lets the process use before it starts paging
+    u64 blockBytes = 0;      // heaps and committed resources created through D3D12MA
+    u64 allocationBytes = 0; // the part of blockBytes handed out to resources
+};
+
+struct Snapshot
+{
+    Array<CategoryStats, GpuMemoryCategory_Count> categories{};
+    u64 trackedBytes = 0;
+    SegmentBudget local{};    // video memory
+    SegmentBudget nonLocal{}; // system memory visible to the GPU
+    u64 processPrivateBytes = 0;
+    u64 processWorkingSetBytes = 0;
+};
+
+const char* GetCategoryName(GpuMemoryCategory category);
+
+// Attributes the resource to a category until it is destroyed; tracking it again moves it to the new category. Without a size,
+// the device's allocation size for the resource description is used.
+void Track(ID3D12Resource* resource, GpuMemoryCategory category, u64 sizeInBytes = 0);
+// Same for an explicit heap. Resources placed in it must not be tracked on their own, their bytes are the heap's.
+void Track(ID3D12Heap* heap, GpuMemoryCategory category);
+
+Snapshot Query(D3D12MA::Allocator* allocator);
+void LogSnapshot(const Snapshot& snapshot, const char* context);
+} // namespace GpuMemory
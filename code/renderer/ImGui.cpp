@@ -45,23 +45,6 @@ u32 gDebugSrvCount = 0;
 std::vector<u32> gFreeSrvIndices;
 std::unordered_map<ID3D12Resource*, D3D12_GPU_DESCRIPTOR_HANDLE> gDebugSrvCache;
 
-struct TimeSample
-{
-    f64 valueMs = 0.0;
-    f32 dtMs = 0.0f;
-};
-
-struct WindowedAverageState
-{
-    static constexpr u32 kHistoryCapacity = 8192u;
-
-    std::array<TimeSample, kHistoryCapacity> history{};
-    u32 historyStart = 0u;
-    u32 historyCount = 0u;
-};
-
-WindowedAverageState g_CpuFrameAvgState{};
-
 D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(u32 index)
 {
     D3D12_CPU_DESCRIPTOR_HANDLE cpu{};
@@ -84,58 +67,6 @@ u32 GetHandleIndex(D3D12_CPU_DESCRIPTOR_HANDLE cpu)
     return static_cast<u32>(byteOffset / gAlloc.inc);
 }
 
-f64 UpdateWindowedAverageMs(WindowedAverageState& state, f64 valueMs, f32 sampleDtMs, f32 windowMs)
-{
-    if (state.historyCount < WindowedAverageState::kHistoryCapacity)
-    {
-        const u32 writeIndex = (state.historyStart + state.historyCount) % WindowedAverageState::kHistoryCapacity;
-        state.history[writeIndex].valueMs = valueMs;
-        state.history[writeIndex].dtMs = sampleDtMs;
-        ++state.historyCount;
-    }
-    else
-    {
-        state.history[state.historyStart].valueMs = valueMs;
-        state.history[state.historyStart].dtMs = sampleDtMs;
-        state.historyStart = (state.historyStart + 1u) % WindowedAverageState::kHistoryCapacity;
-    }
-
-    if (windowMs <= 0.0f)
-    {
-        return valueMs;
-    }
-
-    f64 weightedSum = 0.0;
-    f64 coveredMs = 0.0;
-    for (u32 age = 0; age < state.historyCount && coveredMs < windowMs; ++age)
-    {
-        const u32 idx = (state.historyStart + state.historyCount - 1u - age) % WindowedAverageState::kHistoryCapacity;
-        const TimeSample& entry = state.history[idx];
-        const f64 entryDtMs = entry.dtMs > 0.0f ? static_cast<f64>(entry.dtMs) : 0.0;
-        if (entryDtMs <= 0.0)
-        {
-            continue;
-        }
-
-        const f64 remainingMs = static_cast<f64>(windowMs) - coveredMs;
-        const f64 takeMs = std::min(entryDtMs, remainingMs);
-        weightedSum += entry.valueMs * takeMs;
-        coveredMs += takeMs;
-    }
-
-    if (coveredMs <= 0.0)
-    {
-        return valueMs;
-    }
-
-    return weightedSum / coveredMs;
-}
-
-f64 UpdateCpuFrameAvgMs(f64 frameMs, f32 windowMs)
-{
-    return UpdateWindowedAverageMs(g_CpuFrameAvgState, frameMs, static_cast<f32>(frameMs), windowMs);
-}
-
 f32 HorizontalFovFromVerticalDegrees(f32 verticalFovDeg, f32 aspectRatio)
 {
     const f32 clampedAspect = IE_Max(aspectRatio, 1e-4f);
@@ -297,8 +228,7 @@ void ImGui_Render(const ImGui_RenderParams& p)
     ImGui::NewFrame();
 
     IE_Assert(p.renderer != nullptr);
-    const f32 rawFrameTimeMs = p.renderer->GetWindow().GetFrameTimeMs();
-    const f64 displayedFrameTimeMs = UpdateCpuFrameAvgMs(rawFrameTimeMs, g_Settings.timingAverageWindowMs);
+    const f64 displayedFrameTimeMs = p.frameTime.mean;
     const f32 engineFps = (displayedFrameTimeMs > 0.0) ? static_cast<f32>(1000.0 / displayedFrameTimeMs) : 0.0f;
     const u32 fgPresentedFrames = p.renderer->GetFrameGenerationPresentedFrames();
     const f32 displayedFps = engineFps * static_cast<f32>(fgPresentedFrames);
@@ -323,23 +253,58 @@ void ImGui_Render(const ImGui_RenderParams& p)
         {
             g_Settings.timingAverageWindowMs = timingAverageWindowSec * 1000.0f;
         }
-        const f64 statsFrameTimeMs = UpdateCpuFrameAvgMs(rawFrameTimeMs, g_Settings.timingAverageWindowMs);
-        ImGui::Text("%s %.3f", (g_Settings.timingAverageWindowMs <= 0.0f) ? "Frame Time (Raw, ms):" : "Frame Time (Average, ms):", static_cast<f32>(statsFrameTimeMs));
+        ImGui::Text("%s %.3f", (g_Settings.timingAverageWindowMs <= 0.0f) ? "Frame Time (Raw, ms):" : "Frame Time (Average, ms):", static_cast<f32>(p.frameTime.mean));
+        ImGui::Text("Frame Time p50 / p95 / p99 / Max (ms): %.2f / %.2f / %.2f / %.2f", static_cast<f32>(p.frameTime.p50), static_cast<f32>(p.frameTime.p95),
+                    static_cast<f32>(p.frameTime.p99), static_cast<f32>(p.frameTime.max));
+        if (p.frameTimeHistogram)
+        {
+            // Only the occupied range of the log histogram is plotted, so the distribution stays readable.
+            const Array<u32, TimingState::kHistogramBuckets>& histogram = *p.frameTimeHistogram;
+            u32 firstBucket = TimingState::kHistogramBuckets;
+            u32 lastBucket = 0;
+            for (u32 b = 0; b < TimingState::kHistogramBuckets; ++b)
+            {
+                if (histogram[b] > 0)
+                {
+                    firstBucket = IE_Min(firstBucket, b);
+                    lastBucket = b;
+                }
+            }
+            if (firstBucket <= lastBucket)
+            {
+                std::array<f32, TimingState::kHistogramBuckets> counts{};
+                const u32 plotCount = lastBucket - firstBucket + 1;
+                for (u32 b = 0; b < plotCount; ++b)
+                {
+                    counts[b] = static_cast<f32>(histogram[firstBucket + b]);
+                }
+                char overlay[64];
+                std::snprintf(overlay, sizeof(overlay), "%.2f - %.2f ms", static_cast<f32>(Timings_HistogramBucketLowerMs(firstBucket)),
+                              static_cast<f32>(Timings_HistogramBucketLowerMs(lastBucket + 1)));
+                ImGui::PlotHistogram("Frame Time Distribution", counts.data(), static_cast<i32>(plotCount), 0, overlay, 0.0f, FLT_MAX, ImVec2(0.0f, 60.0f));
+            }
+        }
         ImGui::Text("DLSS FG Presented Frames: %u", fgPresentedFrames);
 
         const char* timingValueLabel = (g_Settings.timingAverageWindowMs <= 0.0f) ? "Raw (ms)" : "Average (ms)";
 
-        if (ImGui::BeginTable("CpuTimingsTbl", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchSame))
+        if (ImGui::BeginTable("CpuTimingsTbl", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchSame))
         {
             ImGui::TableSetupColumn("CPU Pass");
             ImGui::TableSetupColumn(timingValueLabel, ImGuiTableColumnFlags_WidthFixed, 90.0f);
+            ImGui::TableSetupColumn("p95 (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableSetupColumn("p99 (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
             ImGui::TableSetupColumn("% of Total", ImGuiTableColumnFlags_WidthFixed, 110.0f);
             ImGui::TableHeadersRow();
 
             f64 cpuTotal = 0.0;
             for (u32 i = 0; i < p.cpuTimingsCount; ++i)
             {
-                cpuTotal += p.cpuTimings[i].ms;
+                if (p.cpuTimings[i].depth == 0)
+                {
+                    cpuTotal += p.cpuTimings[i].ms;
+                }
             }
 
             for (u32 i = 0; i < p.cpuTimingsCount; ++i)
@@ -348,10 +313,25 @@ void ImGui_Render(const ImGui_RenderParams& p)
 
                 ImGui::TableNextRow();
                 ImGui::TableSetColumnIndex(0);
-                ImGui::TextUnformatted(timing.name);
+                if (timing.depth > 0)
+                {
+                    ImGui::Indent(ImGui::GetStyle().IndentSpacing * static_cast<f32>(timing.depth));
+                    ImGui::TextUnformatted(timing.name);
+                    ImGui::Unindent(ImGui::GetStyle().IndentSpacing * static_cast<f32>(timing.depth));
+                }
+                else
+                {
+                    ImGui::TextUnformatted(timing.name);
+                }
                 ImGui::TableSetColumnIndex(1);
                 ImGui::Text("%.3f", static_cast<f32>(timing.ms));
                 ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.3f", static_cast<f32>(timing.p95Ms));
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.3f", static_cast<f32>(timing.p99Ms));
+                ImGui::TableSetColumnIndex(4);
+                ImGui::Text("%.3f", static_cast<f32>(timing.maxMs));
+                ImGui::TableSetColumnIndex(5);
                 ImGui::Text("%.1f%%", (cpuTotal > 0.0) ? static_cast<f32>(timing.ms * 100.0 / cpuTotal) : 0.0f);
             }
 
@@ -360,16 +340,19 @@ void ImGui_Render(const ImGui_RenderParams& p)
             ImGui::TextUnformatted("Total");
             ImGui::TableSetColumnIndex(1);
             ImGui::Text("%.3f", static_cast<f32>(cpuTotal));
-            ImGui::TableSetColumnIndex(2);
+            ImGui::TableSetColumnIndex(5);
             ImGui::Text("%s", (cpuTotal > 0.0) ? "100.0%" : "0.0%");
 
             ImGui::EndTable();
         }
 
-        if (ImGui::BeginTable("GpuTimingsTbl", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchSame))
+        if (ImGui::BeginTable("GpuTimingsTbl", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchSame))
         {
             ImGui::TableSetupColumn("GPU Pass");
             ImGui::TableSetupColumn(timingValueLabel, ImGuiTableColumnFlags_WidthFixed, 90.0f);
+            ImGui::TableSetupColumn("p95 (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableSetupColumn("p99 (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+            ImGui::TableSetupColumn("Max (ms)", ImGuiTableColumnFlags_WidthFixed, 70.0f);
             ImGui::TableSetupColumn("% of Total", ImGuiTableColumnFlags_WidthFixed, 110.0f);
             ImGui::TableHeadersRow();
 
@@ -389,6 +372,12 @@ void ImGui_Render(const ImGui_RenderParams& p)
                 ImGui::TableSetColumnIndex(1);
                 ImGui::Text("%.3f", static_cast<f32>(timing.ms));
                 ImGui::TableSetColumnIndex(2);
+                ImGui::Text("%.3f", static_cast<f32>(timing.p95Ms));
+                ImGui::TableSetColumnIndex(3);
+                ImGui::Text("%.3f", static_cast<f32>(timing.p99Ms));
+                ImGui::TableSetColumnIndex(4);
+                ImGui::Text("%.3f", static_cast<f32>(timing.maxMs));
+                ImGui::TableSetColumnIndex(5);
                 ImGui::Text("%.1f%%", (gpuTotal > 0.0) ? static_cast<f32>(timing.ms * 100.0 / gpuTotal) : 0.0f);
             }
 
@@ -397,15 +386,63 @@ void ImGui_Render(const ImGui_RenderParams& p)
             ImGui::TextUnformatted("Total");
             ImGui::TableSetColumnIndex(1);
             ImGui::Text("%.3f", static_cast<f32>(gpuTotal));
-            ImGui::TableSetColumnIndex(2);
+            ImGui::TableSetColumnIndex(5);
             ImGui::Text("%s", (gpuTotal > 0.0) ? "100.0%" : "0.0%");
 
             ImGui::EndTable();
         }
         const f32 culledPct =
             (g_Stats.cpuFrustumCullTotalInstances > 0) ? (100.0f * static_cast<f32>(g_Stats.cpuFrustumCullRasterCulled) / static_cast<f32>(g_Stats.cpuFrustumCullTotalInstances)) : 0.0f;
-        ImGui::Text("Raster Instances: %u submitted / %u total (%u culled, %.1f%%)", g_Stats.cpuFrustumCullRasterSubmitted, g_Stats.cpuFrustumCullTotalInstances, g_Stats.cpuFrustumCullRasterCulled,
-                    culledPct);
+        ImGui::Text("Raster Instances: %u submitted / %u total (%u culled, %.1f%%, %u by box test)", g_Stats.cpuFrustumCullRasterSubmitted, g_Stats.cpuFrustumCullTotalInstances,
+                    g_Stats.cpuFrustumCullRasterCulled, culledPct, g_Stats.cpuFrustumCullBoxCulled);
+        ImGui::Text("Raster Draw Groups: %u", g_Stats.rasterDrawGroups);
+
+        if (p.memory)
+        {
+            constexpr f64 mib = 1024.0 * 1024.0;
+            const GpuMemory::Snapshot& memory = *p.memory;
+
+            if (ImGui::BeginTable("GpuMemoryTbl", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_SizingStretchSame))
+            {
+                ImGui::TableSetupColumn("GPU Memory");
+                ImGui::TableSetupColumn("MiB", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("Peak MiB", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+                ImGui::TableSetupColumn("Resources", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+                ImGui::TableHeadersRow();
+
+                for (u32 c = 0; c < GpuMemoryCategory_Count; ++c)
+                {
+                    const GpuMemory::CategoryStats& stats = memory.categories[c];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::TextUnformatted(GpuMemory::GetCategoryName(static_cast<GpuMemoryCategory>(c)));
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.1f", static_cast<f32>(static_cast<f64>(stats.bytes) / mib));
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.1f", static_cast<f32>(static_cast<f64>(stats.peakBytes) / mib));
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%u", stats.resourceCount);
+                }
+
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                ImGui::TextUnformatted("Total");
+                ImGui::TableSetColumnIndex(1);
+                ImGui::Text("%.1f", static_cast<f32>(static_cast<f64>(memory.trackedBytes) / mib));
+
+                ImGui::EndTable();
+            }
+
+            ImGui::Text("Video Memory: %.1f / %.1f MiB budget (D3D12MA %.1f MiB in %.1f MiB of blocks)", static_cast<f32>(static_cast<f64>(memory.local.usageBytes) / mib),
+                        static_cast<f32>(static_cast<f64>(memory.local.budgetBytes) / mib), static_cast<f32>(static_cast<f64>(memory.local.allocationBytes) / mib),
+                        static_cast<f32>(static_cast<f64>(memory.local.blockBytes) / mib));
+            ImGui::Text("System Memory: %.1f / %.1f MiB budget (D3D12MA %.1f MiB in %.1f MiB of blocks)", static_cast<f32>(static_cast<f64>(memory.nonLocal.usageBytes) / mib),
+                        static_cast<f32>(static_cast<f64>(memory.nonLocal.budgetBytes) / mib), static_cast<f32>(static_cast<f64>(memory.nonLocal.allocationBytes) / mib),
+                        static_cast<f32>(static_cast<f64>(memory.nonLocal.blockBytes) / mib));
+            ImGui::Text("Process: %.1f MiB private, %.1f MiB working set", static_cast<f32>(static_cast<f64>(memory.processPrivateBytes) / mib),
+                        static_cast<f32>(static_cast<f64>(memory.processWorkingSetBytes) / mib));
+        }
 
         ImGui::End();
     }
@@ -655,6 +692,25 @@ void ImGui_Render(const ImGui_RenderParams& p)
         {
             renderer.RequestShaderReload();
         }
+        ImGui::SameLine();
+        ImGui::BeginDisabled(renderer.IsCapturingCpuTrace());
+        if (ImGui::Button("Capture CPU Trace"))
+        {
+            renderer.RequestCpuTraceCapture();
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        ImGui::BeginDisabled(renderer.IsCapturingTimeline());
+        if (ImGui::Button("Capture Timeline"))
+        {
+            renderer.RequestTimelineCapture();
+        }
+        ImGui::EndDisabled();
+        ImGui::SameLine();
+        if (ImGui::Button("Export Timing Stats"))
+        {
+            renderer.RequestTimingStatsExport();
+        }
         if (!g_Stats.shadersCompilationSuccess)
         {
             ImGui::SameLine();
@@ -796,6 +852,12 @@ void ImGui_Render(const ImGui_RenderParams& p)
             settingsRow("CPU Frustum Culling", [&] { return ImGui::Checkbox("##ViewCpuFrustumCulling", &g_Settings.cpuFrustumCulling); });
             settingsRow("GPU Frustum Culling", [&] { return ImGui::Checkbox("##ViewGpuFrustumCulling", &g_Settings.gpuFrustumCulling); });
             settingsRow("GPU Backface Culling", [&] { return ImGui::Checkbox("##ViewGpuBackfaceCulling", &g_Settings.gpuBackfaceCulling); });
+            const char* drawSortModeLabels[] = {"Instance Order", "Front To Back", "By Primitive"};
+            i32 drawSortMode = static_cast<i32>(g_Settings.drawSortMode);
+            if (settingsRow("Draw Order", [&] { return ImGui::Combo("##ViewDrawSortMode", &drawSortMode, drawSortModeLabels, IM_ARRAYSIZE(drawSortModeLabels)); }))
+            {
+                g_Settings.drawSortMode = static_cast<u32>(drawSortMode);
+            }
             ImGui::EndTable();
         }
 
@@ -948,6 +1010,23 @@ void ImGui_Render(const ImGui_RenderParams& p)
             ImGui::EndTable();
         }
 
+        ImGui::SeparatorText("Acceleration Structure");
+        if (beginSettingsTable("##RayTracingTlasTbl", "Build Scratch Budget (MiB)", 240.0f))
+        {
+            {
+                const u32 minv = 8, maxv = 1024;
+                settingsRow("Build Scratch Budget (MiB)",
+                            [&] { return ImGui::SliderScalar("##RayTracingBuildScratchBudget", ImGuiDataType_U32, &g_Settings.rtBuildScratchBudgetMiB, &minv, &maxv); });
+            }
+            settingsRow("TLAS Rebuild Drift", [&] { return ImGui::SliderFloat("##RayTracingTlasRebuildDrift", &g_Settings.rtTlasRebuildDrift, 0.0f, 1.0f); });
+            settingsRow("TLAS Rebuild Max Drift", [&] { return ImGui::SliderFloat("##RayTracingTlasRebuildMaxDrift", &g_Settings.rtTlasRebuildMaxDrift, 0.0f, 16.0f); });
+            ImGui::EndTable();
+        }
+        ImGui::Text("BLAS Memory: %.2f MiB (%.2f MiB before compaction)", static_cast<f64>(g_Stats.rtBlasCompactedBytes) / (1024.0 * 1024.0),
+                    static_cast<f64>(g_Stats.rtBlasUncompactedBytes) / (1024.0 * 1024.0));
+        ImGui::Text("Last TLAS Update: %s, %u instances, drift %.3f mean, %.3f max", g_Stats.rtTlasRefit ? "refit" : "rebuild", g_Stats.rtTlasUpdatedInstances,
+                    g_Stats.rtTlasDrift, g_Stats.rtTlasMaxDrift);
+
         ImGui::End();
     }
 
@@ -7,7 +7,9 @@
 
 #include <Windows.h>
 
+#include "GpuMemory.h"
 #include "RuntimeState.h"
+#include "Timings.h"
 
 class Renderer;
 
@@ -25,6 +27,10 @@ struct ImGui_TimingValue
 {
     const char* name;
     f64 ms;
+    f64 p95Ms;
+    f64 p99Ms;
+    f64 maxMs;
+    u32 depth; // nesting level; only top-level entries count towards the total
 };
 
 struct ImGui_FrameStats
@@ -43,12 +49,16 @@ struct ImGui_RenderParams
     const char* loadingLabel = nullptr;
 
     ImGui_FrameStats frame;
+    TimingStats frameTime;
+    const Array<u32, TimingState::kHistogramBuckets>* frameTimeHistogram = nullptr;
 
     const ImGui_TimingValue* gpuTimings = nullptr;
     u32 gpuTimingsCount = 0;
     const ImGui_TimingValue* cpuTimings = nullptr;
     u32 cpuTimingsCount = 0;
 
+    const GpuMemory::Snapshot* memory = nullptr;
+
     // Optional: GBuffer debug preview
     ID3D12Resource* gbufferAlbedo = nullptr;
     ID3D12Resource* gbufferNormal = nullptr;
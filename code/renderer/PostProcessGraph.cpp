@@ -0,0 +1,86 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "PostProcessGraph.h"
+
+#include <d3dx12/d3dx12.h>
+
+namespace
+{
+constexpr D3D12_RESOURCE_STATES kShaderRead = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+constexpr D3D12_RESOURCE_STATES kShaderWrite = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+RGTextureDesc MakeTextureDesc(const XMUINT2 size, const wchar_t* name, const bool createUav)
+{
+    RGTextureDesc desc{};
+    desc.desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, size.x, size.y, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+    desc.name = name;
+    desc.createSrv = true;
+    desc.createUav = createUav;
+    return desc;
+}
+} // namespace
+
+D3D12_RESOURCE_ALLOCATION_INFO EstimatePostProcessAllocationInfo(const D3D12_RESOURCE_DESC& desc)
+{
+    constexpr u64 kPage = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    const u64 bytes = desc.Width * desc.Height * 8ull;
+    return {(bytes + kPage - 1) / kPage * kPage, kPage};
+}
+
+RGTexture PostProcessGraph::GetBloomResult() const
+{
+    return bloomMipCount > 1u ? bloomUp[0] : bloomDown[0];
+}
+
+void DeclarePostProcessGraph(RenderGraph& graph, const XMUINT2 renderSize, const XMUINT2 presentSize, PostProcessGraph& out)
+{
+    out = {};
+
+    out.diffuseAlbedoGuide = graph.CreateTexture(MakeTextureDesc(renderSize, L"DLSS RR Diffuse Albedo", true));
+    out.specularAlbedoGuide = graph.CreateTexture(MakeTextureDesc(renderSize, L"DLSS RR Specular Albedo", true));
+    // DLSS writes the output through its own views, the engine only samples it.
+    out.upscaleOutput = graph.CreateTexture(MakeTextureDesc(presentSize, L"Upscale Output", false));
+
+    u32 width = (presentSize.x > 1u) ? (presentSize.x / 2u) : 1u;
+    u32 height = (presentSize.y > 1u) ? (presentSize.y / 2u) : 1u;
+    for (u32 mip = 0; mip < PostProcessGraph::kMaxBloomMipCount; ++mip)
+    {
+        out.bloomMipSizes[mip] = XMUINT2(width, height);
+        out.bloomMipCount = mip + 1u;
+        if (width == 1u && height == 1u)
+        {
+            break;
+        }
+        width = (width > 1u) ? (width / 2u) : 1u;
+        height = (height > 1u) ? (height / 2u) : 1u;
+    }
+    for (u32 mip = 0; mip < out.bloomMipCount; ++mip)
+    {
+        out.bloomDown[mip] = graph.CreateTexture(MakeTextureDesc(out.bloomMipSizes[mip], L"Bloom Down", true));
+    }
+    for (u32 mip = 0; mip + 1u < out.bloomMipCount; ++mip)
+    {
+        out.bloomUp[mip] = graph.CreateTexture(MakeTextureDesc(out.bloomMipSizes[mip], L"Bloom Up", true));
+    }
+
+    out.guidesPass = graph.AddPass("DLSS RR Guides", {{out.diffuseAlbedoGuide, kShaderWrite}, {out.specularAlbedoGuide, kShaderWrite}});
+    out.upscalePass = graph.AddPass("DLSS RR", {{out.diffuseAlbedoGuide, kShaderRead}, {out.specularAlbedoGuide, kShaderRead}, {out.upscaleOutput, kShaderWrite}});
+
+    for (u32 mip = 0; mip < out.bloomMipCount; ++mip)
+    {
+        const RGTexture source = (mip == 0u) ? out.upscaleOutput : out.bloomDown[mip - 1u];
+        out.bloomDownPasses[mip] = graph.AddPass("Bloom Downsample", {{source, kShaderRead}, {out.bloomDown[mip], kShaderWrite}});
+    }
+    for (i32 mip = static_cast<i32>(out.bloomMipCount) - 2; mip >= 0; --mip)
+    {
+        const RGTexture bloom = (mip == static_cast<i32>(out.bloomMipCount) - 2) ? out.bloomDown[mip + 1] : out.bloomUp[mip + 1];
+        out.bloomUpPasses[mip] = graph.AddPass("Bloom Upsample", {{out.bloomDown[mip], kShaderRead}, {bloom, kShaderRead}, {out.bloomUp[mip], kShaderWrite}});
+    }
+
+    out.tonemapPass = graph.AddPass("Tone Mapping", {{out.upscaleOutput, kShaderRead}, {out.GetBloomResult(), kShaderRead}});
+    // The render target viewer can preview the guides and the upscale output, so they stay intact until the UI is drawn.
+    out.uiPass = graph.AddPass("UI", {{out.diffuseAlbedoGuide, kShaderRead}, {out.specularAlbedoGuide, kShaderRead}, {out.upscaleOutput, kShaderRead}});
+}
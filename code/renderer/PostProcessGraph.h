@@ -0,0 +1,39 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "RenderGraph.h"
+
+// The frame-local textures from the DLSS RR guides to the UI. The GBuffer, depth, hudless and UI targets are not part of it:
+// frame generation reads them after the frame has been submitted, so they keep one copy per frame in flight.
+struct PostProcessGraph
+{
+    static constexpr u32 kMaxBloomMipCount = 6;
+
+    RGTexture diffuseAlbedoGuide = RG_Invalid;
+    RGTexture specularAlbedoGuide = RG_Invalid;
+    RGTexture upscaleOutput = RG_Invalid;
+    Array<RGTexture, kMaxBloomMipCount> bloomDown{};
+    Array<RGTexture, kMaxBloomMipCount> bloomUp{}; // mip count - 1 entries; the smallest mip is only downsampled
+    u32 bloomMipCount = 0;
+    Array<XMUINT2, kMaxBloomMipCount> bloomMipSizes{};
+
+    RGPass guidesPass = RG_Invalid;
+    RGPass upscalePass = RG_Invalid;
+    Array<RGPass, kMaxBloomMipCount> bloomDownPasses{};
+    Array<RGPass, kMaxBloomMipCount> bloomUpPasses{};
+    RGPass tonemapPass = RG_Invalid;
+    RGPass uiPass = RG_Invalid;
+
+    // Tone mapping reads the last bloom level written.
+    RGTexture GetBloomResult() const;
+};
+
+void DeclarePostProcessGraph(RenderGraph& graph, XMUINT2 renderSize, XMUINT2 presentSize, PostProcessGraph& out);
+
+// Allocation sizes without a device, for compiling the graph on the CPU: 8 bytes per texel in 64 KiB pages, which is what the
+// RGBA16F targets above take on current drivers within a page or two. The renderer uses the device's sizes instead.
+D3D12_RESOURCE_ALLOCATION_INFO EstimatePostProcessAllocationInfo(const D3D12_RESOURCE_DESC& desc);
@@ -10,27 +10,33 @@
 
 struct Primitive
 {
-    // GPU buffers
+    // GPU buffers, shared by every primitive of the scene
     SharedPtr<Buffer> vertices; // stride sizeof(Vertex)
     SharedPtr<Buffer> meshlets; // bytes
     SharedPtr<Buffer> mlVerts;  // u32
     SharedPtr<Buffer> mlTris;   // bytes
     SharedPtr<Buffer> mlBounds; // sizeof(MeshletBounds)
 
+    // This primitive's ranges in the buffers above
+    u32 baseVertex = 0;
+    u32 firstMeshlet = 0;          // into meshlets and mlBounds
+    u32 meshletVertexOffset = 0;   // u32 elements
+    u32 meshletTriangleOffset = 0; // bytes, 4-byte aligned
+
     u32 meshletCount = 0;
     XMFLOAT3 localBoundsCenter = {0.0f, 0.0f, 0.0f};
     f32 localBoundsRadius = 0.0f;
+    XMFLOAT4X4 localBoxToObject{}; // unit cube [-1, 1]^3 -> object-space bounding box
 
     // BLAS resources
     SharedPtr<Buffer> blas;
-    SharedPtr<Buffer> blasScratch;
     SharedPtr<Buffer> ommArray;
-    SharedPtr<Buffer> ommArrayScratch;
     SharedPtr<Buffer> ommIndices;
     SharedPtr<Buffer> ommDescs;
     SharedPtr<Buffer> ommData;
 
     SharedPtr<Buffer> rtVertices;
-    SharedPtr<Buffer> rtIndices;
+    SharedPtr<Buffer> rtIndices; // shared, indices are relative to baseVertex
+    u32 firstIndex = 0;
 };
 
@@ -19,6 +19,12 @@ constexpr u32 kInvalidMaterialIdx = 0xFFFFFFFFu;
 constexpr u32 kPathTracePayloadBytes = 72u;
 constexpr u32 kTriangleAttribBytes = 2u * sizeof(f32);
 
+// Per-instance drift is measured in bounding radii. The mean clamps it so one teleported instance does not dominate the average;
+// the largest unclamped drift is tracked separately so that instance still triggers a rebuild on its own.
+constexpr f32 kMaxInstanceDrift = 4.0f;
+constexpr f32 kMinDriftRadius = 1e-3f;
+static_assert(IE_Constants::frameInFlightCount <= 8u); // m_InstancePendingSlots holds one bit per frame slot
+
 void RequireOpacityMicromapSupport(const ComPtr<ID3D12Device14>& device)
 {
     D3D12_FEATURE_DATA_D3D12_OPTIONS5 options5{};
@@ -81,6 +87,22 @@ Vector<D3D12_RAYTRACING_OPACITY_MICROMAP_HISTOGRAM_ENTRY> BuildOpacityMicromapHi
     return histogram;
 }
 
+XMFLOAT3 ComputeWorldBoundsCenter(const Primitive& prim, const XMFLOAT4X4& world)
+{
+    const XMVECTOR center = XMVector3TransformCoord(XMLoadFloat3(&prim.localBoundsCenter), XMLoadFloat4x4(&world));
+    XMFLOAT3 result;
+    XMStoreFloat3(&result, center);
+    return result;
+}
+
+f32 ComputeMaxWorldScale(const XMFLOAT4X4& world)
+{
+    const f32 rowX = world._11 * world._11 + world._12 * world._12 + world._13 * world._13;
+    const f32 rowY = world._21 * world._21 + world._22 * world._22 + world._23 * world._23;
+    const f32 rowZ = world._31 * world._31 + world._32 * world._32 + world._33 * world._33;
+    return IE_Sqrt(IE_Max(rowX, IE_Max(rowY, rowZ)));
+}
+
 void FillInstanceTransform(D3D12_RAYTRACING_INSTANCE_DESC& dst, const XMFLOAT4X4& m)
 {
     dst.Transform[0][0] = m._11;
@@ -107,8 +129,8 @@ u32 CalcShaderRecordSize()
 
 void ReleaseTextureDescriptors(BindlessHeaps& bindlessHeaps, Texture& texture)
 {
-    bindlessHeaps.FreeCbvSrvUav(texture.srvIndex);
-    bindlessHeaps.FreeCbvSrvUav(texture.uavIndex);
+    bindlessHeaps.FreeCbvSrvUav(texture.srvIndex, texture.srvGeneration);
+    bindlessHeaps.FreeCbvSrvUav(texture.uavIndex, texture.uavGeneration);
     texture.srvIndex = UINT32_MAX;
     texture.uavIndex = UINT32_MAX;
 }
@@ -141,6 +163,7 @@ void CreateShaderTable(const ComPtr<ID3D12Device14>& device, const ComPtr<ID3D12
     IE_Check(device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&outTable)));
 
     IE_Check(outTable->SetName(tableName));
+    GpuMemory::Track(outTable.Get(), GpuMemoryCategory_Upload);
 
     u8* mappedData = nullptr;
     IE_Check(outTable->Map(0, nullptr, reinterpret_cast<void**>(&mappedData)));
@@ -163,7 +186,7 @@ SharedPtr<Buffer> Raytracing::CreateBuffer(ID3D12GraphicsCommandList7* cmd, cons
 
 void Raytracing::SetBufferData(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes, u32 offsetInBytes)
 {
-    m_RenderDevice.SetBufferData(cmd, dst, data, sizeInBytes, offsetInBytes);
+    m_RenderDevice.SetBufferData(m_BindlessHeaps, cmd, dst, data, sizeInBytes, offsetInBytes);
 }
 
 void Raytracing::Init(ComPtr<ID3D12GraphicsCommandList7>& cmd, const XMUINT2& renderSize, Vector<Primitive>& primitives, const Vector<LoadedPrimitive>& loadedPrimitives,
@@ -173,17 +196,34 @@ void Raytracing::Init(ComPtr<ID3D12GraphicsCommandList7>& cmd, const XMUINT2& re
     CreatePathTracePassResources(renderSize);
 }
 
-void Raytracing::ReloadShaders()
+void Raytracing::QueueShaders(ShaderCompileQueue& shaderQueue)
 {
+    shaderQueue.Add(m_PathTrace.trace.shader, IE_SHADER_TYPE_LIB, "systems/raytracing/lighting/path_trace.rt.hlsl", {});
+}
+
+void Raytracing::CreatePipelines(const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_PathTrace.trace.shader}))
+    {
+        return;
+    }
+
     CreatePathTracePassPipelines();
 }
 
+void Raytracing::CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const
+{
+    const PathTracePassResources::Trace& trace = m_PathTrace.trace;
+    outObjects.insert(outObjects.end(), {trace.rootSig, trace.dxrStateObject, trace.rayGenShaderTable, trace.missShaderTable, trace.hitGroupShaderTable});
+}
+
 void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Vector<Primitive>& primitives, const Vector<LoadedPrimitive>& loadedPrimitives, const Vector<RTInstance>& instances)
 {
     const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
     RequireOpacityMicromapSupport(device);
     m_Primitives = &primitives;
     IE_Assert(primitives.size() == loadedPrimitives.size());
+    IE_Assert(!primitives.empty());
 
     Vector<u32> primMaterialIdx(primitives.size(), kInvalidMaterialIdx);
     Vector<u32> primAlphaMode(primitives.size(), static_cast<u32>(AlphaMode_Opaque));
@@ -214,19 +254,55 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
 
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS in{};
     in.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL;
-    in.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_DISABLE_OMMS;
+    in.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_DISABLE_OMMS |
+               D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_COMPACTION;
     in.NumDescs = 1;
     in.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
 
+    // Each build writes its compacted size here; CompactBottomLevel() reads them back once this command list has executed.
+    {
+        BufferCreateDesc d{};
+        d.sizeInBytes = static_cast<u32>(primitives.size() * sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC));
+        d.heapType = D3D12_HEAP_TYPE_DEFAULT;
+        d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        d.finalState = d.initialState;
+        d.name = L"BLAS Compacted Sizes";
+        m_BlasCompactedSizes = CreateBuffer(cmd.Get(), d);
+
+        d.heapType = D3D12_HEAP_TYPE_READBACK;
+        d.resourceFlags = D3D12_RESOURCE_FLAG_NONE;
+        d.initialState = D3D12_RESOURCE_STATE_COPY_DEST;
+        d.finalState = d.initialState;
+        d.name = L"BLAS Compacted Sizes Readback";
+        m_BlasCompactedSizesReadback = CreateBuffer(nullptr, d);
+    }
+    m_BlasUncompactedBytes = 0;
+    m_BuildScratchOffset = 0;
+    m_BuildScratchBatchCount = 0;
+    u32 ommArrayCount = 0;
+
     Vector<RTPrimInfo> primInfos(primitives.size());
 
-    for (u32 primIndex = 0; primIndex < primitives.size(); ++primIndex)
+    // Like the raster geometry, the indices of every primitive go into one shared buffer. The raster vertex buffer is reused
+    // to avoid duplicating GPU uploads; BLAS inputs and RTPrimInfo carry each primitive's base vertex and first index.
     {
-        Primitive& prim = primitives[primIndex];
-        const LoadedPrimitive& srcPrim = loadedPrimitives[primIndex];
-        const u32 indexCount = srcPrim.indexCount;
-        const u32 vertexCount = srcPrim.vertexCount;
-        const bool alphaTested = primAlphaMode[primIndex] != static_cast<u32>(AlphaMode_Opaque);
+        u64 indexCount = 0;
+        for (const LoadedPrimitive& srcPrim : loadedPrimitives)
+        {
+            indexCount += srcPrim.indexCount;
+        }
+        IE_Assert(indexCount > 0 && indexCount * sizeof(u32) <= UINT32_MAX);
+
+        Vector<u32> indices(indexCount);
+        u32 nextIndex = 0;
+        for (u32 primIndex = 0; primIndex < primitives.size(); ++primIndex)
+        {
+            const LoadedPrimitive& srcPrim = loadedPrimitives[primIndex];
+            primitives[primIndex].firstIndex = nextIndex;
+            std::memcpy(indices.data() + nextIndex, srcPrim.indices, srcPrim.indexCount * sizeof(u32));
+            nextIndex += srcPrim.indexCount;
+        }
 
         BufferCreateDesc d{};
         d.heapType = D3D12_HEAP_TYPE_DEFAULT;
@@ -235,36 +311,35 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
         d.createUAV = false;
         d.initialState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
         d.finalState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
-
-        // Reuse the raster vertex buffer for RT to avoid duplicating GPU uploads.
-        prim.rtVertices = prim.vertices;
-        IE_Assert(prim.rtVertices && prim.rtVertices->resource);
-        prim.rtVertices->Transition(cmd, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
-
-        d.sizeInBytes = indexCount * sizeof(u32);
+        d.sizeInBytes = static_cast<u32>(indices.size() * sizeof(u32));
         d.initialDataSize = d.sizeInBytes;
         d.strideInBytes = sizeof(u32);
-        d.initialData = srcPrim.indices;
-        d.name = L"Primitive/rtIndices";
-        prim.rtIndices = CreateBuffer(cmd.Get(), d);
+        d.initialData = indices.data();
+        d.memoryCategory = GpuMemoryCategory_Geometry;
+        d.name = L"Scene/rtIndices";
+        const SharedPtr<Buffer> indicesBuffer = CreateBuffer(cmd.Get(), d);
+
+        for (Primitive& prim : primitives)
+        {
+            prim.rtVertices = prim.vertices;
+            prim.rtIndices = indicesBuffer;
+        }
+        IE_Assert(primitives[0].rtVertices && primitives[0].rtVertices->resource);
+        primitives[0].rtVertices->Transition(cmd, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+    }
+
+    for (u32 primIndex = 0; primIndex < primitives.size(); ++primIndex)
+    {
+        Primitive& prim = primitives[primIndex];
+        const LoadedPrimitive& srcPrim = loadedPrimitives[primIndex];
+        const u32 indexCount = srcPrim.indexCount;
+        const bool alphaTested = primAlphaMode[primIndex] != static_cast<u32>(AlphaMode_Opaque);
 
         primInfos[primIndex].vbSrvIndex = prim.rtVertices->srvIndex;
         primInfos[primIndex].ibSrvIndex = prim.rtIndices->srvIndex;
         primInfos[primIndex].materialIdx = primMaterialIdx[primIndex];
-
-        D3D12_RAYTRACING_GEOMETRY_TRIANGLES_DESC trianglesDesc{};
-        trianglesDesc.Transform3x4 = 0;
-        trianglesDesc.IndexFormat = DXGI_FORMAT_R32_UINT;
-        trianglesDesc.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
-        trianglesDesc.IndexCount = indexCount;
-        trianglesDesc.VertexCount = vertexCount;
-        trianglesDesc.IndexBuffer = prim.rtIndices->resource->GetGPUVirtualAddress();
-        trianglesDesc.VertexBuffer.StartAddress = prim.rtVertices->resource->GetGPUVirtualAddress();
-        trianglesDesc.VertexBuffer.StrideInBytes = sizeof(Vertex);
-
-        D3D12_RAYTRACING_GEOMETRY_DESC geom{};
-        geom.Flags = alphaTested ? D3D12_RAYTRACING_GEOMETRY_FLAG_NONE : D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
-        D3D12_RAYTRACING_GEOMETRY_OMM_LINKAGE_DESC ommLinkage{};
+        primInfos[primIndex].baseVertex = prim.baseVertex;
+        primInfos[primIndex].firstIndex = prim.firstIndex;
 
         if (alphaTested)
         {
@@ -274,6 +349,8 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
                 IE_Assert(false);
             }
 
+            BufferCreateDesc d{};
+            d.heapType = D3D12_HEAP_TYPE_DEFAULT;
             d.viewKind = BufferCreateDesc::ViewKind::None;
             d.createSRV = false;
             d.createUAV = false;
@@ -283,6 +360,7 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
             d.initialData = srcPrim.ommIndices;
             d.initialDataSize = srcPrim.ommIndexCount * sizeof(i32);
             d.sizeInBytes = d.initialDataSize;
+            d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
             d.name = L"Primitive/ommIndices";
             prim.ommIndices = CreateBuffer(cmd.Get(), d);
 
@@ -305,12 +383,14 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
                 d.initialData = ommDescs.data();
                 d.initialDataSize = static_cast<u32>(ommDescs.size() * sizeof(D3D12_RAYTRACING_OPACITY_MICROMAP_DESC));
                 d.sizeInBytes = d.initialDataSize;
+                d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
                 d.name = L"Primitive/ommDescs";
                 prim.ommDescs = CreateBuffer(cmd.Get(), d);
 
                 d.initialData = srcPrim.ommData;
                 d.initialDataSize = srcPrim.ommDataByteCount;
                 d.sizeInBytes = srcPrim.ommDataByteCount;
+                d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
                 d.name = L"Primitive/ommData";
                 prim.ommData = CreateBuffer(cmd.Get(), d);
 
@@ -339,28 +419,48 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
                 d.initialData = nullptr;
                 d.initialDataSize = 0u;
                 d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-                d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-                d.finalState = d.initialState;
-                d.sizeInBytes = static_cast<u32>(ommInfo.ScratchDataSizeInBytes);
-                d.name = L"Primitive/ommArrayScratch";
-                prim.ommArrayScratch = CreateBuffer(cmd.Get(), d);
-
                 d.sizeInBytes = static_cast<u32>(ommInfo.ResultDataMaxSizeInBytes);
                 d.initialState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
                 d.finalState = d.initialState;
+                d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
                 d.name = L"Primitive/ommArray";
                 prim.ommArray = CreateBuffer(nullptr, d);
 
                 D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC ommBuild{};
                 ommBuild.DestAccelerationStructureData = prim.ommArray->resource->GetGPUVirtualAddress();
                 ommBuild.Inputs = ommInputs;
-                ommBuild.ScratchAccelerationStructureData = prim.ommArrayScratch->resource->GetGPUVirtualAddress();
+                ommBuild.ScratchAccelerationStructureData = AllocateBuildScratch(cmd, ommInfo.ScratchDataSizeInBytes);
                 cmd->BuildRaytracingAccelerationStructure(&ommBuild, 0, nullptr);
-
-                const D3D12_RESOURCE_BARRIER ommBarrier = CD3DX12_RESOURCE_BARRIER::UAV(prim.ommArray->resource.Get());
-                cmd->ResourceBarrier(1, &ommBarrier);
+                ommArrayCount++;
             }
+        }
+    }
+
+    // BLAS builds below read the OMM arrays, so the last OMM batch must land first.
+    FlushBuildScratch(cmd);
+
+    for (u32 primIndex = 0; primIndex < primitives.size(); ++primIndex)
+    {
+        Primitive& prim = primitives[primIndex];
+        const LoadedPrimitive& srcPrim = loadedPrimitives[primIndex];
+        const bool alphaTested = primAlphaMode[primIndex] != static_cast<u32>(AlphaMode_Opaque);
 
+        D3D12_RAYTRACING_GEOMETRY_TRIANGLES_DESC trianglesDesc{};
+        trianglesDesc.Transform3x4 = 0;
+        trianglesDesc.IndexFormat = DXGI_FORMAT_R32_UINT;
+        trianglesDesc.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
+        trianglesDesc.IndexCount = srcPrim.indexCount;
+        trianglesDesc.VertexCount = srcPrim.vertexCount;
+        trianglesDesc.IndexBuffer = prim.rtIndices->resource->GetGPUVirtualAddress() + static_cast<u64>(prim.firstIndex) * sizeof(u32);
+        trianglesDesc.VertexBuffer.StartAddress = prim.rtVertices->resource->GetGPUVirtualAddress() + static_cast<u64>(prim.baseVertex) * sizeof(Vertex);
+        trianglesDesc.VertexBuffer.StrideInBytes = sizeof(Vertex);
+
+        D3D12_RAYTRACING_GEOMETRY_DESC geom{};
+        geom.Flags = alphaTested ? D3D12_RAYTRACING_GEOMETRY_FLAG_NONE : D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE;
+        D3D12_RAYTRACING_GEOMETRY_OMM_LINKAGE_DESC ommLinkage{};
+
+        if (alphaTested)
+        {
             ommLinkage.OpacityMicromapIndexBuffer.StartAddress = prim.ommIndices->resource->GetGPUVirtualAddress();
             ommLinkage.OpacityMicromapIndexBuffer.StrideInBytes = sizeof(i32);
             ommLinkage.OpacityMicromapIndexFormat = DXGI_FORMAT_R32_UINT;
@@ -381,23 +481,13 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
 
         D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO info{};
         device->GetRaytracingAccelerationStructurePrebuildInfo(&in, &info);
-        IE_Assert(info.ScratchDataSizeInBytes <= UINT32_MAX);
         IE_Assert(info.ResultDataMaxSizeInBytes <= UINT32_MAX);
 
-        d.initialData = nullptr;
-        d.initialDataSize = 0;
+        BufferCreateDesc d{};
+        d.heapType = D3D12_HEAP_TYPE_DEFAULT;
         d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-        d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        d.finalState = d.initialState;
-        d.viewKind = BufferCreateDesc::ViewKind::None;
-        d.createSRV = false;
-        d.createUAV = false;
-
-        d.sizeInBytes = static_cast<u32>(info.ScratchDataSizeInBytes);
-        d.name = L"BLAS Scratch";
-        prim.blasScratch = CreateBuffer(cmd.Get(), d);
-
         d.sizeInBytes = static_cast<u32>(info.ResultDataMaxSizeInBytes);
+        d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
         d.name = L"BLAS";
         d.initialState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
         d.finalState = d.initialState;
@@ -406,16 +496,24 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
         D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC build{};
         build.DestAccelerationStructureData = prim.blas->resource->GetGPUVirtualAddress();
         build.Inputs = in;
-        build.ScratchAccelerationStructureData = prim.blasScratch->resource->GetGPUVirtualAddress();
+        build.ScratchAccelerationStructureData = AllocateBuildScratch(cmd, info.ScratchDataSizeInBytes);
 
-        cmd->BuildRaytracingAccelerationStructure(&build, 0, nullptr);
-    }
+        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_DESC postbuild{};
+        postbuild.InfoType = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE;
+        postbuild.DestBuffer =
+            m_BlasCompactedSizes->resource->GetGPUVirtualAddress() + primIndex * sizeof(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC);
 
-    {
-        const D3D12_RESOURCE_BARRIER uav = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
-        cmd->ResourceBarrier(1, &uav);
+        cmd->BuildRaytracingAccelerationStructure(&build, 1, &postbuild);
+        m_BlasUncompactedBytes += info.ResultDataMaxSizeInBytes;
     }
 
+    FlushBuildScratch(cmd);
+    IE_LogInfo("Built {} BLAS(es) and {} OMM array(s) in {} scratch batch(es) sharing {:.2f} MiB", primitives.size(), ommArrayCount, m_BuildScratchBatchCount,
+               static_cast<f64>(m_BuildScratchSize) / (1024.0 * 1024.0));
+
+    m_BlasCompactedSizes->Transition(cmd, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    cmd->CopyResource(m_BlasCompactedSizesReadback->resource.Get(), m_BlasCompactedSizes->resource.Get());
+
     {
         BufferCreateDesc d{};
         d.sizeInBytes = static_cast<u32>(primInfos.size() * sizeof(RTPrimInfo));
@@ -431,28 +529,160 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
         m_RTPrimInfoBuffer = CreateBuffer(nullptr, d);
         SetBufferData(cmd, m_RTPrimInfoBuffer, primInfos.data(), d.sizeInBytes, 0);
     }
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS Raytracing::AllocateBuildScratch(const ComPtr<ID3D12GraphicsCommandList7>& cmd, u64 sizeInBytes)
+{
+    IE_Assert(sizeInBytes <= UINT32_MAX);
+    const u64 alignedSize = IE_AlignUp(static_cast<u32>(sizeInBytes), D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT);
+    if (m_BuildScratchOffset + alignedSize > m_BuildScratchSize)
+    {
+        FlushBuildScratch(cmd);
+
+        if (alignedSize > m_BuildScratchSize)
+        {
+            // Builds already recorded against the old arena keep it alive until this command list has executed.
+            if (m_BuildScratch)
+            {
+                m_RenderDevice.TrackUpload({m_BuildScratch->resource, m_BuildScratch->allocation});
+            }
+
+            const u64 budget = static_cast<u64>(g_Settings.rtBuildScratchBudgetMiB) * 1024ull * 1024ull;
+            const u64 arenaSize = IE_Max(budget, alignedSize);
+            IE_Assert(arenaSize <= UINT32_MAX);
+
+            BufferCreateDesc d{};
+            d.sizeInBytes = static_cast<u32>(arenaSize);
+            d.heapType = D3D12_HEAP_TYPE_DEFAULT;
+            d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+            d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            d.finalState = d.initialState;
+            d.memoryCategory = GpuMemoryCategory_Scratch;
+            d.name = L"AS Build Scratch";
+            m_BuildScratch = CreateBuffer(cmd.Get(), d);
+            m_BuildScratchSize = arenaSize;
+        }
+    }
+
+    const D3D12_GPU_VIRTUAL_ADDRESS address = m_BuildScratch->resource->GetGPUVirtualAddress() + m_BuildScratchOffset;
+    m_BuildScratchOffset += alignedSize;
+    return address;
+}
+
+void Raytracing::FlushBuildScratch(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
+{
+    if (m_BuildScratchOffset == 0)
+    {
+        return;
+    }
 
-    Vector<D3D12_RAYTRACING_INSTANCE_DESC> instanceDescs;
-    instanceDescs.reserve(instances.size());
+    // Every build in the batch must finish before the arena is handed out again or its results are read.
+    const D3D12_RESOURCE_BARRIER uav = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+    cmd->ResourceBarrier(1, &uav);
+    m_BuildScratchOffset = 0;
+    m_BuildScratchBatchCount++;
+}
 
+void Raytracing::CompactBottomLevel(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
+{
+    IE_Assert(m_Primitives && m_BlasCompactedSizesReadback);
+    Vector<Primitive>& primitives = *m_Primitives;
+
+    using CompactedSizeDesc = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_POSTBUILD_INFO_COMPACTED_SIZE_DESC;
+    CompactedSizeDesc* compactedSizes = nullptr;
+    const CD3DX12_RANGE readRange(0, primitives.size() * sizeof(CompactedSizeDesc));
+    IE_Check(m_BlasCompactedSizesReadback->Map(0, &readRange, reinterpret_cast<void**>(&compactedSizes)));
+
+    u64 compactedBytes = 0;
+    for (u32 primIndex = 0; primIndex < primitives.size(); ++primIndex)
+    {
+        Primitive& prim = primitives[primIndex];
+        const u64 compactedSize = compactedSizes[primIndex].CompactedSizeInBytes;
+        IE_Assert(compactedSize > 0 && compactedSize <= UINT32_MAX);
+
+        BufferCreateDesc d{};
+        d.sizeInBytes = static_cast<u32>(compactedSize);
+        d.heapType = D3D12_HEAP_TYPE_DEFAULT;
+        d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        d.initialState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
+        d.finalState = d.initialState;
+        d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
+        d.name = L"BLAS";
+        SharedPtr<Buffer> compacted = CreateBuffer(nullptr, d);
+
+        cmd->CopyRaytracingAccelerationStructure(compacted->resource->GetGPUVirtualAddress(), prim.blas->resource->GetGPUVirtualAddress(),
+                                                 D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT);
+
+        // The uncompacted source is read by the copy above, so it lives until this command list has executed.
+        m_RenderDevice.TrackUpload({prim.blas->resource, prim.blas->allocation});
+        prim.blas = compacted;
+
+        compactedBytes += compactedSize;
+    }
+
+    const CD3DX12_RANGE writeRange(0, 0);
+    m_BlasCompactedSizesReadback->Unmap(0, &writeRange);
+    // The builds that used the scratch arena have completed by now.
+    m_BuildScratch.reset();
+    m_BuildScratchSize = 0;
+    m_BlasCompactedSizesReadback.reset();
+    m_BlasCompactedSizes.reset();
+
+    const D3D12_RESOURCE_BARRIER uav = CD3DX12_RESOURCE_BARRIER::UAV(nullptr);
+    cmd->ResourceBarrier(1, &uav);
+
+    g_Stats.rtBlasUncompactedBytes = m_BlasUncompactedBytes;
+    g_Stats.rtBlasCompactedBytes = compactedBytes;
+    constexpr f64 kBytesToMiB = 1.0 / (1024.0 * 1024.0);
+    const f64 savedPct = m_BlasUncompactedBytes > 0 ? 100.0 * (1.0 - static_cast<f64>(compactedBytes) / static_cast<f64>(m_BlasUncompactedBytes)) : 0.0;
+    IE_LogInfo("Compacted {} BLAS(es): {:.2f} MiB -> {:.2f} MiB ({:.1f}% saved)", primitives.size(), static_cast<f64>(m_BlasUncompactedBytes) * kBytesToMiB,
+               static_cast<f64>(compactedBytes) * kBytesToMiB, savedPct);
+}
+
+void Raytracing::InitTopLevel(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& instances)
+{
+    IE_Assert(m_Primitives);
+    const Vector<Primitive>& primitives = *m_Primitives;
+
+    m_InstanceDescs.clear();
+    m_InstanceDescs.reserve(instances.size());
+    m_InstancePrimIndices.clear();
+    m_InstancePrimIndices.reserve(instances.size());
+    m_InstanceOmmsEnabled = g_Settings.rtOmmsEnabled;
     for (const RTInstance& inst : instances)
     {
         IE_Assert(inst.primIndex < primitives.size());
+        IE_Assert(inst.instanceIndex == m_InstanceDescs.size());
         const Primitive& prim = primitives[inst.primIndex];
 
         D3D12_RAYTRACING_INSTANCE_DESC idesc{};
         idesc.InstanceMask = 0xFF;
-        idesc.Flags = g_Settings.rtOmmsEnabled ? D3D12_RAYTRACING_INSTANCE_FLAG_NONE : D3D12_RAYTRACING_INSTANCE_FLAG_DISABLE_OMMS;
+        idesc.Flags = m_InstanceOmmsEnabled ? D3D12_RAYTRACING_INSTANCE_FLAG_NONE : D3D12_RAYTRACING_INSTANCE_FLAG_DISABLE_OMMS;
         idesc.AccelerationStructure = prim.blas->resource->GetGPUVirtualAddress();
         idesc.InstanceID = inst.primIndex;
 
         FillInstanceTransform(idesc, inst.world);
 
-        instanceDescs.push_back(idesc);
+        m_InstanceDescs.push_back(idesc);
+        m_InstancePrimIndices.push_back(inst.primIndex);
     }
 
+    m_InstanceBuildCenters.resize(instances.size());
+    m_InstancePendingSlots.assign(instances.size(), 0u);
+
+    CreateTlasResources(cmd);
+    BuildTlas(cmd, m_RenderDevice.GetCurrentBackBufferIndex(), false);
+}
+
+void Raytracing::CreateTlasResources(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
+{
+    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
+    const u32 instanceCount = static_cast<u32>(m_InstanceDescs.size());
+    IE_Assert(instanceCount > 0);
+
+    // Every frame slot owns a persistently mapped copy of the descriptors, so writing one never races the GPU reading another.
     BufferCreateDesc d{};
-    d.sizeInBytes = static_cast<u32>(instanceDescs.size() * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
+    d.sizeInBytes = instanceCount * static_cast<u32>(sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
     d.strideInBytes = 0;
     d.heapType = D3D12_HEAP_TYPE_UPLOAD;
     d.viewKind = BufferCreateDesc::ViewKind::None;
@@ -461,21 +691,23 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
     d.initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
     d.finalState = D3D12_RESOURCE_STATE_GENERIC_READ;
     d.name = L"InstanceDescs";
-    m_InstanceDescs = CreateBuffer(nullptr, d);
-
+    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
     {
-        u8* mapped = nullptr;
-        IE_Check(m_InstanceDescs->Map(0, nullptr, reinterpret_cast<void**>(&mapped)));
-        std::memcpy(mapped, instanceDescs.data(), d.sizeInBytes);
-        m_InstanceDescs->Unmap(0, nullptr);
+        if (m_InstanceDescBuffers[i] && m_InstanceDescBuffersMapped[i])
+        {
+            m_InstanceDescBuffers[i]->Unmap(0, nullptr);
+        }
+        m_InstanceDescBuffers[i] = CreateBuffer(nullptr, d);
+        IE_Check(m_InstanceDescBuffers[i]->Map(0, nullptr, reinterpret_cast<void**>(&m_InstanceDescBuffersMapped[i])));
+        std::memcpy(m_InstanceDescBuffersMapped[i], m_InstanceDescs.data(), d.sizeInBytes);
+        m_PendingInstanceWrites[i].clear();
     }
 
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs{};
     topLevelInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
     topLevelInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-    topLevelInputs.NumDescs = static_cast<UINT>(instanceDescs.size());
+    topLevelInputs.NumDescs = instanceCount;
     topLevelInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    topLevelInputs.InstanceDescs = m_InstanceDescs->resource->GetGPUVirtualAddress();
 
     D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO topInfo{};
     device->GetRaytracingAccelerationStructurePrebuildInfo(&topLevelInputs, &topInfo);
@@ -484,141 +716,161 @@ void Raytracing::InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Ve
     d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
     d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
     d.finalState = d.initialState;
-    d.sizeInBytes = static_cast<u32>(topInfo.ScratchDataSizeInBytes);
+    d.sizeInBytes = static_cast<u32>(IE_Max(topInfo.ScratchDataSizeInBytes, topInfo.UpdateScratchDataSizeInBytes));
+    d.memoryCategory = GpuMemoryCategory_Scratch;
     d.name = L"TLAS Scratch";
     m_TlasScratch = CreateBuffer(cmd.Get(), d);
 
     d.sizeInBytes = static_cast<u32>(topInfo.ResultDataMaxSizeInBytes);
+    d.memoryCategory = GpuMemoryCategory_AccelerationStructures;
     d.name = L"TLAS";
     d.initialState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
     d.finalState = d.initialState;
     m_Tlas = CreateBuffer(nullptr, d);
 
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC topBuild{};
-    topBuild.DestAccelerationStructureData = m_Tlas->resource->GetGPUVirtualAddress();
-    topBuild.Inputs = topLevelInputs;
-    topBuild.ScratchAccelerationStructureData = m_TlasScratch->resource->GetGPUVirtualAddress();
-
-    cmd->BuildRaytracingAccelerationStructure(&topBuild, 0, nullptr);
-
     D3D12_SHADER_RESOURCE_VIEW_DESC tlasSrvDesc{};
     tlasSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_RAYTRACING_ACCELERATION_STRUCTURE;
     tlasSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     tlasSrvDesc.RaytracingAccelerationStructure.Location = m_Tlas->resource->GetGPUVirtualAddress();
     m_TlasSrvIndex = m_BindlessHeaps.CreateSRV(nullptr, tlasSrvDesc);
-    m_InstanceCount = static_cast<u32>(instanceDescs.size());
+    m_InstanceCount = instanceCount;
 }
 
-void Raytracing::UpdateInstances(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& instances)
+void Raytracing::QueueInstanceWrite(u32 instanceIndex)
 {
-    if (!cmd)
+    u8& pendingSlots = m_InstancePendingSlots[instanceIndex];
+    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
     {
-        return;
+        const u8 slotBit = static_cast<u8>(1u << i);
+        if (!(pendingSlots & slotBit))
+        {
+            pendingSlots |= slotBit;
+            m_PendingInstanceWrites[i].push_back(instanceIndex);
+        }
     }
-    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
+}
 
-    if (instances.empty())
+void Raytracing::FlushInstanceWrites(u32 frameInFlightIdx)
+{
+    const u8 slotBit = static_cast<u8>(1u << frameInFlightIdx);
+    D3D12_RAYTRACING_INSTANCE_DESC* mapped = m_InstanceDescBuffersMapped[frameInFlightIdx];
+    for (u32 instanceIndex : m_PendingInstanceWrites[frameInFlightIdx])
     {
-        return;
+        mapped[instanceIndex] = m_InstanceDescs[instanceIndex];
+        m_InstancePendingSlots[instanceIndex] &= static_cast<u8>(~slotBit);
     }
-    Vector<D3D12_RAYTRACING_INSTANCE_DESC> instanceDescs;
-    instanceDescs.reserve(instances.size());
+    m_PendingInstanceWrites[frameInFlightIdx].clear();
+}
 
-    if (!m_Primitives)
-    {
-        return;
-    }
-    const Vector<Primitive>& primitives = *m_Primitives;
-    for (const RTInstance& inst : instances)
+void Raytracing::BuildTlas(const ComPtr<ID3D12GraphicsCommandList7>& cmd, u32 frameInFlightIdx, bool refit)
+{
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs{};
+    topLevelInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
+    topLevelInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
+    if (refit)
     {
-        IE_Assert(inst.primIndex < primitives.size());
-        const Primitive& prim = primitives[inst.primIndex];
-
-        D3D12_RAYTRACING_INSTANCE_DESC idesc{};
-        idesc.InstanceMask = 0xFF;
-        idesc.Flags = g_Settings.rtOmmsEnabled ? D3D12_RAYTRACING_INSTANCE_FLAG_NONE : D3D12_RAYTRACING_INSTANCE_FLAG_DISABLE_OMMS;
-        idesc.AccelerationStructure = prim.blas->resource->GetGPUVirtualAddress();
-        idesc.InstanceID = inst.primIndex;
-        FillInstanceTransform(idesc, inst.world);
-
-        instanceDescs.push_back(idesc);
+        topLevelInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
     }
+    topLevelInputs.NumDescs = m_InstanceCount;
+    topLevelInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
+    topLevelInputs.InstanceDescs = m_InstanceDescBuffers[frameInFlightIdx]->resource->GetGPUVirtualAddress();
 
-    const bool countChanged = (m_InstanceCount != static_cast<u32>(instanceDescs.size()));
-    if (countChanged || !m_InstanceDescs || !m_Tlas || !m_TlasScratch)
+    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC topBuild{};
+    topBuild.Inputs = topLevelInputs;
+    topBuild.ScratchAccelerationStructureData = m_TlasScratch->resource->GetGPUVirtualAddress();
+    topBuild.DestAccelerationStructureData = m_Tlas->resource->GetGPUVirtualAddress();
+    if (refit)
     {
-        BufferCreateDesc d{};
-        d.sizeInBytes = static_cast<u32>(instanceDescs.size() * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
-        d.strideInBytes = 0;
-        d.heapType = D3D12_HEAP_TYPE_UPLOAD;
-        d.viewKind = BufferCreateDesc::ViewKind::None;
-        d.createSRV = false;
-        d.createUAV = false;
-        d.initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
-        d.finalState = D3D12_RESOURCE_STATE_GENERIC_READ;
-        d.name = L"InstanceDescs";
-        m_InstanceDescs = CreateBuffer(nullptr, d);
-
-        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs{};
-        topLevelInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-        topLevelInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-        topLevelInputs.NumDescs = static_cast<UINT>(instanceDescs.size());
-        topLevelInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-        topLevelInputs.InstanceDescs = m_InstanceDescs->resource->GetGPUVirtualAddress();
-
-        D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO topInfo{};
-        device->GetRaytracingAccelerationStructurePrebuildInfo(&topLevelInputs, &topInfo);
+        topBuild.SourceAccelerationStructureData = m_Tlas->resource->GetGPUVirtualAddress();
+    }
+    cmd->BuildRaytracingAccelerationStructure(&topBuild, 0, nullptr);
 
-        d.heapType = D3D12_HEAP_TYPE_DEFAULT;
-        d.resourceFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
-        d.initialState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        d.finalState = d.initialState;
-        d.sizeInBytes = static_cast<u32>(topInfo.ScratchDataSizeInBytes);
-        d.name = L"TLAS Scratch";
-        m_TlasScratch = CreateBuffer(cmd.Get(), d);
+    const D3D12_RESOURCE_BARRIER uav = CD3DX12_RESOURCE_BARRIER::UAV(m_Tlas->resource.Get());
+    cmd->ResourceBarrier(1, &uav);
 
-        d.sizeInBytes = static_cast<u32>(topInfo.ResultDataMaxSizeInBytes);
-        d.name = L"TLAS";
-        d.initialState = D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE;
-        d.finalState = d.initialState;
-        m_Tlas = CreateBuffer(nullptr, d);
+    if (!refit)
+    {
+        // A full build re-sorts the hierarchy around the current positions, so drift starts over.
+        const Vector<Primitive>& primitives = *m_Primitives;
+        for (u32 i = 0; i < m_InstanceCount; ++i)
+        {
+            const D3D12_RAYTRACING_INSTANCE_DESC& idesc = m_InstanceDescs[i];
+            const XMFLOAT3& c = primitives[m_InstancePrimIndices[i]].localBoundsCenter;
+            m_InstanceBuildCenters[i] = {idesc.Transform[0][0] * c.x + idesc.Transform[0][1] * c.y + idesc.Transform[0][2] * c.z + idesc.Transform[0][3],
+                                         idesc.Transform[1][0] * c.x + idesc.Transform[1][1] * c.y + idesc.Transform[1][2] * c.z + idesc.Transform[1][3],
+                                         idesc.Transform[2][0] * c.x + idesc.Transform[2][1] * c.y + idesc.Transform[2][2] * c.z + idesc.Transform[2][3]};
+        }
+        m_InstanceDrift.assign(m_InstanceCount, 0.0f);
+        m_TlasTotalDrift = 0.0f;
+        m_TlasMaxDrift = 0.0f;
+    }
 
-        D3D12_SHADER_RESOURCE_VIEW_DESC tlasSrvDesc{};
-        tlasSrvDesc.ViewDimension = D3D12_SRV_DIMENSION_RAYTRACING_ACCELERATION_STRUCTURE;
-        tlasSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        tlasSrvDesc.RaytracingAccelerationStructure.Location = m_Tlas->resource->GetGPUVirtualAddress();
-        m_TlasSrvIndex = m_BindlessHeaps.CreateSRV(nullptr, tlasSrvDesc);
+    g_Stats.rtTlasRefit = refit;
+    g_Stats.rtTlasDrift = m_InstanceCount > 0 ? m_TlasTotalDrift / static_cast<f32>(m_InstanceCount) : 0.0f;
+    g_Stats.rtTlasMaxDrift = m_TlasMaxDrift;
+}
 
-        m_InstanceCount = static_cast<u32>(instanceDescs.size());
+void Raytracing::UpdateInstances(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& changedInstances)
+{
+    if (!cmd || !m_Primitives || m_InstanceCount == 0)
+    {
+        return;
     }
+    const Vector<Primitive>& primitives = *m_Primitives;
 
+    bool rebuild = false;
+    if (m_InstanceOmmsEnabled != g_Settings.rtOmmsEnabled)
     {
-        u8* mapped = nullptr;
-        IE_Check(m_InstanceDescs->Map(0, nullptr, reinterpret_cast<void**>(&mapped)));
-        std::memcpy(mapped, instanceDescs.data(), instanceDescs.size() * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
-        m_InstanceDescs->Unmap(0, nullptr);
+        m_InstanceOmmsEnabled = g_Settings.rtOmmsEnabled;
+        const D3D12_RAYTRACING_INSTANCE_FLAGS flags = m_InstanceOmmsEnabled ? D3D12_RAYTRACING_INSTANCE_FLAG_NONE : D3D12_RAYTRACING_INSTANCE_FLAG_DISABLE_OMMS;
+        for (u32 i = 0; i < m_InstanceCount; ++i)
+        {
+            m_InstanceDescs[i].Flags = flags;
+            QueueInstanceWrite(i);
+        }
+        // Instance flags feed the traversal hierarchy, so a refit is not allowed to change them.
+        rebuild = true;
     }
 
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS topLevelInputs{};
-    topLevelInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
-    topLevelInputs.Flags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
-    if (!countChanged)
+    if (changedInstances.empty() && !rebuild)
     {
-        topLevelInputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+        return;
     }
-    topLevelInputs.NumDescs = static_cast<UINT>(instanceDescs.size());
-    topLevelInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
-    topLevelInputs.InstanceDescs = m_InstanceDescs->resource->GetGPUVirtualAddress();
 
-    D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC topBuild{};
-    topBuild.Inputs = topLevelInputs;
-    topBuild.ScratchAccelerationStructureData = m_TlasScratch->resource->GetGPUVirtualAddress();
-    topBuild.DestAccelerationStructureData = m_Tlas->resource->GetGPUVirtualAddress();
-    if (!countChanged)
+    for (const RTInstance& inst : changedInstances)
     {
-        topBuild.SourceAccelerationStructureData = m_Tlas->resource->GetGPUVirtualAddress();
+        IE_Assert(inst.instanceIndex < m_InstanceCount);
+        IE_Assert(inst.primIndex == m_InstancePrimIndices[inst.instanceIndex]);
+        const Primitive& prim = primitives[inst.primIndex];
+
+        FillInstanceTransform(m_InstanceDescs[inst.instanceIndex], inst.world);
+        QueueInstanceWrite(inst.instanceIndex);
+
+        const XMFLOAT3 center = ComputeWorldBoundsCenter(prim, inst.world);
+        const XMFLOAT3& buildCenter = m_InstanceBuildCenters[inst.instanceIndex];
+        const f32 dx = center.x - buildCenter.x;
+        const f32 dy = center.y - buildCenter.y;
+        const f32 dz = center.z - buildCenter.z;
+        const f32 radius = IE_Max(prim.localBoundsRadius * ComputeMaxWorldScale(inst.world), kMinDriftRadius);
+        const f32 unclampedDrift = IE_Sqrt(dx * dx + dy * dy + dz * dz) / radius;
+        const f32 drift = IE_Min(unclampedDrift, kMaxInstanceDrift);
+
+        // Kept as a high-water mark until the next full build: an instance that moved away and back still left a refitted box behind.
+        m_TlasMaxDrift = IE_Max(m_TlasMaxDrift, unclampedDrift);
+        m_TlasTotalDrift += drift - m_InstanceDrift[inst.instanceIndex];
+        m_InstanceDrift[inst.instanceIndex] = drift;
     }
-    cmd->BuildRaytracingAccelerationStructure(&topBuild, 0, nullptr);
+    m_TlasTotalDrift = IE_Max(m_TlasTotalDrift, 0.0f);
+
+    const u32 frameInFlightIdx = m_RenderDevice.GetCurrentBackBufferIndex();
+    FlushInstanceWrites(frameInFlightIdx);
+
+    // Refitting keeps the hierarchy built for the old positions; once instances have wandered far enough its boxes overlap and traversal slows down.
+    // The mean catches many small moves, the maximum catches a few instances moving far in a large scene.
+    rebuild = rebuild || m_TlasTotalDrift > g_Settings.rtTlasRebuildDrift * static_cast<f32>(m_InstanceCount);
+    rebuild = rebuild || m_TlasMaxDrift > g_Settings.rtTlasRebuildMaxDrift;
+    BuildTlas(cmd, frameInFlightIdx, !rebuild);
+    g_Stats.rtTlasUpdatedInstances = static_cast<u32>(changedInstances.size());
 }
 
 void Raytracing::CreatePathTracePassResources(const XMUINT2& renderSize)
@@ -635,11 +887,13 @@ void Raytracing::CreatePathTracePassResources(const XMUINT2& renderSize)
                                              IID_PPV_ARGS(&m_PathTrace.trace.outputTexture.resource)));
     m_PathTrace.trace.outputTexture.state = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
     m_PathTrace.trace.outputTexture.SetName(L"Path-Traced Lighting");
+    GpuMemory::Track(m_PathTrace.trace.outputTexture.Get(), GpuMemoryCategory_RenderTargets);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC outUavDesc{};
     outUavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
     outUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
     m_PathTrace.trace.outputTexture.uavIndex = m_BindlessHeaps.CreateUAV(m_PathTrace.trace.outputTexture.resource, outUavDesc);
+    m_PathTrace.trace.outputTexture.uavGeneration = m_BindlessHeaps.GetGeneration(m_PathTrace.trace.outputTexture.uavIndex);
 
     D3D12_SHADER_RESOURCE_VIEW_DESC outSrvDesc{};
     outSrvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
@@ -647,16 +901,19 @@ void Raytracing::CreatePathTracePassResources(const XMUINT2& renderSize)
     outSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     outSrvDesc.Texture2D.MipLevels = 1;
     m_PathTrace.trace.outputTexture.srvIndex = m_BindlessHeaps.CreateSRV(m_PathTrace.trace.outputTexture.resource, outSrvDesc);
+    m_PathTrace.trace.outputTexture.srvGeneration = m_BindlessHeaps.GetGeneration(m_PathTrace.trace.outputTexture.srvIndex);
 
     IE_Check(device->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &hitDistanceDesc, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, nullptr,
                                              IID_PPV_ARGS(&m_PathTrace.trace.hitDistanceTexture.resource)));
     m_PathTrace.trace.hitDistanceTexture.state = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
     m_PathTrace.trace.hitDistanceTexture.SetName(L"Path-Traced Lighting Specular Hit Distance");
+    GpuMemory::Track(m_PathTrace.trace.hitDistanceTexture.Get(), GpuMemoryCategory_RenderTargets);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC hitDistanceUavDesc{};
     hitDistanceUavDesc.Format = DXGI_FORMAT_R16_FLOAT;
     hitDistanceUavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
     m_PathTrace.trace.hitDistanceTexture.uavIndex = m_BindlessHeaps.CreateUAV(m_PathTrace.trace.hitDistanceTexture.resource, hitDistanceUavDesc);
+    m_PathTrace.trace.hitDistanceTexture.uavGeneration = m_BindlessHeaps.GetGeneration(m_PathTrace.trace.hitDistanceTexture.uavIndex);
 
     D3D12_SHADER_RESOURCE_VIEW_DESC hitDistanceSrvDesc{};
     hitDistanceSrvDesc.Format = DXGI_FORMAT_R16_FLOAT;
@@ -664,6 +921,7 @@ void Raytracing::CreatePathTracePassResources(const XMUINT2& renderSize)
     hitDistanceSrvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
     hitDistanceSrvDesc.Texture2D.MipLevels = 1;
     m_PathTrace.trace.hitDistanceTexture.srvIndex = m_BindlessHeaps.CreateSRV(m_PathTrace.trace.hitDistanceTexture.resource, hitDistanceSrvDesc);
+    m_PathTrace.trace.hitDistanceTexture.srvGeneration = m_BindlessHeaps.GetGeneration(m_PathTrace.trace.hitDistanceTexture.srvIndex);
 }
 
 void Raytracing::InvalidatePathTraceDescriptorIndices()
@@ -680,7 +938,6 @@ void Raytracing::CreatePathTracePassPipelines()
     RequireOpacityMicromapSupport(device);
     RequireShaderExecutionReorderingSupport(device);
 
-    Shader::ReloadOrCreate(m_PathTrace.trace.shader, IE_SHADER_TYPE_LIB, "systems/raytracing/lighting/path_trace.rt.hlsl", {});
     CreateGlobalRootSigConstants(device, sizeof(PathTraceConstants) / sizeof(u32), m_PathTrace.trace.rootSig);
 
     CD3DX12_STATE_OBJECT_DESC raytracingPipeline{D3D12_STATE_OBJECT_TYPE_RAYTRACING_PIPELINE};
@@ -26,6 +26,7 @@ class Raytracing
 
     struct RTInstance
     {
+        u32 instanceIndex;
         u32 primIndex;
         u32 materialIndex;
         u32 alphaMode;
@@ -34,11 +35,18 @@ class Raytracing
 
     void Init(ComPtr<ID3D12GraphicsCommandList7>& cmd, const XMUINT2& renderSize, Vector<Primitive>& primitives, const Vector<LoadedPrimitive>& loadedPrimitives,
               const Vector<RTInstance>& instances);
-    void ReloadShaders();
+    void QueueShaders(ShaderCompileQueue& shaderQueue);
+    void CreatePipelines(const ShaderCompileQueue& shaderQueue);
+    // The shader tables hold identifiers of the state object, so they are retired along with it.
+    void CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const;
 
     void InitRaytracingWorld(ComPtr<ID3D12GraphicsCommandList7>& cmd, Vector<Primitive>& primitives, const Vector<LoadedPrimitive>& loadedPrimitives,
                              const Vector<RTInstance>& instances);
-    void UpdateInstances(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& instances);
+    // Both run on a fresh command list after the one passed to Init() has executed, since compacted sizes are read back from the GPU.
+    void CompactBottomLevel(const ComPtr<ID3D12GraphicsCommandList7>& cmd);
+    void InitTopLevel(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& instances);
+    // Takes only the instances whose transform changed; the TLAS is refit in place until accumulated drift asks for a full rebuild.
+    void UpdateInstances(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<RTInstance>& changedInstances);
 
     void CreatePathTracePassResources(const XMUINT2& renderSize);
     void CreatePathTracePassPipelines();
@@ -87,13 +95,40 @@ class Raytracing
     SharedPtr<Buffer> CreateBuffer(ID3D12GraphicsCommandList7* cmd, const BufferCreateDesc& createDesc);
     void SetBufferData(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes, u32 offsetInBytes = 0);
 
+    D3D12_GPU_VIRTUAL_ADDRESS AllocateBuildScratch(const ComPtr<ID3D12GraphicsCommandList7>& cmd, u64 sizeInBytes);
+    void FlushBuildScratch(const ComPtr<ID3D12GraphicsCommandList7>& cmd);
+    void CreateTlasResources(const ComPtr<ID3D12GraphicsCommandList7>& cmd);
+    void QueueInstanceWrite(u32 instanceIndex);
+    void FlushInstanceWrites(u32 frameInFlightIdx);
+    void BuildTlas(const ComPtr<ID3D12GraphicsCommandList7>& cmd, u32 frameInFlightIdx, bool refit);
+
     RenderDevice& m_RenderDevice;
     BindlessHeaps& m_BindlessHeaps;
     Camera& m_Camera;
 
+    // Shared by every BLAS and OMM array build during scene load, released once the builds have executed.
+    SharedPtr<Buffer> m_BuildScratch;
+    u64 m_BuildScratchSize = 0;
+    u64 m_BuildScratchOffset = 0;
+    u32 m_BuildScratchBatchCount = 0;
+
+    SharedPtr<Buffer> m_BlasCompactedSizes;
+    SharedPtr<Buffer> m_BlasCompactedSizesReadback;
+    u64 m_BlasUncompactedBytes = 0;
+
     SharedPtr<Buffer> m_TlasScratch;
     SharedPtr<Buffer> m_Tlas;
-    SharedPtr<Buffer> m_InstanceDescs;
+    Array<SharedPtr<Buffer>, IE_Constants::frameInFlightCount> m_InstanceDescBuffers;
+    Array<D3D12_RAYTRACING_INSTANCE_DESC*, IE_Constants::frameInFlightCount> m_InstanceDescBuffersMapped{};
+    Array<Vector<u32>, IE_Constants::frameInFlightCount> m_PendingInstanceWrites; // instances whose descriptor is stale in that frame slot
+    Vector<D3D12_RAYTRACING_INSTANCE_DESC> m_InstanceDescs;                        // authoritative copy, slots catch up when they next build
+    Vector<u8> m_InstancePendingSlots;                                             // bit per frame slot already queued in m_PendingInstanceWrites
+    Vector<u32> m_InstancePrimIndices;
+    Vector<XMFLOAT3> m_InstanceBuildCenters; // world bounds center at the last full build
+    Vector<f32> m_InstanceDrift;             // distance from m_InstanceBuildCenters in bounding radii
+    f32 m_TlasTotalDrift = 0.0f;
+    f32 m_TlasMaxDrift = 0.0f; // largest unclamped instance drift since the last full build
+    bool m_InstanceOmmsEnabled = true;
     Vector<Primitive>* m_Primitives = nullptr;
 
     u32 m_TlasSrvIndex = UINT_MAX;
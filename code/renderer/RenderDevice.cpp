@@ -5,6 +5,7 @@
 
 #include "RenderDevice.h"
 
+#include <algorithm>
 #include <sl.h>
 #include <sl_helpers.h>
 
@@ -17,6 +18,11 @@
 
 namespace
 {
+constexpr u64 kUploadRingCapacity = 64ull * 1024ull * 1024ull;
+// A single upload takes at most this much of the ring, so large copies stream through it instead of waiting for it to drain.
+constexpr u64 kMaxUploadChunk = kUploadRingCapacity / 4;
+constexpr u64 kBufferUploadAlignment = 16;
+
 template <typename T> ComPtr<T> CreateStreamlineProxy(const ComPtr<T>& nativeInterface, const char* debugName)
 {
     if (!nativeInterface)
@@ -52,12 +58,16 @@ void RenderDevice::Init(const Window& window, const XMUINT2& presentSize)
     CreateSwapchain(window, presentSize);
     CreateCommands();
     CreateFrameSynchronizationFences();
+    m_UploadRing.Init(m_Allocator.Get(), m_Device.Get(), kUploadRingCapacity);
 }
 
 void RenderDevice::Terminate()
 {
     IE_SetDeviceRemovedReasonDevice(nullptr);
 
+    ReleaseAllRetiredObjects();
+    m_UploadRing.Terminate();
+
     for (PerFrameData& frameData : m_AllFrameData)
     {
         if (frameData.fenceEvent)
@@ -136,6 +146,17 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
     out->SetName(createDesc.name);
     out->state = createState;
 
+    GpuMemoryCategory memoryCategory = createDesc.memoryCategory;
+    if (memoryCategory == GpuMemoryCategory_Other && createDesc.heapType == D3D12_HEAP_TYPE_UPLOAD)
+    {
+        memoryCategory = GpuMemoryCategory_Upload;
+    }
+    else if (memoryCategory == GpuMemoryCategory_Other && createDesc.heapType == D3D12_HEAP_TYPE_READBACK)
+    {
+        memoryCategory = GpuMemoryCategory_Readback;
+    }
+    GpuMemory::Track(out->Get(), memoryCategory, out->allocation->GetSize());
+
     D3D12_RESOURCE_STATES desiredState = createDesc.initialState;
     if (hasInitData && createDesc.finalState != D3D12_RESOURCE_STATE_COMMON)
     {
@@ -168,34 +189,14 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
             IE_Assert(createDesc.heapType == D3D12_HEAP_TYPE_DEFAULT);
             IE_Assert(cmd != nullptr);
 
-            UploadTemp staging{};
-            const D3D12_RESOURCE_DESC upDesc = CD3DX12_RESOURCE_DESC::Buffer(createDesc.initialDataSize);
-
-            D3D12MA::ALLOCATION_DESC upAlloc{};
-            upAlloc.HeapType = D3D12_HEAP_TYPE_UPLOAD;
-
-            IE_Check(m_Allocator->CreateResource(&upAlloc, &upDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, staging.allocation.ReleaseAndGetAddressOf(),
-                                                 IID_PPV_ARGS(staging.resource.ReleaseAndGetAddressOf())));
-
-            IE_Check(staging.resource->SetName(L"BufferInit/Upload"));
-
-            u8* mapped = nullptr;
-            const CD3DX12_RANGE readRange(0, 0);
-            IE_Check(staging.resource->Map(0, &readRange, reinterpret_cast<void**>(&mapped)));
-            std::memcpy(mapped, createDesc.initialData, createDesc.initialDataSize);
-            const CD3DX12_RANGE writeRange(0, createDesc.initialDataSize);
-            staging.resource->Unmap(0, &writeRange);
-
             TransitionIfNeeded(D3D12_RESOURCE_STATE_COPY_DEST);
 
-            cmd->CopyBufferRegion(out->Get(), 0, staging.resource.Get(), 0, createDesc.initialDataSize);
+            UploadBufferData(bindlessHeaps, cmd, out->Get(), 0, createDesc.initialData, createDesc.initialDataSize);
 
             if (desiredState != D3D12_RESOURCE_STATE_COPY_DEST)
             {
                 TransitionIfNeeded(desiredState);
             }
-
-            TrackUpload(std::move(staging));
         }
     }
     else if (cmd && createDesc.heapType == D3D12_HEAP_TYPE_DEFAULT && createDesc.initialState != D3D12_RESOURCE_STATE_COMMON)
@@ -230,6 +231,7 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
             srv.Buffer.NumElements = n;
             srv.Buffer.StructureByteStride = createDesc.strideInBytes;
             out->srvIndex = bindlessHeaps.CreateSRV(out->resource, srv);
+            out->srvGeneration = bindlessHeaps.GetGeneration(out->srvIndex);
         }
 
         if (createDesc.createUAV)
@@ -241,6 +243,7 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
             uav.Buffer.NumElements = n;
             uav.Buffer.StructureByteStride = createDesc.strideInBytes;
             out->uavIndex = bindlessHeaps.CreateUAV(out->resource, uav);
+            out->uavGeneration = bindlessHeaps.GetGeneration(out->uavIndex);
         }
     }
     else if (createDesc.viewKind == BufferCreateDesc::ViewKind::Raw)
@@ -263,6 +266,7 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
             srv.Buffer.NumElements = n;
             srv.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
             out->srvIndex = bindlessHeaps.CreateSRV(out->resource, srv);
+            out->srvGeneration = bindlessHeaps.GetGeneration(out->srvIndex);
         }
 
         if (createDesc.createUAV)
@@ -274,6 +278,7 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
             uav.Buffer.NumElements = n;
             uav.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW;
             out->uavIndex = bindlessHeaps.CreateUAV(out->resource, uav);
+            out->uavGeneration = bindlessHeaps.GetGeneration(out->uavIndex);
         }
     }
     else
@@ -285,28 +290,86 @@ SharedPtr<Buffer> RenderDevice::CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D1
     return out;
 }
 
-void RenderDevice::SetBufferData(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes, u32 offsetInBytes)
+void RenderDevice::SetBufferData(BindlessHeaps& bindlessHeaps, const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes,
+                                 u32 offsetInBytes)
 {
-    UploadTemp staging{};
-
-    D3D12_RESOURCE_DESC upDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeInBytes);
-    D3D12MA::ALLOCATION_DESC upAlloc{};
-    upAlloc.HeapType = D3D12_HEAP_TYPE_UPLOAD;
-    IE_Check(m_Allocator->CreateResource(&upAlloc, &upDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, staging.allocation.ReleaseAndGetAddressOf(),
-                                         IID_PPV_ARGS(staging.resource.ReleaseAndGetAddressOf())));
-    IE_Check(staging.resource->SetName(L"SetBufferData/Upload"));
-
-    u8* mapped = nullptr;
-    IE_Check(staging.resource->Map(0, nullptr, reinterpret_cast<void**>(&mapped)));
-    std::memcpy(mapped, data, sizeInBytes);
-    staging.resource->Unmap(0, nullptr);
-
     const D3D12_RESOURCE_STATES before = dst->state;
     dst->Transition(cmd, D3D12_RESOURCE_STATE_COPY_DEST);
-    cmd->CopyBufferRegion(dst->Get(), offsetInBytes, staging.resource.Get(), 0, sizeInBytes);
+    UploadBufferData(bindlessHeaps, cmd.Get(), dst->Get(), offsetInBytes, data, sizeInBytes);
     dst->Transition(cmd, before);
+}
 
-    TrackUpload(std::move(staging));
+void RenderDevice::UploadBufferData(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, ID3D12Resource* dst, const u64 dstOffset, const void* data, const u64 sizeInBytes)
+{
+    const u8* src = static_cast<const u8*>(data);
+    for (u64 copied = 0; copied < sizeInBytes;)
+    {
+        const u64 chunkSize = std::min(sizeInBytes - copied, kMaxUploadChunk);
+        const UploadRing::Allocation staging = AllocateUpload(bindlessHeaps, cmd, chunkSize, kBufferUploadAlignment);
+        std::memcpy(staging.cpuAddress, src + copied, chunkSize);
+        cmd->CopyBufferRegion(dst, dstOffset + copied, staging.resource, staging.offset, chunkSize);
+        copied += chunkSize;
+    }
+}
+
+void RenderDevice::UploadTextureData(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, ID3D12Resource* dst, const u32 firstSubresource, const u32 subresourceCount,
+                                     const D3D12_SUBRESOURCE_DATA* subresources)
+{
+    const D3D12_RESOURCE_DESC desc = dst->GetDesc();
+    for (u32 i = 0; i < subresourceCount; ++i)
+    {
+        const u32 subresource = firstSubresource + i;
+        const D3D12_SUBRESOURCE_DATA& src = subresources[i];
+
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint{};
+        UINT numRows = 0;
+        UINT64 rowSizeInBytes = 0;
+        m_Device->GetCopyableFootprints(&desc, subresource, 1, 0, &footprint, &numRows, &rowSizeInBytes, nullptr);
+        IE_Assert(numRows > 0 && footprint.Footprint.Height % numRows == 0);
+
+        const u64 rowPitch = footprint.Footprint.RowPitch;
+        const u32 blockHeight = footprint.Footprint.Height / numRows;
+
+        // Copies rowCount block rows of sliceCount depth slices, starting at (firstRow, firstSlice).
+        auto copyRegion = [&](const u32 firstSlice, const u32 sliceCount, const u32 firstRow, const u32 rowCount) {
+            const u64 slicePitch = rowPitch * rowCount;
+            const UploadRing::Allocation staging = AllocateUpload(bindlessHeaps, cmd, slicePitch * sliceCount, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+            for (u32 z = 0; z < sliceCount; ++z)
+            {
+                const u8* srcSlice = static_cast<const u8*>(src.pData) + static_cast<size_t>(firstSlice + z) * src.SlicePitch;
+                u8* dstSlice = staging.cpuAddress + z * slicePitch;
+                for (u32 row = 0; row < rowCount; ++row)
+                {
+                    std::memcpy(dstSlice + row * rowPitch, srcSlice + static_cast<size_t>(firstRow + row) * src.RowPitch, rowSizeInBytes);
+                }
+            }
+
+            D3D12_PLACED_SUBRESOURCE_FOOTPRINT placed = footprint;
+            placed.Offset = staging.offset;
+            placed.Footprint.Height = rowCount * blockHeight;
+            placed.Footprint.Depth = sliceCount;
+
+            const CD3DX12_TEXTURE_COPY_LOCATION dstLocation(dst, subresource);
+            const CD3DX12_TEXTURE_COPY_LOCATION srcLocation(staging.resource, placed);
+            cmd->CopyTextureRegion(&dstLocation, 0, firstRow * blockHeight, firstSlice, &srcLocation, nullptr);
+        };
+
+        const u32 depth = footprint.Footprint.Depth;
+        if (rowPitch * numRows * depth <= kMaxUploadChunk)
+        {
+            copyRegion(0, depth, 0, numRows);
+            continue;
+        }
+
+        const u32 rowsPerChunk = static_cast<u32>(std::clamp<u64>(kMaxUploadChunk / rowPitch, 1, numRows));
+        for (u32 z = 0; z < depth; ++z)
+        {
+            for (u32 row = 0; row < numRows; row += rowsPerChunk)
+            {
+                copyRegion(z, 1, row, std::min(rowsPerChunk, numRows - row));
+            }
+        }
+    }
 }
 
 void RenderDevice::CreateGPUTimers(TimingState& timingState)
@@ -326,6 +389,7 @@ void RenderDevice::CreateGPUTimers(TimingState& timingState)
         const CD3DX12_HEAP_PROPERTIES hp(D3D12_HEAP_TYPE_READBACK);
         IE_Check(m_Device->CreateCommittedResource(&hp, D3D12_HEAP_FLAG_NONE, &rb, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&frameData.gpuTimers.readback)));
         IE_Check(frameData.gpuTimers.readback->SetName(L"GpuTimers Readback"));
+        GpuMemory::Track(frameData.gpuTimers.readback.Get(), GpuMemoryCategory_Readback);
 
         frameData.gpuTimers.nextIdx = 0;
         frameData.gpuTimers.passCount = 0;
@@ -358,6 +422,7 @@ void RenderDevice::ExecuteFrame(const PerFrameData& frameData, const ComPtr<ID3D
 
     Streamline::SetPCLMarker(sl::PCLMarker::eRenderSubmitStart, streamlineFrameIndex);
     m_CommandQueue->ExecuteCommandLists(1, &pCmdList);
+    m_UploadRing.Submit(m_CommandQueue.Get());
     IE_Check(m_CommandQueue->Signal(frameData.frameFence.Get(), frameData.frameFenceValue));
     Streamline::SetPCLMarker(sl::PCLMarker::eRenderSubmitEnd, streamlineFrameIndex);
 
@@ -372,6 +437,7 @@ void RenderDevice::ExecuteAndWait(PerFrameData& frameData, const ComPtr<ID3D12Gr
     IE_Check(cmd->Close());
     ID3D12CommandList* pCmdList = cmd.Get();
     m_CommandQueue->ExecuteCommandLists(1, &pCmdList);
+    m_UploadRing.Submit(m_CommandQueue.Get());
 
     const u64 signalValue = frameData.frameFenceValue + 1;
     IE_Check(m_CommandQueue->Signal(frameData.frameFence.Get(), signalValue));
@@ -402,6 +468,31 @@ void RenderDevice::ClearAllTrackedUploads()
     }
 }
 
+void RenderDevice::RetireObjects(Vector<ComPtr<ID3D12DeviceChild>>&& objects)
+{
+    Vector<ComPtr<ID3D12DeviceChild>>& retired = m_RetiredObjects[GetCurrentBackBufferIndex()];
+    for (ComPtr<ID3D12DeviceChild>& object : objects)
+    {
+        if (object)
+        {
+            retired.push_back(std::move(object));
+        }
+    }
+}
+
+void RenderDevice::ReleaseRetiredObjects(u32 frameInFlightIdx)
+{
+    m_RetiredObjects[frameInFlightIdx].clear();
+}
+
+void RenderDevice::ReleaseAllRetiredObjects()
+{
+    for (Vector<ComPtr<ID3D12DeviceChild>>& retired : m_RetiredObjects)
+    {
+        retired.clear();
+    }
+}
+
 u32 RenderDevice::GetCurrentBackBufferIndex() const
 {
     IE_Assert(m_Swapchain != nullptr);
@@ -618,3 +709,36 @@ void RenderDevice::CreateCommands()
         m_AllFrameData[i].cmd->Close();
     }
 }
+
+UploadRing::Allocation RenderDevice::AllocateUpload(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, const u64 size, const u64 alignment)
+{
+    UploadRing::Allocation allocation{};
+    while (!m_UploadRing.TryAllocate(size, alignment, allocation))
+    {
+        if (m_UploadRing.WaitForOldestBatch())
+        {
+            continue;
+        }
+        // Everything left in the ring belongs to cmd, so it has to reach the GPU before any of it can be reused.
+        SubmitPendingUploads(bindlessHeaps, cmd);
+    }
+    return allocation;
+}
+
+void RenderDevice::SubmitPendingUploads(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd)
+{
+    PerFrameData& frameData = GetCurrentFrameData();
+    IE_Assert(cmd != nullptr && frameData.cmd.Get() == cmd);
+    IE_Assert(m_UploadRing.HasPendingAllocations());
+
+    // Descriptors freed while recording the submitted work retire against it, like at the end of a frame.
+    ExecuteAndWait(frameData, frameData.cmd);
+    bindlessHeaps.Submit(m_CommandQueue.Get());
+
+    // The list is reset empty: the bindless heaps are bound again for the work recorded after the upload, but pipelines and
+    // root signatures set earlier do not carry over.
+    IE_Check(frameData.commandAllocator->Reset());
+    IE_Check(frameData.cmd->Reset(frameData.commandAllocator.Get(), nullptr));
+    const Array<ID3D12DescriptorHeap*, BindlessHeapType_Count>& descriptorHeaps = bindlessHeaps.GetDescriptorHeaps();
+    frameData.cmd->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+}
@@ -10,6 +10,7 @@
 #include "Buffer.h"
 #include "Constants.h"
 #include "Timings.h"
+#include "UploadRing.h"
 
 class BindlessHeaps;
 class Window;
@@ -39,7 +40,14 @@ class RenderDevice
     void Terminate();
 
     SharedPtr<Buffer> CreateBuffer(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, const BufferCreateDesc& createDesc);
-    void SetBufferData(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes, u32 offsetInBytes = 0);
+    void SetBufferData(BindlessHeaps& bindlessHeaps, const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes,
+                       u32 offsetInBytes = 0);
+    // Both copy through the staging ring; dst must already be in COPY_DEST. Uploads larger than the ring's free space are split
+    // into chunks, and when the ring is full of data recorded on cmd (the current frame's list), cmd is submitted, waited on and
+    // reset before recording continues. The reset list gets the bindless heaps bound again; other state must be re-set by the caller.
+    void UploadBufferData(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, ID3D12Resource* dst, u64 dstOffset, const void* data, u64 sizeInBytes);
+    void UploadTextureData(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, ID3D12Resource* dst, u32 firstSubresource, u32 subresourceCount,
+                           const D3D12_SUBRESOURCE_DATA* subresources);
 
     void CreateGPUTimers(TimingState& timingState);
     void WaitForGpuIdle();
@@ -49,6 +57,11 @@ class RenderDevice
     void TrackUpload(UploadTemp&& upload);
     void ClearTrackedUploads(u32 frameInFlightIdx);
     void ClearAllTrackedUploads();
+    // Pipeline objects replaced while frames are in flight; each is released once its frame slot comes around again,
+    // after frameInFlightCount frames, so the GPU no longer uses it.
+    void RetireObjects(Vector<ComPtr<ID3D12DeviceChild>>&& objects);
+    void ReleaseRetiredObjects(u32 frameInFlightIdx);
+    void ReleaseAllRetiredObjects();
 
     u32 GetCurrentBackBufferIndex() const;
     PerFrameData& GetCurrentFrameData();
@@ -69,6 +82,9 @@ class RenderDevice
     void CreateFrameSynchronizationFences();
     void CreateCommands();
 
+    UploadRing::Allocation AllocateUpload(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd, u64 size, u64 alignment);
+    void SubmitPendingUploads(BindlessHeaps& bindlessHeaps, ID3D12GraphicsCommandList7* cmd);
+
     ComPtr<ID3D12Device14> m_Device;
     ComPtr<ID3D12Device14> m_DeviceProxy;
     ComPtr<ID3D12Debug> m_Debug;
@@ -81,4 +97,6 @@ class RenderDevice
 
     Array<PerFrameData, IE_Constants::frameInFlightCount> m_AllFrameData{};
     Array<Vector<UploadTemp>, IE_Constants::frameInFlightCount> m_InFlightUploads{};
+    Array<Vector<ComPtr<ID3D12DeviceChild>>, IE_Constants::frameInFlightCount> m_RetiredObjects{};
+    UploadRing m_UploadRing;
 };
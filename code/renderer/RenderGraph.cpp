@@ -0,0 +1,330 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <format>
+
+#include "common/Asserts.h"
+#include "common/Log.h"
+#include "common/MathUtils.h"
+#include "common/UtfConversion.h"
+
+namespace
+{
+constexpr D3D12_RESOURCE_STATES kWriteStates = D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_RENDER_TARGET | D3D12_RESOURCE_STATE_DEPTH_WRITE |
+                                               D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_RESOLVE_DEST;
+
+u64 AlignUp(const u64 value, const u64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool LifetimesOverlap(const RenderGraph::TextureLayout& a, const RenderGraph::TextureLayout& b)
+{
+    return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+bool RangesOverlap(const RenderGraph::TextureLayout& a, const RenderGraph::TextureLayout& b)
+{
+    return a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+}
+} // namespace
+
+void RenderGraph::Reset()
+{
+    m_TextureDescs.clear();
+    m_Layouts.clear();
+    m_Passes.clear();
+    m_HeapSizes = {};
+    m_HeapAlignments = {};
+    m_Compiled = false;
+}
+
+RGTexture RenderGraph::CreateTexture(const RGTextureDesc& desc)
+{
+    IE_Assert(!m_Compiled);
+    IE_Assert(desc.desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER && desc.desc.Dimension != D3D12_RESOURCE_DIMENSION_UNKNOWN);
+    m_TextureDescs.push_back(desc);
+    return static_cast<RGTexture>(m_TextureDescs.size() - 1);
+}
+
+RGPass RenderGraph::AddPass(const char* name, const Vector<RGAccess>& accesses)
+{
+    IE_Assert(!m_Compiled);
+    for (u32 i = 0; i < accesses.size(); ++i)
+    {
+        IE_Assert(accesses[i].texture < m_TextureDescs.size());
+        for (u32 j = 0; j < i; ++j)
+        {
+            IE_Assert(accesses[j].texture != accesses[i].texture);
+        }
+    }
+
+    Pass& pass = m_Passes.emplace_back();
+    pass.name = name;
+    pass.accesses = accesses;
+    return static_cast<RGPass>(m_Passes.size() - 1);
+}
+
+String RenderGraph::Validate() const
+{
+    Vector<RGPass> firstPass(m_TextureDescs.size(), RG_Invalid);
+    Vector<RGPass> lastPass(m_TextureDescs.size(), RG_Invalid);
+    for (RGPass p = 0; p < m_Passes.size(); ++p)
+    {
+        for (const RGAccess& access : m_Passes[p].accesses)
+        {
+            if (firstPass[access.texture] == RG_Invalid)
+            {
+                // Nothing survives from the previous frame, so the first access has to produce the contents.
+                if ((access.state & kWriteStates) == 0)
+                {
+                    return std::format("texture '{}' is read by pass '{}' before any pass writes it", WideToUtf8(m_TextureDescs[access.texture].name), m_Passes[p].name);
+                }
+                firstPass[access.texture] = p;
+            }
+            lastPass[access.texture] = p;
+        }
+    }
+
+    for (RGTexture t = 0; t < m_TextureDescs.size(); ++t)
+    {
+        if (firstPass[t] == RG_Invalid)
+        {
+            return std::format("texture '{}' is not used by any pass", WideToUtf8(m_TextureDescs[t].name));
+        }
+        // A texture only its producer touches is wasted work and heap space.
+        if (lastPass[t] == firstPass[t])
+        {
+            return std::format("texture '{}' is written by pass '{}' but never read", WideToUtf8(m_TextureDescs[t].name), m_Passes[firstPass[t]].name);
+        }
+    }
+    return {};
+}
+
+void RenderGraph::Compile(const AllocationInfoFn& getAllocationInfo)
+{
+    IE_Assert(!m_Compiled);
+
+    const String error = Validate();
+    if (!error.empty())
+    {
+        IE_LogError("Render graph: {}", error);
+        IE_Assert(false);
+    }
+
+    m_Layouts.assign(m_TextureDescs.size(), {});
+    for (RGPass p = 0; p < m_Passes.size(); ++p)
+    {
+        for (const RGAccess& access : m_Passes[p].accesses)
+        {
+            TextureLayout& layout = m_Layouts[access.texture];
+            if (layout.firstPass == RG_Invalid)
+            {
+                layout.firstPass = p;
+            }
+            layout.lastPass = p;
+            layout.initialState = access.state;
+        }
+    }
+
+    for (RGTexture t = 0; t < m_TextureDescs.size(); ++t)
+    {
+        TextureLayout& layout = m_Layouts[t];
+        const D3D12_RESOURCE_DESC& desc = m_TextureDescs[t].desc;
+        const D3D12_RESOURCE_ALLOCATION_INFO info = getAllocationInfo(desc);
+        IE_Assert(info.SizeInBytes > 0 && info.Alignment > 0);
+        layout.size = info.SizeInBytes;
+        layout.alignment = info.Alignment;
+        layout.heapClass = (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) ? RGHeapClass_RenderTargets : RGHeapClass_Textures;
+    }
+
+    PlaceTextures();
+    PlanBarriers();
+    m_Compiled = true;
+}
+
+void RenderGraph::PlaceTextures()
+{
+    // Largest first, each at the lowest offset that no already placed texture with an overlapping lifetime occupies.
+    Vector<RGTexture> order(m_Layouts.size());
+    for (RGTexture t = 0; t < order.size(); ++t)
+    {
+        order[t] = t;
+    }
+    std::sort(order.begin(), order.end(), [&](const RGTexture a, const RGTexture b) {
+        const TextureLayout& la = m_Layouts[a];
+        const TextureLayout& lb = m_Layouts[b];
+        if (la.size != lb.size)
+        {
+            return la.size > lb.size;
+        }
+        return la.firstPass != lb.firstPass ? la.firstPass < lb.firstPass : a < b;
+    });
+
+    Vector<RGTexture> placed;
+    Vector<const TextureLayout*> occupied;
+    placed.reserve(order.size());
+    for (const RGTexture t : order)
+    {
+        TextureLayout& layout = m_Layouts[t];
+
+        occupied.clear();
+        for (const RGTexture other : placed)
+        {
+            const TextureLayout& otherLayout = m_Layouts[other];
+            if (otherLayout.heapClass == layout.heapClass && LifetimesOverlap(layout, otherLayout))
+            {
+                occupied.push_back(&otherLayout);
+            }
+        }
+        std::sort(occupied.begin(), occupied.end(), [](const TextureLayout* a, const TextureLayout* b) { return a->offset < b->offset; });
+
+        u64 offset = 0;
+        for (const TextureLayout* range : occupied)
+        {
+            if (AlignUp(offset, layout.alignment) + layout.size <= range->offset)
+            {
+                break;
+            }
+            offset = IE_Max(offset, range->offset + range->size);
+        }
+        layout.offset = AlignUp(offset, layout.alignment);
+
+        m_HeapSizes[layout.heapClass] = IE_Max(m_HeapSizes[layout.heapClass], layout.offset + layout.size);
+        m_HeapAlignments[layout.heapClass] = IE_Max(m_HeapAlignments[layout.heapClass], layout.alignment);
+        placed.push_back(t);
+    }
+
+    for (RGTexture a = 0; a < m_Layouts.size(); ++a)
+    {
+        for (RGTexture b = a + 1; b < m_Layouts.size(); ++b)
+        {
+            TextureLayout& la = m_Layouts[a];
+            TextureLayout& lb = m_Layouts[b];
+            if (la.heapClass == lb.heapClass && RangesOverlap(la, lb))
+            {
+                IE_Assert(!LifetimesOverlap(la, lb));
+                la.aliased = true;
+                lb.aliased = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::PlanBarriers()
+{
+    Vector<D3D12_RESOURCE_STATES> states(m_Layouts.size());
+    for (RGTexture t = 0; t < m_Layouts.size(); ++t)
+    {
+        states[t] = m_Layouts[t].initialState;
+    }
+
+    for (RGPass p = 0; p < m_Passes.size(); ++p)
+    {
+        Pass& pass = m_Passes[p];
+        pass.barriers.clear();
+
+        // Aliasing barriers go first so the transitions below already apply to the texture that now owns the memory.
+        for (const RGAccess& access : pass.accesses)
+        {
+            const TextureLayout& layout = m_Layouts[access.texture];
+            if (layout.aliased && layout.firstPass == p)
+            {
+                pass.barriers.push_back({RGBarrierType_Aliasing, access.texture, access.state, access.state});
+            }
+        }
+
+        for (const RGAccess& access : pass.accesses)
+        {
+            const D3D12_RESOURCE_STATES before = states[access.texture];
+            if (before != access.state)
+            {
+                pass.barriers.push_back({RGBarrierType_Transition, access.texture, before, access.state});
+            }
+            else if (access.state == D3D12_RESOURCE_STATE_UNORDERED_ACCESS && m_Layouts[access.texture].firstPass != p)
+            {
+                pass.barriers.push_back({RGBarrierType_Uav, access.texture, before, access.state});
+            }
+            states[access.texture] = access.state;
+        }
+    }
+}
+
+bool RenderGraph::IsCompiled() const
+{
+    return m_Compiled;
+}
+
+u32 RenderGraph::GetTextureCount() const
+{
+    return static_cast<u32>(m_TextureDescs.size());
+}
+
+u32 RenderGraph::GetPassCount() const
+{
+    return static_cast<u32>(m_Passes.size());
+}
+
+const RGTextureDesc& RenderGraph::GetTextureDesc(const RGTexture texture) const
+{
+    IE_Assert(texture < m_TextureDescs.size());
+    return m_TextureDescs[texture];
+}
+
+const RenderGraph::TextureLayout& RenderGraph::GetTextureLayout(const RGTexture texture) const
+{
+    IE_Assert(m_Compiled && texture < m_Layouts.size());
+    return m_Layouts[texture];
+}
+
+const char* RenderGraph::GetPassName(const RGPass pass) const
+{
+    IE_Assert(pass < m_Passes.size());
+    return m_Passes[pass].name;
+}
+
+const Vector<RGBarrier>& RenderGraph::GetPassBarriers(const RGPass pass) const
+{
+    IE_Assert(m_Compiled && pass < m_Passes.size());
+    return m_Passes[pass].barriers;
+}
+
+u64 RenderGraph::GetHeapSize(const RGHeapClass heapClass) const
+{
+    IE_Assert(m_Compiled && heapClass < RGHeapClass_Count);
+    return m_HeapSizes[heapClass];
+}
+
+u64 RenderGraph::GetHeapAlignment(const RGHeapClass heapClass) const
+{
+    IE_Assert(m_Compiled && heapClass < RGHeapClass_Count);
+    return m_HeapAlignments[heapClass];
+}
+
+RenderGraph::Stats RenderGraph::GetStats() const
+{
+    IE_Assert(m_Compiled);
+
+    Stats stats{};
+    stats.textureCount = GetTextureCount();
+    stats.passCount = GetPassCount();
+    for (const TextureLayout& layout : m_Layouts)
+    {
+        stats.textureBytes += layout.size;
+        stats.aliasedTextureCount += layout.aliased ? 1u : 0u;
+    }
+    for (const Pass& pass : m_Passes)
+    {
+        stats.barrierCount += static_cast<u32>(pass.barriers.size());
+    }
+    for (const u64 heapSize : m_HeapSizes)
+    {
+        stats.heapBytes += heapSize;
+    }
+    return stats;
+}
@@ -0,0 +1,129 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <d3d12.h>
+
+#include <functional>
+
+#include "common/Types.h"
+
+using RGTexture = u32;
+using RGPass = u32;
+constexpr u32 RG_Invalid = UINT32_MAX;
+
+// Placed textures must share a heap with textures of the same class (tier 1 resource heaps).
+enum RGHeapClass : u8
+{
+    RGHeapClass_Textures,
+    RGHeapClass_RenderTargets,
+
+    RGHeapClass_Count
+};
+
+enum RGBarrierType : u8
+{
+    RGBarrierType_Aliasing,
+    RGBarrierType_Transition,
+    RGBarrierType_Uav,
+
+    RGBarrierType_Count
+};
+
+struct RGTextureDesc
+{
+    D3D12_RESOURCE_DESC desc{};
+    const wchar_t* name = L"Transient Texture";
+    bool createSrv = true;
+    bool createUav = false;
+};
+
+struct RGAccess
+{
+    RGTexture texture = RG_Invalid;
+    D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+};
+
+struct RGBarrier
+{
+    RGBarrierType type = RGBarrierType_Transition;
+    RGTexture texture = RG_Invalid;
+    D3D12_RESOURCE_STATES before = D3D12_RESOURCE_STATE_COMMON;
+    D3D12_RESOURCE_STATES after = D3D12_RESOURCE_STATE_COMMON;
+};
+
+// Frame-local textures declared with the passes that touch them. Compile derives every texture's lifetime from its first and
+// last access, packs textures whose lifetimes do not overlap at the same heap offsets and plans the barriers each pass needs.
+// It only works on descriptions, so it runs without a device; TransientTextures places the resources the plan describes.
+//
+// Every texture is rewritten each frame: its first access must be a write, a later pass must consume it, and the frame starts
+// from the state the previous frame left it in.
+class RenderGraph
+{
+  public:
+    struct TextureLayout
+    {
+        RGHeapClass heapClass = RGHeapClass_Textures;
+        u64 offset = 0;
+        u64 size = 0;
+        u64 alignment = 0;
+        RGPass firstPass = RG_Invalid;
+        RGPass lastPass = RG_Invalid;
+        D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COMMON; // state at frame start, i.e. its last access state
+        bool aliased = false;                                              // shares heap bytes with another texture
+    };
+
+    struct Stats
+    {
+        u32 textureCount = 0;
+        u32 passCount = 0;
+        u32 aliasedTextureCount = 0;
+        u32 barrierCount = 0;
+        u64 textureBytes = 0; // what one committed resource per texture would take
+        u64 heapBytes = 0;
+    };
+
+    using AllocationInfoFn = std::function<D3D12_RESOURCE_ALLOCATION_INFO(const D3D12_RESOURCE_DESC&)>;
+
+    void Reset();
+
+    RGTexture CreateTexture(const RGTextureDesc& desc);
+    // Passes execute in declaration order; a texture appears at most once per pass.
+    RGPass AddPass(const char* name, const Vector<RGAccess>& accesses);
+
+    // Empty when the passes declare a valid frame, otherwise the first rule they break. Compile asserts on it.
+    String Validate() const;
+    void Compile(const AllocationInfoFn& getAllocationInfo);
+
+    bool IsCompiled() const;
+    u32 GetTextureCount() const;
+    u32 GetPassCount() const;
+    const RGTextureDesc& GetTextureDesc(RGTexture texture) const;
+    const TextureLayout& GetTextureLayout(RGTexture texture) const;
+    const char* GetPassName(RGPass pass) const;
+    const Vector<RGBarrier>& GetPassBarriers(RGPass pass) const;
+    u64 GetHeapSize(RGHeapClass heapClass) const;
+    u64 GetHeapAlignment(RGHeapClass heapClass) const;
+    Stats GetStats() const;
+
+  private:
+    struct Pass
+    {
+        const char* name = nullptr;
+        Vector<RGAccess> accesses;
+        Vector<RGBarrier> barriers;
+    };
+
+    void PlaceTextures();
+    void PlanBarriers();
+
+    Vector<RGTextureDesc> m_TextureDescs;
+    Vector<TextureLayout> m_Layouts;
+    Vector<Pass> m_Passes;
+    Array<u64, RGHeapClass_Count> m_HeapSizes{};
+    Array<u64, RGHeapClass_Count> m_HeapAlignments{};
+    bool m_Compiled = false;
+};
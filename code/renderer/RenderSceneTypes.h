@@ -25,9 +25,28 @@ enum CullMode : u8
     CullMode_Count
 };
 
+enum DrawSortMode : u8
+{
+    DrawSortMode_None,
+    DrawSortMode_FrontToBack,
+    DrawSortMode_ByPrimitive,
+
+    DrawSortMode_Count
+};
+
+// One raster instance that survived CPU culling, before being grouped by primitive.
+struct VisibleInstance
+{
+    u32 primIndex;
+    u64 sortKey;
+    DrawInstance drawInstance;
+};
+
+// One instanced mesh dispatch: instanceCount instances of primIndex starting at primConstants.firstInstance.
 struct PrimitiveRenderData
 {
     u32 primIndex;
+    u32 instanceCount;
     PrimitiveConstants primConstants;
 };
 
@@ -9,6 +9,7 @@
 #include "Constants.h"
 #include "Culling.h"
 #include "DLSS.h"
+#include "GpuMemory.h"
 #include "ImGui.h"
 #include "PipelineHelpers.h"
 #include "Raytracing.h"
@@ -16,6 +17,8 @@
 #include "Streamline.h"
 #include "TemporalJitter.h"
 #include "common/CommandLineArguments.h"
+#include "common/Profiler.h"
+#include "common/TimelineFormat.h"
 #include "window/Window.h"
 
 #include <cmath>
@@ -64,19 +67,11 @@ bool MatchesTexture(ID3D12Resource* resource, const DXGI_FORMAT expectedFormat,
     return desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE2D && desc.Format == expectedFormat && desc.Width == expectedSize.x && desc.Height == expectedSize.y;
 }
 
-void ReleaseSrv(BindlessHeaps& bindlessHeaps, u32& srvIndex)
+void ReleaseSrv(BindlessHeaps& bindlessHeaps, u32& srvIndex, const u32 srvGeneration)
 {
-    bindlessHeaps.FreeCbvSrvUav(srvIndex);
+    bindlessHeaps.FreeCbvSrvUav(srvIndex, srvGeneration);
     srvIndex = UINT32_MAX;
 }
-
-void ReleaseTextureDescriptors(BindlessHeaps& bindlessHeaps, Texture& texture)
-{
-    bindlessHeaps.FreeCbvSrvUav(texture.srvIndex);
-    bindlessHeaps.FreeCbvSrvUav(texture.uavIndex);
-    texture.srvIndex = UINT32_MAX;
-    texture.uavIndex = UINT32_MAX;
-}
 } // namespace
 
 Renderer::Renderer(Window& window)
@@ -118,6 +113,25 @@ void Renderer::Init()
 
     m_SceneResources.RefreshAvailableScenes();
     const CommandLineArguments& args = GetCommandLineArguments();
+    if (args.captureFrames > 0)
+    {
+        m_TimelineCapture.Start(args.captureFrames, true, m_GpuTimingState.timestampFrequency);
+    }
+    if (!args.benchmarkPath.empty())
+    {
+        BenchmarkDesc benchmarkDesc{};
+        benchmarkDesc.scene = args.sceneFile;
+        benchmarkDesc.cameraPath = args.benchmarkPath;
+        benchmarkDesc.warmupFrames = args.benchmarkWarmupFrames;
+        benchmarkDesc.frameCount = args.benchmarkFrames;
+        benchmarkDesc.outputStem = args.benchmarkOutput;
+        if (benchmarkDesc.outputStem.empty())
+        {
+            const String stem = std::format("benchmark_{}_{}", std::filesystem::path(args.sceneFile).stem().string(), benchmarkDesc.cameraPath.stem().string());
+            benchmarkDesc.outputStem = std::filesystem::path("data/profiles") / stem;
+        }
+        m_Benchmark.Start(benchmarkDesc);
+    }
     const String startupSceneArg = args.sceneFile.empty() ? "Sponza" : args.sceneFile;
     String startupScene = m_SceneResources.ResolveSceneName(startupSceneArg);
     const Vector<String>& loadableScenes = m_SceneResources.GetLoadableScenes();
@@ -152,17 +166,30 @@ void Renderer::Init()
     PresentLoadingFrame();
 
     ReloadShaders();
+    // Shader edits would change what a benchmark measures halfway through, so hot reload stays off while one runs.
+    if (!m_Benchmark.IsActive())
+    {
+        m_ShaderFileWatcher.Start(L"data/shaders");
+    }
 }
 
 void Renderer::Terminate()
 {
+    m_ShaderFileWatcher.Stop();
+    CancelShaderHotReload();
     WaitForGpuIdle();
 
+    if (m_TimelineCapture.IsRolling())
+    {
+        WriteTimelineCapture();
+    }
+
     if (m_ConstantsBuffer && m_ConstantsBuffer->resource && m_ConstantsCbMapped)
     {
         m_ConstantsBuffer->Unmap(0, nullptr);
         m_ConstantsCbMapped = nullptr;
     }
+    ReleaseDrawInstanceBuffers();
 
     m_Sky.Terminate();
     ImGui_Shutdown();
@@ -171,6 +198,15 @@ void Renderer::Terminate()
 
 void Renderer::Render()
 {
+    if (m_PendingCpuTraceCapture)
+    {
+        m_PendingCpuTraceCapture = false;
+        m_CpuTraceFramesRemaining = kCpuTraceCaptureFrames;
+        Profiler::BeginCapture();
+    }
+    Profiler::BeginScope("Frame");
+    const std::chrono::steady_clock::time_point frameBegin = std::chrono::steady_clock::now();
+
     m_CpuTimers.passCount = 0;
     m_CpuTimers.openScopeCount = 0;
     m_FrameInFlightIdx = m_RenderDevice.GetCurrentBackBufferIndex();
@@ -210,20 +246,21 @@ void Renderer::Render()
     cullingParams.cpuFrustumCullingEnabled = g_Settings.cpuFrustumCulling;
     cullingParams.updateInstances = updateInstances;
     cullingParams.debugMeshletColorEnabled = g_Settings.debugMeshletColor;
+    cullingParams.drawSortMode = static_cast<DrawSortMode>(IE_Min(g_Settings.drawSortMode, static_cast<u32>(DrawSortMode_Count - 1)));
     cullingParams.materialsBufferSrvIndex = materialsBuffer->srvIndex;
     cullingParams.cpuTimers = &m_CpuTimers;
 
     Culling& culling = m_Culling;
     culling.Build(cullingParams);
 
+    CPU_MARKER_BEGIN(m_CpuTimers, "Draw Instance Upload");
+    UploadDrawInstances();
+    CPU_MARKER_END(m_CpuTimers);
+
     CPU_MARKER_BEGIN(m_CpuTimers, "Ray Tracing Instance Upload");
     if (updateInstances)
     {
-        const Vector<Raytracing::RTInstance>& rtInstances = culling.GetRTInstances();
-        if (!rtInstances.empty())
-        {
-            m_Raytracing.UpdateInstances(cmd, rtInstances);
-        }
+        m_Raytracing.UpdateInstances(cmd, culling.GetRTInstances());
         m_SceneResources.ClearInstancesDirty();
     }
     CPU_MARKER_END(m_CpuTimers);
@@ -241,8 +278,10 @@ void Renderer::Render()
     m_Sky.PassProceduralSkyCube(cmd, frameData.gpuTimers, m_Environments.GetCurrentEnvironment(), m_BindlessHeaps);
     Pass_PathTrace(cmd);
     Raytracing::PathTracePassResources& pathTraceResources = m_Raytracing.GetPathTracePassResources();
+    // Exposure adaptation is time based; benchmarks step it with their fixed timestep so every run converges the same way.
+    const f32 exposureDtMs = m_Benchmark.IsActive() ? Benchmark::kFixedStepSeconds * 1000.0f : m_Window.GetFrameTimeMs();
     m_AutoExposure.Pass(cmd, frameData.gpuTimers, m_BindlessHeaps, pathTraceResources.trace.outputTexture, pathTraceResources.trace.outputTexture.srvIndex,
-                        m_DepthPre.dsvs[m_FrameInFlightIdx].srvIndex, m_Upscale.renderSize, m_Window.GetFrameTimeMs());
+                        m_DepthPre.dsvs[m_FrameInFlightIdx].srvIndex, m_Upscale.renderSize, exposureDtMs);
     Pass_Upscale(cmd, cameraFrameData);
     Pass_Bloom(cmd);
     Pass_Tonemap(cmd);
@@ -250,10 +289,52 @@ void Renderer::Render()
 
     Timings_CollectCpu(m_CpuTimers, m_CpuTimingState);
     Timings_UpdateAverages(m_CpuTimingState, m_Window.GetFrameTimeMs(), g_Settings.timingAverageWindowMs);
+    Timings_AddSample(m_FrameTimingState, kFrameTimingName, m_Window.GetFrameTimeMs(), m_Window.GetFrameTimeMs(), g_Settings.timingAverageWindowMs);
     Pass_ImGui(cmd, cameraFrameData);
     Pass_PresentComposite(cmd);
 
     EndFrame(frameData, cmd);
+
+    Profiler::Counter("Raster Draw Groups", static_cast<f64>(g_Stats.rasterDrawGroups));
+    Profiler::Counter("Raster Instances Submitted", static_cast<f64>(g_Stats.cpuFrustumCullRasterSubmitted));
+    Profiler::EndScope();
+    const std::chrono::steady_clock::time_point frameEnd = std::chrono::steady_clock::now();
+    if (m_Benchmark.IsActive())
+    {
+        m_Benchmark.EndFrame(m_TimelineCapture.GetCurrentFrame(), !m_SceneResources.HasPendingSceneSwitch(), std::chrono::duration<f64, std::milli>(frameEnd - frameBegin).count(),
+                             m_CpuTimingState);
+    }
+    m_TimelineCapture.RecordCpuFrame(m_CpuTimers, frameBegin, frameEnd);
+    if (m_PendingTimelineWrite || m_TimelineCapture.IsComplete())
+    {
+        WriteTimelineCapture();
+    }
+    if (m_PendingTimingStatsExport)
+    {
+        m_PendingTimingStatsExport = false;
+        const std::filesystem::path statsPath = std::filesystem::path("data/profiles") / std::format("timing_stats_{}.json", m_FrameIndex);
+        if (ExportTimingStats(statsPath))
+        {
+            IE_LogInfo("Timing statistics written to {}.", statsPath.generic_string());
+        }
+        else
+        {
+            IE_LogWarn("Timing statistics could not be written to {}.", statsPath.generic_string());
+        }
+    }
+    if (m_CpuTraceFramesRemaining > 0 && --m_CpuTraceFramesRemaining == 0)
+    {
+        Profiler::EndCapture();
+        const std::filesystem::path tracePath = std::filesystem::path("data/profiles") / std::format("cpu_trace_{}.json", m_FrameIndex);
+        if (Profiler::WriteChromeTrace(tracePath))
+        {
+            IE_LogInfo("CPU trace written to {}.", tracePath.generic_string());
+        }
+        else
+        {
+            IE_LogWarn("CPU trace could not be written to {}.", tracePath.generic_string());
+        }
+    }
 }
 
 void Renderer::MarkInstancesDirty()
@@ -269,18 +350,27 @@ SharedPtr<Buffer> Renderer::CreateBuffer(ID3D12GraphicsCommandList7* cmd, const
 void Renderer::BeginFrame(PerFrameData& frameData, ComPtr<ID3D12GraphicsCommandList7>& cmd, Camera::FrameData& cameraFrameData, f32& jitterNormX, f32& jitterNormY)
 {
     m_RenderDevice.ClearTrackedUploads(m_FrameInFlightIdx);
+    m_RenderDevice.ReleaseRetiredObjects(m_FrameInFlightIdx);
 
     if (m_PendingShaderReload)
     {
+        CancelShaderHotReload();
         g_Stats.shadersCompilationSuccess = true;
         ReloadShaders();
         m_PendingShaderReload = false;
     }
+    else
+    {
+        UpdateShaderHotReload();
+    }
 
     Timings_CollectGpu(frameData.gpuTimers, m_GpuTimingState);
     Timings_UpdateAverages(m_GpuTimingState, m_Window.GetFrameTimeMs(), g_Settings.timingAverageWindowMs);
+    m_TimelineCapture.RecordGpuFrame(frameData.gpuTimers, m_RenderDevice.GetCommandQueue().Get());
+    m_Benchmark.RecordGpuFrame(frameData.gpuTimers.captureFrame, m_GpuTimingState);
     frameData.gpuTimers.passCount = 0;
     frameData.gpuTimers.nextIdx = 0;
+    frameData.gpuTimers.captureFrame = m_TimelineCapture.GetCurrentFrame();
 
     const u32 jitterPhaseCount = GetDLSSJitterPhaseCount(m_DLSSMode);
     const TemporalJitter::Sample jitter = TemporalJitter::ComputeHaltonJitter(m_FrameIndex, m_Upscale.renderSize.x, m_Upscale.renderSize.y, jitterPhaseCount);
@@ -328,6 +418,81 @@ void Renderer::BeginFrame(PerFrameData& frameData, ComPtr<ID3D12GraphicsCommandL
     cmd->RSSetScissorRects(1, &m_RenderRect);
 }
 
+void Renderer::UploadDrawInstances()
+{
+    const Vector<DrawInstance>& drawInstances = m_Culling.GetDrawInstances();
+    const u32 requiredCount = IE_Max(static_cast<u32>(drawInstances.size()), 1u);
+
+    SharedPtr<Buffer>& buffer = m_DrawInstanceBuffers[m_FrameInFlightIdx];
+    if (!buffer || buffer->numElements < requiredCount)
+    {
+        // This frame slot has already been waited on, so the GPU no longer reads the old buffer.
+        if (buffer)
+        {
+            buffer->Unmap(0, nullptr);
+            m_BindlessHeaps.FreeCbvSrvUav(buffer->srvIndex, buffer->srvGeneration);
+        }
+
+        const u32 capacity = IE_Max(requiredCount + requiredCount / 2, 1024u);
+        BufferCreateDesc d{};
+        d.sizeInBytes = capacity * static_cast<u32>(sizeof(DrawInstance));
+        d.heapType = D3D12_HEAP_TYPE_UPLOAD;
+        d.viewKind = BufferCreateDesc::ViewKind::Structured;
+        d.createSRV = true;
+        d.strideInBytes = sizeof(DrawInstance);
+        d.initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
+        d.finalState = D3D12_RESOURCE_STATE_GENERIC_READ;
+        d.name = L"Draw Instances";
+        buffer = CreateBuffer(nullptr, d);
+        IE_Check(buffer->Map(0, nullptr, reinterpret_cast<void**>(&m_DrawInstanceBuffersMapped[m_FrameInFlightIdx])));
+    }
+
+    if (!drawInstances.empty())
+    {
+        std::memcpy(m_DrawInstanceBuffersMapped[m_FrameInFlightIdx], drawInstances.data(), drawInstances.size() * sizeof(DrawInstance));
+    }
+}
+
+void Renderer::ReleaseDrawInstanceBuffers()
+{
+    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
+    {
+        if (m_DrawInstanceBuffers[i] && m_DrawInstanceBuffersMapped[i])
+        {
+            m_DrawInstanceBuffers[i]->Unmap(0, nullptr);
+        }
+        m_DrawInstanceBuffers[i].reset();
+        m_DrawInstanceBuffersMapped[i] = nullptr;
+    }
+}
+
+void Renderer::DrawPrimitiveGroups(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<PrimitiveRenderData>& drawGroups) const
+{
+    // Mesh dispatches are limited to 65535 groups per dimension and 2^22 groups in total.
+    constexpr u32 kMaxDispatchDimension = 65535u;
+    constexpr u32 kMaxDispatchGroups = 1u << 22;
+
+    const u32 instancesBufferIndex = m_DrawInstanceBuffers[m_FrameInFlightIdx]->srvIndex;
+    for (const PrimitiveRenderData& drawGroup : drawGroups)
+    {
+        const u32 meshletGroups = IE_DivRoundUp(drawGroup.primConstants.meshletCount, 32);
+        if (meshletGroups == 0)
+        {
+            continue;
+        }
+
+        const u32 maxInstancesPerDispatch = IE_Min(kMaxDispatchDimension, kMaxDispatchGroups / meshletGroups);
+        PrimitiveConstants primConstants = drawGroup.primConstants;
+        primConstants.instancesBufferIndex = instancesBufferIndex;
+        for (u32 first = 0; first < drawGroup.instanceCount; first += maxInstancesPerDispatch)
+        {
+            primConstants.firstInstance = drawGroup.primConstants.firstInstance + first;
+            cmd->SetGraphicsRoot32BitConstants(0, sizeof(primConstants) / 4, &primConstants, 0);
+            cmd->DispatchMesh(meshletGroups, IE_Min(drawGroup.instanceCount - first, maxInstancesPerDispatch), 1);
+        }
+    }
+}
+
 void Renderer::Pass_DepthPre(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 {
     m_DepthPre.dsvs[m_FrameInFlightIdx].Transition(cmd, D3D12_RESOURCE_STATE_DEPTH_WRITE);
@@ -335,15 +500,6 @@ void Renderer::Pass_DepthPre(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
     cmd->OMSetRenderTargets(0, nullptr, false, &m_DepthPre.dsvs[m_FrameInFlightIdx].dsv);
     cmd->ClearDepthStencilView(m_DepthPre.dsvs[m_FrameInFlightIdx].dsv, D3D12_CLEAR_FLAG_DEPTH, 0.0f, 0, 0, nullptr);
 
-    auto drawPrimitives = [&](const Vector<PrimitiveRenderData>& primitivesRenderData) {
-        const Vector<Primitive>& primitives = m_SceneResources.GetPrimitives();
-        for (const PrimitiveRenderData& primitiveRenderData : primitivesRenderData)
-        {
-            cmd->SetGraphicsRoot32BitConstants(0, sizeof(primitiveRenderData.primConstants) / 4, &primitiveRenderData.primConstants, 0);
-            cmd->DispatchMesh(IE_DivRoundUp(primitives[primitiveRenderData.primIndex].meshletCount, 32), 1, 1);
-        }
-    };
-
     PerFrameData& frameData = GetCurrentFrameData();
     const D3D12_GPU_VIRTUAL_ADDRESS frameCbGpuAddress = m_ConstantsBuffer->GetGPUVirtualAddress() + static_cast<u64>(m_FrameInFlightIdx) * m_ConstantsCbStride;
     const PrimitiveBuckets& primitiveBuckets = m_Culling.GetPrimitiveBuckets();
@@ -361,12 +517,12 @@ void Renderer::Pass_DepthPre(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
             if (!opaqueBack.empty())
             {
                 cmd->SetPipelineState(m_DepthPre.opaquePSO[CullMode_Back].Get());
-                drawPrimitives(opaqueBack);
+                DrawPrimitiveGroups(cmd, opaqueBack);
             }
             if (!opaqueNone.empty())
             {
                 cmd->SetPipelineState(m_DepthPre.opaquePSO[CullMode_None].Get());
-                drawPrimitives(opaqueNone);
+                DrawPrimitiveGroups(cmd, opaqueNone);
             }
         }
         GPU_MARKER_END(cmd, frameData.gpuTimers);
@@ -381,12 +537,12 @@ void Renderer::Pass_DepthPre(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
             if (!maskedBack.empty())
             {
                 cmd->SetPipelineState(m_DepthPre.alphaTestPSO[CullMode_Back].Get());
-                drawPrimitives(maskedBack);
+                DrawPrimitiveGroups(cmd, maskedBack);
             }
             if (!maskedNone.empty())
             {
                 cmd->SetPipelineState(m_DepthPre.alphaTestPSO[CullMode_None].Get());
-                drawPrimitives(maskedNone);
+                DrawPrimitiveGroups(cmd, maskedNone);
             }
         }
         GPU_MARKER_END(cmd, frameData.gpuTimers);
@@ -413,15 +569,6 @@ void Renderer::Pass_GBuffer(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 
     TransitionGBuffer(D3D12_RESOURCE_STATE_RENDER_TARGET);
 
-    auto drawPrimitives = [&](const Vector<PrimitiveRenderData>& primitivesRenderData) {
-        const Vector<Primitive>& primitives = m_SceneResources.GetPrimitives();
-        for (const PrimitiveRenderData& primitiveRenderData : primitivesRenderData)
-        {
-            cmd->SetGraphicsRoot32BitConstants(0, sizeof(primitiveRenderData.primConstants) / 4, &primitiveRenderData.primConstants, 0);
-            cmd->DispatchMesh(IE_DivRoundUp(primitives[primitiveRenderData.primIndex].meshletCount, 32), 1, 1);
-        }
-    };
-
     const Array<ID3D12DescriptorHeap*, 2> descriptorHeaps = m_BindlessHeaps.GetDescriptorHeaps();
     cmd->SetDescriptorHeaps(descriptorHeaps.size(), descriptorHeaps.data());
     const D3D12_GPU_VIRTUAL_ADDRESS frameCbGpuAddress = m_ConstantsBuffer->GetGPUVirtualAddress() + static_cast<u64>(m_FrameInFlightIdx) * m_ConstantsCbStride;
@@ -446,13 +593,13 @@ void Renderer::Pass_GBuffer(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
             if (!drawBack.empty())
             {
                 cmd->SetPipelineState(m_GBuf.psos[alphaMode][CullMode_Back].Get());
-                drawPrimitives(drawBack);
+                DrawPrimitiveGroups(cmd, drawBack);
             }
 
             if (!drawNone.empty())
             {
                 cmd->SetPipelineState(m_GBuf.psos[alphaMode][CullMode_None].Get());
-                drawPrimitives(drawNone);
+                DrawPrimitiveGroups(cmd, drawNone);
             }
         }
         GPU_MARKER_END(cmd, frameData.gpuTimers);
@@ -494,13 +641,12 @@ void Renderer::Pass_DLSSRRGuides(const ComPtr<ID3D12GraphicsCommandList7>& cmd,
     const Array<ID3D12DescriptorHeap*, 2> descriptorHeaps = m_BindlessHeaps.GetDescriptorHeaps();
     cmd->SetDescriptorHeaps(descriptorHeaps.size(), descriptorHeaps.data());
 
-    Texture& diffuseAlbedo = m_DLSSRRGuides.diffuseAlbedo[m_FrameInFlightIdx];
-    Texture& specularAlbedo = m_DLSSRRGuides.specularAlbedo[m_FrameInFlightIdx];
+    Texture& diffuseAlbedo = m_TransientTextures.Get(m_PostGraph.diffuseAlbedoGuide);
+    Texture& specularAlbedo = m_TransientTextures.Get(m_PostGraph.specularAlbedoGuide);
 
     GPU_MARKER_BEGIN(cmd, frameData.gpuTimers, "DLSS RR Guides");
     {
-        diffuseAlbedo.Transition(cmd, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        specularAlbedo.Transition(cmd, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+        m_TransientTextures.BeginPass(cmd, m_PostGraph.guidesPass);
 
         DLSSRRGuideConstants c{};
         c.invViewProj = cameraFrameData.invViewProj;
@@ -516,12 +662,6 @@ void Renderer::Pass_DLSSRRGuides(const ComPtr<ID3D12GraphicsCommandList7>& cmd,
         cmd->SetPipelineState(m_DLSSRRGuides.pso.Get());
         cmd->SetComputeRoot32BitConstants(0, sizeof(c) / sizeof(u32), &c, 0);
         cmd->Dispatch(IE_DivRoundUp(m_Upscale.renderSize.x, kGuideDispatchGroupSize), IE_DivRoundUp(m_Upscale.renderSize.y, kGuideDispatchGroupSize), 1);
-
-        diffuseAlbedo.UavBarrier(cmd);
-        specularAlbedo.UavBarrier(cmd);
-
-        diffuseAlbedo.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
-        specularAlbedo.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
     }
     GPU_MARKER_END(cmd, frameData.gpuTimers);
 }
@@ -529,31 +669,25 @@ void Renderer::Pass_DLSSRRGuides(const ComPtr<ID3D12GraphicsCommandList7>& cmd,
 void Renderer::Pass_Upscale(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Camera::FrameData& cameraFrameData)
 {
     PerFrameData& frameData = GetCurrentFrameData();
-
-    auto EnsureOutputState = [&](u32 idx, D3D12_RESOURCE_STATES desired) {
-        if (m_Upscale.outputs[idx].state != desired)
-        {
-            m_Upscale.outputs[idx].Transition(cmd, desired);
-        }
-    };
-
-    EnsureOutputState(m_FrameInFlightIdx, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    Texture& upscaleOutput = m_TransientTextures.Get(m_PostGraph.upscaleOutput);
 
     GPU_MARKER_BEGIN(cmd, frameData.gpuTimers, "DLSS RR");
     {
+        m_TransientTextures.BeginPass(cmd, m_PostGraph.upscalePass);
+
         const Raytracing::PathTracePassResources& pathTracePassResources = m_Raytracing.GetPathTracePassResources();
-        Texture& diffuseAlbedoGuide = m_DLSSRRGuides.diffuseAlbedo[m_FrameInFlightIdx];
-        Texture& specularAlbedoGuide = m_DLSSRRGuides.specularAlbedo[m_FrameInFlightIdx];
+        Texture& diffuseAlbedoGuide = m_TransientTextures.Get(m_PostGraph.diffuseAlbedoGuide);
+        Texture& specularAlbedoGuide = m_TransientTextures.Get(m_PostGraph.specularAlbedoGuide);
         RenderTarget& normalRoughnessGuide = m_GBuf.gbuffers[m_FrameInFlightIdx].normal;
         IE_Assert(MatchesTexture(diffuseAlbedoGuide.Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.renderSize));
         IE_Assert(MatchesTexture(specularAlbedoGuide.Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.renderSize));
         IE_Assert(MatchesTexture(normalRoughnessGuide.Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.renderSize));
         IE_Assert(MatchesTexture(pathTracePassResources.trace.hitDistanceTexture.Get(), DXGI_FORMAT_R16_FLOAT, m_Upscale.renderSize));
         IE_Assert(MatchesTexture(pathTracePassResources.trace.outputTexture.Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.renderSize));
-        IE_Assert(MatchesTexture(m_Upscale.outputs[m_FrameInFlightIdx].Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.presentSize));
+        IE_Assert(MatchesTexture(upscaleOutput.Get(), DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.presentSize));
 
         const D3D12_RESOURCE_DESC hdrDesc = pathTracePassResources.trace.outputTexture.GetDesc();
-        const D3D12_RESOURCE_DESC outDesc = m_Upscale.outputs[m_FrameInFlightIdx].GetDesc();
+        const D3D12_RESOURCE_DESC outDesc = upscaleOutput.GetDesc();
         const D3D12_RESOURCE_DESC mvDesc = m_GBuf.gbuffers[m_FrameInFlightIdx].motionVector.GetDesc();
         const D3D12_RESOURCE_DESC diffuseAlbedoDesc = diffuseAlbedoGuide.GetDesc();
         const D3D12_RESOURCE_DESC specularAlbedoDesc = specularAlbedoGuide.GetDesc();
@@ -563,7 +697,7 @@ void Renderer::Pass_Upscale(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const
         DLSS::EvaluateDesc d{};
         d.cmd = cmd.Get();
         d.colorIn = pathTracePassResources.trace.outputTexture.Get();
-        d.colorOut = m_Upscale.outputs[m_FrameInFlightIdx].Get();
+        d.colorOut = upscaleOutput.Get();
         d.depth = m_DepthPre.dsvs[m_FrameInFlightIdx].Get();
         d.motionVectors = m_GBuf.gbuffers[m_FrameInFlightIdx].motionVector.Get();
         d.exposure = m_AutoExposure.GetFinalExposureTexture().Get();
@@ -583,7 +717,7 @@ void Renderer::Pass_Upscale(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const
         d.specularHitDistanceFormat = specularHitDistanceDesc.Format;
 
         d.colorInState = pathTracePassResources.trace.outputTexture.state;
-        d.colorOutState = m_Upscale.outputs[m_FrameInFlightIdx].state;
+        d.colorOutState = upscaleOutput.state;
         d.depthState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
         d.motionVectorsState = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
         d.exposureState = m_AutoExposure.GetFinalExposureTexture().state;
@@ -603,26 +737,32 @@ void Renderer::Pass_Upscale(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const
         DLSS::Evaluate(d);
     }
     GPU_MARKER_END(cmd, frameData.gpuTimers);
-
-    m_Upscale.outputs[m_FrameInFlightIdx].UavBarrier(cmd);
-    EnsureOutputState(m_FrameInFlightIdx, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
 }
 
 void Renderer::Pass_Bloom(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 {
+    const u32 mipCount = m_PostGraph.bloomMipCount;
     if (!g_Settings.bloomEnabled || g_Settings.bloomIntensity <= 0.0f)
     {
+        // The graph still expects every pass; only the barriers are recorded and tone mapping skips the bloom texture.
+        for (u32 mip = 0; mip < mipCount; ++mip)
+        {
+            m_TransientTextures.BeginPass(cmd, m_PostGraph.bloomDownPasses[mip]);
+        }
+        for (i32 mip = static_cast<i32>(mipCount) - 2; mip >= 0; --mip)
+        {
+            m_TransientTextures.BeginPass(cmd, m_PostGraph.bloomUpPasses[mip]);
+        }
         return;
     }
 
     PerFrameData& frameData = GetCurrentFrameData();
-    GpuResource* source = &m_Upscale.outputs[m_FrameInFlightIdx];
-    u32 sourceSrvIndex = m_Upscale.outputs[m_FrameInFlightIdx].srvIndex;
-
-    source->Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
+    auto downChain = [&](u32 mip) -> Texture& { return m_TransientTextures.Get(m_PostGraph.bloomDown[mip]); };
+    auto upChain = [&](u32 mip) -> Texture& { return m_TransientTextures.Get(m_PostGraph.bloomUp[mip]); };
+    const u32 sourceSrvIndex = m_TransientTextures.Get(m_PostGraph.upscaleOutput).srvIndex;
 
     const u32 linearSamplerIndex = m_SceneResources.GetLinearSamplerIdx();
-    auto dispatchForMip = [&](u32 mip) { return XMUINT2(IE_DivRoundUp(m_Bloom.mipSizes[mip].x, 8u), IE_DivRoundUp(m_Bloom.mipSizes[mip].y, 8u)); };
+    auto dispatchForMip = [&](u32 mip) { return XMUINT2(IE_DivRoundUp(m_PostGraph.bloomMipSizes[mip].x, 8u), IE_DivRoundUp(m_PostGraph.bloomMipSizes[mip].y, 8u)); };
 
     GPU_MARKER_BEGIN(cmd, frameData.gpuTimers, "Bloom");
     {
@@ -630,12 +770,13 @@ void Renderer::Pass_Bloom(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 
         cmd->SetComputeRootSignature(m_Bloom.downsampleRootSig.Get());
         cmd->SetPipelineState(m_Bloom.downsamplePso.Get());
-        for (u32 mip = 0; mip < m_Bloom.mipCount; ++mip)
+        for (u32 mip = 0; mip < mipCount; ++mip)
         {
-            Texture& dst = m_Bloom.downChain[m_FrameInFlightIdx][mip];
+            Texture& dst = downChain(mip);
+            m_TransientTextures.BeginPass(cmd, m_PostGraph.bloomDownPasses[mip]);
 
             BloomDownsampleConstants c{};
-            c.inputTextureIndex = (mip == 0u) ? sourceSrvIndex : m_Bloom.downChain[m_FrameInFlightIdx][mip - 1u].srvIndex;
+            c.inputTextureIndex = (mip == 0u) ? sourceSrvIndex : downChain(mip - 1u).srvIndex;
             c.outputTextureIndex = dst.uavIndex;
             c.samplerIndex = linearSamplerIndex;
             c.applyThreshold = (mip == 0u) ? 1u : 0u;
@@ -643,33 +784,29 @@ void Renderer::Pass_Bloom(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
             c.softKnee = g_Settings.bloomSoftKnee;
 
             const XMUINT2 dispatch = dispatchForMip(mip);
-            dst.Transition(cmd, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
             cmd->SetComputeRoot32BitConstants(0, sizeof(c) / sizeof(u32), &c, 0);
             cmd->Dispatch(dispatch.x, dispatch.y, 1);
-            dst.UavBarrier(cmd);
-            dst.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
         }
 
-        if (m_Bloom.mipCount > 1u)
+        if (mipCount > 1u)
         {
             cmd->SetComputeRootSignature(m_Bloom.upsampleRootSig.Get());
             cmd->SetPipelineState(m_Bloom.upsamplePso.Get());
-            for (i32 mip = static_cast<i32>(m_Bloom.mipCount) - 2; mip >= 0; --mip)
+            for (i32 mip = static_cast<i32>(mipCount) - 2; mip >= 0; --mip)
             {
-                Texture& dst = m_Bloom.upChain[m_FrameInFlightIdx][mip];
+                const u32 level = static_cast<u32>(mip);
+                Texture& dst = upChain(level);
+                m_TransientTextures.BeginPass(cmd, m_PostGraph.bloomUpPasses[level]);
 
                 BloomUpsampleConstants c{};
-                c.baseTextureIndex = m_Bloom.downChain[m_FrameInFlightIdx][mip].srvIndex;
-                c.bloomTextureIndex = (mip == static_cast<i32>(m_Bloom.mipCount) - 2) ? m_Bloom.downChain[m_FrameInFlightIdx][mip + 1].srvIndex : m_Bloom.upChain[m_FrameInFlightIdx][mip + 1].srvIndex;
+                c.baseTextureIndex = downChain(level).srvIndex;
+                c.bloomTextureIndex = (level + 2u == mipCount) ? downChain(level + 1u).srvIndex : upChain(level + 1u).srvIndex;
                 c.outputTextureIndex = dst.uavIndex;
                 c.samplerIndex = linearSamplerIndex;
 
-                const XMUINT2 dispatch = dispatchForMip(static_cast<u32>(mip));
-                dst.Transition(cmd, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+                const XMUINT2 dispatch = dispatchForMip(level);
                 cmd->SetComputeRoot32BitConstants(0, sizeof(c) / sizeof(u32), &c, 0);
                 cmd->Dispatch(dispatch.x, dispatch.y, 1);
-                dst.UavBarrier(cmd);
-                dst.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
             }
         }
     }
@@ -682,12 +819,13 @@ void Renderer::Pass_Tonemap(const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 
     GPU_MARKER_BEGIN(cmd, frameData.gpuTimers, "Tone Mapping");
     {
+        m_TransientTextures.BeginPass(cmd, m_PostGraph.tonemapPass);
         m_Tonemap.sdrRt[m_FrameInFlightIdx].Transition(cmd, D3D12_RESOURCE_STATE_RENDER_TARGET);
 
         TonemapConstants t{};
-        t.srvIndex = m_Upscale.outputs[m_FrameInFlightIdx].srvIndex;
+        t.srvIndex = m_TransientTextures.Get(m_PostGraph.upscaleOutput).srvIndex;
         t.samplerIndex = m_SceneResources.GetLinearSamplerIdx();
-        t.bloomTextureIndex = (m_Bloom.mipCount > 1u) ? m_Bloom.upChain[m_FrameInFlightIdx][0].srvIndex : m_Bloom.downChain[m_FrameInFlightIdx][0].srvIndex;
+        t.bloomTextureIndex = m_TransientTextures.Get(m_PostGraph.GetBloomResult()).srvIndex;
         t.exposureTextureIndex = m_AutoExposure.GetFinalExposureTextureSrvIndex();
         t.contrast = g_Settings.toneMappingContrast;
         t.saturation = g_Settings.toneMappingSaturation;
@@ -712,6 +850,7 @@ void Renderer::Pass_ImGui(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const C
 
     GPU_MARKER_BEGIN(cmd, frameData.gpuTimers, "UI");
     {
+        m_TransientTextures.BeginPass(cmd, m_PostGraph.uiPass);
         RenderTarget& uiRt = m_Tonemap.uiRt[m_FrameInFlightIdx];
         uiRt.Transition(cmd, D3D12_RESOURCE_STATE_RENDER_TARGET);
         constexpr FLOAT clearColor[4] = {0.0f, 0.0f, 0.0f, 0.0f};
@@ -722,20 +861,26 @@ void Renderer::Pass_ImGui(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const C
         static ImGui_TimingValue gpuTimings[128];
         static ImGui_TimingValue cpuTimings[128];
 
-        const f32 timingWindowMs = g_Settings.timingAverageWindowMs;
+        auto fillTiming = [](ImGui_TimingValue& timing, const TimingState& state, const TimingState::TimDisp& last) {
+            const TimingStats stats = Timings_GetStats(state, last.name);
+            timing.name = last.name;
+            timing.ms = stats.mean;
+            timing.p95Ms = stats.p95;
+            timing.p99Ms = stats.p99;
+            timing.maxMs = stats.max;
+            timing.depth = last.depth;
+        };
 
         u32 nGpuTimings = m_GpuTimingState.lastCount;
         for (u32 i = 0; i < nGpuTimings; ++i)
         {
-            gpuTimings[i].name = m_GpuTimingState.last[i].name;
-            gpuTimings[i].ms = Timings_ComputeAverageWindowMs(m_GpuTimingState, gpuTimings[i].name, timingWindowMs);
+            fillTiming(gpuTimings[i], m_GpuTimingState, m_GpuTimingState.last[i]);
         }
 
         u32 nCpuTimings = m_CpuTimingState.lastCount;
         for (u32 i = 0; i < nCpuTimings; ++i)
         {
-            cpuTimings[i].name = m_CpuTimingState.last[i].name;
-            cpuTimings[i].ms = Timings_ComputeAverageWindowMs(m_CpuTimingState, cpuTimings[i].name, timingWindowMs);
+            fillTiming(cpuTimings[i], m_CpuTimingState, m_CpuTimingState.last[i]);
         }
 
         ImGui_FrameStats frameStats{};
@@ -747,8 +892,8 @@ void Renderer::Pass_ImGui(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const C
         frameStats.cameraPitch = cameraFrameData.pitch;
 
         const Raytracing::PathTracePassResources& pathTracePassResources = m_Raytracing.GetPathTracePassResources();
-        Texture& rrDiffuseAlbedo = m_DLSSRRGuides.diffuseAlbedo[m_FrameInFlightIdx];
-        Texture& rrSpecularAlbedo = m_DLSSRRGuides.specularAlbedo[m_FrameInFlightIdx];
+        Texture& rrDiffuseAlbedo = m_TransientTextures.Get(m_PostGraph.diffuseAlbedoGuide);
+        Texture& rrSpecularAlbedo = m_TransientTextures.Get(m_PostGraph.specularAlbedoGuide);
 
         ImGui_RenderParams rp{};
         rp.cmd = cmd.Get();
@@ -767,12 +912,16 @@ void Renderer::Pass_ImGui(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const C
         rp.dlssRRSpecularAlbedo = rrSpecularAlbedo.Get();
         rp.dlssRRNormalRoughness = m_GBuf.gbuffers[m_FrameInFlightIdx].normal.Get();
         rp.dlssRRSpecularHitDistance = pathTracePassResources.trace.hitDistanceTexture.Get();
-        rp.dlssRROutput = m_Upscale.outputs[m_FrameInFlightIdx].Get();
+        rp.dlssRROutput = m_TransientTextures.Get(m_PostGraph.upscaleOutput).Get();
         rp.frame = frameStats;
+        rp.frameTime = Timings_GetStats(m_FrameTimingState, kFrameTimingName);
+        rp.frameTimeHistogram = Timings_GetHistogram(m_FrameTimingState, kFrameTimingName);
         rp.gpuTimings = gpuTimings;
         rp.gpuTimingsCount = nGpuTimings;
         rp.cpuTimings = cpuTimings;
         rp.cpuTimingsCount = nCpuTimings;
+        const GpuMemory::Snapshot memory = GpuMemory::Query(m_RenderDevice.GetAllocator().Get());
+        rp.memory = &memory;
         ImGui_Render(rp);
     }
     GPU_MARKER_END(cmd, frameData.gpuTimers);
@@ -867,6 +1016,7 @@ void Renderer::EndFrame(const PerFrameData& frameData, const ComPtr<ID3D12Graphi
     m_Tonemap.backBufferRt[m_FrameInFlightIdx].Transition(cmd, D3D12_RESOURCE_STATE_PRESENT);
 
     m_RenderDevice.ExecuteFrame(frameData, cmd, m_StreamlineFrameIndex);
+    m_BindlessHeaps.Submit(m_RenderDevice.GetCommandQueue().Get());
     CheckFrameGenerationApiError();
     m_StreamlineFrameIndex++;
     m_FrameIndex++;
@@ -896,21 +1046,121 @@ void Renderer::ReloadShaders()
     IE_LogInfo("Reloading shaders...");
     Shader::ResetReloadStats();
 
+    // Every shader is gathered first so DXC can compile them all concurrently; pipelines are created afterwards from the results.
+    ShaderCompileQueue shaderQueue;
+    QueueShaders(shaderQueue);
+    shaderQueue.CompileAll();
+    CreatePipelines(shaderQueue);
+
+    const Shader::ReloadStats reloadStats = Shader::GetReloadStats();
+    IE_LogInfo("Shader reload done. Reloaded {}/{} (from cache {}, skipped {}, failed {}).", reloadStats.reloaded, reloadStats.total, reloadStats.cacheHits,
+               reloadStats.skipped, reloadStats.failed);
+}
+
+void Renderer::QueueShaders(ShaderCompileQueue& shaderQueue)
+{
     Vector<String> globalDefines;
-    CreateDepthPrePassPipelines(globalDefines);
-    CreateGBufferPassPipelines(globalDefines);
-    CreateDLSSRRGuidePassPipelines(globalDefines);
-    m_Sky.CreateProceduralSkyCubePipelines(m_RenderDevice.GetDevice(), globalDefines);
-    m_AutoExposure.CreatePipelines(m_RenderDevice.GetDevice(), globalDefines);
-    m_Sky.CreateSkyMotionPassPipelines(m_RenderDevice.GetDevice(), globalDefines);
-    CreateBloomPassPipelines(globalDefines);
-    CreateToneMapPassPipelines(globalDefines);
-
-    m_Raytracing.ReloadShaders();
+    QueueDepthPrePassShaders(shaderQueue, globalDefines);
+    QueueGBufferPassShaders(shaderQueue, globalDefines);
+    QueueDLSSRRGuidePassShaders(shaderQueue, globalDefines);
+    m_Sky.QueueProceduralSkyCubeShaders(shaderQueue, globalDefines);
+    m_AutoExposure.QueueShaders(shaderQueue, globalDefines);
+    m_Sky.QueueSkyMotionPassShaders(shaderQueue, globalDefines);
+    QueueBloomPassShaders(shaderQueue, globalDefines);
+    QueueToneMapPassShaders(shaderQueue, globalDefines);
+    m_Raytracing.QueueShaders(shaderQueue);
+}
+
+// Only passes with a shader that received new bytecode from the queue rebuild their pipelines.
+void Renderer::CreatePipelines(const ShaderCompileQueue& shaderQueue)
+{
+    CreateDepthPrePassPipelines(shaderQueue);
+    CreateGBufferPassPipelines(shaderQueue);
+    CreateDLSSRRGuidePassPipelines(shaderQueue);
+    m_Sky.CreateProceduralSkyCubePipelines(m_RenderDevice.GetDevice(), shaderQueue);
+    m_AutoExposure.CreatePipelines(m_RenderDevice.GetDevice(), shaderQueue);
+    m_Sky.CreateSkyMotionPassPipelines(m_RenderDevice.GetDevice(), shaderQueue);
+    CreateBloomPassPipelines(shaderQueue);
+    CreateToneMapPassPipelines(shaderQueue);
+
+    m_Raytracing.CreatePipelines(shaderQueue);
     m_Sky.MarkProceduralSkyDirty();
+}
 
-    const Shader::ReloadStats reloadStats = Shader::GetReloadStats();
-    IE_LogInfo("Shader reload done. Reloaded {}/{} (skipped {}, failed {}).", reloadStats.reloaded, reloadStats.total, reloadStats.skipped, reloadStats.failed);
+// Hands every current pipeline object to the device's retire list before CreatePipelines replaces some of them, so the
+// frames in flight that reference them finish without a GPU idle wait. Objects that are not replaced only gain a reference.
+void Renderer::RetirePipelines()
+{
+    Vector<ComPtr<ID3D12DeviceChild>> objects;
+    objects.insert(objects.end(), m_DepthPre.opaquePSO.begin(), m_DepthPre.opaquePSO.end());
+    objects.insert(objects.end(), m_DepthPre.alphaTestPSO.begin(), m_DepthPre.alphaTestPSO.end());
+    objects.insert(objects.end(), {m_DepthPre.opaqueRootSig, m_DepthPre.alphaTestRootSig});
+    for (const Array<ComPtr<ID3D12PipelineState>, CullMode_Count>& psos : m_GBuf.psos)
+    {
+        objects.insert(objects.end(), psos.begin(), psos.end());
+    }
+    objects.insert(objects.end(), m_GBuf.rootSigs.begin(), m_GBuf.rootSigs.end());
+    objects.insert(objects.end(), {m_DLSSRRGuides.rootSig, m_DLSSRRGuides.pso, m_Bloom.downsampleRootSig, m_Bloom.downsamplePso, m_Bloom.upsampleRootSig, m_Bloom.upsamplePso,
+                                   m_Tonemap.rootSig, m_Tonemap.pso, m_Tonemap.composeRootSig, m_Tonemap.composePso});
+    m_Sky.CollectPipelineObjects(objects);
+    m_AutoExposure.CollectPipelineObjects(objects);
+    m_Raytracing.CollectPipelineObjects(objects);
+    m_RenderDevice.RetireObjects(std::move(objects));
+}
+
+void Renderer::UpdateShaderHotReload()
+{
+    if (m_HotReloadCompile.valid())
+    {
+        if (m_HotReloadCompile.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+        m_HotReloadCompile.get();
+
+        RetirePipelines();
+        Shader::ResetReloadStats();
+        g_Stats.shadersCompilationSuccess = true;
+        m_HotReloadQueue->Publish();
+        CreatePipelines(*m_HotReloadQueue);
+        m_HotReloadQueue.reset();
+
+        const Shader::ReloadStats reloadStats = Shader::GetReloadStats();
+        IE_LogInfo("Shader hot reload done. Reloaded {}/{} (from cache {}, skipped {}, failed {}).", reloadStats.reloaded, reloadStats.total, reloadStats.cacheHits,
+                   reloadStats.skipped, reloadStats.failed);
+        return;
+    }
+
+    ShaderFileChanges changes;
+    if (!m_ShaderFileWatcher.ConsumeChanges(changes))
+    {
+        return;
+    }
+
+    m_HotReloadQueue = IE_MakeUniquePtr<ShaderCompileQueue>();
+    QueueShaders(*m_HotReloadQueue);
+    if (!changes.overflowed)
+    {
+        m_HotReloadQueue->RetainDependentsOf(changes.files);
+    }
+    if (m_HotReloadQueue->IsEmpty())
+    {
+        m_HotReloadQueue.reset();
+        return;
+    }
+
+    IE_LogInfo("Shader change detected, recompiling dependent shaders...");
+    m_HotReloadCompile = std::async(std::launch::async, [queue = m_HotReloadQueue.get()] { queue->Compile(); });
+}
+
+void Renderer::CancelShaderHotReload()
+{
+    if (m_HotReloadCompile.valid())
+    {
+        m_HotReloadCompile.wait();
+        m_HotReloadCompile = {};
+    }
+    m_HotReloadQueue.reset();
 }
 
 void Renderer::CreateRTVs()
@@ -966,17 +1216,19 @@ void Renderer::CreateRTVs()
 
         for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
         {
-            ReleaseSrv(m_BindlessHeaps, targets[i].srvIndex);
+            ReleaseSrv(m_BindlessHeaps, targets[i].srvIndex, targets[i].srvGeneration);
 
             IE_Check(device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, &renderTargetClearValue,
                                                      IID_PPV_ARGS(&targets[i].resource)));
             targets[i].state = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
             targets[i].SetName(resourceName);
+            GpuMemory::Track(targets[i].Get(), GpuMemoryCategory_RenderTargets);
 
             targets[i].rtv = rtvHeap->GetCPUDescriptorHandleForHeapStart();
             targets[i].rtv.ptr += i * device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
             device->CreateRenderTargetView(targets[i].Get(), &rtvDesc, targets[i].rtv);
             targets[i].srvIndex = m_BindlessHeaps.CreateSRV(targets[i].resource, srvDesc);
+            targets[i].srvGeneration = m_BindlessHeaps.GetGeneration(targets[i].srvIndex);
         }
     };
 
@@ -1014,6 +1266,7 @@ void Renderer::CreateDSV()
                                            m_DepthPre.dsvs[i].allocation.ReleaseAndGetAddressOf(), IID_PPV_ARGS(&m_DepthPre.dsvs[i].resource)));
         m_DepthPre.dsvs[i].state = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
         m_DepthPre.dsvs[i].SetName(L"Depth/Stencil : DSV");
+        GpuMemory::Track(m_DepthPre.dsvs[i].Get(), GpuMemoryCategory_RenderTargets, m_DepthPre.dsvs[i].allocation->GetSize());
 
         m_DepthPre.dsvs[i].dsv = m_DepthPre.dsvHeap->GetCPUDescriptorHandleForHeapStart();
         m_DepthPre.dsvs[i].dsv.ptr += i * device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
@@ -1056,92 +1309,39 @@ void Renderer::SetRenderAndPresentSize()
     m_RenderRect.bottom = static_cast<i32>(m_Upscale.renderSize.y);
 }
 
-void Renderer::CreateUpscaleResources()
+void Renderer::CreateTransientResources()
 {
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
-    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
-    {
-        ReleaseSrv(m_BindlessHeaps, m_Upscale.outputs[i].srvIndex);
+    m_TransientTextures.Release(m_BindlessHeaps);
+    m_RenderGraph.Reset();
+    DeclarePostProcessGraph(m_RenderGraph, m_Upscale.renderSize, m_Upscale.presentSize, m_PostGraph);
 
-        CD3DX12_RESOURCE_DESC desc =
-            CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, m_Upscale.presentSize.x, m_Upscale.presentSize.y, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-        IE_Check(
-            m_RenderDevice.GetDevice()->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_UNORDERED_ACCESS, nullptr, IID_PPV_ARGS(&m_Upscale.outputs[i].resource)));
-        m_Upscale.outputs[i].state = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
-        m_Upscale.outputs[i].SetName(L"Upscale Output");
+    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
+    m_RenderGraph.Compile([&](const D3D12_RESOURCE_DESC& desc) { return device->GetResourceAllocationInfo(0, 1, &desc); });
+    m_TransientTextures.Realize(m_RenderGraph, m_RenderDevice.GetAllocator().Get(), m_BindlessHeaps);
 
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Format = desc.Format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Texture2D.MipLevels = 1;
-        m_Upscale.outputs[i].srvIndex = m_BindlessHeaps.CreateSRV(m_Upscale.outputs[i].Get(), srvDesc);
-    }
+    const RenderGraph::Stats stats = m_RenderGraph.GetStats();
+    constexpr f64 kMiB = 1024.0 * 1024.0;
+    IE_LogInfo("Transient textures: {} over {} passes, {:.1f} MiB in {:.1f} MiB of heaps ({} aliased), {:.1f} MiB as committed copies per frame in flight",
+               stats.textureCount, stats.passCount, static_cast<f64>(stats.textureBytes) / kMiB, static_cast<f64>(stats.heapBytes) / kMiB, stats.aliasedTextureCount,
+               static_cast<f64>(stats.textureBytes * IE_Constants::frameInFlightCount) / kMiB);
 }
 
-void Renderer::CreateBloomResources()
+void Renderer::QueueDepthPrePassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
 {
-    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
-    CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
-    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-    srvDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srvDesc.Texture2D.MipLevels = 1;
-
-    D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
-    uavDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
-    uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-
-    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
-    {
-        for (u32 mip = 0; mip < BloomResources::kMaxMipCount; ++mip)
-        {
-            ReleaseTextureDescriptors(m_BindlessHeaps, m_Bloom.downChain[i][mip]);
-            ReleaseTextureDescriptors(m_BindlessHeaps, m_Bloom.upChain[i][mip]);
-        }
-    }
-
-    m_Bloom.mipCount = 0;
-    u32 width = (m_Upscale.presentSize.x > 1u) ? (m_Upscale.presentSize.x / 2u) : 1u;
-    u32 height = (m_Upscale.presentSize.y > 1u) ? (m_Upscale.presentSize.y / 2u) : 1u;
-    for (u32 mip = 0; mip < BloomResources::kMaxMipCount; ++mip)
-    {
-        m_Bloom.mipSizes[mip] = XMUINT2(width, height);
-        m_Bloom.mipCount = mip + 1u;
-        if (width == 1u && height == 1u)
-        {
-            break;
-        }
-        width = (width > 1u) ? (width / 2u) : 1u;
-        height = (height > 1u) ? (height / 2u) : 1u;
-    }
-
-    auto createTexture = [&](Texture& texture, const XMUINT2& size, const wchar_t* name) {
-        CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, size.x, size.y, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-        IE_Check(device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, nullptr, IID_PPV_ARGS(&texture.resource)));
-        texture.state = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
-        texture.SetName(name);
-        texture.srvIndex = m_BindlessHeaps.CreateSRV(texture.Get(), srvDesc);
-        texture.uavIndex = m_BindlessHeaps.CreateUAV(texture.Get(), uavDesc);
-    };
+    shaderQueue.Add(m_GBuf.amplificationShader, IE_SHADER_TYPE_AMPLIFICATION, "systems/gbuffer/gbuffer.as.hlsl", globalDefines);
+    shaderQueue.Add(m_DepthPre.opaqueMeshShader, IE_SHADER_TYPE_MESH, "systems/depth/depth_pre_opaque.ms.hlsl", globalDefines);
+    shaderQueue.Add(m_DepthPre.alphaTestMeshShader, IE_SHADER_TYPE_MESH, "systems/depth/depth_pre_alpha_test.ms.hlsl", globalDefines);
+    shaderQueue.Add(m_DepthPre.alphaTestShader, IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer_alpha_test.ps.hlsl", globalDefines);
+}
 
-    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
+void Renderer::CreateDepthPrePassPipelines(const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_GBuf.amplificationShader, &m_DepthPre.opaqueMeshShader, &m_DepthPre.alphaTestMeshShader, &m_DepthPre.alphaTestShader}))
     {
-        for (u32 mip = 0; mip < m_Bloom.mipCount; ++mip)
-        {
-            createTexture(m_Bloom.downChain[i][mip], m_Bloom.mipSizes[mip], L"Bloom Down");
-            createTexture(m_Bloom.upChain[i][mip], m_Bloom.mipSizes[mip], L"Bloom Up");
-        }
+        return;
     }
-}
 
-void Renderer::CreateDepthPrePassPipelines(const Vector<String>& globalDefines)
-{
     const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
-    Shader::ReloadOrCreate(m_GBuf.amplificationShader, IE_SHADER_TYPE_AMPLIFICATION, "systems/gbuffer/gbuffer.as.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_DepthPre.opaqueMeshShader, IE_SHADER_TYPE_MESH, "systems/depth/depth_pre_opaque.ms.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_DepthPre.alphaTestMeshShader, IE_SHADER_TYPE_MESH, "systems/depth/depth_pre_alpha_test.ms.hlsl", globalDefines);
 
     CD3DX12_DEPTH_STENCIL_DESC ds(D3D12_DEFAULT);
     ds.DepthFunc = D3D12_COMPARISON_FUNC_GREATER_EQUAL;
@@ -1176,8 +1376,6 @@ void Renderer::CreateDepthPrePassPipelines(const Vector<String>& globalDefines)
     }
 
     {
-        Shader::ReloadOrCreate(m_DepthPre.alphaTestShader, IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer_alpha_test.ps.hlsl", globalDefines);
-
         m_DepthPre.alphaTestRootSig = m_DepthPre.alphaTestShader->GetOrCreateRootSignature(device);
 
         D3DX12_MESH_SHADER_PIPELINE_STATE_DESC depthDesc{};
@@ -1220,20 +1418,30 @@ constexpr DXGI_FORMAT formats[GBuffer::targetCount] = {
 constexpr const wchar_t* rtvNames[GBuffer::targetCount] = {L"GBuffer Albedo", L"GBuffer Normal Roughness", L"GBuffer Normal Geometry", L"GBuffer Metallic", L"GBuffer Motion Vector",
                                                            L"GBuffer AO",     L"GBuffer Emissive"};
 
-void Renderer::CreateGBufferPassPipelines(const Vector<String>& globalDefines)
+void Renderer::QueueGBufferPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
 {
-    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
-    Shader::ReloadOrCreate(m_GBuf.amplificationShader, IE_SHADER_TYPE_AMPLIFICATION, "systems/gbuffer/gbuffer.as.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_GBuf.meshShader, IE_SHADER_TYPE_MESH, "systems/gbuffer/gbuffer.ms.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_GBuf.pixelShaders[AlphaMode_Opaque], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", globalDefines);
+    shaderQueue.Add(m_GBuf.amplificationShader, IE_SHADER_TYPE_AMPLIFICATION, "systems/gbuffer/gbuffer.as.hlsl", globalDefines);
+    shaderQueue.Add(m_GBuf.meshShader, IE_SHADER_TYPE_MESH, "systems/gbuffer/gbuffer.ms.hlsl", globalDefines);
+    shaderQueue.Add(m_GBuf.pixelShaders[AlphaMode_Opaque], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", globalDefines);
 
     Vector<String> blendDefines = globalDefines;
     blendDefines.push_back("ENABLE_BLEND");
-    Shader::ReloadOrCreate(m_GBuf.pixelShaders[AlphaMode_Blend], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", blendDefines);
+    shaderQueue.Add(m_GBuf.pixelShaders[AlphaMode_Blend], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", blendDefines);
 
     Vector<String> maskDefines = globalDefines;
     maskDefines.push_back("ENABLE_ALPHA_TEST");
-    Shader::ReloadOrCreate(m_GBuf.pixelShaders[AlphaMode_Mask], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", maskDefines);
+    shaderQueue.Add(m_GBuf.pixelShaders[AlphaMode_Mask], IE_SHADER_TYPE_PIXEL, "systems/gbuffer/gbuffer.ps.hlsl", maskDefines);
+}
+
+void Renderer::CreateGBufferPassPipelines(const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_GBuf.amplificationShader, &m_GBuf.meshShader, &m_GBuf.pixelShaders[AlphaMode_Opaque], &m_GBuf.pixelShaders[AlphaMode_Blend],
+                                 &m_GBuf.pixelShaders[AlphaMode_Mask]}))
+    {
+        return;
+    }
+
+    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
 
     for (AlphaMode alphaMode = AlphaMode_Opaque; alphaMode < AlphaMode_Count; alphaMode = static_cast<AlphaMode>(alphaMode + 1))
     {
@@ -1280,29 +1488,55 @@ void Renderer::CreateGBufferPassPipelines(const Vector<String>& globalDefines)
     }
 }
 
-void Renderer::CreateDLSSRRGuidePassPipelines(const Vector<String>& globalDefines)
+void Renderer::QueueDLSSRRGuidePassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
 {
+    shaderQueue.Add(m_DLSSRRGuides.cs, IE_SHADER_TYPE_COMPUTE, "systems/dlss/dlss_rr_guides.cs.hlsl", globalDefines);
+}
+
+void Renderer::CreateDLSSRRGuidePassPipelines(const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_DLSSRRGuides.cs}))
+    {
+        return;
+    }
+
     const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
-    Shader::ReloadOrCreate(m_DLSSRRGuides.cs, IE_SHADER_TYPE_COMPUTE, "systems/dlss/dlss_rr_guides.cs.hlsl", globalDefines);
     PipelineHelpers::CreateComputePipeline(device, m_DLSSRRGuides.cs, m_DLSSRRGuides.rootSig, m_DLSSRRGuides.pso);
 }
 
-void Renderer::CreateBloomPassPipelines(const Vector<String>& globalDefines)
+void Renderer::QueueBloomPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
+{
+    shaderQueue.Add(m_Bloom.downsampleCs, IE_SHADER_TYPE_COMPUTE, "systems/post/bloom_extract.cs.hlsl", globalDefines);
+    shaderQueue.Add(m_Bloom.upsampleCs, IE_SHADER_TYPE_COMPUTE, "systems/post/bloom_blur.cs.hlsl", globalDefines);
+}
+
+void Renderer::CreateBloomPassPipelines(const ShaderCompileQueue& shaderQueue)
 {
+    if (!shaderQueue.AnyUpdated({&m_Bloom.downsampleCs, &m_Bloom.upsampleCs}))
+    {
+        return;
+    }
+
     const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
 
-    Shader::ReloadOrCreate(m_Bloom.downsampleCs, IE_SHADER_TYPE_COMPUTE, "systems/post/bloom_extract.cs.hlsl", globalDefines);
     PipelineHelpers::CreateComputePipeline(device, m_Bloom.downsampleCs, m_Bloom.downsampleRootSig, m_Bloom.downsamplePso);
-
-    Shader::ReloadOrCreate(m_Bloom.upsampleCs, IE_SHADER_TYPE_COMPUTE, "systems/post/bloom_blur.cs.hlsl", globalDefines);
     PipelineHelpers::CreateComputePipeline(device, m_Bloom.upsampleCs, m_Bloom.upsampleRootSig, m_Bloom.upsamplePso);
 }
 
-void Renderer::CreateToneMapPassPipelines(const Vector<String>& globalDefines)
+void Renderer::QueueToneMapPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
+{
+    shaderQueue.Add(m_Tonemap.vxShader, IE_SHADER_TYPE_VERTEX, "shared/fullscreen.vs.hlsl", globalDefines);
+    shaderQueue.Add(m_Tonemap.pxShader, IE_SHADER_TYPE_PIXEL, "systems/post/tonemap.ps.hlsl", globalDefines);
+    shaderQueue.Add(m_Tonemap.composePxShader, IE_SHADER_TYPE_PIXEL, "systems/post/present_composite.ps.hlsl", globalDefines);
+}
+
+void Renderer::CreateToneMapPassPipelines(const ShaderCompileQueue& shaderQueue)
 {
-    Shader::ReloadOrCreate(m_Tonemap.vxShader, IE_SHADER_TYPE_VERTEX, "shared/fullscreen.vs.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_Tonemap.pxShader, IE_SHADER_TYPE_PIXEL, "systems/post/tonemap.ps.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_Tonemap.composePxShader, IE_SHADER_TYPE_PIXEL, "systems/post/present_composite.ps.hlsl", globalDefines);
+    if (!shaderQueue.AnyUpdated({&m_Tonemap.vxShader, &m_Tonemap.pxShader, &m_Tonemap.composePxShader}))
+    {
+        return;
+    }
+
     PipelineHelpers::CreateFullscreenGraphicsPipeline(m_RenderDevice.GetDevice(), m_Tonemap.vxShader, m_Tonemap.pxShader, DXGI_FORMAT_R8G8B8A8_UNORM, m_Tonemap.rootSig, m_Tonemap.pso);
     PipelineHelpers::CreateFullscreenGraphicsPipeline(m_RenderDevice.GetDevice(), m_Tonemap.vxShader, m_Tonemap.composePxShader, DXGI_FORMAT_R8G8B8A8_UNORM, m_Tonemap.composeRootSig,
                                                       m_Tonemap.composePso);
@@ -1330,7 +1564,7 @@ void Renderer::CreateGBufferPassResources()
 
         for (u32 t = 0; t < GBuffer::targetCount; ++t)
         {
-            ReleaseSrv(m_BindlessHeaps, targets[t]->srvIndex);
+            ReleaseSrv(m_BindlessHeaps, targets[t]->srvIndex, targets[t]->srvGeneration);
 
             CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(formats[t], m_Upscale.renderSize.x, m_Upscale.renderSize.y, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
 
@@ -1340,52 +1574,20 @@ void Renderer::CreateGBufferPassResources()
             IE_Check(device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, &clearValue, IID_PPV_ARGS(&targets[t]->resource)));
             targets[t]->state = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
             targets[t]->SetName(rtvNames[t]);
+            GpuMemory::Track(targets[t]->Get(), GpuMemoryCategory_RenderTargets);
 
             targets[t]->rtv = rtvHandle;
             device->CreateRenderTargetView(targets[t]->Get(), nullptr, targets[t]->rtv);
 
             srv2D.Format = targets[t]->GetDesc().Format;
             targets[t]->srvIndex = m_BindlessHeaps.CreateSRV(targets[t]->resource, srv2D);
+            targets[t]->srvGeneration = m_BindlessHeaps.GetGeneration(targets[t]->srvIndex);
 
             rtvHandle.ptr += device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
         }
     }
 }
 
-void Renderer::CreateDLSSRRGuideResources()
-{
-    const ComPtr<ID3D12Device14>& device = m_RenderDevice.GetDevice();
-    const CD3DX12_HEAP_PROPERTIES heapProps(D3D12_HEAP_TYPE_DEFAULT);
-    const XMUINT2 size = m_Upscale.renderSize;
-
-    auto createGuideTexture = [&](Texture& texture, DXGI_FORMAT format, const wchar_t* name) {
-        const CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(format, size.x, size.y, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-        IE_Check(device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, nullptr, IID_PPV_ARGS(&texture.resource)));
-        texture.state = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
-        texture.SetName(name);
-
-        D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
-        srvDesc.Format = format;
-        srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvDesc.Texture2D.MipLevels = 1;
-        texture.srvIndex = m_BindlessHeaps.CreateSRV(texture.resource, srvDesc);
-
-        D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
-        uavDesc.Format = format;
-        uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-        texture.uavIndex = m_BindlessHeaps.CreateUAV(texture.resource, uavDesc);
-    };
-
-    for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
-    {
-        ReleaseTextureDescriptors(m_BindlessHeaps, m_DLSSRRGuides.diffuseAlbedo[i]);
-        ReleaseTextureDescriptors(m_BindlessHeaps, m_DLSSRRGuides.specularAlbedo[i]);
-        createGuideTexture(m_DLSSRRGuides.diffuseAlbedo[i], DXGI_FORMAT_R16G16B16A16_FLOAT, L"DLSS RR Diffuse Albedo");
-        createGuideTexture(m_DLSSRRGuides.specularAlbedo[i], DXGI_FORMAT_R16G16B16A16_FLOAT, L"DLSS RR Specular Albedo");
-    }
-}
-
 void Renderer::InvalidateRuntimeDescriptorIndices()
 {
     for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
@@ -1400,26 +1602,11 @@ void Renderer::InvalidateRuntimeDescriptorIndices()
         m_GBuf.gbuffers[i].ao.srvIndex = UINT32_MAX;
         m_GBuf.gbuffers[i].emissive.srvIndex = UINT32_MAX;
 
-        m_DLSSRRGuides.diffuseAlbedo[i].srvIndex = UINT32_MAX;
-        m_DLSSRRGuides.diffuseAlbedo[i].uavIndex = UINT32_MAX;
-        m_DLSSRRGuides.specularAlbedo[i].srvIndex = UINT32_MAX;
-        m_DLSSRRGuides.specularAlbedo[i].uavIndex = UINT32_MAX;
-
-        m_Upscale.outputs[i].srvIndex = UINT32_MAX;
-        m_Upscale.outputs[i].uavIndex = UINT32_MAX;
-
         m_Tonemap.sdrRt[i].srvIndex = UINT32_MAX;
         m_Tonemap.uiRt[i].srvIndex = UINT32_MAX;
-
-        for (u32 mip = 0; mip < BloomResources::kMaxMipCount; ++mip)
-        {
-            m_Bloom.downChain[i][mip].srvIndex = UINT32_MAX;
-            m_Bloom.downChain[i][mip].uavIndex = UINT32_MAX;
-            m_Bloom.upChain[i][mip].srvIndex = UINT32_MAX;
-            m_Bloom.upChain[i][mip].uavIndex = UINT32_MAX;
-        }
     }
 
+    m_TransientTextures.InvalidateDescriptorIndices();
     m_AutoExposure.InvalidateDescriptorIndices();
     m_Raytracing.InvalidatePathTraceDescriptorIndices();
 }
@@ -1444,10 +1631,8 @@ void Renderer::RecreateRuntimeFrameResources(const bool recreateSkyCube)
     CreateRTVs();
     CreateDSV();
     CreateSceneDepthSRVs();
-    CreateUpscaleResources();
-    CreateBloomResources();
+    CreateTransientResources();
     CreateGBufferPassResources();
-    CreateDLSSRRGuideResources();
     if (recreateSkyCube)
     {
         m_Sky.CreateProceduralSkyCubeResources(m_RenderDevice.GetDevice(), m_BindlessHeaps);
@@ -1481,8 +1666,10 @@ void Renderer::ReloadRuntimeAndScene(const String& sceneFile)
 
     m_BindlessHeaps.ResetAll();
     InvalidateRuntimeDescriptorIndices();
+    ReleaseDrawInstanceBuffers();
 
     m_RenderDevice.ClearAllTrackedUploads();
+    m_RenderDevice.ReleaseAllRetiredObjects();
 
     m_SceneResources.Reset();
     m_Culling.Reset();
@@ -1502,8 +1689,9 @@ void Renderer::CreateSceneDepthSRVs()
     depthSrvDesc.Texture2D.MipLevels = 1;
     for (u32 i = 0; i < IE_Constants::frameInFlightCount; ++i)
     {
-        ReleaseSrv(m_BindlessHeaps, m_DepthPre.dsvs[i].srvIndex);
+        ReleaseSrv(m_BindlessHeaps, m_DepthPre.dsvs[i].srvIndex, m_DepthPre.dsvs[i].srvGeneration);
         m_DepthPre.dsvs[i].srvIndex = m_BindlessHeaps.CreateSRV(m_DepthPre.dsvs[i].resource, depthSrvDesc);
+        m_DepthPre.dsvs[i].srvGeneration = m_BindlessHeaps.GetGeneration(m_DepthPre.dsvs[i].srvIndex);
     }
 }
 
@@ -1575,6 +1763,7 @@ void Renderer::PresentLoadingFrame()
     loadingRt.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
     backBuffer.Transition(cmd, D3D12_RESOURCE_STATE_PRESENT);
     m_RenderDevice.ExecuteFrame(frameData, cmd, m_StreamlineFrameIndex);
+    m_BindlessHeaps.Submit(m_RenderDevice.GetCommandQueue().Get());
     CheckFrameGenerationApiError();
     m_StreamlineFrameIndex++;
 }
@@ -1582,6 +1771,7 @@ void Renderer::PresentLoadingFrame()
 void Renderer::SubmitSceneUploadAndSync(PerFrameData& frameData, const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 {
     m_RenderDevice.ExecuteAndWait(frameData, cmd);
+    m_BindlessHeaps.Submit(m_RenderDevice.GetCommandQueue().Get());
 }
 
 void Renderer::ReloadRuntimeForUpscalingConfigChange()
@@ -1624,10 +1814,20 @@ void Renderer::LoadScene(const String& sceneFile)
     m_Raytracing.Init(cmd, m_Upscale.renderSize, m_SceneResources.GetPrimitives(), scene.primitives, rtInstances);
     SubmitSceneUploadAndSync(frameData, cmd);
 
+    // BLAS compaction needs the compacted sizes written by the builds above, so the TLAS goes on a second list.
+    IE_Check(frameData.commandAllocator->Reset());
+    IE_Check(frameData.cmd->Reset(frameData.commandAllocator.Get(), nullptr));
+    cmd->SetDescriptorHeaps(static_cast<UINT>(descriptorHeaps.size()), descriptorHeaps.data());
+    m_Raytracing.CompactBottomLevel(cmd);
+    m_Raytracing.InitTopLevel(cmd, rtInstances);
+    SubmitSceneUploadAndSync(frameData, cmd);
+
     m_SceneResources.SetCurrentSceneFile(resolvedScene);
     m_TestMovePrev = false;
     m_TestBaseWorlds.clear();
     m_FrameIndex = 0;
+
+    GpuMemory::LogSnapshot(GpuMemory::Query(m_RenderDevice.GetAllocator().Get()), resolvedScene.c_str());
 }
 
 void Renderer::ProcessPendingSceneSwitch()
@@ -1739,6 +1939,81 @@ void Renderer::RequestShaderReload()
     m_PendingShaderReload = true;
 }
 
+void Renderer::RequestCpuTraceCapture()
+{
+    if (!IsCapturingCpuTrace())
+    {
+        m_PendingCpuTraceCapture = true;
+    }
+}
+
+bool Renderer::IsCapturingCpuTrace() const
+{
+    return m_PendingCpuTraceCapture || m_CpuTraceFramesRemaining > 0;
+}
+
+bool Renderer::ExportTimingStats(const std::filesystem::path& path) const
+{
+    return Timings_WriteStatsJson(path, {{"frame", &m_FrameTimingState}, {"cpu", &m_CpuTimingState}, {"gpu", &m_GpuTimingState}});
+}
+
+void Renderer::RequestTimingStatsExport()
+{
+    m_PendingTimingStatsExport = true;
+}
+
+bool Renderer::IsBenchmarkRunning() const
+{
+    return m_Benchmark.IsActive();
+}
+
+bool Renderer::IsBenchmarkFinished() const
+{
+    return m_Benchmark.IsFinished();
+}
+
+void Renderer::ApplyBenchmarkCamera()
+{
+    const CameraPathPose pose = m_Benchmark.GetCameraPose();
+    m_Camera.SetPose(XMFLOAT3(pose.position[0], pose.position[1], pose.position[2]), pose.yaw, pose.pitch);
+}
+
+void Renderer::RequestTimelineCapture()
+{
+    if (m_TimelineCapture.IsRolling())
+    {
+        m_PendingTimelineWrite = true;
+    }
+    else if (!m_TimelineCapture.IsActive())
+    {
+        m_TimelineCapture.Start(kTimelineCaptureFrames, false, m_GpuTimingState.timestampFrequency);
+    }
+}
+
+bool Renderer::IsCapturingTimeline() const
+{
+    return m_TimelineCapture.IsActive() && !m_TimelineCapture.IsRolling();
+}
+
+void Renderer::WriteTimelineCapture()
+{
+    m_PendingTimelineWrite = false;
+    const std::filesystem::path timelinePath = std::filesystem::path("data/profiles") / std::format("timeline_{}{}", m_TimelineCapture.GetCurrentFrame(), IETimeline::TIMELINE_FILE_EXTENSION);
+    if (m_TimelineCapture.Write(timelinePath))
+    {
+        IE_LogInfo("Frame timeline written to {}.", timelinePath.generic_string());
+    }
+    else
+    {
+        IE_LogWarn("Frame timeline could not be written to {}.", timelinePath.generic_string());
+    }
+
+    if (!m_TimelineCapture.IsRolling())
+    {
+        m_TimelineCapture.Stop();
+    }
+}
+
 void Renderer::RequestSceneSwitch(const String& sceneFile)
 {
     const bool hadPendingSceneSwitch = m_SceneResources.HasPendingSceneSwitch();
@@ -1825,7 +2100,7 @@ const Vector<SceneUtils::SceneListEntry>& Renderer::GetAvailableScenes() const
 
 void Renderer::SetBufferData(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const SharedPtr<Buffer>& dst, const void* data, u32 sizeInBytes, u32 offsetInBytes)
 {
-    m_RenderDevice.SetBufferData(cmd, dst, data, sizeInBytes, offsetInBytes);
+    m_RenderDevice.SetBufferData(m_BindlessHeaps, cmd, dst, data, sizeInBytes, offsetInBytes);
 }
 
 const ComPtr<ID3D12Device14>& Renderer::GetDevice() const
@@ -6,8 +6,10 @@
 #pragma once
 
 #include <dxgi1_6.h>
+#include <future>
 
 #include "AutoExposure.h"
+#include "Benchmark.h"
 #include "BindlessHeaps.h"
 #include "Buffer.h"
 #include "Camera.h"
@@ -17,15 +19,20 @@
 #include "Environments.h"
 #include "GBuffer.h"
 #include "GpuResource.h"
+#include "PostProcessGraph.h"
 #include "Primitive.h"
 #include "Raytracing.h"
 #include "RenderDevice.h"
+#include "RenderGraph.h"
 #include "RenderSceneTypes.h"
 #include "SceneResources.h"
 #include "Shader.h"
+#include "ShaderFileWatcher.h"
 #include "Sky.h"
 #include "Texture.h"
+#include "TimelineCapture.h"
 #include "Timings.h"
+#include "TransientTextures.h"
 #include "common/IskurPackFormat.h"
 #include "shaders/CPUGPU.h"
 
@@ -64,6 +71,19 @@ class Renderer
     void SetCurrentEnvironmentIndex(i32 index);
 
     void RequestShaderReload();
+    // Records the next frames with the CPU profiler and writes them to data/profiles as a Chrome trace.
+    void RequestCpuTraceCapture();
+    bool IsCapturingCpuTrace() const;
+    // Writes the rolling timeline kept by --capture-frames, or records the next frames' CPU and GPU timeline when none is kept.
+    void RequestTimelineCapture();
+    bool IsCapturingTimeline() const;
+    // Writes the windowed frame, CPU and GPU timing statistics and histograms as JSON.
+    bool ExportTimingStats(const std::filesystem::path& path) const;
+    void RequestTimingStatsExport();
+    // Benchmark mode (--benchmark): the camera follows the benchmark path instead of input, and the window closes once it finished.
+    bool IsBenchmarkRunning() const;
+    bool IsBenchmarkFinished() const;
+    void ApplyBenchmarkCamera();
     void RequestSceneSwitch(const String& sceneFile);
     void RequestDLSSMode(DLSS::Mode mode);
     void RequestFrameGenerationEnabled(bool enabled);
@@ -121,9 +141,6 @@ class Renderer
         SharedPtr<Shader> cs;
         ComPtr<ID3D12RootSignature> rootSig;
         ComPtr<ID3D12PipelineState> pso;
-
-        Array<Texture, IE_Constants::frameInFlightCount> diffuseAlbedo;
-        Array<Texture, IE_Constants::frameInFlightCount> specularAlbedo;
     } m_DLSSRRGuides{};
 
     struct ToneMapResources
@@ -146,12 +163,6 @@ class Renderer
 
     struct BloomResources
     {
-        static constexpr u32 kMaxMipCount = 6;
-        u32 mipCount = 0;
-        Array<XMUINT2, kMaxMipCount> mipSizes{};
-        Array<Array<Texture, kMaxMipCount>, IE_Constants::frameInFlightCount> downChain{};
-        Array<Array<Texture, kMaxMipCount>, IE_Constants::frameInFlightCount> upChain{};
-
         ComPtr<ID3D12RootSignature> downsampleRootSig;
         ComPtr<ID3D12PipelineState> downsamplePso;
         SharedPtr<Shader> downsampleCs;
@@ -165,30 +176,41 @@ class Renderer
     {
         XMUINT2 renderSize{};
         XMUINT2 presentSize{};
-        Array<Texture, IE_Constants::frameInFlightCount> outputs;
     } m_Upscale{};
 
+    // DLSS RR guides, upscale output and bloom chain: one copy of each, aliased where their lifetimes allow.
+    RenderGraph m_RenderGraph;
+    PostProcessGraph m_PostGraph{};
+    TransientTextures m_TransientTextures;
+
     void CreateRTVs();
     void CreateDSV();
 
     void SetRenderAndPresentSize();
 
-    void CreateUpscaleResources();
-    void CreateBloomResources();
+    void CreateTransientResources();
     void CreateGBufferPassResources();
-    void CreateDLSSRRGuideResources();
 
-    void CreateDepthPrePassPipelines(const Vector<String>& globalDefines);
-    void CreateGBufferPassPipelines(const Vector<String>& globalDefines);
-    void CreateDLSSRRGuidePassPipelines(const Vector<String>& globalDefines);
-    void CreateBloomPassPipelines(const Vector<String>& globalDefines);
-    void CreateToneMapPassPipelines(const Vector<String>& globalDefines);
+    void QueueDepthPrePassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void QueueGBufferPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void QueueDLSSRRGuidePassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void QueueBloomPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void QueueToneMapPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+
+    void CreateDepthPrePassPipelines(const ShaderCompileQueue& shaderQueue);
+    void CreateGBufferPassPipelines(const ShaderCompileQueue& shaderQueue);
+    void CreateDLSSRRGuidePassPipelines(const ShaderCompileQueue& shaderQueue);
+    void CreateBloomPassPipelines(const ShaderCompileQueue& shaderQueue);
+    void CreateToneMapPassPipelines(const ShaderCompileQueue& shaderQueue);
 
     void ReloadRuntimeAndScene(const String& sceneFile);
     void ReloadRuntimeForUpscalingConfigChange();
     void LoadScene(const String& sceneFile);
     void ProcessPendingSceneSwitch();
     void BeginFrame(PerFrameData& frameData, ComPtr<ID3D12GraphicsCommandList7>& cmd, Camera::FrameData& cameraFrameData, f32& jitterNormX, f32& jitterNormY);
+    void UploadDrawInstances();
+    void ReleaseDrawInstanceBuffers();
+    void DrawPrimitiveGroups(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Vector<PrimitiveRenderData>& drawGroups) const;
     void Pass_DepthPre(const ComPtr<ID3D12GraphicsCommandList7>& cmd);
     void Pass_GBuffer(const ComPtr<ID3D12GraphicsCommandList7>& cmd);
     void Pass_DLSSRRGuides(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const Camera::FrameData& cameraFrameData);
@@ -202,7 +224,12 @@ class Renderer
     void CheckFrameGenerationApiError();
 
     void WaitForGpuIdle();
+    void QueueShaders(ShaderCompileQueue& shaderQueue);
+    void CreatePipelines(const ShaderCompileQueue& shaderQueue);
+    void RetirePipelines();
     void ReloadShaders();
+    void UpdateShaderHotReload();
+    void CancelShaderHotReload();
 
     u32 m_FrameInFlightIdx = 0;
     u32 m_FrameIndex = 0;
@@ -212,6 +239,9 @@ class Renderer
     u8* m_ConstantsCbMapped = nullptr;
     u32 m_ConstantsCbStride = 0;
 
+    Array<SharedPtr<Buffer>, IE_Constants::frameInFlightCount> m_DrawInstanceBuffers{};
+    Array<u8*, IE_Constants::frameInFlightCount> m_DrawInstanceBuffersMapped{};
+
     D3D12_VIEWPORT m_RenderViewport = {0, 0, 0, 0, 0, 0};
     D3D12_RECT m_RenderRect = {0, 0, 0, 0};
     D3D12_VIEWPORT m_PresentViewport = {0, 0, 0, 0, 0, 0};
@@ -220,6 +250,8 @@ class Renderer
     TimingState m_GpuTimingState{};
     CpuTimers m_CpuTimers{};
     TimingState m_CpuTimingState{};
+    static constexpr const char* kFrameTimingName = "Frame";
+    TimingState m_FrameTimingState{};
 
     Camera m_Camera;
     Raytracing m_Raytracing;
@@ -239,4 +271,20 @@ class Renderer
     Environments m_Environments;
 
     bool m_PendingShaderReload = false;
+    static constexpr u32 kCpuTraceCaptureFrames = 60;
+    u32 m_CpuTraceFramesRemaining = 0;
+    bool m_PendingCpuTraceCapture = false;
+
+    void WriteTimelineCapture();
+    static constexpr u32 kTimelineCaptureFrames = 300;
+    TimelineCapture m_TimelineCapture;
+    bool m_PendingTimelineWrite = false;
+    bool m_PendingTimingStatsExport = false;
+
+    Benchmark m_Benchmark;
+
+    // Edits under data/shaders recompile their dependent shaders off-thread; the new PSOs are swapped in at a frame boundary.
+    ShaderFileWatcher m_ShaderFileWatcher;
+    UniquePtr<ShaderCompileQueue> m_HotReloadQueue;
+    std::future<void> m_HotReloadCompile;
 };
@@ -26,6 +26,7 @@ struct RuntimeSettings
     bool cpuFrustumCulling = true;
     bool gpuFrustumCulling = true;
     bool gpuBackfaceCulling = true;
+    u32 drawSortMode = 1; // 0=Instance Order, 1=Front To Back, 2=By Primitive
 
     f32 sunAzimuth = IE_ToRadians(210.0f);
     f32 sunElevation = IE_ToRadians(240.0f);
@@ -50,6 +51,9 @@ struct RuntimeSettings
     bool rtOmmsEnabled = true;
     bool rtUse2StateOmmRays = true;
     bool rtSerEnabled = true;
+    u32 rtBuildScratchBudgetMiB = 64; // shared BLAS/OMM build scratch per batch, applied on scene load
+    f32 rtTlasRebuildDrift = 0.1f;    // mean instance drift (in bounding radii) since the last full TLAS build before refitting stops
+    f32 rtTlasRebuildMaxDrift = 2.0f; // drift of any single instance (in bounding radii) before refitting stops
 
     u32 rtPathTraceSpp = 1;
     u32 rtMaxBounces = 12;
@@ -67,6 +71,14 @@ struct RuntimeStats
     u32 cpuFrustumCullTotalInstances = 0;
     u32 cpuFrustumCullRasterSubmitted = 0;
     u32 cpuFrustumCullRasterCulled = 0;
+    u32 cpuFrustumCullBoxCulled = 0;
+    u32 rasterDrawGroups = 0;
+    u64 rtBlasUncompactedBytes = 0;
+    u64 rtBlasCompactedBytes = 0;
+    u32 rtTlasUpdatedInstances = 0;
+    f32 rtTlasDrift = 0.0f;
+    f32 rtTlasMaxDrift = 0.0f;
+    bool rtTlasRefit = false;
     bool shadersCompilationSuccess = true;
 };
 
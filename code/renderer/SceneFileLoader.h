@@ -6,6 +6,7 @@
 #pragma once
 
 #include "common/IskurPackFormat.h"
+#include "common/Types.h"
 
 #include <filesystem>
 
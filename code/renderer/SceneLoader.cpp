@@ -210,10 +210,16 @@ void SceneLoader::BuildPrimitives(LoadedScene& outScene, const SceneFileData& sc
         prim.ommDataByteCount = r.ommDataByteSize;
         prim.ommFormat = r.ommFormat;
         prim.meshletCount = r.meshletCount;
-        prim.localBoundsCenter = r.localBoundsCenter;
+        prim.localBoundsCenter = XMFLOAT3(r.localBoundsCenter);
         prim.localBoundsRadius = r.localBoundsRadius;
+        prim.localBoxCenter = XMFLOAT3(r.localBoxCenter);
+        prim.localBoxHalfExtents = XMFLOAT3(r.localBoxHalfExtents);
+        prim.localBoxRotation = XMFLOAT4(r.localBoxRotation);
         IE_Assert(IsFiniteFloat3(prim.localBoundsCenter));
         IE_Assert(IE_IsFinite(prim.localBoundsRadius) && prim.localBoundsRadius >= 0.0f);
+        IE_Assert(IsFiniteFloat3(prim.localBoxCenter) && IsFiniteFloat3(prim.localBoxHalfExtents));
+        IE_Assert(prim.localBoxHalfExtents.x >= 0.0f && prim.localBoxHalfExtents.y >= 0.0f && prim.localBoxHalfExtents.z >= 0.0f);
+        IE_Assert(IE_IsFinite(prim.localBoxRotation.x) && IE_IsFinite(prim.localBoxRotation.y) && IE_IsFinite(prim.localBoxRotation.z) && IE_IsFinite(prim.localBoxRotation.w));
 
         outScene.primitives.push_back(std::move(prim));
     }
@@ -228,12 +234,12 @@ void SceneLoader::BuildInstances(LoadedScene& outScene, const SceneFileData& sce
     {
         IE_Assert(inst.primIndex < outScene.primitives.size());
         IE_Assert(inst.materialIndex < outScene.materials.size());
-        IE_Assert(IsFiniteFloat4x4(inst.world));
 
         InstanceData instance{};
         instance.primIndex = inst.primIndex;
         instance.materialIndex = inst.materialIndex;
-        instance.world = inst.world;
+        instance.world = XMFLOAT4X4(&inst.world[0][0]);
+        IE_Assert(IsFiniteFloat4x4(instance.world));
         outScene.instances.push_back(instance);
     }
 }
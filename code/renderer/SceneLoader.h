@@ -76,6 +76,9 @@ struct LoadedPrimitive
     u32 meshletCount = 0;
     XMFLOAT3 localBoundsCenter = {0.0f, 0.0f, 0.0f};
     f32 localBoundsRadius = 0.0f;
+    XMFLOAT3 localBoxCenter = {0.0f, 0.0f, 0.0f};
+    XMFLOAT3 localBoxHalfExtents = {0.0f, 0.0f, 0.0f};
+    XMFLOAT4 localBoxRotation = {0.0f, 0.0f, 0.0f, 1.0f};
 };
 
 struct LoadedScene
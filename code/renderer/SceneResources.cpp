@@ -6,6 +6,7 @@
 #include "SceneResources.h"
 
 #include <DirectXTex.h>
+#include <chrono>
 
 #include "BindlessHeaps.h"
 #include "RenderDevice.h"
@@ -22,6 +23,9 @@ void SceneResources::Reset()
     m_DefaultWrapSamplerIdx = UINT_MAX;
     m_LinearSamplerIdx = UINT_MAX;
 
+    // Reset follows BindlessHeaps::ResetAll, which already freed the texture SRVs; a live range here would leak.
+    IE_Assert(m_TextureSrvFirst == UINT32_MAX || !m_BindlessHeaps.IsLive(m_TextureSrvFirst, m_TextureSrvGeneration));
+    m_TextureSrvFirst = UINT32_MAX;
     m_TxhdToSrv.clear();
     m_SampToHeap.clear();
     m_Textures.clear();
@@ -199,6 +203,7 @@ Vector<Raytracing::RTInstance> SceneResources::BuildRTInstances() const
         IE_Assert(instance.materialIndex < m_Materials.size());
 
         Raytracing::RTInstance rtInstance{};
+        rtInstance.instanceIndex = static_cast<u32>(rtInstances.size());
         rtInstance.primIndex = instance.primIndex;
         rtInstance.materialIndex = instance.materialIndex;
         rtInstance.alphaMode = m_Materials[instance.materialIndex].alphaMode;
@@ -229,15 +234,48 @@ void SceneResources::ClearInstancesDirty()
     m_InstancesDirty = false;
 }
 
+void SceneResources::CreateTexturePool()
+{
+    // Textures larger than a block fall back to committed resources inside the pool. Small ones get the 4 KiB placement
+    // alignment from D3D12MA instead of the 64 KiB an implicit heap would round them up to.
+    D3D12MA::POOL_DESC poolDesc{};
+    poolDesc.Flags = D3D12MA_RECOMMENDED_POOL_FLAGS;
+    poolDesc.HeapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    poolDesc.HeapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES | D3D12MA_RECOMMENDED_HEAP_FLAGS;
+    poolDesc.BlockSize = 64ull * 1024ull * 1024ull;
+    IE_Check(m_RenderDevice.GetAllocator()->CreatePool(&poolDesc, &m_TexturePool));
+    m_TexturePool->SetName(L"Scene Textures");
+}
+
 void SceneResources::ImportSceneTextures(const LoadedScene& scene, const ComPtr<ID3D12GraphicsCommandList7>& cmd)
 {
     using namespace DirectX;
 
+    if (!m_TexturePool)
+    {
+        CreateTexturePool();
+    }
+
+    const std::chrono::steady_clock::time_point importBegin = std::chrono::steady_clock::now();
+    u64 smallAlignedCount = 0;
+    u64 allocationBytes = 0;
+    u64 committedEquivalentBytes = 0;
+
+    // A range still held belongs to the previous scene's textures; freeing it checks it was not reset or freed under us.
+    m_BindlessHeaps.FreeCbvSrvUavRange(m_TextureSrvFirst, static_cast<u32>(m_Textures.size()), m_TextureSrvGeneration);
+    m_TextureSrvFirst = UINT32_MAX;
     m_Textures.clear();
     m_TxhdToSrv.clear();
     m_Textures.reserve(scene.textures.size());
     m_TxhdToSrv.reserve(scene.textures.size());
 
+    // One contiguous block of SRVs, so the scene's texture table can be released or replaced as a unit.
+    if (!scene.textures.empty())
+    {
+        m_TextureSrvFirst = m_BindlessHeaps.AllocateCbvSrvUavRange(static_cast<u32>(scene.textures.size()));
+        m_TextureSrvGeneration = m_BindlessHeaps.GetGeneration(m_TextureSrvFirst);
+    }
+
     for (const LoadedTexture& src : scene.textures)
     {
         IE_Assert(src.texelBytes != nullptr && src.texelByteCount > 0);
@@ -254,10 +292,21 @@ void SceneResources::ImportSceneTextures(const LoadedScene& scene, const ComPtr<
         desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
 
         Texture texture{};
-        const CD3DX12_HEAP_PROPERTIES defaultHeap(D3D12_HEAP_TYPE_DEFAULT);
-        IE_Check(m_RenderDevice.GetDevice()->CreateCommittedResource(&defaultHeap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&texture.resource)));
+        D3D12MA::ALLOCATION_DESC allocDesc{};
+        allocDesc.CustomPool = m_TexturePool.Get();
+        IE_Check(m_RenderDevice.GetAllocator()->CreateResource(&allocDesc, &desc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, texture.allocation.ReleaseAndGetAddressOf(),
+                                                               IID_PPV_ARGS(texture.resource.ReleaseAndGetAddressOf())));
         texture.state = D3D12_RESOURCE_STATE_COPY_DEST;
         texture.SetName(L"Scene Texture");
+        GpuMemory::Track(texture.Get(), GpuMemoryCategory_Textures, texture.allocation->GetSize());
+
+        const u64 textureBytes = texture.allocation->GetSize();
+        allocationBytes += textureBytes;
+        committedEquivalentBytes += (textureBytes + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) / D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT * D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        if (texture.resource->GetDesc().Alignment == D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+        {
+            smallAlignedCount++;
+        }
 
         Vector<D3D12_SUBRESOURCE_DATA> subresources;
         subresources.reserve(src.subresourceCount);
@@ -273,15 +322,7 @@ void SceneResources::ImportSceneTextures(const LoadedScene& scene, const ComPtr<
             subresources.push_back(subresource);
         }
 
-        const UINT subresourceCount = static_cast<UINT>(subresources.size());
-        const UINT64 uploadSize = GetRequiredIntermediateSize(texture.resource.Get(), 0, subresourceCount);
-        RenderDevice::UploadTemp upload{};
-        const CD3DX12_HEAP_PROPERTIES uploadHeap(D3D12_HEAP_TYPE_UPLOAD);
-        const CD3DX12_RESOURCE_DESC uploadDesc = CD3DX12_RESOURCE_DESC::Buffer(uploadSize);
-        IE_Check(m_RenderDevice.GetDevice()->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &uploadDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&upload.resource)));
-        IE_Check(upload.resource->SetName(L"Scene Texture Upload"));
-
-        UpdateSubresources(cmd.Get(), texture.resource.Get(), upload.resource.Get(), 0, 0, subresourceCount, subresources.data());
+        m_RenderDevice.UploadTextureData(m_BindlessHeaps, cmd.Get(), texture.Get(), 0, static_cast<u32>(subresources.size()), subresources.data());
         texture.Transition(cmd, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
 
         D3D12_SHADER_RESOURCE_VIEW_DESC srv{};
@@ -333,10 +374,21 @@ void SceneResources::ImportSceneTextures(const LoadedScene& scene, const ComPtr<
             srv.Texture2D.MipLevels = static_cast<UINT>(src.mipLevels);
         }
 
-        texture.srvIndex = m_BindlessHeaps.CreateSRV(texture.resource, srv);
+        texture.srvIndex = m_TextureSrvFirst + static_cast<u32>(m_Textures.size());
+        texture.srvGeneration = m_TextureSrvGeneration;
+        m_BindlessHeaps.WriteSRV(texture.srvIndex, texture.srvGeneration, texture.resource, srv);
         m_TxhdToSrv.push_back(texture.srvIndex);
         m_Textures.push_back(std::move(texture));
-        m_RenderDevice.TrackUpload(std::move(upload));
+    }
+
+    if (!m_Textures.empty())
+    {
+        D3D12MA::Statistics poolStats{};
+        m_TexturePool->GetStatistics(&poolStats);
+        constexpr f64 toMiB = 1.0 / (1024.0 * 1024.0);
+        const f64 importMs = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - importBegin).count();
+        IE_LogInfo("Scene textures: {} imported in {:.1f} ms, {} with 4 KiB alignment, {:.1f} MiB in {:.1f} MiB of heaps ({:.1f} MiB saved over 64 KiB-aligned committed)",
+                   m_Textures.size(), importMs, smallAlignedCount, allocationBytes * toMiB, poolStats.BlockBytes * toMiB, (committedEquivalentBytes - allocationBytes) * toMiB);
     }
 }
 
@@ -454,63 +506,127 @@ void SceneResources::ImportScenePrimitives(const LoadedScene& scene, const ComPt
 {
     m_Primitives.clear();
     m_Primitives.reserve(scene.primitives.size());
+    if (scene.primitives.empty())
+    {
+        return;
+    }
 
+    // Every primitive is gathered into one buffer per geometry stream, so the five raster streams here plus the RT index buffer
+    // (Raytracing.cpp) cost a scene six allocations and six descriptors however many primitives it has. Primitives locate
+    // their ranges through the offsets passed in PrimitiveConstants.
+    u64 vertexCount = 0;
+    u64 meshletCount = 0;
+    u64 meshletVertexCount = 0;
+    u64 meshletTriangleBytes = 0;
+    for (const LoadedPrimitive& src : scene.primitives)
+    {
+        vertexCount += src.vertexCount;
+        meshletCount += src.meshletCount;
+        meshletVertexCount += src.meshletVertexCount;
+        meshletTriangleBytes += IE_AlignUp(src.meshletTriangleByteCount, 4u);
+    }
+    IE_Assert(vertexCount > 0 && meshletCount > 0 && meshletVertexCount > 0 && meshletTriangleBytes > 0);
+    IE_Assert(vertexCount * sizeof(Vertex) <= UINT32_MAX && meshletCount * sizeof(MeshletBounds) <= UINT32_MAX);
+    IE_Assert(meshletVertexCount * sizeof(u32) <= UINT32_MAX && meshletTriangleBytes <= UINT32_MAX);
+
+    Vector<Vertex> vertices(vertexCount);
+    Vector<Meshlet> meshlets(meshletCount);
+    Vector<u32> meshletVertices(meshletVertexCount);
+    Vector<u8> meshletTriangles(meshletTriangleBytes, 0);
+    Vector<MeshletBounds> meshletBounds(meshletCount);
+
+    u32 nextVertex = 0;
+    u32 nextMeshlet = 0;
+    u32 nextMeshletVertex = 0;
+    u32 nextMeshletTriangleByte = 0;
     for (const LoadedPrimitive& src : scene.primitives)
     {
         Primitive prim{};
         prim.meshletCount = src.meshletCount;
         prim.localBoundsCenter = src.localBoundsCenter;
         prim.localBoundsRadius = src.localBoundsRadius;
+        {
+            const XMVECTOR rotation = XMQuaternionNormalize(XMLoadFloat4(&src.localBoxRotation));
+            const XMMATRIX boxToObject = XMMatrixScaling(src.localBoxHalfExtents.x, src.localBoxHalfExtents.y, src.localBoxHalfExtents.z) * XMMatrixRotationQuaternion(rotation) *
+                                         XMMatrixTranslation(src.localBoxCenter.x, src.localBoxCenter.y, src.localBoxCenter.z);
+            XMStoreFloat4x4(&prim.localBoxToObject, boxToObject);
+        }
 
-        BufferCreateDesc d{};
-        d.heapType = D3D12_HEAP_TYPE_DEFAULT;
-        d.createSRV = true;
-        d.createUAV = false;
-        d.initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
-        d.finalState = D3D12_RESOURCE_STATE_GENERIC_READ;
-
-        d.viewKind = BufferCreateDesc::ViewKind::Structured;
-        d.sizeInBytes = src.vertexCount * sizeof(Vertex);
-        d.strideInBytes = sizeof(Vertex);
-        d.initialData = src.vertices;
-        d.initialDataSize = d.sizeInBytes;
-        d.name = L"Primitive/vertices";
-        prim.vertices = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
-
-        d.viewKind = BufferCreateDesc::ViewKind::Raw;
-        d.sizeInBytes = src.meshletCount * sizeof(Meshlet);
-        d.strideInBytes = 0;
-        d.initialData = src.meshlets;
-        d.initialDataSize = d.sizeInBytes;
-        d.name = L"Primitive/meshlets";
-        prim.meshlets = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
-
-        d.viewKind = BufferCreateDesc::ViewKind::Structured;
-        d.sizeInBytes = src.meshletVertexCount * sizeof(u32);
-        d.strideInBytes = sizeof(u32);
-        d.initialData = src.meshletVertices;
-        d.initialDataSize = d.sizeInBytes;
-        d.name = L"Primitive/meshletVertices";
-        prim.mlVerts = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
-
-        d.viewKind = BufferCreateDesc::ViewKind::Raw;
-        d.sizeInBytes = IE_AlignUp(src.meshletTriangleByteCount, 4u);
-        d.strideInBytes = 0;
-        d.initialData = src.meshletTriangles;
-        d.initialDataSize = src.meshletTriangleByteCount;
-        d.name = L"Primitive/meshletTriangles";
-        prim.mlTris = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
-
-        d.viewKind = BufferCreateDesc::ViewKind::Structured;
-        d.sizeInBytes = src.meshletCount * sizeof(MeshletBounds);
-        d.strideInBytes = sizeof(MeshletBounds);
-        d.initialData = src.meshletBounds;
-        d.initialDataSize = d.sizeInBytes;
-        d.name = L"Primitive/meshletBounds";
-        prim.mlBounds = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+        prim.baseVertex = nextVertex;
+        prim.firstMeshlet = nextMeshlet;
+        prim.meshletVertexOffset = nextMeshletVertex;
+        prim.meshletTriangleOffset = nextMeshletTriangleByte;
+
+        std::memcpy(vertices.data() + nextVertex, src.vertices, src.vertexCount * sizeof(Vertex));
+        std::memcpy(meshlets.data() + nextMeshlet, src.meshlets, src.meshletCount * sizeof(Meshlet));
+        std::memcpy(meshletBounds.data() + nextMeshlet, src.meshletBounds, src.meshletCount * sizeof(MeshletBounds));
+        std::memcpy(meshletVertices.data() + nextMeshletVertex, src.meshletVertices, src.meshletVertexCount * sizeof(u32));
+        std::memcpy(meshletTriangles.data() + nextMeshletTriangleByte, src.meshletTriangles, src.meshletTriangleByteCount);
+
+        nextVertex += src.vertexCount;
+        nextMeshlet += src.meshletCount;
+        nextMeshletVertex += src.meshletVertexCount;
+        nextMeshletTriangleByte += IE_AlignUp(src.meshletTriangleByteCount, 4u);
 
         m_Primitives.push_back(std::move(prim));
     }
+
+    BufferCreateDesc d{};
+    d.heapType = D3D12_HEAP_TYPE_DEFAULT;
+    d.memoryCategory = GpuMemoryCategory_Geometry;
+    d.createSRV = true;
+    d.createUAV = false;
+    d.initialState = D3D12_RESOURCE_STATE_GENERIC_READ;
+    d.finalState = D3D12_RESOURCE_STATE_GENERIC_READ;
+
+    d.viewKind = BufferCreateDesc::ViewKind::Structured;
+    d.sizeInBytes = static_cast<u32>(vertices.size() * sizeof(Vertex));
+    d.strideInBytes = sizeof(Vertex);
+    d.initialData = vertices.data();
+    d.initialDataSize = d.sizeInBytes;
+    d.name = L"Scene/vertices";
+    const SharedPtr<Buffer> verticesBuffer = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+
+    d.viewKind = BufferCreateDesc::ViewKind::Raw;
+    d.sizeInBytes = static_cast<u32>(meshlets.size() * sizeof(Meshlet));
+    d.strideInBytes = 0;
+    d.initialData = meshlets.data();
+    d.initialDataSize = d.sizeInBytes;
+    d.name = L"Scene/meshlets";
+    const SharedPtr<Buffer> meshletsBuffer = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+
+    d.viewKind = BufferCreateDesc::ViewKind::Structured;
+    d.sizeInBytes = static_cast<u32>(meshletVertices.size() * sizeof(u32));
+    d.strideInBytes = sizeof(u32);
+    d.initialData = meshletVertices.data();
+    d.initialDataSize = d.sizeInBytes;
+    d.name = L"Scene/meshletVertices";
+    const SharedPtr<Buffer> meshletVerticesBuffer = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+
+    d.viewKind = BufferCreateDesc::ViewKind::Raw;
+    d.sizeInBytes = static_cast<u32>(meshletTriangles.size());
+    d.strideInBytes = 0;
+    d.initialData = meshletTriangles.data();
+    d.initialDataSize = d.sizeInBytes;
+    d.name = L"Scene/meshletTriangles";
+    const SharedPtr<Buffer> meshletTrianglesBuffer = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+
+    d.viewKind = BufferCreateDesc::ViewKind::Structured;
+    d.sizeInBytes = static_cast<u32>(meshletBounds.size() * sizeof(MeshletBounds));
+    d.strideInBytes = sizeof(MeshletBounds);
+    d.initialData = meshletBounds.data();
+    d.initialDataSize = d.sizeInBytes;
+    d.name = L"Scene/meshletBounds";
+    const SharedPtr<Buffer> meshletBoundsBuffer = m_RenderDevice.CreateBuffer(m_BindlessHeaps, cmd.Get(), d);
+
+    for (Primitive& prim : m_Primitives)
+    {
+        prim.vertices = verticesBuffer;
+        prim.meshlets = meshletsBuffer;
+        prim.mlVerts = meshletVerticesBuffer;
+        prim.mlTris = meshletTrianglesBuffer;
+        prim.mlBounds = meshletBoundsBuffer;
+    }
 }
 
 void SceneResources::ImportSceneInstances(const LoadedScene& scene)
@@ -56,6 +56,7 @@ class SceneResources
     void ClearInstancesDirty();
 
   private:
+    void CreateTexturePool();
     void ImportSceneTextures(const LoadedScene& scene, const ComPtr<ID3D12GraphicsCommandList7>& cmd);
     void ImportSceneSamplers(const LoadedScene& scene);
     void CreateDefaultSamplers();
@@ -84,5 +85,10 @@ class SceneResources
     String m_CurrentSceneFile;
     String m_PendingSceneFile;
 
+    // Scene textures are placed in the pool's heaps instead of each getting an implicit heap from a committed resource.
+    ComPtr<D3D12MA::Pool> m_TexturePool;
     Vector<Texture> m_Textures;
+    // The SRV range of m_Textures, one slot per texture.
+    u32 m_TextureSrvFirst = UINT32_MAX;
+    u32 m_TextureSrvGeneration = 0;
 };
@@ -5,14 +5,21 @@
 
 #include "Shader.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cwchar>
 #include <format>
 #include <string>
 #include <string_view>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
 #include "RuntimeState.h"
+#include "common/Profiler.h"
 #include "common/UtfConversion.h"
 
 namespace
@@ -22,6 +29,7 @@ struct DxcContext
     ComPtr<IDxcLibrary> library;
     ComPtr<IDxcCompiler3> compiler;
     ComPtr<IDxcUtils> utils;
+    u64 versionHash = 0; // compiler version and commit, part of every shader cache key
     HRESULT initHr = S_OK;
     const char* initContext = nullptr;
     bool initialized = false;
@@ -32,8 +40,31 @@ struct ShaderCompileResult
     ComPtr<IDxcBlob> blob;
     String errorLog;
     bool ok : 1;
+    bool fromCache : 1;
 };
 
+struct ShaderCompileArguments
+{
+    std::wstring filename;
+    std::wstring targetName;
+    Vector<std::wstring> defineArgs;
+    Vector<LPCWSTR> arguments;
+};
+
+// On-disk DXIL cache entry: header followed by the bytecode.
+struct ShaderCacheFileHeader
+{
+    char magic[8];
+    u32 version;
+    u32 reserved;
+    u64 key;
+    u64 byteSize;
+};
+
+constexpr char kShaderCacheMagic[8] = {'I', 'E', 'D', 'X', 'I', 'L', 'C', '\0'};
+constexpr u32 kShaderCacheVersion = 1;
+constexpr const wchar_t* kShaderCacheDirectory = L"data/shader_cache";
+
 struct ShaderSourceHashResult
 {
     u64 hash = 0;
@@ -242,25 +273,53 @@ bool ResolveIncludePath(const std::filesystem::path& includingFile, const String
     return false;
 }
 
-bool HashShaderFileRecursive(const std::filesystem::path& filePath, u64& hash, std::unordered_set<String>& visited)
+// Process-wide include graph for source hashing. Every file is read and parsed once, then revalidated with one stat per
+// hash pass; per-shader hashes combine memoized subgraph hashes, so shared headers are not re-read for every shader.
+struct IncludeEdge
 {
-    const String pathKey = MakePathKey(filePath);
-    if (visited.find(pathKey) != visited.end())
-    {
-        return true;
-    }
-    visited.insert(pathKey);
+    String key;            // resolved include, key into IncludeGraph::nodes
+    String unresolvedName; // set when the include could not be resolved
+};
+
+struct IncludeGraphNode
+{
+    std::filesystem::path path;
+    std::filesystem::file_time_type writeTime{};
+    u64 fileSize = 0;
+    u64 contentHash = 0;
+    Vector<IncludeEdge> includes; // in source order
+    u32 validatedPass = 0;
+    u32 subgraphPass = 0;
+    u64 subgraphHash = 0;
+    bool readable = false;
+    bool visiting = false;
+};
+
+struct IncludeGraph
+{
+    std::mutex mutex;
+    std::unordered_map<String, IncludeGraphNode> nodes;
+    u32 pass = 1;
+};
+
+IncludeGraph g_IncludeGraph;
+
+void ParseIncludeNode(IncludeGraphNode& node, const String& pathKey)
+{
+    node.includes.clear();
+    node.contentHash = kFnvOffsetBasis;
 
     Vector<u8> bytes;
-    if (!ReadFileBytes(filePath, bytes))
+    node.readable = ReadFileBytes(node.path, bytes);
+    if (!node.readable)
     {
-        return false;
+        return;
     }
 
-    HashString(hash, pathKey);
+    HashString(node.contentHash, pathKey);
     if (!bytes.empty())
     {
-        HashBytes(hash, bytes.data(), bytes.size());
+        HashBytes(node.contentHash, bytes.data(), bytes.size());
     }
 
     const String sourceText = bytes.empty() ? String() : String(reinterpret_cast<const char*>(bytes.data()), bytes.size());
@@ -276,17 +335,20 @@ bool HashShaderFileRecursive(const std::filesystem::path& filePath, u64& hash, s
         if (TryParseIncludeLine(line, includeNameUtf8))
         {
             std::filesystem::path includePath;
-            if (!ResolveIncludePath(filePath, includeNameUtf8, includePath))
+            if (ResolveIncludePath(node.path, includeNameUtf8, includePath))
             {
-                // Some headers (for example shared CPU/GPU headers) may contain non-shader includes
-                // behind preprocessor branches. Keep the hash stable without forcing recompilation.
-                constexpr std::string_view unresolvedPrefix = "UNRESOLVED_INCLUDE:";
-                HashBytes(hash, unresolvedPrefix.data(), unresolvedPrefix.size());
-                HashString(hash, includeNameUtf8);
+                node.includes.push_back({MakePathKey(includePath), {}});
+                IncludeGraphNode& child = g_IncludeGraph.nodes[node.includes.back().key];
+                if (child.path.empty())
+                {
+                    child.path = includePath;
+                }
             }
-            else if (!HashShaderFileRecursive(includePath, hash, visited))
+            else
             {
-                return false;
+                // Some headers (for example shared CPU/GPU headers) may contain non-shader includes
+                // behind preprocessor branches. Keep the hash stable without forcing recompilation.
+                node.includes.push_back({{}, includeNameUtf8});
             }
         }
 
@@ -301,8 +363,105 @@ bool HashShaderFileRecursive(const std::filesystem::path& filePath, u64& hash, s
             ++lineStart;
         }
     }
+}
 
-    return true;
+// Re-parses the file only when its size or write time changed, or when a previously unresolved include now resolves.
+void ValidateIncludeNode(IncludeGraphNode& node, const String& pathKey)
+{
+    if (node.validatedPass == g_IncludeGraph.pass)
+    {
+        return;
+    }
+    node.validatedPass = g_IncludeGraph.pass;
+
+    std::error_code ec;
+    const std::filesystem::directory_entry entry(node.path, ec);
+    if (ec || !entry.is_regular_file(ec))
+    {
+        node.readable = false;
+        node.includes.clear();
+        return;
+    }
+
+    const std::filesystem::file_time_type writeTime = entry.last_write_time(ec);
+    const u64 fileSize = ec ? 0 : static_cast<u64>(entry.file_size(ec));
+    bool changed = ec || !node.readable || writeTime != node.writeTime || fileSize != node.fileSize;
+    for (const IncludeEdge& edge : node.includes)
+    {
+        std::filesystem::path includePath;
+        if (!changed && !edge.unresolvedName.empty() && ResolveIncludePath(node.path, edge.unresolvedName, includePath))
+        {
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        node.writeTime = writeTime;
+        node.fileSize = fileSize;
+        ParseIncludeNode(node, pathKey);
+    }
+}
+
+bool ComputeSubgraphHash(IncludeGraphNode& node, const String& pathKey, u64& outHash)
+{
+    ValidateIncludeNode(node, pathKey);
+    if (!node.readable)
+    {
+        return false;
+    }
+
+    if (node.subgraphPass == g_IncludeGraph.pass)
+    {
+        outHash = node.subgraphHash;
+        return true;
+    }
+
+    // An include cycle only contributes the path; the content is already part of the enclosing subgraph.
+    if (node.visiting)
+    {
+        outHash = kFnvOffsetBasis;
+        HashString(outHash, pathKey);
+        return true;
+    }
+
+    node.visiting = true;
+    u64 hash = node.contentHash;
+    bool ok = true;
+    for (const IncludeEdge& edge : node.includes)
+    {
+        if (!edge.unresolvedName.empty())
+        {
+            constexpr std::string_view unresolvedPrefix = "UNRESOLVED_INCLUDE:";
+            HashBytes(hash, unresolvedPrefix.data(), unresolvedPrefix.size());
+            HashString(hash, edge.unresolvedName);
+            continue;
+        }
+
+        u64 childHash = 0;
+        if (!ComputeSubgraphHash(g_IncludeGraph.nodes[edge.key], edge.key, childHash))
+        {
+            ok = false;
+            break;
+        }
+        HashBytes(hash, &childHash, sizeof(childHash));
+    }
+    node.visiting = false;
+
+    if (ok)
+    {
+        node.subgraphHash = hash;
+        node.subgraphPass = g_IncludeGraph.pass;
+        outHash = hash;
+    }
+    return ok;
+}
+
+// Starts a new hash pass: every file is stat'ed again the first time a shader in this pass reaches it.
+void BeginSourceHashPass()
+{
+    std::lock_guard lock(g_IncludeGraph.mutex);
+    g_IncludeGraph.pass++;
 }
 
 ShaderSourceHashResult ComputeShaderSourceHash(const ShaderType type, const String& filename, const Vector<String>& defines)
@@ -315,43 +474,123 @@ ShaderSourceHashResult ComputeShaderSourceHash(const ShaderType type, const Stri
     HashDefines(result.hash, defines);
 
     const std::filesystem::path shaderPath = std::filesystem::path(L"data/shaders") / Utf8ToWide(filename);
-    std::unordered_set<String> visited;
-    result.valid = HashShaderFileRecursive(shaderPath, result.hash, visited);
+    const String pathKey = MakePathKey(shaderPath);
+
+    std::lock_guard lock(g_IncludeGraph.mutex);
+    IncludeGraphNode& root = g_IncludeGraph.nodes[pathKey];
+    if (root.path.empty())
+    {
+        root.path = shaderPath;
+    }
+
+    u64 subgraphHash = 0;
+    result.valid = ComputeSubgraphHash(root, pathKey, subgraphHash);
+    HashBytes(result.hash, &subgraphHash, sizeof(subgraphHash));
     return result;
 }
 
-DxcContext& GetDxcContext()
+DxcContext CreateDxcContext()
 {
-    static DxcContext ctx = [] {
-        DxcContext c{};
+    DxcContext c{};
 
-        c.initHr = DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&c.library));
-        if (!IE_Try(c.initHr))
+    c.initHr = DxcCreateInstance(CLSID_DxcLibrary, IID_PPV_ARGS(&c.library));
+    if (!IE_Try(c.initHr))
+    {
+        c.initContext = "DxcCreateInstance(CLSID_DxcLibrary)";
+        return c;
+    }
+
+    c.initHr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&c.compiler));
+    if (!IE_Try(c.initHr))
+    {
+        c.initContext = "DxcCreateInstance(CLSID_DxcCompiler)";
+        return c;
+    }
+
+    c.initHr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&c.utils));
+    if (!IE_Try(c.initHr))
+    {
+        c.initContext = "DxcCreateInstance(CLSID_DxcUtils)";
+        return c;
+    }
+
+    // A different dxcompiler.dll must not reuse DXIL produced by another build, so the version and commit go into the cache key.
+    c.versionHash = kFnvOffsetBasis;
+    ComPtr<IDxcVersionInfo> versionInfo;
+    u32 versionMajor = 0;
+    u32 versionMinor = 0;
+    if (SUCCEEDED(c.compiler.As(&versionInfo)) && SUCCEEDED(versionInfo->GetVersion(&versionMajor, &versionMinor)))
+    {
+        HashBytes(c.versionHash, &versionMajor, sizeof(versionMajor));
+        HashBytes(c.versionHash, &versionMinor, sizeof(versionMinor));
+    }
+    ComPtr<IDxcVersionInfo2> versionInfo2;
+    u32 commitCount = 0;
+    char* commitHash = nullptr;
+    if (SUCCEEDED(c.compiler.As(&versionInfo2)) && SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)))
+    {
+        HashBytes(c.versionHash, &commitCount, sizeof(commitCount));
+        if (commitHash)
         {
-            c.initContext = "DxcCreateInstance(CLSID_DxcLibrary)";
-            return c;
+            HashString(c.versionHash, commitHash);
+            CoTaskMemFree(commitHash);
         }
+    }
+
+    c.initialized = true;
+    return c;
+}
 
-        c.initHr = DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&c.compiler));
-        if (!IE_Try(c.initHr))
+// DXC compiler instances are not safe to share between threads. Compile workers only live for one ShaderCompileQueue::Compile,
+// so instead of one context per thread (recreated by every hot reload), each compile checks a context out of this pool and
+// returns it afterwards; the pool grows to the peak number of concurrent compiles and is reused from then on.
+struct DxcContextPool
+{
+    std::mutex mutex;
+    Vector<UniquePtr<DxcContext>> free;
+};
+
+DxcContextPool g_DxcContextPool;
+
+class DxcContextLease
+{
+  public:
+    DxcContextLease()
+    {
         {
-            c.initContext = "DxcCreateInstance(CLSID_DxcCompiler)";
-            return c;
+            std::lock_guard lock(g_DxcContextPool.mutex);
+            if (!g_DxcContextPool.free.empty())
+            {
+                m_Context = std::move(g_DxcContextPool.free.back());
+                g_DxcContextPool.free.pop_back();
+            }
         }
-
-        c.initHr = DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&c.utils));
-        if (!IE_Try(c.initHr))
+        if (!m_Context)
+        {
+            m_Context = IE_MakeUniquePtr<DxcContext>(CreateDxcContext());
+        }
+    }
+    ~DxcContextLease()
+    {
+        // A context that failed to initialize is dropped, so the next compile retries and reports the error again.
+        if (m_Context->initialized)
         {
-            c.initContext = "DxcCreateInstance(CLSID_DxcUtils)";
-            return c;
+            std::lock_guard lock(g_DxcContextPool.mutex);
+            g_DxcContextPool.free.push_back(std::move(m_Context));
         }
+    }
 
-        c.initialized = true;
-        return c;
-    }();
+    DxcContextLease(const DxcContextLease&) = delete;
+    DxcContextLease& operator=(const DxcContextLease&) = delete;
 
-    return ctx;
-}
+    DxcContext& Get()
+    {
+        return *m_Context;
+    }
+
+  private:
+    UniquePtr<DxcContext> m_Context;
+};
 
 const wchar_t* ToTargetPrefix(const ShaderType type)
 {
@@ -399,43 +638,21 @@ ShaderCompileResult Fail(HRESULT hr, const char* context, ShaderCompileResult& r
     return result;
 }
 
-ShaderCompileResult CompileShader(ShaderType type, const String& filename, const Vector<String>& defines)
+// The argument pointers reference strings owned by outArgs, so it must outlive any use of outArgs.arguments.
+void BuildCompileArguments(ShaderType type, const String& filename, const Vector<String>& defines, ShaderCompileArguments& outArgs)
 {
-    ShaderCompileResult result{};
-
-    DxcContext& dxc = GetDxcContext();
-    if (!dxc.initialized)
-    {
-        return Fail(dxc.initHr, dxc.initContext ? dxc.initContext : "DXC init", result);
-    }
-
-    HRESULT hr = S_OK;
-    u32 codePage = CP_UTF8;
-    ComPtr<IDxcBlobEncoding> sourceBlob;
-
-    const std::wstring filenameWide = Utf8ToWide(filename);
-    const std::wstring shaderPath = L"data/shaders/" + filenameWide;
-    const std::wstring targetName = MakeTargetName(type);
-    hr = dxc.library->CreateBlobFromFile(shaderPath.c_str(), &codePage, &sourceBlob);
-    if (!IE_Try(hr))
-    {
-        return Fail(hr, "CreateBlobFromFile", result);
-    }
-
-    DxcBuffer sourceBuffer{};
-    sourceBuffer.Ptr = sourceBlob->GetBufferPointer();
-    sourceBuffer.Size = sourceBlob->GetBufferSize();
-    sourceBuffer.Encoding = 0;
-
-    Vector<std::wstring> defineArgs;
-    defineArgs.reserve(defines.size());
+    outArgs.filename = Utf8ToWide(filename);
+    outArgs.targetName = MakeTargetName(type);
+    outArgs.defineArgs.clear();
+    outArgs.defineArgs.reserve(defines.size());
     for (const String& define : defines)
     {
-        defineArgs.push_back(L"-D" + Utf8ToWide(define));
+        outArgs.defineArgs.push_back(L"-D" + Utf8ToWide(define));
     }
 
-    Vector<LPCWSTR> arguments;
-    arguments.push_back(filenameWide.c_str());
+    Vector<LPCWSTR>& arguments = outArgs.arguments;
+    arguments.clear();
+    arguments.push_back(outArgs.filename.c_str());
     switch (type)
     {
     case IE_SHADER_TYPE_AMPLIFICATION:
@@ -450,10 +667,10 @@ ShaderCompileResult CompileShader(ShaderType type, const String& filename, const
         break;
     }
     arguments.push_back(L"-T");
-    arguments.push_back(targetName.c_str());
+    arguments.push_back(outArgs.targetName.c_str());
     arguments.push_back(L"-I");
     arguments.push_back(L"data/shaders");
-    for (const std::wstring& arg : defineArgs)
+    for (const std::wstring& arg : outArgs.defineArgs)
     {
         arguments.push_back(arg.data());
     }
@@ -463,6 +680,35 @@ ShaderCompileResult CompileShader(ShaderType type, const String& filename, const
     arguments.push_back(L"-Zi");
     arguments.push_back(L"-Qembed_debug");
 #endif
+}
+
+ShaderCompileResult CompileShader(DxcContext& dxc, ShaderType type, const String& filename, const Vector<String>& defines)
+{
+    ShaderCompileResult result{};
+
+    if (!dxc.initialized)
+    {
+        return Fail(dxc.initHr, dxc.initContext ? dxc.initContext : "DXC init", result);
+    }
+
+    HRESULT hr = S_OK;
+    u32 codePage = CP_UTF8;
+    ComPtr<IDxcBlobEncoding> sourceBlob;
+
+    ShaderCompileArguments compileArgs;
+    BuildCompileArguments(type, filename, defines, compileArgs);
+    Vector<LPCWSTR>& arguments = compileArgs.arguments;
+    const std::wstring shaderPath = L"data/shaders/" + compileArgs.filename;
+    hr = dxc.library->CreateBlobFromFile(shaderPath.c_str(), &codePage, &sourceBlob);
+    if (!IE_Try(hr))
+    {
+        return Fail(hr, "CreateBlobFromFile", result);
+    }
+
+    DxcBuffer sourceBuffer{};
+    sourceBuffer.Ptr = sourceBlob->GetBufferPointer();
+    sourceBuffer.Size = sourceBlob->GetBufferSize();
+    sourceBuffer.Encoding = 0;
 
     ComPtr<IDxcIncludeHandler> includeHandler;
     hr = dxc.utils->CreateDefaultIncludeHandler(&includeHandler);
@@ -520,6 +766,123 @@ ShaderCompileResult CompileShader(ShaderType type, const String& filename, const
     result.blob = code;
     return result;
 }
+
+u64 ComputeShaderCacheKey(const DxcContext& dxc, u64 sourceHash, ShaderType type, const String& filename, const Vector<String>& defines)
+{
+    ShaderCompileArguments compileArgs;
+    BuildCompileArguments(type, filename, defines, compileArgs);
+
+    u64 key = kFnvOffsetBasis;
+    HashBytes(key, &kShaderCacheVersion, sizeof(kShaderCacheVersion));
+    HashBytes(key, &sourceHash, sizeof(sourceHash));
+    HashBytes(key, &dxc.versionHash, sizeof(dxc.versionHash));
+    for (const LPCWSTR arg : compileArgs.arguments)
+    {
+        HashBytes(key, arg, std::wcslen(arg) * sizeof(wchar_t));
+        constexpr u8 separator = 0xFF;
+        HashBytes(key, &separator, sizeof(separator));
+    }
+    return key;
+}
+
+std::filesystem::path MakeShaderCachePath(u64 key)
+{
+    return std::filesystem::path(kShaderCacheDirectory) / std::format(L"{:016x}.dxil", key);
+}
+
+bool LoadCachedShader(const DxcContext& dxc, u64 key, ComPtr<IDxcBlob>& outBlob)
+{
+    Vector<u8> bytes;
+    if (!ReadFileBytes(MakeShaderCachePath(key), bytes) || bytes.size() < sizeof(ShaderCacheFileHeader))
+    {
+        return false;
+    }
+
+    ShaderCacheFileHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kShaderCacheMagic, sizeof(kShaderCacheMagic)) != 0 || header.version != kShaderCacheVersion || header.key != key || header.byteSize == 0 ||
+        header.byteSize != bytes.size() - sizeof(header))
+    {
+        return false;
+    }
+
+    ComPtr<IDxcBlobEncoding> blob;
+    if (FAILED(dxc.utils->CreateBlob(bytes.data() + sizeof(header), static_cast<u32>(header.byteSize), DXC_CP_ACP, &blob)))
+    {
+        return false;
+    }
+
+    outBlob = blob;
+    return true;
+}
+
+// Writes through a temporary file so a crash or a concurrent writer never leaves a truncated entry behind.
+void StoreCachedShader(u64 key, const ComPtr<IDxcBlob>& blob)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(kShaderCacheDirectory, ec);
+    if (ec)
+    {
+        IE_LogWarn("Shader cache directory could not be created: {}", ec.message());
+        return;
+    }
+
+    ShaderCacheFileHeader header{};
+    std::memcpy(header.magic, kShaderCacheMagic, sizeof(kShaderCacheMagic));
+    header.version = kShaderCacheVersion;
+    header.key = key;
+    header.byteSize = blob->GetBufferSize();
+
+    const std::filesystem::path finalPath = MakeShaderCachePath(key);
+    std::filesystem::path tempPath = finalPath;
+    tempPath += std::format(L".{}.tmp", GetCurrentThreadId());
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(blob->GetBufferPointer()), static_cast<std::streamsize>(header.byteSize));
+        if (!file.good())
+        {
+            file.close();
+            std::filesystem::remove(tempPath, ec);
+            IE_LogWarn("Shader cache entry could not be written: {}", WideToUtf8(tempPath.c_str()));
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+
+// Compiles through the on-disk cache when the source hash is known. Safe to call from several threads at once. Entries are keyed by the source hash (type, defines, include
+// graph), the DXC version, and the full argument list, so any input that could change the DXIL produces a new key.
+ShaderCompileResult CompileShaderCached(ShaderType type, const String& filename, const Vector<String>& defines, const ShaderSourceHashResult& sourceHash)
+{
+    DxcContextLease lease;
+    DxcContext& dxc = lease.Get();
+    if (!dxc.initialized || !sourceHash.valid)
+    {
+        return CompileShader(dxc, type, filename, defines);
+    }
+
+    const u64 key = ComputeShaderCacheKey(dxc, sourceHash.hash, type, filename, defines);
+    ShaderCompileResult result{};
+    if (LoadCachedShader(dxc, key, result.blob))
+    {
+        result.ok = true;
+        result.fromCache = true;
+        return result;
+    }
+
+    result = CompileShader(dxc, type, filename, defines);
+    if (result.ok)
+    {
+        StoreCachedShader(key, result.blob);
+    }
+    return result;
+}
 } // namespace
 
 void Shader::VerifyRequiredShaderModelSupport(const ComPtr<ID3D12Device14>& device)
@@ -547,116 +910,265 @@ void Shader::VerifyRequiredShaderModelSupport(const ComPtr<ID3D12Device14>& devi
 Shader::Shader(ShaderType type, String filename, Vector<String> defines)
     : m_Type(type), m_Filename(std::move(filename)), m_Defines(std::move(defines))
 {
-    const ShaderCompileResult result = CompileShader(type, m_Filename, m_Defines);
-    if (!result.ok)
-    {
-        m_Valid = false;
-        m_ErrorLog = result.errorLog;
-        return;
-    }
-
-    m_Blob = result.blob;
-    m_Valid = true;
-    m_ErrorLog.clear();
-
-    const ShaderSourceHashResult sourceHash = ComputeShaderSourceHash(m_Type, m_Filename, m_Defines);
-    m_SourceHash = sourceHash.hash;
-    m_SourceHashValid = sourceHash.valid;
 }
 
 bool Shader::Reload()
 {
-    bool didReload = false;
-    return Reload(didReload);
-}
-
-bool Shader::Reload(bool& outDidReload)
-{
+    BeginSourceHashPass();
     const ShaderSourceHashResult sourceHash = ComputeShaderSourceHash(m_Type, m_Filename, m_Defines);
-    if (sourceHash.valid && m_SourceHashValid && sourceHash.hash == m_SourceHash)
+    if (m_Valid && sourceHash.valid && m_SourceHashValid && sourceHash.hash == m_SourceHash)
     {
-        outDidReload = false;
         return true;
     }
 
-    const ShaderCompileResult result = CompileShader(m_Type, m_Filename, m_Defines);
+    const ShaderCompileResult result = CompileShaderCached(m_Type, m_Filename, m_Defines, sourceHash);
     if (!result.ok)
     {
-        outDidReload = false;
         m_ErrorLog = result.errorLog;
         IE_LogError("Shader reload failed for {}:\n{}\n", m_Filename, m_ErrorLog);
         g_Stats.shadersCompilationSuccess = false;
         return false;
     }
 
-    m_Blob = result.blob;
+    if (result.fromCache)
+    {
+        g_ShaderReloadStats.cacheHits++;
+    }
+    SetBlob(result.blob, sourceHash.hash, sourceHash.valid);
+    return true;
+}
+
+bool Shader::IsSameConfig(ShaderType type, const String& filename, const Vector<String>& defines) const
+{
+    return m_Type == type && m_Filename == filename && m_Defines == defines;
+}
+
+void Shader::SetBlob(const ComPtr<IDxcBlob>& blob, u64 sourceHash, bool sourceHashValid)
+{
+    m_Blob = blob;
     m_Valid = true;
     m_ErrorLog.clear();
-    m_SourceHash = sourceHash.hash;
-    m_SourceHashValid = sourceHash.valid;
+    m_SourceHash = sourceHash;
+    m_SourceHashValid = sourceHashValid;
     m_CachedRootSig.Reset();
     m_CachedRootSigDevice = nullptr;
-    outDidReload = true;
-    return true;
 }
 
 bool Shader::ReloadOrCreate(SharedPtr<Shader>& shader, ShaderType type, const String& filename, const Vector<String>& defines)
 {
-    g_ShaderReloadStats.total++;
+    ShaderCompileQueue queue;
+    queue.Add(shader, type, filename, defines);
+    return queue.CompileAll();
+}
+
+void ShaderCompileQueue::Add(SharedPtr<Shader>& shader, ShaderType type, const String& filename, const Vector<String>& defines)
+{
+    // Passes that share a shader slot (the depth pre-pass reuses the G-buffer amplification shader) request it twice.
+    for (const Request& request : m_Requests)
+    {
+        if (request.shader == &shader)
+        {
+            IE_Assert(request.type == type && request.filename == filename && request.defines == defines);
+            return;
+        }
+    }
 
-    auto LogCompileFailure = [&](const SharedPtr<Shader>& failedShader) {
-        g_ShaderReloadStats.failed++;
-        IE_LogError("Shader compile failed for {}:\n{}\n", filename, failedShader->GetErrorLog());
-        g_Stats.shadersCompilationSuccess = false;
+    m_Requests.push_back({&shader, type, filename, defines});
+}
+
+bool ShaderCompileQueue::CompileAll()
+{
+    Compile();
+    return Publish();
+}
+
+void ShaderCompileQueue::Compile()
+{
+    // Hash sources and decide what needs compiling up front, so identical configurations requested for different slots
+    // (the fullscreen vertex shader) are compiled once.
+    Vector<u32> compileJobs;
+    BeginSourceHashPass();
+    for (u32 i = 0; i < m_Requests.size(); ++i)
+    {
+        Request& request = m_Requests[i];
+        const SharedPtr<Shader>& shader = *request.shader;
+        const ShaderSourceHashResult sourceHash = ComputeShaderSourceHash(request.type, request.filename, request.defines);
+        request.sourceHash = sourceHash.hash;
+        request.sourceHashValid = sourceHash.valid;
+        request.compileSource = UINT32_MAX;
+
+        if (shader && shader->m_Valid && shader->IsSameConfig(request.type, request.filename, request.defines) && sourceHash.valid && shader->m_SourceHashValid &&
+            sourceHash.hash == shader->m_SourceHash)
+        {
+            continue;
+        }
+
+        request.compileSource = i;
+        for (const u32 other : compileJobs)
+        {
+            const Request& otherRequest = m_Requests[other];
+            if (otherRequest.type == request.type && otherRequest.filename == request.filename && otherRequest.defines == request.defines)
+            {
+                request.compileSource = other;
+                break;
+            }
+        }
+        if (request.compileSource == i)
+        {
+            compileJobs.push_back(i);
+        }
+    }
+
+    auto CompileJob = [&](const u32 jobIndex) {
+        IE_PROFILE_SCOPE("Compile Shader");
+        Request& request = m_Requests[jobIndex];
+        const ShaderSourceHashResult sourceHash{request.sourceHash, request.sourceHashValid};
+        const ShaderCompileResult result = CompileShaderCached(request.type, request.filename, request.defines, sourceHash);
+        request.blob = result.blob;
+        request.errorLog = result.errorLog;
+        request.ok = result.ok;
+        request.fromCache = result.fromCache;
     };
 
-    if (!shader)
+    const u32 workerCount = std::min<u32>(std::max(1u, std::thread::hardware_concurrency()), static_cast<u32>(compileJobs.size()));
+    if (workerCount <= 1)
     {
-        SharedPtr<Shader> candidate = IE_MakeSharedPtr<Shader>(type, filename, defines);
-        if (!candidate->IsValid())
+        for (const u32 jobIndex : compileJobs)
         {
-            LogCompileFailure(candidate);
-            return false;
+            CompileJob(jobIndex);
         }
+        return;
+    }
 
-        g_ShaderReloadStats.reloaded++;
-        shader = std::move(candidate);
-        return true;
+    std::atomic<u32> nextJob = 0;
+    Vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (u32 w = 0; w < workerCount; ++w)
+    {
+        workers.emplace_back([&] {
+            Profiler::SetThreadName("Shader Compile Worker");
+            for (u32 i = nextJob.fetch_add(1); i < compileJobs.size(); i = nextJob.fetch_add(1))
+            {
+                CompileJob(compileJobs[i]);
+            }
+        });
     }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
 
-    const bool isSameConfig = shader->m_Type == type && shader->m_Filename == filename && shader->m_Defines == defines;
-    if (isSameConfig)
+bool ShaderCompileQueue::Publish()
+{
+    // Publish results in request order on this thread; a failed compile keeps whatever the slot held before.
+    bool allSucceeded = true;
+    for (u32 i = 0; i < m_Requests.size(); ++i)
     {
-        bool didReload = false;
-        const bool success = shader->Reload(didReload);
-        if (!success)
+        Request& request = m_Requests[i];
+        SharedPtr<Shader>& shader = *request.shader;
+        g_ShaderReloadStats.total++;
+
+        if (request.compileSource == UINT32_MAX)
+        {
+            g_ShaderReloadStats.skipped++;
+            continue;
+        }
+
+        const Request& result = m_Requests[request.compileSource];
+        if (!result.ok)
         {
             g_ShaderReloadStats.failed++;
-            return false;
+            IE_LogError("Shader compile failed for {}:\n{}\n", request.filename, result.errorLog);
+            g_Stats.shadersCompilationSuccess = false;
+            if (shader && shader->IsSameConfig(request.type, request.filename, request.defines))
+            {
+                shader->m_ErrorLog = result.errorLog;
+            }
+            allSucceeded = false;
+            continue;
         }
 
-        if (didReload)
+        if (result.fromCache && request.compileSource == i)
         {
-            g_ShaderReloadStats.reloaded++;
+            g_ShaderReloadStats.cacheHits++;
         }
-        else
+        if (!shader || !shader->IsSameConfig(request.type, request.filename, request.defines))
         {
-            g_ShaderReloadStats.skipped++;
+            shader = IE_MakeSharedPtr<Shader>(request.type, request.filename, request.defines);
         }
-
-        return true;
+        shader->SetBlob(result.blob, request.sourceHash, request.sourceHashValid);
+        request.updated = true;
+        g_ShaderReloadStats.reloaded++;
     }
 
-    SharedPtr<Shader> candidate = IE_MakeSharedPtr<Shader>(type, filename, defines);
-    if (!candidate->IsValid())
+    return allSucceeded;
+}
+
+void ShaderCompileQueue::RetainDependentsOf(const Vector<std::filesystem::path>& changedFiles)
+{
+    std::unordered_set<String> changedKeys;
+    for (const std::filesystem::path& file : changedFiles)
     {
-        LogCompileFailure(candidate);
-        return false;
+        changedKeys.insert(MakePathKey(file));
     }
 
-    g_ShaderReloadStats.reloaded++;
-    shader = std::move(candidate);
-    return true;
+    std::lock_guard lock(g_IncludeGraph.mutex);
+    std::erase_if(m_Requests, [&](const Request& request) {
+        const String rootKey = MakePathKey(std::filesystem::path(L"data/shaders") / Utf8ToWide(request.filename));
+        if (g_IncludeGraph.nodes.find(rootKey) == g_IncludeGraph.nodes.end())
+        {
+            return false;
+        }
+
+        // Walks the graph as of the last hash pass; an edit that adds an include still touches a file already in the graph.
+        Vector<const String*> stack = {&rootKey};
+        std::unordered_set<String> visited;
+        while (!stack.empty())
+        {
+            const String& key = *stack.back();
+            stack.pop_back();
+            if (!visited.insert(key).second)
+            {
+                continue;
+            }
+            if (changedKeys.contains(key))
+            {
+                return false;
+            }
+
+            const auto it = g_IncludeGraph.nodes.find(key);
+            if (it == g_IncludeGraph.nodes.end())
+            {
+                continue;
+            }
+            for (const IncludeEdge& edge : it->second.includes)
+            {
+                if (edge.unresolvedName.empty())
+                {
+                    stack.push_back(&edge.key);
+                }
+            }
+        }
+        return true;
+    });
+}
+
+bool ShaderCompileQueue::IsEmpty() const
+{
+    return m_Requests.empty();
+}
+
+bool ShaderCompileQueue::AnyUpdated(std::initializer_list<const SharedPtr<Shader>*> shaders) const
+{
+    for (const Request& request : m_Requests)
+    {
+        if (request.updated && std::find(shaders.begin(), shaders.end(), request.shader) != shaders.end())
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void Shader::ResetReloadStats()
@@ -7,6 +7,7 @@
 
 #include <d3d12.h>
 #include <dxcapi.h>
+#include <initializer_list>
 
 #include "common/Types.h"
 
@@ -34,8 +35,10 @@ class Shader
         u32 reloaded = 0;
         u32 skipped = 0;
         u32 failed = 0;
+        u32 cacheHits = 0; // reloaded from the on-disk DXIL cache instead of compiling
     };
 
+    // Describes the shader; bytecode is produced by Reload() or by a ShaderCompileQueue.
     Shader(ShaderType type, String filename, Vector<String> defines);
     bool Reload();
     static bool ReloadOrCreate(SharedPtr<Shader>& shader, ShaderType type, const String& filename, const Vector<String>& defines);
@@ -51,7 +54,10 @@ class Shader
     const String& GetErrorLog() const;
 
   private:
-    bool Reload(bool& outDidReload);
+    friend class ShaderCompileQueue;
+
+    bool IsSameConfig(ShaderType type, const String& filename, const Vector<String>& defines) const;
+    void SetBlob(const ComPtr<IDxcBlob>& blob, u64 sourceHash, bool sourceHashValid);
 
     ShaderType m_Type = IE_SHADER_TYPE_VERTEX;
     ComPtr<IDxcBlob> m_Blob;
@@ -65,3 +71,41 @@ class Shader
     ComPtr<ID3D12RootSignature> m_CachedRootSig;
     ID3D12Device14* m_CachedRootSigDevice = nullptr;
 };
+
+// Gathers Shader::ReloadOrCreate requests so their DXC compiles run concurrently, one compiler instance per worker thread.
+// Compile() only reads the slots and may run off the render thread; slots are written by Publish() on the render thread.
+class ShaderCompileQueue
+{
+  public:
+    void Add(SharedPtr<Shader>& shader, ShaderType type, const String& filename, const Vector<String>& defines);
+    bool CompileAll();
+
+    void Compile();
+    bool Publish();
+
+    // Drops requests whose include graph does not reach any of the files.
+    void RetainDependentsOf(const Vector<std::filesystem::path>& changedFiles);
+    bool IsEmpty() const;
+    // Valid after Publish(): whether any of these slots received new bytecode.
+    bool AnyUpdated(std::initializer_list<const SharedPtr<Shader>*> shaders) const;
+
+  private:
+    struct Request
+    {
+        SharedPtr<Shader>* shader = nullptr;
+        ShaderType type = IE_SHADER_TYPE_VERTEX;
+        String filename;
+        Vector<String> defines;
+
+        u64 sourceHash = 0;
+        bool sourceHashValid = false;
+        u32 compileSource = UINT32_MAX; // request whose compile result this one shares, or UINT32_MAX when up to date
+        ComPtr<IDxcBlob> blob;
+        String errorLog;
+        bool ok = false;
+        bool fromCache = false;
+        bool updated = false;
+    };
+
+    Vector<Request> m_Requests;
+};
@@ -0,0 +1,125 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "ShaderFileWatcher.h"
+
+#include "common/Profiler.h"
+#include "common/UtfConversion.h"
+
+ShaderFileWatcher::~ShaderFileWatcher()
+{
+    Stop();
+}
+
+void ShaderFileWatcher::Start(const std::filesystem::path& directory)
+{
+    Stop();
+
+    m_Directory = directory;
+    m_DirectoryHandle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (m_DirectoryHandle == INVALID_HANDLE_VALUE)
+    {
+        IE_LogWarn("Shader hot reload disabled: {} could not be watched.", WideToUtf8(directory.c_str()));
+        return;
+    }
+
+    m_StopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_Thread = std::thread([this] { Run(); });
+}
+
+void ShaderFileWatcher::Stop()
+{
+    if (m_Thread.joinable())
+    {
+        SetEvent(m_StopEvent);
+        m_Thread.join();
+    }
+    if (m_StopEvent)
+    {
+        CloseHandle(m_StopEvent);
+        m_StopEvent = nullptr;
+    }
+    if (m_DirectoryHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_DirectoryHandle);
+        m_DirectoryHandle = INVALID_HANDLE_VALUE;
+    }
+
+    std::lock_guard lock(m_Mutex);
+    m_Pending = {};
+}
+
+bool ShaderFileWatcher::ConsumeChanges(ShaderFileChanges& outChanges)
+{
+    std::lock_guard lock(m_Mutex);
+    if ((m_Pending.files.empty() && !m_Pending.overflowed) || std::chrono::steady_clock::now() - m_LastChange < kDebounce)
+    {
+        return false;
+    }
+
+    outChanges = std::move(m_Pending);
+    m_Pending = {};
+    return true;
+}
+
+void ShaderFileWatcher::Run()
+{
+    Profiler::SetThreadName("Shader File Watcher");
+
+    alignas(DWORD) u8 buffer[64 * 1024];
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    const HANDLE waitHandles[2] = {m_StopEvent, overlapped.hEvent};
+    constexpr DWORD notifyFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+
+    while (true)
+    {
+        ResetEvent(overlapped.hEvent);
+        if (!ReadDirectoryChangesW(m_DirectoryHandle, buffer, sizeof(buffer), TRUE, notifyFilter, nullptr, &overlapped, nullptr))
+        {
+            IE_LogWarn("Shader hot reload stopped: ReadDirectoryChangesW failed ({}).", GetLastError());
+            break;
+        }
+
+        if (WaitForMultipleObjects(2, waitHandles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+        {
+            CancelIoEx(m_DirectoryHandle, &overlapped);
+            DWORD ignored = 0;
+            GetOverlappedResult(m_DirectoryHandle, &overlapped, &ignored, TRUE);
+            break;
+        }
+
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(m_DirectoryHandle, &overlapped, &bytes, FALSE))
+        {
+            continue;
+        }
+
+        std::lock_guard lock(m_Mutex);
+        m_LastChange = std::chrono::steady_clock::now();
+        if (bytes == 0)
+        {
+            m_Pending.overflowed = true;
+            continue;
+        }
+
+        const u8* entry = buffer;
+        while (true)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(entry);
+            const std::wstring_view name(info->FileName, info->FileNameLength / sizeof(wchar_t));
+            m_Pending.files.push_back(m_Directory / std::filesystem::path(name));
+
+            if (info->NextEntryOffset == 0)
+            {
+                break;
+            }
+            entry += info->NextEntryOffset;
+        }
+    }
+
+    CloseHandle(overlapped.hEvent);
+}
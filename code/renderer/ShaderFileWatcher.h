@@ -0,0 +1,45 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "common/Types.h"
+
+struct ShaderFileChanges
+{
+    Vector<std::filesystem::path> files;
+    bool overflowed = false; // the change buffer overflowed, so any file may have changed
+};
+
+// Watches a shader directory tree on a background thread with ReadDirectoryChangesW.
+class ShaderFileWatcher
+{
+  public:
+    ~ShaderFileWatcher();
+
+    void Start(const std::filesystem::path& directory);
+    void Stop();
+
+    // Hands out the accumulated changes once no new change arrived for the debounce interval, since editors often save in several writes.
+    bool ConsumeChanges(ShaderFileChanges& outChanges);
+
+  private:
+    void Run();
+
+    static constexpr std::chrono::milliseconds kDebounce{100};
+
+    std::filesystem::path m_Directory;
+    HANDLE m_DirectoryHandle = INVALID_HANDLE_VALUE;
+    HANDLE m_StopEvent = nullptr;
+    std::thread m_Thread;
+
+    std::mutex m_Mutex;
+    ShaderFileChanges m_Pending;
+    std::chrono::steady_clock::time_point m_LastChange{};
+};
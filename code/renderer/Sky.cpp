@@ -5,6 +5,7 @@
 
 #include "Sky.h"
 
+#include "GpuMemory.h"
 #include "PipelineHelpers.h"
 #include "Raytracing.h"
 #include "RuntimeState.h"
@@ -170,19 +171,42 @@ void Sky::PassProceduralSkyCube(const ComPtr<ID3D12GraphicsCommandList7>& cmd, G
     m_ProceduralSkyCube.dirty = false;
 }
 
-void Sky::CreateProceduralSkyCubePipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines)
+void Sky::QueueProceduralSkyCubeShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
 {
-    Shader::ReloadOrCreate(m_ProceduralSkyCube.genSkyShader, IE_SHADER_TYPE_COMPUTE, "systems/sky/sky_cube_gen.cs.hlsl", globalDefines);
+    shaderQueue.Add(m_ProceduralSkyCube.genSkyShader, IE_SHADER_TYPE_COMPUTE, "systems/sky/sky_cube_gen.cs.hlsl", globalDefines);
+}
+
+void Sky::QueueSkyMotionPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines)
+{
+    shaderQueue.Add(m_SkyMotion.vxShader, IE_SHADER_TYPE_VERTEX, "shared/fullscreen.vs.hlsl", globalDefines);
+    shaderQueue.Add(m_SkyMotion.pxShader, IE_SHADER_TYPE_PIXEL, "systems/sky/sky_motion.ps.hlsl", globalDefines);
+}
+
+void Sky::CreateProceduralSkyCubePipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue)
+{
+    if (!shaderQueue.AnyUpdated({&m_ProceduralSkyCube.genSkyShader}))
+    {
+        return;
+    }
+
     PipelineHelpers::CreateComputePipeline(device, m_ProceduralSkyCube.genSkyShader, m_ProceduralSkyCube.genSkyRootSig, m_ProceduralSkyCube.genSkyPso);
 }
 
-void Sky::CreateSkyMotionPassPipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines)
+void Sky::CreateSkyMotionPassPipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue)
 {
-    Shader::ReloadOrCreate(m_SkyMotion.vxShader, IE_SHADER_TYPE_VERTEX, "shared/fullscreen.vs.hlsl", globalDefines);
-    Shader::ReloadOrCreate(m_SkyMotion.pxShader, IE_SHADER_TYPE_PIXEL, "systems/sky/sky_motion.ps.hlsl", globalDefines);
+    if (!shaderQueue.AnyUpdated({&m_SkyMotion.vxShader, &m_SkyMotion.pxShader}))
+    {
+        return;
+    }
+
     PipelineHelpers::CreateFullscreenGraphicsPipeline(device, m_SkyMotion.vxShader, m_SkyMotion.pxShader, DXGI_FORMAT_R16G16_FLOAT, m_SkyMotion.rootSig, m_SkyMotion.pso);
 }
 
+void Sky::CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const
+{
+    outObjects.insert(outObjects.end(), {m_ProceduralSkyCube.genSkyRootSig, m_ProceduralSkyCube.genSkyPso, m_SkyMotion.rootSig, m_SkyMotion.pso});
+}
+
 void Sky::CreateProceduralSkyCubeResources(const ComPtr<ID3D12Device14>& device, BindlessHeaps& bindlessHeaps)
 {
     m_ProceduralSkyCube.skyCube.Reset();
@@ -195,6 +219,7 @@ void Sky::CreateProceduralSkyCubeResources(const ComPtr<ID3D12Device14>& device,
         IE_Check(device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE, nullptr, IID_PPV_ARGS(&out.resource)));
         out.state = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
         out.SetName(name);
+        GpuMemory::Track(out.Get(), GpuMemoryCategory_Textures);
     };
 
     CreateCube(ProceduralSkyCubeResources::skyCubeSize, 1, L"Procedural Sky Cube", m_ProceduralSkyCube.skyCube);
@@ -208,6 +233,7 @@ void Sky::CreateProceduralSkyCubeResources(const ComPtr<ID3D12Device14>& device,
 
     srv.TextureCube.MipLevels = 1;
     m_ProceduralSkyCube.skyCube.srvIndex = bindlessHeaps.CreateSRV(m_ProceduralSkyCube.skyCube.resource, srv);
+    m_ProceduralSkyCube.skyCube.srvGeneration = bindlessHeaps.GetGeneration(m_ProceduralSkyCube.skyCube.srvIndex);
 
     D3D12_UNORDERED_ACCESS_VIEW_DESC uav{};
     uav.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
@@ -218,6 +244,7 @@ void Sky::CreateProceduralSkyCubeResources(const ComPtr<ID3D12Device14>& device,
 
     uav.Texture2DArray.MipSlice = 0;
     m_ProceduralSkyCube.skyCube.uavIndex = bindlessHeaps.CreateUAV(m_ProceduralSkyCube.skyCube.resource, uav);
+    m_ProceduralSkyCube.skyCube.uavGeneration = bindlessHeaps.GetGeneration(m_ProceduralSkyCube.skyCube.uavIndex);
 
     m_ProceduralSkyCube.dirty = true;
     m_ProceduralSkyCube.lastSunIntensity = -1.0f;
@@ -248,6 +275,7 @@ void Sky::CreateSkyMotionPassResources(const ComPtr<ID3D12Device14>& device)
     {
         IE_Check(device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &cbDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&m_SkyMotion.cb[i])));
         IE_Check(m_SkyMotion.cb[i]->SetName(L"SkyMotionPassConstants"));
+        GpuMemory::Track(m_SkyMotion.cb[i].Get(), GpuMemoryCategory_Upload);
         IE_Check(m_SkyMotion.cb[i]->Map(0, nullptr, reinterpret_cast<void**>(&m_SkyMotion.cbMapped[i])));
     }
 }
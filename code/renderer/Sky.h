@@ -27,8 +27,11 @@ class Sky
     void CreateProceduralSkyCubeResources(const ComPtr<ID3D12Device14>& device, BindlessHeaps& bindlessHeaps);
     void CreateSkyMotionPassResources(const ComPtr<ID3D12Device14>& device);
 
-    void CreateProceduralSkyCubePipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines);
-    void CreateSkyMotionPassPipelines(const ComPtr<ID3D12Device14>& device, const Vector<String>& globalDefines);
+    void QueueProceduralSkyCubeShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void QueueSkyMotionPassShaders(ShaderCompileQueue& shaderQueue, const Vector<String>& globalDefines);
+    void CreateProceduralSkyCubePipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue);
+    void CreateSkyMotionPassPipelines(const ComPtr<ID3D12Device14>& device, const ShaderCompileQueue& shaderQueue);
+    void CollectPipelineObjects(Vector<ComPtr<ID3D12DeviceChild>>& outObjects) const;
 
     void PassSkyMotion(const ComPtr<ID3D12GraphicsCommandList7>& cmd, GpuTimers& gpuTimers, u32 frameInFlightIdx, const Camera::FrameData& cameraFrameData,
                        const Array<D3D12_CPU_DESCRIPTOR_HANDLE, GBuffer::targetCount>& gbufferRtvHandles, GpuResource& gbufferMotionVector, u32 depthSrvIndex, const BindlessHeaps& bindlessHeaps);
@@ -9,14 +9,18 @@
 
 struct Texture : public GpuResource
 {
+    ComPtr<D3D12MA::Allocation> allocation;
     u32 srvIndex = UINT32_MAX;
     u32 uavIndex = UINT32_MAX;
+    u32 srvGeneration = 0; // BindlessHeaps generations of the views, passed back when they are freed
+    u32 uavGeneration = 0;
 };
 
 struct RenderTarget : public GpuResource
 {
     D3D12_CPU_DESCRIPTOR_HANDLE rtv = {};
     u32 srvIndex = UINT32_MAX;
+    u32 srvGeneration = 0;
 };
 
 struct DepthTexture : public GpuResource
@@ -24,4 +28,5 @@ struct DepthTexture : public GpuResource
     ComPtr<D3D12MA::Allocation> allocation;
     D3D12_CPU_DESCRIPTOR_HANDLE dsv = {};
     u32 srvIndex = UINT32_MAX;
+    u32 srvGeneration = 0;
 };
@@ -0,0 +1,214 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "TimelineCapture.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+#include "Constants.h"
+#include "common/TimelineFormat.h"
+
+void TimelineCapture::Start(const u32 frameCount, const bool rolling, const u64 gpuTimestampFrequency)
+{
+    // Rolling captures overwrite old slots, so the ring must outlive the GPU readback latency.
+    m_FrameCount = std::clamp(frameCount, IE_Constants::frameInFlightCount + 1, 4096u);
+    m_Slots.assign(m_FrameCount, FrameSlot{});
+    m_FirstFrame = m_NextFrame;
+    m_GpuTimestampFrequency = gpuTimestampFrequency;
+    m_Origin = std::chrono::steady_clock::now();
+    m_Active = true;
+    m_Rolling = rolling;
+}
+
+void TimelineCapture::Stop()
+{
+    m_Active = false;
+    m_Rolling = false;
+    m_Slots.clear();
+    m_Slots.shrink_to_fit();
+}
+
+bool TimelineCapture::IsActive() const
+{
+    return m_Active;
+}
+
+bool TimelineCapture::IsRolling() const
+{
+    return m_Active && m_Rolling;
+}
+
+bool TimelineCapture::IsComplete() const
+{
+    return m_Active && !m_Rolling && m_NextFrame >= m_FirstFrame + m_FrameCount + IE_Constants::frameInFlightCount;
+}
+
+u64 TimelineCapture::GetCurrentFrame() const
+{
+    return m_NextFrame;
+}
+
+void TimelineCapture::RecordGpuFrame(const GpuTimers& timers, ID3D12CommandQueue* queue)
+{
+    if (!m_Active || !timers.nextIdx || !m_GpuTimestampFrequency || timers.captureFrame < m_FirstFrame)
+    {
+        return;
+    }
+
+    FrameSlot& slot = m_Slots[timers.captureFrame % m_Slots.size()];
+    if (slot.frame != timers.captureFrame)
+    {
+        return;
+    }
+
+    // The calibration pairs a GPU timestamp with a QPC value; QPC is then related to the steady clock used by the CPU scopes.
+    u64 gpuCalibration = 0;
+    u64 qpcCalibration = 0;
+    if (FAILED(queue->GetClockCalibration(&gpuCalibration, &qpcCalibration)))
+    {
+        return;
+    }
+    LARGE_INTEGER qpcNow{};
+    LARGE_INTEGER qpcFrequency{};
+    QueryPerformanceCounter(&qpcNow);
+    const i64 nowNs = ToCaptureNs(std::chrono::steady_clock::now());
+    QueryPerformanceFrequency(&qpcFrequency);
+
+    const f64 calibrationNs = static_cast<f64>(nowNs) - static_cast<f64>(qpcNow.QuadPart - static_cast<i64>(qpcCalibration)) * 1e9 / static_cast<f64>(qpcFrequency.QuadPart);
+    const f64 nsPerTick = 1e9 / static_cast<f64>(m_GpuTimestampFrequency);
+    auto ToNs = [&](const u64 ticks) { return static_cast<i64>(calibrationNs + static_cast<f64>(static_cast<i64>(ticks - gpuCalibration)) * nsPerTick); };
+
+    u64* ticks = nullptr;
+    D3D12_RANGE r{0, static_cast<size_t>(timers.nextIdx) * sizeof(u64)};
+    IE_Check(timers.readback->Map(0, &r, reinterpret_cast<void**>(&ticks)));
+
+    slot.gpuPassCount = 0;
+    for (u32 i = 0; i < timers.passCount && slot.gpuPassCount < kMaxPassesPerFrame; ++i)
+    {
+        const GpuTimers::Pass& p = timers.passes[i];
+        if (p.idxEnd <= p.idxBegin)
+        {
+            continue;
+        }
+        slot.gpuPasses[slot.gpuPassCount++] = {p.name, ToNs(ticks[p.idxBegin]), ToNs(ticks[p.idxEnd])};
+    }
+
+    D3D12_RANGE w{0, 0};
+    timers.readback->Unmap(0, &w);
+}
+
+void TimelineCapture::RecordCpuFrame(const CpuTimers& timers, const std::chrono::steady_clock::time_point frameBegin, const std::chrono::steady_clock::time_point frameEnd)
+{
+    const u64 frame = m_NextFrame++;
+    if (!m_Active || (!m_Rolling && frame >= m_FirstFrame + m_FrameCount))
+    {
+        return;
+    }
+
+    FrameSlot& slot = m_Slots[frame % m_Slots.size()];
+    slot.frame = frame;
+    slot.cpuBeginNs = ToCaptureNs(frameBegin);
+    slot.cpuEndNs = ToCaptureNs(frameEnd);
+    slot.gpuPassCount = 0;
+    slot.cpuScopeCount = 0;
+    for (u32 i = 0; i < timers.passCount && slot.cpuScopeCount < kMaxPassesPerFrame; ++i)
+    {
+        const CpuTimers::Pass& p = timers.passes[i];
+        slot.cpuScopes[slot.cpuScopeCount++] = {p.name, p.depth, ToCaptureNs(p.startTime), ToCaptureNs(p.endTime)};
+    }
+}
+
+bool TimelineCapture::Write(const std::filesystem::path& path) const
+{
+    using namespace IETimeline;
+
+    if (!m_Active)
+    {
+        return false;
+    }
+
+    const u64 endFrame = m_Rolling ? m_NextFrame : std::min(m_NextFrame, m_FirstFrame + m_FrameCount);
+    const u64 beginFrame = std::max(m_FirstFrame, endFrame > m_Slots.size() ? endFrame - m_Slots.size() : 0);
+
+    Vector<FrameRecord> frames;
+    Vector<CpuScopeRecord> cpuScopes;
+    Vector<GpuPassRecord> gpuPasses;
+    Vector<std::string_view> names;
+    std::unordered_map<std::string_view, u32> nameIndices;
+    auto NameIndex = [&](const char* name) {
+        const std::string_view key = name ? name : "";
+        auto [it, inserted] = nameIndices.try_emplace(key, static_cast<u32>(names.size()));
+        if (inserted)
+        {
+            names.push_back(key);
+        }
+        return it->second;
+    };
+
+    for (u64 frame = beginFrame; frame < endFrame; ++frame)
+    {
+        const FrameSlot& slot = m_Slots[frame % m_Slots.size()];
+        if (slot.frame != frame)
+        {
+            continue;
+        }
+
+        FrameRecord& record = frames.emplace_back();
+        record.frame = frame;
+        record.cpuBeginNs = slot.cpuBeginNs;
+        record.cpuEndNs = slot.cpuEndNs;
+        record.firstCpuScope = static_cast<u32>(cpuScopes.size());
+        record.cpuScopeCount = slot.cpuScopeCount;
+        record.firstGpuPass = static_cast<u32>(gpuPasses.size());
+        record.gpuPassCount = slot.gpuPassCount;
+
+        for (u32 i = 0; i < slot.cpuScopeCount; ++i)
+        {
+            const CpuScope& scope = slot.cpuScopes[i];
+            cpuScopes.push_back({NameIndex(scope.name), scope.depth, scope.beginNs, scope.endNs});
+        }
+        for (u32 i = 0; i < slot.gpuPassCount; ++i)
+        {
+            const GpuPass& pass = slot.gpuPasses[i];
+            gpuPasses.push_back({NameIndex(pass.name), 0, pass.beginNs, pass.endNs});
+        }
+    }
+
+    TimelineHeader header{};
+    std::copy(std::begin(TIMELINE_MAGIC), std::end(TIMELINE_MAGIC), header.magic);
+    header.version = TIMELINE_VERSION_LATEST;
+    header.frameCount = static_cast<u32>(frames.size());
+    header.cpuScopeCount = static_cast<u32>(cpuScopes.size());
+    header.gpuPassCount = static_cast<u32>(gpuPasses.size());
+    header.nameCount = static_cast<u32>(names.size());
+    header.gpuTimestampFrequency = m_GpuTimestampFrequency;
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(frames.data()), static_cast<std::streamsize>(frames.size() * sizeof(FrameRecord)));
+    file.write(reinterpret_cast<const char*>(cpuScopes.data()), static_cast<std::streamsize>(cpuScopes.size() * sizeof(CpuScopeRecord)));
+    file.write(reinterpret_cast<const char*>(gpuPasses.data()), static_cast<std::streamsize>(gpuPasses.size() * sizeof(GpuPassRecord)));
+    for (const std::string_view name : names)
+    {
+        const u16 length = static_cast<u16>(std::min<size_t>(name.size(), UINT16_MAX));
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file.write(name.data(), length);
+    }
+    return file.good();
+}
+
+i64 TimelineCapture::ToCaptureNs(const std::chrono::steady_clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_Origin).count();
+}
@@ -0,0 +1,77 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+
+#include "Timings.h"
+#include "common/Types.h"
+
+// Records per-frame CPU scopes and GPU pass timestamps into a ring buffer of frames, with GPU ticks mapped onto the CPU clock through
+// the queue's clock calibration. A one-shot capture completes once its frames and their GPU results are in; a rolling capture keeps
+// the most recent frames until it is written.
+class TimelineCapture
+{
+  public:
+    void Start(u32 frameCount, bool rolling, u64 gpuTimestampFrequency);
+    void Stop();
+
+    bool IsActive() const;
+    bool IsRolling() const;
+    // A one-shot capture that has recorded all of its frames.
+    bool IsComplete() const;
+
+    // Serial of the frame being recorded; it keeps counting across scene switches, unlike the renderer's frame index.
+    u64 GetCurrentFrame() const;
+
+    // GPU results arrive frameInFlightCount frames late; they are attached to the frame the timers were tagged with.
+    void RecordGpuFrame(const GpuTimers& timers, ID3D12CommandQueue* queue);
+    // Ends the current frame and advances the frame serial, also when no capture is running.
+    void RecordCpuFrame(const CpuTimers& timers, std::chrono::steady_clock::time_point frameBegin, std::chrono::steady_clock::time_point frameEnd);
+
+    bool Write(const std::filesystem::path& path) const;
+
+  private:
+    static constexpr u32 kMaxPassesPerFrame = 128;
+
+    struct CpuScope
+    {
+        const char* name;
+        u32 depth;
+        i64 beginNs;
+        i64 endNs;
+    };
+
+    struct GpuPass
+    {
+        const char* name;
+        i64 beginNs;
+        i64 endNs;
+    };
+
+    struct FrameSlot
+    {
+        u64 frame = UINT64_MAX;
+        i64 cpuBeginNs = 0;
+        i64 cpuEndNs = 0;
+        u32 cpuScopeCount = 0;
+        u32 gpuPassCount = 0;
+        Array<CpuScope, kMaxPassesPerFrame> cpuScopes;
+        Array<GpuPass, kMaxPassesPerFrame> gpuPasses;
+    };
+
+    i64 ToCaptureNs(std::chrono::steady_clock::time_point time) const;
+
+    Vector<FrameSlot> m_Slots;
+    u64 m_NextFrame = 0;
+    u64 m_FirstFrame = 0;
+    u32 m_FrameCount = 0;
+    u64 m_GpuTimestampFrequency = 0;
+    std::chrono::steady_clock::time_point m_Origin{};
+    bool m_Active = false;
+    bool m_Rolling = false;
+};
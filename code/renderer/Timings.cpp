@@ -6,77 +6,238 @@
 #include "Timings.h"
 
 #include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
 #include <pix.h>
 
+#include "common/JsonUtils.h"
+#include "common/Profiler.h"
+
 namespace
 {
-void PushHistorySample(TimingState::TimingSmoother& smoother, const f64 sample, const f32 dtMs)
+using TimingSmoother = TimingState::TimingSmoother;
+using TimingSample = TimingState::TimingSample;
+constexpr u32 kCapacity = TimingState::kHistoryCapacity;
+
+u32 HistogramBucket(const f64 ms)
 {
-    const u32 capacity = TimingState::kHistoryCapacity;
-    if (capacity == 0u)
+    if (!(ms > TimingState::kHistogramMinMs))
     {
-        return;
+        return 0;
     }
+    const f64 bucket = std::log2(ms / TimingState::kHistogramMinMs) * TimingState::kHistogramBucketsPerOctave;
+    return static_cast<u32>(std::min(bucket, static_cast<f64>(TimingState::kHistogramBuckets - 1)));
+}
+
+const TimingSample& SampleAt(const TimingSmoother& sm, const u32 serial)
+{
+    return sm.history[serial % kCapacity];
+}
+
+f64 SampleWeight(const TimingSample& sample)
+{
+    return sample.dtMs > 0.0f ? static_cast<f64>(sample.dtMs) : 0.0;
+}
+
+u32 OldestWindowSerial(const TimingSmoother& sm)
+{
+    return sm.sampleSerial - sm.windowCount;
+}
+
+u32& MaxQueueAt(TimingSmoother& sm, const u32 i)
+{
+    return sm.maxQueue[(sm.maxQueueStart + i) % kCapacity];
+}
+
+void AddSampleToWindow(TimingSmoother& sm, const u32 serial, const bool newest)
+{
+    const TimingSample& sample = SampleAt(sm, serial);
+    sm.windowWeightedSum += sample.value * SampleWeight(sample);
+    sm.windowCoveredMs += SampleWeight(sample);
+    sm.histogram[HistogramBucket(sample.value)]++;
+    sm.windowCount++;
 
-    if (smoother.history.empty())
+    if (newest)
     {
-        smoother.history.resize(capacity);
+        // Older candidates that are not larger can never be the max again.
+        while (sm.maxQueueCount > 0 && SampleAt(sm, MaxQueueAt(sm, sm.maxQueueCount - 1)).value <= sample.value)
+        {
+            sm.maxQueueCount--;
+        }
+        MaxQueueAt(sm, sm.maxQueueCount++) = serial;
     }
-
-    if (smoother.historyCount < capacity)
+    else if (sm.maxQueueCount == 0 || sample.value > SampleAt(sm, MaxQueueAt(sm, 0)).value)
     {
-        const u32 writeIndex = (smoother.historyStart + smoother.historyCount) % capacity;
-        smoother.history[writeIndex].value = sample;
-        smoother.history[writeIndex].dtMs = dtMs;
-        ++smoother.historyCount;
-        return;
+        // An older sample leaves the window first, so it only matters if it beats the current max.
+        sm.maxQueueStart = (sm.maxQueueStart + kCapacity - 1) % kCapacity;
+        sm.maxQueueCount++;
+        MaxQueueAt(sm, 0) = serial;
     }
+}
 
-    smoother.history[smoother.historyStart].value = sample;
-    smoother.history[smoother.historyStart].dtMs = dtMs;
-    smoother.historyStart = (smoother.historyStart + 1u) % capacity;
+void RemoveOldestFromWindow(TimingSmoother& sm)
+{
+    const u32 serial = OldestWindowSerial(sm);
+    const TimingSample& sample = SampleAt(sm, serial);
+    sm.windowWeightedSum -= sample.value * SampleWeight(sample);
+    sm.windowCoveredMs -= SampleWeight(sample);
+    sm.histogram[HistogramBucket(sample.value)]--;
+    sm.windowCount--;
+
+    if (sm.maxQueueCount > 0 && MaxQueueAt(sm, 0) == serial)
+    {
+        sm.maxQueueStart = (sm.maxQueueStart + 1) % kCapacity;
+        sm.maxQueueCount--;
+    }
 }
 
-f64 ComputeBoxAverage(const TimingState::TimingSmoother& smoother, const f32 windowMs)
+// Recomputes the window sums from scratch, so the running add/subtract does not drift over long sessions.
+void ResyncWindowSums(TimingSmoother& sm)
 {
-    if (smoother.historyCount == 0u)
+    sm.windowWeightedSum = 0.0;
+    sm.windowCoveredMs = 0.0;
+    for (u32 serial = OldestWindowSerial(sm); serial != sm.sampleSerial; ++serial)
     {
-        return 0.0;
+        const TimingSample& sample = SampleAt(sm, serial);
+        sm.windowWeightedSum += sample.value * SampleWeight(sample);
+        sm.windowCoveredMs += SampleWeight(sample);
     }
+}
 
+// Shrinks or grows the window so it covers windowMs; a zero window keeps only the newest sample.
+void FitWindow(TimingSmoother& sm, const f32 windowMs)
+{
     if (windowMs <= 0.0f)
     {
-        const u32 newestIndex = (smoother.historyStart + smoother.historyCount - 1u) % TimingState::kHistoryCapacity;
-        return smoother.history[newestIndex].value;
+        while (sm.windowCount > 1)
+        {
+            RemoveOldestFromWindow(sm);
+        }
+        return;
     }
 
-    f64 weightedSum = 0.0;
-    f64 coveredMs = 0.0;
+    while (sm.windowCount > 1 && sm.windowCoveredMs - SampleWeight(SampleAt(sm, OldestWindowSerial(sm))) >= windowMs)
+    {
+        RemoveOldestFromWindow(sm);
+    }
+    while (sm.windowCount < sm.historyCount && sm.windowCoveredMs < windowMs)
+    {
+        AddSampleToWindow(sm, OldestWindowSerial(sm) - 1, false);
+    }
+}
 
-    for (u32 age = 0; age < smoother.historyCount && coveredMs < windowMs; ++age)
+// Time-weighted box average; the oldest sample only counts for the part that fits in the window.
+f64 ComputeWindowMean(const TimingSmoother& sm, const f32 windowMs)
+{
+    const TimingSample& newest = SampleAt(sm, sm.sampleSerial - 1);
+    if (windowMs <= 0.0f || sm.windowCoveredMs <= 0.0)
     {
-        const u32 idx = (smoother.historyStart + smoother.historyCount - 1u - age) % TimingState::kHistoryCapacity;
-        const TimingState::TimingSample& entry = smoother.history[idx];
-        const f64 sampleDtMs = entry.dtMs > 0.0f ? static_cast<f64>(entry.dtMs) : 0.0;
-        if (sampleDtMs <= 0.0)
+        return newest.value;
+    }
+
+    const f64 overshootMs = std::max(0.0, sm.windowCoveredMs - static_cast<f64>(windowMs));
+    const f64 coveredMs = sm.windowCoveredMs - overshootMs;
+    return coveredMs > 0.0 ? (sm.windowWeightedSum - SampleAt(sm, OldestWindowSerial(sm)).value * overshootMs) / coveredMs : newest.value;
+}
+
+void PushSample(TimingSmoother& sm, const f64 sample, const f32 dtMs, const f32 windowMs)
+{
+    if (sm.history.empty())
+    {
+        sm.history.resize(kCapacity);
+        sm.maxQueue.resize(kCapacity);
+    }
+
+    // The history slot about to be reused may still be part of the window.
+    if (sm.historyCount == kCapacity)
+    {
+        if (sm.windowCount == kCapacity)
         {
-            continue;
+            RemoveOldestFromWindow(sm);
         }
+        sm.historyCount--;
+    }
 
-        const f64 remainingMs = static_cast<f64>(windowMs) - coveredMs;
-        const f64 takeMs = std::min(sampleDtMs, remainingMs);
+    TimingSample& entry = sm.history[sm.sampleSerial % kCapacity];
+    entry.value = sample;
+    entry.dtMs = dtMs;
+    sm.historyCount++;
+    AddSampleToWindow(sm, sm.sampleSerial++, true);
+    FitWindow(sm, windowMs);
 
-        weightedSum += entry.value * takeMs;
-        coveredMs += takeMs;
+    if (sm.sampleSerial % kCapacity == 0)
+    {
+        ResyncWindowSums(sm);
     }
 
-    if (coveredMs <= 0.0)
+    sm.value = ComputeWindowMean(sm, windowMs);
+    sm.initialized = true;
+}
+
+TimingStats ComputeStats(const TimingSmoother& sm)
+{
+    TimingStats stats{};
+    if (!sm.initialized || sm.windowCount == 0)
     {
-        const u32 newestIndex = (smoother.historyStart + smoother.historyCount - 1u) % TimingState::kHistoryCapacity;
-        return smoother.history[newestIndex].value;
+        return stats;
     }
 
-    return weightedSum / coveredMs;
+    stats.mean = sm.value;
+    stats.sampleCount = sm.windowCount;
+    stats.max = sm.maxQueueCount > 0 ? SampleAt(sm, sm.maxQueue[sm.maxQueueStart]).value : sm.value;
+
+    // Nearest-rank percentiles, interpolated geometrically inside the log bucket and capped by the exact max.
+    const f64 percentiles[3] = {0.50, 0.95, 0.99};
+    f64* outputs[3] = {&stats.p50, &stats.p95, &stats.p99};
+    u32 next = 0;
+    u32 cumulative = 0;
+    for (u32 b = 0; b < TimingState::kHistogramBuckets && next < 3; ++b)
+    {
+        const u32 count = sm.histogram[b];
+        while (next < 3)
+        {
+            const f64 rank = std::max(1.0, std::ceil(percentiles[next] * static_cast<f64>(sm.windowCount)));
+            if (rank > static_cast<f64>(cumulative + count))
+            {
+                break;
+            }
+            const f64 fraction = (rank - static_cast<f64>(cumulative) - 0.5) / static_cast<f64>(count);
+            const f64 lower = Timings_HistogramBucketLowerMs(b);
+            const f64 upper = Timings_HistogramBucketLowerMs(b + 1);
+            *outputs[next++] = std::min(lower * std::pow(upper / lower, fraction), stats.max);
+        }
+        cumulative += count;
+    }
+    return stats;
+}
+
+const TimingSmoother* FindSmoother(const TimingState& s, const char* name)
+{
+    for (u32 i = 0; i < s.smoothCount; ++i)
+    {
+        if (s.smooth[i].name == name)
+        {
+            return &s.smooth[i];
+        }
+    }
+    return nullptr;
+}
+
+TimingSmoother* FindOrAddSmoother(TimingState& s, const char* name)
+{
+    if (const TimingSmoother* existing = FindSmoother(s, name))
+    {
+        return const_cast<TimingSmoother*>(existing);
+    }
+    if (s.smoothCount >= TimingState::kMaxTimings)
+    {
+        return nullptr;
+    }
+
+    TimingSmoother& sm = s.smooth[s.smoothCount++];
+    sm.name = name;
+    return &sm;
 }
 } // namespace
 
@@ -104,9 +265,28 @@ void CPU_MARKER_BEGIN(CpuTimers& timers, const char* name)
         return;
     }
 
+    Profiler::BeginScope(name);
+
+    // The pass slot is reserved up front so parents are listed before their children.
+    u32 passIndex = UINT32_MAX;
+    if (timers.passCount < 128)
+    {
+        passIndex = timers.passCount++;
+        CpuTimers::Pass& p = timers.passes[passIndex];
+        p.name = name;
+        p.ms = 0.0;
+        p.depth = timers.openScopeCount;
+    }
+
+    timers.openPasses[timers.openScopeCount] = passIndex;
     CpuTimers::Scope& s = timers.openScopes[timers.openScopeCount++];
     s.name = name;
     s.startTime = std::chrono::steady_clock::now();
+    if (passIndex != UINT32_MAX)
+    {
+        timers.passes[passIndex].startTime = s.startTime;
+        timers.passes[passIndex].endTime = s.startTime;
+    }
 }
 
 void CPU_MARKER_END(CpuTimers& timers)
@@ -117,58 +297,100 @@ void CPU_MARKER_END(CpuTimers& timers)
     }
 
     const std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
-    const CpuTimers::Scope s = timers.openScopes[--timers.openScopeCount];
-    const f64 dtMs = std::chrono::duration<f64, std::milli>(endTime - s.startTime).count();
+    const u32 passIndex = timers.openPasses[--timers.openScopeCount];
+    const CpuTimers::Scope s = timers.openScopes[timers.openScopeCount];
+    Profiler::EndScope();
 
-    if (timers.passCount >= 128)
+    if (passIndex != UINT32_MAX)
     {
-        return;
+        timers.passes[passIndex].ms = std::chrono::duration<f64, std::milli>(endTime - s.startTime).count();
+        timers.passes[passIndex].endTime = endTime;
     }
-
-    CpuTimers::Pass& p = timers.passes[timers.passCount++];
-    p.name = s.name;
-    p.ms = dtMs;
 }
 
 void Timings_UpdateAverages(TimingState& s, f32 dtMs, f32 windowMs)
 {
     for (u32 i = 0; i < s.lastCount; ++i)
     {
-        const char* name = s.last[i].name;
-        f64 sample = s.last[i].ms;
+        Timings_AddSample(s, s.last[i].name, s.last[i].ms, dtMs, windowMs);
+    }
+}
 
-        u32 j = 0;
-        for (; j < s.smoothCount; ++j)
-        {
-            if (s.smooth[j].name == name)
-                break;
-        }
+void Timings_AddSample(TimingState& s, const char* name, f64 ms, f32 dtMs, f32 windowMs)
+{
+    if (TimingState::TimingSmoother* sm = FindOrAddSmoother(s, name))
+    {
+        PushSample(*sm, ms, dtMs, windowMs);
+    }
+}
 
-        if (j == s.smoothCount && j < TimingState::kMaxTimings)
-        {
-            s.smooth[j].name = name;
-            s.smoothCount++;
-        }
+TimingStats Timings_GetStats(const TimingState& s, const char* name)
+{
+    const TimingState::TimingSmoother* sm = FindSmoother(s, name);
+    return sm ? ComputeStats(*sm) : TimingStats{};
+}
 
-        auto& sm = s.smooth[j];
-        PushHistorySample(sm, sample, dtMs);
-        sm.value = ComputeBoxAverage(sm, windowMs);
-        sm.initialized = true;
-    }
+const Array<u32, TimingState::kHistogramBuckets>* Timings_GetHistogram(const TimingState& s, const char* name)
+{
+    const TimingState::TimingSmoother* sm = FindSmoother(s, name);
+    return sm ? &sm->histogram : nullptr;
+}
+
+f64 Timings_HistogramBucketLowerMs(u32 bucket)
+{
+    return TimingState::kHistogramMinMs * std::exp2(static_cast<f64>(bucket) / TimingState::kHistogramBucketsPerOctave);
 }
 
-f64 Timings_ComputeAverageWindowMs(const TimingState& s, const char* name, f32 windowMs)
+void Timings_ExportStats(const TimingState& s, Vector<TimingStatsExport>& out)
 {
+    out.clear();
+    out.reserve(s.smoothCount);
     for (u32 i = 0; i < s.smoothCount; ++i)
     {
-        const auto& sm = s.smooth[i];
-        if (sm.name == name)
+        TimingStatsExport& entry = out.emplace_back();
+        entry.name = s.smooth[i].name;
+        entry.stats = ComputeStats(s.smooth[i]);
+        entry.histogram = s.smooth[i].histogram;
+    }
+}
+
+bool Timings_WriteStatsJson(const std::filesystem::path& path, std::initializer_list<std::pair<const char*, const TimingState*>> states)
+{
+    String json = std::format("{{\n  \"histogramMinMs\": {}, \"histogramBucketsPerOctave\": {}", TimingState::kHistogramMinMs, TimingState::kHistogramBucketsPerOctave);
+
+    Vector<TimingStatsExport> entries;
+    for (const auto& [label, state] : states)
+    {
+        Timings_ExportStats(*state, entries);
+        json += ",\n  ";
+        AppendJsonString(json, label);
+        json += ": [";
+        for (size_t i = 0; i < entries.size(); ++i)
         {
-            return ComputeBoxAverage(sm, windowMs);
+            const TimingStatsExport& entry = entries[i];
+            json += i == 0 ? "\n    {\"name\": " : ",\n    {\"name\": ";
+            AppendJsonString(json, entry.name);
+            json += std::format(", \"samples\": {}, \"meanMs\": {:.4f}, \"p50Ms\": {:.4f}, \"p95Ms\": {:.4f}, \"p99Ms\": {:.4f}, \"maxMs\": {:.4f}, \"histogram\": [",
+                                entry.stats.sampleCount, entry.stats.mean, entry.stats.p50, entry.stats.p95, entry.stats.p99, entry.stats.max);
+            for (u32 b = 0; b < TimingState::kHistogramBuckets; ++b)
+            {
+                json += std::format(b == 0 ? "{}" : ",{}", entry.histogram[b]);
+            }
+            json += "]}";
         }
+        json += entries.empty() ? "]" : "\n  ]";
+    }
+    json += "\n}\n";
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
     }
 
-    return 0.0;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return file.good();
 }
 
 void Timings_ResetAverages(TimingState& s)
@@ -180,8 +402,14 @@ void Timings_ResetAverages(TimingState& s)
         entry.name = nullptr;
         entry.value = 0.0;
         entry.initialized = false;
-        entry.historyStart = 0;
         entry.historyCount = 0;
+        entry.sampleSerial = 0;
+        entry.windowCount = 0;
+        entry.windowWeightedSum = 0.0;
+        entry.windowCoveredMs = 0.0;
+        entry.histogram = {};
+        entry.maxQueueStart = 0;
+        entry.maxQueueCount = 0;
     }
 }
 
@@ -212,6 +440,7 @@ void Timings_CollectGpu(const GpuTimers& timers, TimingState& s)
         TimingState::TimDisp& ts = s.last[s.lastCount++];
         ts.name = p.name;
         ts.ms = dt;
+        ts.depth = 0;
     }
 
     D3D12_RANGE w{0, 0};
@@ -226,6 +455,7 @@ void Timings_CollectCpu(const CpuTimers& timers, TimingState& s)
         TimingState::TimDisp& ts = s.last[s.lastCount++];
         ts.name = timers.passes[i].name;
         ts.ms = timers.passes[i].ms;
+        ts.depth = timers.passes[i].depth;
     }
 }
 
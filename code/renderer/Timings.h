@@ -6,6 +6,9 @@
 #pragma once
 
 #include <chrono>
+#include <filesystem>
+#include <initializer_list>
+#include <utility>
 
 #include "common/Types.h"
 
@@ -22,6 +25,7 @@ struct GpuTimers
         f64 ms = 0.0;
     } passes[128];
     u32 passCount = 0;
+    u64 captureFrame = 0; // timeline capture frame these passes were recorded in
 };
 
 struct CpuTimers
@@ -31,28 +35,51 @@ struct CpuTimers
         const char* name = nullptr;
         std::chrono::steady_clock::time_point startTime{};
     } openScopes[128];
+    u32 openPasses[128];
     u32 openScopeCount = 0;
 
+    // Recorded in begin order, so a nested pass follows its parent with a greater depth.
     struct Pass
     {
         const char* name = nullptr;
         f64 ms = 0.0;
+        u32 depth = 0;
+        std::chrono::steady_clock::time_point startTime{};
+        std::chrono::steady_clock::time_point endTime{};
     } passes[128];
     u32 passCount = 0;
 };
 
+// Statistics of one timing over the averaging window.
+struct TimingStats
+{
+    f64 mean = 0.0; // time-weighted box average, or the newest sample when the window is 0
+    f64 p50 = 0.0;
+    f64 p95 = 0.0;
+    f64 p99 = 0.0;
+    f64 max = 0.0;
+    u32 sampleCount = 0;
+};
+
 // Aggregation/smoothing state (shared by CPU and GPU timings).
 struct TimingState
 {
     static constexpr u32 kMaxTimings = 128u;
     static constexpr u32 kHistoryCapacity = 8192u;
 
+    // Log-spaced histogram: bucket b covers [kHistogramMinMs * 2^(b / 8), kHistogramMinMs * 2^((b + 1) / 8)) ms. The first bucket also
+    // takes everything below, the last everything above (about 655 ms).
+    static constexpr u32 kHistogramBuckets = 128u;
+    static constexpr u32 kHistogramBucketsPerOctave = 8u;
+    static constexpr f64 kHistogramMinMs = 0.01;
+
     u64 timestampFrequency = 0; // ticks/sec from command queue (GPU-only)
 
     struct TimDisp
     {
         const char* name;
         f64 ms;
+        u32 depth;
     } last[kMaxTimings];
     u32 lastCount = 0;
 
@@ -62,29 +89,59 @@ struct TimingState
         f32 dtMs = 0.0f;
     };
 
+    // The window is the newest windowCount samples of the history. Each sample enters and leaves it once, so keeping the sums,
+    // histogram and running max up to date costs amortized O(1) per frame.
     struct TimingSmoother
     {
         const char* name = nullptr; // expected to be a stable literal
         f64 value = 0.0;
         bool initialized = false;
         Vector<TimingSample> history{};
-        u32 historyStart = 0;
         u32 historyCount = 0;
+        u32 sampleSerial = 0; // serial of the next sample pushed, history entries are addressed by serial % kHistoryCapacity
+
+        u32 windowCount = 0;
+        f64 windowWeightedSum = 0.0;
+        f64 windowCoveredMs = 0.0;
+        Array<u32, kHistogramBuckets> histogram{};
+        // Serials of the window's running max candidates, with decreasing values from front to back.
+        Vector<u32> maxQueue{};
+        u32 maxQueueStart = 0;
+        u32 maxQueueCount = 0;
     };
     TimingSmoother smooth[kMaxTimings] = {};
     u32 smoothCount = 0;
 };
 
+// One timing as handed out by Timings_ExportStats.
+struct TimingStatsExport
+{
+    const char* name = nullptr;
+    TimingStats stats{};
+    Array<u32, TimingState::kHistogramBuckets> histogram{};
+};
+
 void GPU_MARKER_BEGIN(const ComPtr<ID3D12GraphicsCommandList7>& cmd, GpuTimers& timers, const char* name);
 void GPU_MARKER_END(const ComPtr<ID3D12GraphicsCommandList7>& cmd, GpuTimers& timers);
+// CPU markers also feed the hierarchical profiler, so they show up in exported traces.
 void CPU_MARKER_BEGIN(CpuTimers& timers, const char* name);
 void CPU_MARKER_END(CpuTimers& timers);
 
-// Update strict box averages over the requested time window for the latest timings.
+// Update the windowed statistics of the latest timings over the requested time window.
 void Timings_UpdateAverages(TimingState& s, f32 dtMs, f32 windowMs);
 
-// Compute a strict box average for one timing entry over the requested time window.
-f64 Timings_ComputeAverageWindowMs(const TimingState& s, const char* name, f32 windowMs);
+// Push one sample of a named timing outside of the "last" timings, e.g. the whole frame time.
+void Timings_AddSample(TimingState& s, const char* name, f64 ms, f32 dtMs, f32 windowMs);
+
+// Windowed statistics of one timing entry; percentiles come from the histogram, so they are accurate to about one bucket (9%).
+TimingStats Timings_GetStats(const TimingState& s, const char* name);
+const Array<u32, TimingState::kHistogramBuckets>* Timings_GetHistogram(const TimingState& s, const char* name);
+f64 Timings_HistogramBucketLowerMs(u32 bucket);
+
+// Copy the statistics and histograms of every timing, in first-seen order.
+void Timings_ExportStats(const TimingState& s, Vector<TimingStatsExport>& out);
+// Write the exported statistics of several timing states as one JSON object keyed by the given labels.
+bool Timings_WriteStatsJson(const std::filesystem::path& path, std::initializer_list<std::pair<const char*, const TimingState*>> states);
 
 // Clear timing history/averages while keeping timestamp frequency.
 void Timings_ResetAverages(TimingState& s);
@@ -0,0 +1,157 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "TransientTextures.h"
+
+#include "GpuMemory.h"
+
+namespace
+{
+const wchar_t* GetHeapName(const RGHeapClass heapClass)
+{
+    switch (heapClass)
+    {
+    case RGHeapClass_Textures:
+        return L"Transient Textures";
+    case RGHeapClass_RenderTargets:
+        return L"Transient Render Targets";
+    default:
+        return L"Transient Unknown";
+    }
+}
+
+D3D12_HEAP_FLAGS GetHeapFlags(const RGHeapClass heapClass)
+{
+    return heapClass == RGHeapClass_RenderTargets ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+}
+} // namespace
+
+void TransientTextures::Realize(const RenderGraph& graph, D3D12MA::Allocator* allocator, BindlessHeaps& bindlessHeaps)
+{
+    IE_Assert(graph.IsCompiled());
+    Release(bindlessHeaps);
+    m_Graph = &graph;
+    m_NextPass = 0;
+
+    for (u32 c = 0; c < RGHeapClass_Count; ++c)
+    {
+        const RGHeapClass heapClass = static_cast<RGHeapClass>(c);
+        const u64 heapSize = graph.GetHeapSize(heapClass);
+        if (heapSize == 0)
+        {
+            continue;
+        }
+
+        // A dedicated heap per class: the placement offsets computed by the graph are relative to its start.
+        D3D12MA::ALLOCATION_DESC allocDesc{};
+        allocDesc.Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED;
+        allocDesc.HeapType = D3D12_HEAP_TYPE_DEFAULT;
+        allocDesc.ExtraHeapFlags = GetHeapFlags(heapClass);
+
+        D3D12_RESOURCE_ALLOCATION_INFO allocInfo{};
+        allocInfo.SizeInBytes = (heapSize + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) / D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT * D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        allocInfo.Alignment = graph.GetHeapAlignment(heapClass);
+        IE_Check(allocator->AllocateMemory(&allocDesc, &allocInfo, m_Heaps[c].ReleaseAndGetAddressOf()));
+        m_Heaps[c]->SetName(GetHeapName(heapClass));
+        GpuMemory::Track(m_Heaps[c]->GetHeap(), GpuMemoryCategory_RenderTargets);
+    }
+
+    m_Textures.resize(graph.GetTextureCount());
+    for (RGTexture t = 0; t < graph.GetTextureCount(); ++t)
+    {
+        const RGTextureDesc& desc = graph.GetTextureDesc(t);
+        const RenderGraph::TextureLayout& layout = graph.GetTextureLayout(t);
+        Texture& texture = m_Textures[t];
+
+        // Created in the state the frame ends in, which is where the first pass of every frame transitions from.
+        IE_Check(allocator->CreateAliasingResource(m_Heaps[layout.heapClass].Get(), layout.offset, &desc.desc, layout.initialState, nullptr, IID_PPV_ARGS(&texture.resource)));
+        texture.state = layout.initialState;
+        texture.SetName(desc.name);
+
+        if (desc.createSrv)
+        {
+            D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+            srvDesc.Format = desc.desc.Format;
+            srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+            srvDesc.Texture2D.MipLevels = desc.desc.MipLevels;
+            texture.srvIndex = bindlessHeaps.CreateSRV(texture.resource, srvDesc);
+            texture.srvGeneration = bindlessHeaps.GetGeneration(texture.srvIndex);
+        }
+        if (desc.createUav)
+        {
+            D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
+            uavDesc.Format = desc.desc.Format;
+            uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+            texture.uavIndex = bindlessHeaps.CreateUAV(texture.resource, uavDesc);
+            texture.uavGeneration = bindlessHeaps.GetGeneration(texture.uavIndex);
+        }
+    }
+}
+
+void TransientTextures::Release(BindlessHeaps& bindlessHeaps)
+{
+    for (Texture& texture : m_Textures)
+    {
+        bindlessHeaps.FreeCbvSrvUav(texture.srvIndex, texture.srvGeneration);
+        bindlessHeaps.FreeCbvSrvUav(texture.uavIndex, texture.uavGeneration);
+    }
+    m_Textures.clear();
+    for (ComPtr<D3D12MA::Allocation>& heap : m_Heaps)
+    {
+        heap.Reset();
+    }
+    m_Graph = nullptr;
+    m_NextPass = 0;
+}
+
+void TransientTextures::InvalidateDescriptorIndices()
+{
+    for (Texture& texture : m_Textures)
+    {
+        texture.srvIndex = UINT32_MAX;
+        texture.uavIndex = UINT32_MAX;
+    }
+}
+
+void TransientTextures::BeginPass(const ComPtr<ID3D12GraphicsCommandList7>& cmd, const RGPass pass)
+{
+    IE_Assert(m_Graph != nullptr && pass == m_NextPass);
+    m_NextPass = (pass + 1u) % m_Graph->GetPassCount();
+
+    m_Barriers.clear();
+    for (const RGBarrier& barrier : m_Graph->GetPassBarriers(pass))
+    {
+        Texture& texture = m_Textures[barrier.texture];
+        switch (barrier.type)
+        {
+        case RGBarrierType_Aliasing:
+            m_Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, texture.Get()));
+            break;
+        case RGBarrierType_Transition:
+            IE_Assert(texture.state == barrier.before);
+            m_Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(texture.Get(), barrier.before, barrier.after));
+            texture.state = barrier.after;
+            break;
+        case RGBarrierType_Uav:
+            m_Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(texture.Get()));
+            break;
+        default:
+            IE_Assert(false);
+            break;
+        }
+    }
+
+    if (!m_Barriers.empty())
+    {
+        cmd->ResourceBarrier(static_cast<u32>(m_Barriers.size()), m_Barriers.data());
+    }
+}
+
+Texture& TransientTextures::Get(const RGTexture texture)
+{
+    IE_Assert(texture < m_Textures.size());
+    return m_Textures[texture];
+}
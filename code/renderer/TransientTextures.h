@@ -0,0 +1,34 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "BindlessHeaps.h"
+#include "RenderGraph.h"
+#include "Texture.h"
+#include "common/Types.h"
+
+// Places the textures of a compiled RenderGraph in one dedicated heap per heap class and records the barriers the graph
+// planned. There is a single copy of each texture: command lists on the direct queue execute one after the other, so the
+// next frame cannot start writing before the previous one stopped reading.
+class TransientTextures
+{
+  public:
+    void Realize(const RenderGraph& graph, D3D12MA::Allocator* allocator, BindlessHeaps& bindlessHeaps);
+    void Release(BindlessHeaps& bindlessHeaps);
+    void InvalidateDescriptorIndices();
+
+    // Passes must begin in declaration order, every one of them, every frame.
+    void BeginPass(const ComPtr<ID3D12GraphicsCommandList7>& cmd, RGPass pass);
+
+    Texture& Get(RGTexture texture);
+
+  private:
+    const RenderGraph* m_Graph = nullptr;
+    Array<ComPtr<D3D12MA::Allocation>, RGHeapClass_Count> m_Heaps;
+    Vector<Texture> m_Textures;
+    Vector<D3D12_RESOURCE_BARRIER> m_Barriers;
+    RGPass m_NextPass = 0;
+};
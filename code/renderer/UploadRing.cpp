@@ -0,0 +1,142 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "UploadRing.h"
+
+#include "GpuMemory.h"
+
+void UploadRing::Init(D3D12MA::Allocator* allocator, ID3D12Device* device, const u64 capacity)
+{
+    IE_Assert(capacity > 0 && capacity % D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT == 0);
+    m_Capacity = capacity;
+
+    const D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Buffer(capacity);
+    D3D12MA::ALLOCATION_DESC allocDesc{};
+    allocDesc.HeapType = D3D12_HEAP_TYPE_UPLOAD;
+    IE_Check(allocator->CreateResource(&allocDesc, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, m_Allocation.ReleaseAndGetAddressOf(),
+                                       IID_PPV_ARGS(m_Resource.ReleaseAndGetAddressOf())));
+    IE_Check(m_Resource->SetName(L"UploadRing"));
+    GpuMemory::Track(m_Resource.Get(), GpuMemoryCategory_Upload, m_Allocation->GetSize());
+
+    const CD3DX12_RANGE readRange(0, 0);
+    IE_Check(m_Resource->Map(0, &readRange, reinterpret_cast<void**>(&m_Mapped)));
+
+    IE_Check(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_Fence)));
+    m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    IE_Assert(m_FenceEvent != nullptr);
+
+    m_Head = 0;
+    m_Tail = 0;
+    m_SubmittedHead = 0;
+    m_NextFenceValue = 1;
+    m_Batches.clear();
+}
+
+void UploadRing::Terminate()
+{
+    if (m_Resource && m_Mapped)
+    {
+        m_Resource->Unmap(0, nullptr);
+        m_Mapped = nullptr;
+    }
+    if (m_FenceEvent)
+    {
+        CloseHandle(m_FenceEvent);
+        m_FenceEvent = nullptr;
+    }
+
+    m_Batches.clear();
+    m_Fence.Reset();
+    m_Resource.Reset();
+    m_Allocation.Reset();
+}
+
+bool UploadRing::TryAllocate(const u64 size, const u64 alignment, Allocation& out)
+{
+    IE_Assert(size > 0 && size <= m_Capacity);
+    IE_Assert(alignment > 0 && m_Capacity % alignment == 0);
+
+    Reclaim();
+
+    // An empty ring restarts at offset 0 so that a single allocation can use the whole buffer.
+    if (m_Head == m_Tail && m_Head % m_Capacity != 0)
+    {
+        m_Head = (m_Head / m_Capacity + 1) * m_Capacity;
+        m_Tail = m_Head;
+        m_SubmittedHead = m_Head;
+    }
+
+    u64 offset = (m_Head % m_Capacity + alignment - 1) / alignment * alignment;
+    u64 start = m_Head - m_Head % m_Capacity + offset;
+    if (offset + size > m_Capacity)
+    {
+        // Skip the tail end of the buffer; the padding is reclaimed with the batch like any allocation.
+        offset = 0;
+        start = (m_Head / m_Capacity + 1) * m_Capacity;
+    }
+
+    const u64 end = start + size;
+    if (end - m_Tail > m_Capacity)
+    {
+        return false;
+    }
+
+    m_Head = end;
+    out.resource = m_Resource.Get();
+    out.cpuAddress = m_Mapped + offset;
+    out.offset = offset;
+    out.size = size;
+    return true;
+}
+
+void UploadRing::Submit(ID3D12CommandQueue* queue)
+{
+    if (!HasPendingAllocations())
+    {
+        return;
+    }
+
+    const u64 fenceValue = m_NextFenceValue++;
+    IE_Check(queue->Signal(m_Fence.Get(), fenceValue));
+    m_Batches.push_back({fenceValue, m_Head});
+    m_SubmittedHead = m_Head;
+}
+
+bool UploadRing::WaitForOldestBatch()
+{
+    if (m_Batches.empty())
+    {
+        return false;
+    }
+
+    const u64 fenceValue = m_Batches.front().fenceValue;
+    if (m_Fence->GetCompletedValue() < fenceValue)
+    {
+        IE_Check(m_Fence->SetEventOnCompletion(fenceValue, m_FenceEvent));
+        WaitForSingleObject(m_FenceEvent, INFINITE);
+    }
+    Reclaim();
+    return true;
+}
+
+bool UploadRing::HasPendingAllocations() const
+{
+    return m_Head != m_SubmittedHead;
+}
+
+u64 UploadRing::GetCapacity() const
+{
+    return m_Capacity;
+}
+
+void UploadRing::Reclaim()
+{
+    const u64 completed = m_Fence->GetCompletedValue();
+    while (!m_Batches.empty() && m_Batches.front().fenceValue <= completed)
+    {
+        m_Tail = m_Batches.front().end;
+        m_Batches.pop_front();
+    }
+}
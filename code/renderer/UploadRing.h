@@ -0,0 +1,60 @@
+// Iskur Engine
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include <deque>
+
+#include "common/Types.h"
+
+// One persistently mapped upload buffer shared by every CPU to GPU copy. Allocations are carved linearly and grouped into
+// batches, one per queue submission; a batch is reclaimed once the fence value signaled after its submission completes.
+class UploadRing
+{
+  public:
+    struct Allocation
+    {
+        ID3D12Resource* resource = nullptr;
+        u8* cpuAddress = nullptr;
+        u64 offset = 0;
+        u64 size = 0;
+    };
+
+    void Init(D3D12MA::Allocator* allocator, ID3D12Device* device, u64 capacity);
+    void Terminate();
+
+    // Fails when the ring has no room left; the caller then waits for submitted batches or submits the current one.
+    bool TryAllocate(u64 size, u64 alignment, Allocation& out);
+    // Closes the current batch. Call right after ExecuteCommandLists with the queue that consumes the allocations.
+    void Submit(ID3D12CommandQueue* queue);
+    // Blocks until the oldest submitted batch is reclaimed. Returns false when there was nothing submitted to wait for.
+    bool WaitForOldestBatch();
+
+    bool HasPendingAllocations() const;
+    u64 GetCapacity() const;
+
+  private:
+    struct Batch
+    {
+        u64 fenceValue = 0;
+        u64 end = 0;
+    };
+
+    void Reclaim();
+
+    ComPtr<D3D12MA::Allocation> m_Allocation;
+    ComPtr<ID3D12Resource> m_Resource;
+    ComPtr<ID3D12Fence> m_Fence;
+    HANDLE m_FenceEvent = nullptr;
+    u8* m_Mapped = nullptr;
+
+    u64 m_Capacity = 0;
+    // Monotonic byte positions; the buffer offset of a position is position % capacity.
+    u64 m_Head = 0;
+    u64 m_Tail = 0;
+    u64 m_SubmittedHead = 0;
+    u64 m_NextFenceValue = 1;
+    std::deque<Batch> m_Batches;
+};
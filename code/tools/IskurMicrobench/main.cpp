@@ -0,0 +1,890 @@
+// Iskur Engine - Microbenchmarks
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+// Microbenchmarks for the CPU kernels that dominate packing and frame setup: vertex attribute packing, mesh optimization and
+// meshlet building as done by the scene packer, culling and draw list building, pack file loading, timing statistics, and the
+// render graph compile that places the post-processing textures.
+// Each case runs enough iterations to fill --min-time, repeats that --repetitions times (on Windows, on a thread pinned to
+// one core at high priority), and reports the median with its spread, so numbers can be compared across runs and machines in CI.
+// The packing and meshlet kernels only need the standard library, DirectXMath and meshoptimizer, so they also build on Linux
+// from this folder's CMakeLists.txt. The renderer kernels need the D3D12 headers and are only built by the engine's target,
+// which defines ISKUR_MICROBENCH_RENDERER. The render graph's correctness checks live in IskurRenderGraphTests.
+
+#include "common/StringUtils.h"
+#include "common/VertexPacking.h"
+#include "shaders/CPUGPU.h"
+
+#ifdef ISKUR_MICROBENCH_RENDERER
+#include "common/IskurPackFormat.h"
+#include "renderer/Culling.h"
+#include "renderer/PostProcessGraph.h"
+#include "renderer/RenderGraph.h"
+#include "renderer/SceneFileLoader.h"
+#include "renderer/Timings.h"
+#endif
+
+#include <DirectXMath.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <meshoptimizer.h>
+#include <print>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+using namespace DirectX;
+namespace fs = std::filesystem;
+
+struct MicrobenchOptions
+{
+    std::string filter;
+    fs::path jsonPath;
+    u32 repetitions = 5;
+    f64 minTimeSeconds = 0.25;
+};
+
+static MicrobenchOptions g_Options{};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Harness
+// ---------------------------------------------------------------------------------------------------------------------
+
+static const void* volatile g_Sink = nullptr;
+
+// Forces the value to be materialized, so the optimizer cannot drop the work that produced it.
+template <typename T> static void KeepAlive(const T& value)
+{
+    g_Sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+struct BenchState
+{
+    u32 arg = 0;
+
+    // Filled by the case before it calls Measure; per iteration.
+    u64 items = 0;
+    u64 bytes = 0;
+
+    // Filled by Measure.
+    u64 iterations = 0;
+    Vector<f64> repetitionNs{}; // mean ns per iteration of each repetition
+};
+
+using BenchFn = void (*)(BenchState&);
+
+struct BenchCase
+{
+    std::string name;
+    BenchFn fn = nullptr;
+    u32 arg = 0;
+};
+
+template <typename Kernel> static f64 TimeIterations(Kernel& kernel, const u64 iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < iterations; ++i)
+    {
+        kernel();
+    }
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Setup stays outside the kernel; a case calls this once, after building its inputs.
+template <typename Kernel> static void Measure(BenchState& state, Kernel&& kernel)
+{
+    // Warm caches and lazily grown containers before calibrating.
+    kernel();
+
+    u64 iterations = 1;
+    constexpr u64 kMaxIterations = 1ull << 30;
+    for (;;)
+    {
+        const f64 seconds = TimeIterations(kernel, iterations);
+        if (seconds >= g_Options.minTimeSeconds || iterations >= kMaxIterations)
+        {
+            break;
+        }
+        // Aim slightly past the minimum time, but never grow by more than 10x from a noisy short run.
+        const f64 scale = seconds > 0.0 ? (g_Options.minTimeSeconds * 1.4) / seconds : 10.0;
+        iterations = std::min(kMaxIterations, std::max(iterations + 1, static_cast<u64>(static_cast<f64>(iterations) * std::min(scale, 10.0))));
+    }
+
+    state.iterations = iterations;
+    state.repetitionNs.clear();
+    for (u32 r = 0; r < g_Options.repetitions; ++r)
+    {
+        state.repetitionNs.push_back(TimeIterations(kernel, iterations) * 1e9 / static_cast<f64>(iterations));
+    }
+}
+
+struct BenchResult
+{
+    std::string name;
+    u64 iterations = 0;
+    f64 medianNs = 0.0;
+    f64 minNs = 0.0;
+    f64 maxNs = 0.0;
+    f64 cv = 0.0; // coefficient of variation of the repetitions
+    f64 itemsPerSecond = 0.0;
+    f64 bytesPerSecond = 0.0;
+};
+
+static BenchResult Summarize(const BenchCase& bc, const BenchState& state)
+{
+    BenchResult r{};
+    r.name = bc.name;
+    r.iterations = state.iterations;
+
+    Vector<f64> ns = state.repetitionNs;
+    if (ns.empty())
+    {
+        return r;
+    }
+    std::sort(ns.begin(), ns.end());
+    const size_t n = ns.size();
+    r.medianNs = (n % 2) ? ns[n / 2] : 0.5 * (ns[n / 2 - 1] + ns[n / 2]);
+    r.minNs = ns.front();
+    r.maxNs = ns.back();
+
+    f64 mean = 0.0;
+    for (const f64 v : ns)
+    {
+        mean += v;
+    }
+    mean /= static_cast<f64>(n);
+    f64 variance = 0.0;
+    for (const f64 v : ns)
+    {
+        variance += (v - mean) * (v - mean);
+    }
+    variance /= static_cast<f64>(n);
+    r.cv = mean > 0.0 ? std::sqrt(variance) / mean : 0.0;
+
+    if (r.medianNs > 0.0)
+    {
+        r.itemsPerSecond = static_cast<f64>(state.items) * 1e9 / r.medianNs;
+        r.bytesPerSecond = static_cast<f64>(state.bytes) * 1e9 / r.medianNs;
+    }
+    return r;
+}
+
+static std::string FormatNs(const f64 ns)
+{
+    if (ns >= 1e6)
+        return std::format("{:.3f} ms", ns * 1e-6);
+    if (ns >= 1e3)
+        return std::format("{:.3f} us", ns * 1e-3);
+    return std::format("{:.1f} ns", ns);
+}
+
+static std::string FormatRate(const f64 perSecond, const char* unit)
+{
+    if (perSecond <= 0.0)
+        return "";
+    if (perSecond >= 1e9)
+        return std::format("{:.2f} G{}/s", perSecond * 1e-9, unit);
+    if (perSecond >= 1e6)
+        return std::format("{:.2f} M{}/s", perSecond * 1e-6, unit);
+    if (perSecond >= 1e3)
+        return std::format("{:.2f} k{}/s", perSecond * 1e-3, unit);
+    return std::format("{:.2f} {}/s", perSecond, unit);
+}
+
+static void PrintResult(const BenchResult& r)
+{
+    std::println("{:<40} {:>12} {:>12} {:>12} {:>6.1f}% {:>11} {:>14} {:>14}", r.name, FormatNs(r.medianNs), FormatNs(r.minNs), FormatNs(r.maxNs), r.cv * 100.0, r.iterations,
+                 FormatRate(r.itemsPerSecond, "items"), FormatRate(r.bytesPerSecond, "B"));
+}
+
+// Same layout as Google Benchmark's --benchmark_out_format=json, so existing comparison scripts can read it.
+static bool WriteResultsJson(const fs::path& path, const Vector<BenchResult>& results)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f)
+        return false;
+
+    f << "{\n  \"context\": {\n";
+    f << std::format("    \"executable\": \"IskurMicrobench\",\n    \"repetitions\": {},\n    \"min_time\": {:.3f}\n", g_Options.repetitions, g_Options.minTimeSeconds);
+    f << "  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& r = results[i];
+        f << std::format("    {{\"name\": \"{}\", \"run_type\": \"aggregate\", \"aggregate_name\": \"median\", \"iterations\": {}, \"real_time\": {:.3f}, "
+                         "\"min_time_ns\": {:.3f}, \"max_time_ns\": {:.3f}, \"cv\": {:.5f}, \"time_unit\": \"ns\", \"items_per_second\": {:.3f}, "
+                         "\"bytes_per_second\": {:.3f}}}{}\n",
+                         r.name, r.iterations, r.medianNs, r.minNs, r.maxNs, r.cv, r.itemsPerSecond, r.bytesPerSecond, i + 1 < results.size() ? "," : "");
+    }
+    f << "  ]\n}\n";
+    return f.good();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Synthetic inputs
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Rng
+{
+    u32 state = 0x9E3779B9u;
+
+    u32 NextU32()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    f32 NextF32() // [0, 1)
+    {
+        return static_cast<f32>(NextU32() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    f32 NextRange(const f32 lo, const f32 hi)
+    {
+        return lo + (hi - lo) * NextF32();
+    }
+};
+
+static XMFLOAT3 RandomUnitVector(Rng& rng)
+{
+    return NormalizeSafe(XMFLOAT3(rng.NextRange(-1.0f, 1.0f), rng.NextRange(-1.0f, 1.0f), rng.NextRange(-1.0f, 1.0f)));
+}
+
+struct SyntheticMesh
+{
+    Vector<Vertex> vertices;
+    Vector<u32> indices;
+};
+
+// A displaced grid with unshared corners and shuffled triangles, close to what a glTF primitive looks like before the packer
+// welds and reorders it.
+static SyntheticMesh MakeGridMesh(const u32 side)
+{
+    Rng rng{};
+    SyntheticMesh mesh{};
+    mesh.vertices.reserve(static_cast<size_t>(side) * side * 6);
+    mesh.indices.reserve(static_cast<size_t>(side) * side * 6);
+
+    auto addVertex = [&](const u32 x, const u32 y) {
+        Vertex v{};
+        const f32 fx = static_cast<f32>(x) / static_cast<f32>(side);
+        const f32 fy = static_cast<f32>(y) / static_cast<f32>(side);
+        v.position = XMFLOAT3(fx, 0.05f * std::sin(fx * 12.0f) * std::cos(fy * 9.0f), fy);
+        v.normalPacked = PackNormalOctSnorm16(XMFLOAT3(0.0f, 1.0f, 0.0f));
+        v.texCoordPacked = PackTexCoordHalf2(XMFLOAT2(fx, fy));
+        const PackedColorRGBA16Unorm color = PackColorRGBA16Unorm(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f));
+        v.colorPackedLo = color.lo;
+        v.colorPackedHi = color.hi;
+        v.tangentPacked = PackTangentR10G10B10A2(XMFLOAT3(1.0f, 0.0f, 0.0f), 1.0f);
+        mesh.indices.push_back(static_cast<u32>(mesh.vertices.size()));
+        mesh.vertices.push_back(v);
+    };
+
+    Vector<u32> quads(static_cast<size_t>(side) * side);
+    for (u32 i = 0; i < quads.size(); ++i)
+    {
+        quads[i] = i;
+    }
+    for (size_t i = quads.size(); i > 1; --i)
+    {
+        std::swap(quads[i - 1], quads[rng.NextU32() % i]);
+    }
+
+    for (const u32 q : quads)
+    {
+        const u32 x = q % side;
+        const u32 y = q / side;
+        addVertex(x, y);
+        addVertex(x, y + 1);
+        addVertex(x + 1, y);
+        addVertex(x + 1, y);
+        addVertex(x, y + 1);
+        addVertex(x + 1, y + 1);
+    }
+    return mesh;
+}
+
+// Welds and reorders the mesh with the packer's meshoptimizer sequence.
+static void OptimizeMesh(const SyntheticMesh& in, SyntheticMesh& out, Vector<u32>& remap)
+{
+    remap.resize(in.indices.size());
+    const size_t vertexCount = meshopt_generateVertexRemap(remap.data(), in.indices.data(), in.indices.size(), in.vertices.data(), in.vertices.size(), sizeof(Vertex));
+    out.indices.resize(in.indices.size());
+    meshopt_remapIndexBuffer(out.indices.data(), in.indices.data(), in.indices.size(), remap.data());
+    out.vertices.resize(vertexCount);
+    meshopt_remapVertexBuffer(out.vertices.data(), in.vertices.data(), in.vertices.size(), sizeof(Vertex), remap.data());
+    meshopt_optimizeVertexCache(out.indices.data(), out.indices.data(), out.indices.size(), out.vertices.size());
+    meshopt_optimizeOverdraw(out.indices.data(), out.indices.data(), out.indices.size(), &out.vertices[0].position.x, out.vertices.size(), sizeof(Vertex), 1.05f);
+    meshopt_optimizeVertexFetch(out.vertices.data(), out.indices.data(), out.indices.size(), out.vertices.data(), out.vertices.size(), sizeof(Vertex));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Vertex packing
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void Bench_PackNormalOctSnorm16(BenchState& state)
+{
+    Rng rng{};
+    Vector<XMFLOAT3> normals(state.arg);
+    for (XMFLOAT3& n : normals)
+    {
+        n = RandomUnitVector(rng);
+    }
+    Vector<u32> packed(state.arg);
+
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(XMFLOAT3);
+    Measure(state, [&] {
+        for (u32 i = 0; i < state.arg; ++i)
+        {
+            packed[i] = PackNormalOctSnorm16(normals[i]);
+        }
+        KeepAlive(packed);
+    });
+}
+
+static void Bench_UnpackNormalOctSnorm16(BenchState& state)
+{
+    Rng rng{};
+    Vector<u32> packed(state.arg);
+    for (u32& p : packed)
+    {
+        p = PackNormalOctSnorm16(RandomUnitVector(rng));
+    }
+    Vector<XMFLOAT3> normals(state.arg);
+
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(u32);
+    Measure(state, [&] {
+        for (u32 i = 0; i < state.arg; ++i)
+        {
+            normals[i] = UnpackNormalOctSnorm16(packed[i]);
+        }
+        KeepAlive(normals);
+    });
+}
+
+static void Bench_PackTexCoordHalf2(BenchState& state)
+{
+    Rng rng{};
+    Vector<XMFLOAT2> uvs(state.arg);
+    for (XMFLOAT2& uv : uvs)
+    {
+        uv = XMFLOAT2(rng.NextRange(-4.0f, 4.0f), rng.NextRange(-4.0f, 4.0f));
+    }
+    Vector<u32> packed(state.arg);
+
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(XMFLOAT2);
+    Measure(state, [&] {
+        for (u32 i = 0; i < state.arg; ++i)
+        {
+            packed[i] = PackTexCoordHalf2(uvs[i]);
+        }
+        KeepAlive(packed);
+    });
+}
+
+static void Bench_PackColorRGBA16Unorm(BenchState& state)
+{
+    Rng rng{};
+    Vector<XMFLOAT4> colors(state.arg);
+    for (XMFLOAT4& c : colors)
+    {
+        c = XMFLOAT4(rng.NextF32(), rng.NextF32(), rng.NextF32(), rng.NextF32());
+    }
+    Vector<PackedColorRGBA16Unorm> packed(state.arg);
+
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(XMFLOAT4);
+    Measure(state, [&] {
+        for (u32 i = 0; i < state.arg; ++i)
+        {
+            packed[i] = PackColorRGBA16Unorm(colors[i]);
+        }
+        KeepAlive(packed);
+    });
+}
+
+static void Bench_PackTangentR10G10B10A2(BenchState& state)
+{
+    Rng rng{};
+    Vector<XMFLOAT4> tangents(state.arg);
+    for (XMFLOAT4& t : tangents)
+    {
+        const XMFLOAT3 d = RandomUnitVector(rng);
+        t = XMFLOAT4(d.x, d.y, d.z, (rng.NextU32() & 1u) ? 1.0f : -1.0f);
+    }
+    Vector<u32> packed(state.arg);
+
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(XMFLOAT4);
+    Measure(state, [&] {
+        for (u32 i = 0; i < state.arg; ++i)
+        {
+            const XMFLOAT4& t = tangents[i];
+            packed[i] = PackTangentR10G10B10A2(XMFLOAT3(t.x, t.y, t.z), t.w);
+        }
+        KeepAlive(packed);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Mesh optimization and meshlets
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void Bench_MeshOptimize(BenchState& state)
+{
+    const SyntheticMesh input = MakeGridMesh(state.arg);
+    SyntheticMesh output{};
+    Vector<u32> remap;
+
+    state.items = input.indices.size() / 3;
+    state.bytes = input.vertices.size() * sizeof(Vertex) + input.indices.size() * sizeof(u32);
+    Measure(state, [&] {
+        OptimizeMesh(input, output, remap);
+        KeepAlive(output.indices);
+    });
+}
+
+static void Bench_MeshletBuild(BenchState& state)
+{
+    SyntheticMesh mesh{};
+    {
+        Vector<u32> remap;
+        OptimizeMesh(MakeGridMesh(state.arg), mesh, remap);
+    }
+
+    // Same limits as the packer.
+    constexpr size_t maxVertices = 64, maxTriangles = 126;
+    constexpr f32 coneWeight = 0.25f;
+    const size_t maxMeshlets = meshopt_buildMeshletsBound(mesh.indices.size(), maxVertices, maxTriangles);
+    Vector<meshopt_Meshlet> meshlets(maxMeshlets);
+    Vector<u32> mlVerts(maxMeshlets * maxVertices);
+    Vector<u8> mlTris(maxMeshlets * maxTriangles * 3);
+    Vector<meshopt_Bounds> bounds;
+    bounds.reserve(maxMeshlets);
+
+    state.items = mesh.indices.size() / 3;
+    state.bytes = mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(u32);
+    Measure(state, [&] {
+        const size_t meshletCount = meshopt_buildMeshlets(meshlets.data(), mlVerts.data(), mlTris.data(), mesh.indices.data(), mesh.indices.size(), &mesh.vertices[0].position.x,
+                                                          mesh.vertices.size(), sizeof(Vertex), maxVertices, maxTriangles, coneWeight);
+        bounds.clear();
+        for (size_t i = 0; i < meshletCount; ++i)
+        {
+            const meshopt_Meshlet& m = meshlets[i];
+            meshopt_optimizeMeshlet(&mlVerts[m.vertex_offset], &mlTris[m.triangle_offset], m.triangle_count, m.vertex_count);
+            bounds.push_back(
+                meshopt_computeMeshletBounds(&mlVerts[m.vertex_offset], &mlTris[m.triangle_offset], m.triangle_count, &mesh.vertices[0].position.x, mesh.vertices.size(), sizeof(Vertex)));
+        }
+        KeepAlive(bounds);
+    });
+}
+
+#ifdef ISKUR_MICROBENCH_RENDERER
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Culling and draw list build
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void Bench_CullingBuild(BenchState& state)
+{
+    constexpr u32 kPrimitiveCount = 256;
+    constexpr u32 kMaterialCount = 64;
+    Rng rng{};
+
+    // Only the bindless indices of the buffers are read while building draw groups.
+    const SharedPtr<Buffer> buffer = IE_MakeSharedPtr<Buffer>();
+    buffer->srvIndex = 0;
+
+    Vector<Primitive> primitives(kPrimitiveCount);
+    for (Primitive& prim : primitives)
+    {
+        prim.vertices = buffer;
+        prim.meshlets = buffer;
+        prim.mlVerts = buffer;
+        prim.mlTris = buffer;
+        prim.mlBounds = buffer;
+        prim.meshletCount = 1 + rng.NextU32() % 256;
+
+        const XMFLOAT3 extents(rng.NextRange(0.1f, 2.0f), rng.NextRange(0.1f, 2.0f), rng.NextRange(0.1f, 2.0f));
+        prim.localBoundsCenter = XMFLOAT3(0.0f, extents.y, 0.0f);
+        prim.localBoundsRadius = std::sqrt(extents.x * extents.x + extents.y * extents.y + extents.z * extents.z);
+        XMStoreFloat4x4(&prim.localBoxToObject, XMMatrixScaling(extents.x, extents.y, extents.z) * XMMatrixTranslation(0.0f, extents.y, 0.0f));
+    }
+
+    Vector<Material> materials(kMaterialCount);
+    for (u32 i = 0; i < kMaterialCount; ++i)
+    {
+        materials[i] = {};
+        materials[i].alphaMode = (i % 8 == 0) ? AlphaMode_Mask : (i % 16 == 1) ? AlphaMode_Blend : AlphaMode_Opaque;
+        materials[i].doubleSided = (i % 4 == 0) ? 1 : 0;
+    }
+
+    // Instances scattered on a square around the camera, which looks down +z from the middle, so about a quarter survive culling.
+    const f32 halfSize = 4.0f * std::sqrt(static_cast<f32>(state.arg));
+    Vector<InstanceData> instances(state.arg);
+    for (InstanceData& inst : instances)
+    {
+        inst.primIndex = rng.NextU32() % kPrimitiveCount;
+        inst.materialIndex = rng.NextU32() % kMaterialCount;
+        const XMMATRIX world = XMMatrixScaling(rng.NextRange(0.5f, 2.0f), rng.NextRange(0.5f, 2.0f), rng.NextRange(0.5f, 2.0f)) *
+                               XMMatrixRotationY(rng.NextRange(0.0f, XM_2PI)) *
+                               XMMatrixTranslation(rng.NextRange(-halfSize, halfSize), rng.NextRange(0.0f, 4.0f), rng.NextRange(-halfSize, halfSize));
+        XMStoreFloat4x4(&inst.world, world);
+    }
+
+    XMFLOAT4X4 view{};
+    XMStoreFloat4x4(&view, XMMatrixLookToRH(XMVectorSet(0.0f, 2.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+
+    CpuTimers cpuTimers{};
+    BuildParams params{};
+    params.primitives = &primitives;
+    params.materials = &materials;
+    params.instances = &instances;
+    params.view = &view;
+    params.nearPlane = 0.1f;
+    params.frustumCullFovDeg = 60.0f;
+    params.aspectRatio = 16.0f / 9.0f;
+    params.cpuFrustumCullingEnabled = true;
+    params.drawSortMode = DrawSortMode_FrontToBack;
+    params.cpuTimers = &cpuTimers;
+
+    Culling culling;
+    state.items = state.arg;
+    state.bytes = state.arg * sizeof(InstanceData);
+    Measure(state, [&] {
+        cpuTimers.passCount = 0;
+        culling.Build(params);
+        KeepAlive(culling.GetDrawInstances());
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Pack loading
+// ---------------------------------------------------------------------------------------------------------------------
+
+// Writes a pack with the chunks LoadSceneFile requires, holding primCount primitives of the given mesh. Texture data is left
+// out: its chunk is a single copy, already covered by the geometry chunks.
+static bool WriteSyntheticPack(const fs::path& path, const u32 primCount, const SyntheticMesh& mesh)
+{
+    using namespace IEPack;
+
+    Vector<u8> bytes(sizeof(PackHeader));
+    Vector<ChunkRecord> chunks;
+    auto addChunk = [&](const u32 id, const void* data, const u64 size) {
+        chunks.push_back({id, bytes.size(), size});
+        const u8* src = static_cast<const u8*>(data);
+        bytes.insert(bytes.end(), src, src + size);
+        bytes.resize((bytes.size() + 15) & ~size_t{15});
+    };
+
+    const u64 vertexBytes = mesh.vertices.size() * sizeof(Vertex);
+    const u64 indexBytes = mesh.indices.size() * sizeof(u32);
+
+    Vector<PrimRecord> prims(primCount);
+    Vector<u8> vertexBlob;
+    Vector<u8> indexBlob;
+    vertexBlob.reserve(vertexBytes * primCount);
+    indexBlob.reserve(indexBytes * primCount);
+    for (u32 i = 0; i < primCount; ++i)
+    {
+        PrimRecord& prim = prims[i];
+        prim.primIndex = i;
+        prim.vertexCount = static_cast<u32>(mesh.vertices.size());
+        prim.indexCount = static_cast<u32>(mesh.indices.size());
+        prim.vertexByteOffset = vertexBlob.size();
+        prim.indexByteOffset = indexBlob.size();
+        prim.localBoundsRadius = 1.0f;
+        prim.localBoxHalfExtents[0] = prim.localBoxHalfExtents[1] = prim.localBoxHalfExtents[2] = 1.0f;
+        prim.localBoxRotation[3] = 1.0f;
+
+        const u8* vertexSrc = reinterpret_cast<const u8*>(mesh.vertices.data());
+        const u8* indexSrc = reinterpret_cast<const u8*>(mesh.indices.data());
+        vertexBlob.insert(vertexBlob.end(), vertexSrc, vertexSrc + vertexBytes);
+        indexBlob.insert(indexBlob.end(), indexSrc, indexSrc + indexBytes);
+    }
+
+    Vector<MaterialRecord> materials(1);
+    Vector<InstanceRecord> instances(primCount);
+    for (u32 i = 0; i < primCount; ++i)
+    {
+        instances[i].primIndex = i;
+        instances[i].materialIndex = 0;
+        XMFLOAT4X4 world{};
+        XMStoreFloat4x4(&world, XMMatrixTranslation(static_cast<f32>(i), 0.0f, 0.0f));
+        std::memcpy(instances[i].world, &world, sizeof(instances[i].world));
+    }
+
+    addChunk(CH_PRIM, prims.data(), prims.size() * sizeof(PrimRecord));
+    addChunk(CH_VERT, vertexBlob.data(), vertexBlob.size());
+    addChunk(CH_INDX, indexBlob.data(), indexBlob.size());
+    addChunk(CH_MSHL, nullptr, 0);
+    addChunk(CH_MLVT, nullptr, 0);
+    addChunk(CH_MLTR, nullptr, 0);
+    addChunk(CH_MLBD, nullptr, 0);
+    addChunk(CH_OMIX, nullptr, 0);
+    addChunk(CH_OMDS, nullptr, 0);
+    addChunk(CH_OMDT, nullptr, 0);
+    addChunk(CH_MATL, materials.data(), materials.size() * sizeof(MaterialRecord));
+    addChunk(CH_INST, instances.data(), instances.size() * sizeof(InstanceRecord));
+
+    PackHeader header{};
+    std::memcpy(header.magic, "ISKURPACK", sizeof(header.magic));
+    header.version = PACK_VERSION_LATEST;
+    header.primCount = primCount;
+    header.chunkCount = static_cast<u32>(chunks.size());
+    header.chunkTableOffset = bytes.size();
+    header.primTableOffset = chunks[0].offset;
+    header.verticesOffset = chunks[1].offset;
+    header.indicesOffset = chunks[2].offset;
+    const u8* chunkSrc = reinterpret_cast<const u8*>(chunks.data());
+    bytes.insert(bytes.end(), chunkSrc, chunkSrc + chunks.size() * sizeof(ChunkRecord));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return f.good();
+}
+
+// The file is read back from the OS cache, so this measures parsing and copying rather than the disk.
+static void Bench_LoadSceneFile(BenchState& state)
+{
+    const fs::path path = fs::temp_directory_path() / std::format("IskurMicrobench_{}.ikp", state.arg);
+    if (!WriteSyntheticPack(path, state.arg, MakeGridMesh(16)))
+    {
+        std::println("Error: Could not write {}", path.string());
+        std::exit(EXIT_FAILURE);
+    }
+
+    state.items = state.arg;
+    state.bytes = fs::file_size(path);
+    Measure(state, [&] {
+        const SceneFileData data = LoadSceneFile(path);
+        KeepAlive(data.prims);
+    });
+
+    std::error_code ec;
+    fs::remove(path, ec);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Timings
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void Bench_TimingsUpdateAverages(BenchState& state)
+{
+    // Smoothers keep the name pointers, so the names must outlive the state.
+    Vector<std::string> names(state.arg);
+    for (u32 i = 0; i < state.arg; ++i)
+    {
+        names[i] = std::format("Pass {}", i);
+    }
+
+    const UniquePtr<TimingState> timings = IE_MakeUniquePtr<TimingState>();
+    timings->lastCount = std::min(state.arg, TimingState::kMaxTimings);
+    for (u32 i = 0; i < timings->lastCount; ++i)
+    {
+        timings->last[i] = {names[i].c_str(), 0.0, 0};
+    }
+
+    // Noisy frame times keep the histogram and the running max busy; a one second window at 60 Hz holds about 60 samples.
+    Rng rng{};
+    state.items = timings->lastCount;
+    Measure(state, [&] {
+        for (u32 i = 0; i < timings->lastCount; ++i)
+        {
+            timings->last[i].ms = 0.05 + 2.0 * rng.NextF32();
+        }
+        Timings_UpdateAverages(*timings, 16.6f, 1000.0f);
+        KeepAlive(*timings);
+    });
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Render graph
+// ---------------------------------------------------------------------------------------------------------------------
+
+// arg is the present height at 16:9, rendered at the DLSS Quality scale. The sizes printed are EstimatePostProcessAllocationInfo's,
+// not a driver's (the renderer logs those at startup). They split the saving over one committed copy per frame in flight into
+// what a single copy saves and what aliasing saves on top: at 4K, 162.0 MiB of textures fit in 155.3 MiB of heaps against
+// 486.0 MiB for three committed copies.
+static void Bench_RenderGraphCompile(BenchState& state)
+{
+    const XMUINT2 presentSize(state.arg * 16u / 9u, state.arg);
+    const XMUINT2 renderSize(presentSize.x * 2u / 3u, presentSize.y * 2u / 3u);
+
+    {
+        RenderGraph graph;
+        PostProcessGraph postGraph{};
+        DeclarePostProcessGraph(graph, renderSize, presentSize, postGraph);
+        graph.Compile(EstimatePostProcessAllocationInfo);
+
+        const RenderGraph::Stats stats = graph.GetStats();
+        constexpr f64 kMiB = 1024.0 * 1024.0;
+        const u64 perFrameBytes = stats.textureBytes * IE_Constants::frameInFlightCount;
+        std::println("RenderGraph {}x{}: {} textures, {} passes, {} barriers", presentSize.x, presentSize.y, stats.textureCount, stats.passCount, stats.barrierCount);
+        std::println("  Estimated: {:.1f} MiB of textures in {:.1f} MiB of heaps, against {:.1f} MiB for {} committed copies", static_cast<f64>(stats.textureBytes) / kMiB,
+                     static_cast<f64>(stats.heapBytes) / kMiB, static_cast<f64>(perFrameBytes) / kMiB, IE_Constants::frameInFlightCount);
+        std::println("  Saved: {:.1f} MiB by one copy instead of one per frame in flight, {:.1f} MiB by aliasing", static_cast<f64>(perFrameBytes - stats.textureBytes) / kMiB,
+                     static_cast<f64>(stats.textureBytes - stats.heapBytes) / kMiB);
+        state.items = stats.textureCount;
+    }
+
+    RenderGraph graph;
+    PostProcessGraph postGraph{};
+    Measure(state, [&] {
+        graph.Reset();
+        DeclarePostProcessGraph(graph, renderSize, presentSize, postGraph);
+        graph.Compile(EstimatePostProcessAllocationInfo);
+        KeepAlive(graph);
+    });
+}
+
+#endif // ISKUR_MICROBENCH_RENDERER
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Registry and entry point
+// ---------------------------------------------------------------------------------------------------------------------
+
+static Vector<BenchCase> BuildCases()
+{
+    Vector<BenchCase> cases;
+    auto add = [&](const char* name, const BenchFn fn, std::initializer_list<u32> args) {
+        for (const u32 arg : args)
+        {
+            cases.push_back({std::format("{}/{}", name, arg), fn, arg});
+        }
+    };
+
+    add("VertexPacking/PackNormalOctSnorm16", Bench_PackNormalOctSnorm16, {4096});
+    add("VertexPacking/UnpackNormalOctSnorm16", Bench_UnpackNormalOctSnorm16, {4096});
+    add("VertexPacking/PackTexCoordHalf2", Bench_PackTexCoordHalf2, {4096});
+    add("VertexPacking/PackColorRGBA16Unorm", Bench_PackColorRGBA16Unorm, {4096});
+    add("VertexPacking/PackTangentR10G10B10A2", Bench_PackTangentR10G10B10A2, {4096});
+    add("Mesh/Optimize", Bench_MeshOptimize, {32, 128});   // grid side, 2 * side^2 triangles
+    add("Mesh/BuildMeshlets", Bench_MeshletBuild, {32, 128}); // grid side, 2 * side^2 triangles
+#ifdef ISKUR_MICROBENCH_RENDERER
+    add("Culling/Build", Bench_CullingBuild, {1000, 10000, 100000});
+    add("Scene/LoadSceneFile", Bench_LoadSceneFile, {16, 256});
+    add("Timings/UpdateAverages", Bench_TimingsUpdateAverages, {16, 64});
+    add("RenderGraph/Compile", Bench_RenderGraphCompile, {1080, 2160}); // present height
+#endif
+    return cases;
+}
+
+static void PrintUsage()
+{
+    std::println("IskurMicrobench\nUsage:\n  IskurMicrobench [--filter <substring>] [--json <file.json>] [--repetitions <n>] [--min-time <seconds>] [--list]");
+}
+
+static u32 ParseU32(const char* text, const char* what)
+{
+    char* end = nullptr;
+    const unsigned long v = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || v == 0 || v > UINT32_MAX)
+    {
+        std::println("Error: Invalid value '{}' for {}", text, what);
+        std::exit(EXIT_FAILURE);
+    }
+    return static_cast<u32>(v);
+}
+
+static f64 ParsePositiveF64(const char* text, const char* what)
+{
+    char* end = nullptr;
+    const f64 v = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !(v > 0.0))
+    {
+        std::println("Error: Invalid value '{}' for {}", text, what);
+        std::exit(EXIT_FAILURE);
+    }
+    return v;
+}
+
+int main(int argc, char** argv)
+{
+    bool listOnly = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = ToLowerAscii(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if (a == "--filter" && hasValue)
+            g_Options.filter = argv[++i];
+        else if (a == "--json" && hasValue)
+            g_Options.jsonPath = argv[++i];
+        else if (a == "--repetitions" && hasValue)
+            g_Options.repetitions = ParseU32(argv[++i], "--repetitions");
+        else if (a == "--min-time" && hasValue)
+            g_Options.minTimeSeconds = ParsePositiveF64(argv[++i], "--min-time");
+        else if (a == "--list")
+            listOnly = true;
+        else
+        {
+            PrintUsage();
+            std::println("Error: Unknown command-line argument '{}'", a);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+
+    Vector<BenchCase> cases = BuildCases();
+    if (!g_Options.filter.empty())
+    {
+        std::erase_if(cases, [](const BenchCase& bc) { return bc.name.find(g_Options.filter) == std::string::npos; });
+    }
+    if (listOnly)
+    {
+        for (const BenchCase& bc : cases)
+        {
+            std::println("{}", bc.name);
+        }
+        return EXIT_SUCCESS;
+    }
+
+#ifdef _WIN32
+    // One core and a raised priority keep migrations and preemption out of the numbers.
+    SetThreadAffinityMask(GetCurrentThread(), 1);
+    SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+#endif
+
+    std::println("{} cases, {} repetitions of at least {:.2f} s each", cases.size(), g_Options.repetitions, g_Options.minTimeSeconds);
+    std::println("{:<40} {:>12} {:>12} {:>12} {:>7} {:>11} {:>14} {:>14}", "Case", "Median", "Min", "Max", "CV", "Iterations", "Items", "Bytes");
+
+    Vector<BenchResult> results;
+    results.reserve(cases.size());
+    for (const BenchCase& bc : cases)
+    {
+        BenchState state{};
+        state.arg = bc.arg;
+        bc.fn(state);
+        results.push_back(Summarize(bc, state));
+        PrintResult(results.back());
+    }
+
+    if (!g_Options.jsonPath.empty())
+    {
+        if (!WriteResultsJson(g_Options.jsonPath, results))
+        {
+            std::println("Error: Could not write {}", g_Options.jsonPath.string());
+            return EXIT_FAILURE;
+        }
+        std::println("Results written to {}", g_Options.jsonPath.string());
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,259 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "PackReader.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace IEPack;
+using namespace TracerPack;
+
+namespace
+{
+bool MagicOk(const char magic[9])
+{
+    constexpr char mk[9] = {'I', 'S', 'K', 'U', 'R', 'P', 'A', 'C', 'K'};
+    return std::memcmp(magic, mk, 9) == 0;
+}
+
+bool IsSubrangeValid(u64 offset, u64 size, u64 totalSize)
+{
+    return offset <= totalSize && size <= (totalSize - offset);
+}
+
+bool IsPackFile(const fs::path& p)
+{
+    return EqualsIgnoreCaseAscii(p.extension().string(), PACK_FILE_EXTENSION);
+}
+
+std::string SceneStemFromArg(const std::string& sceneArg)
+{
+    const std::string lower = ToLowerAscii(sceneArg);
+    if (lower.ends_with(".glb") || lower.ends_with(PACK_FILE_EXTENSION))
+        return sceneArg.substr(0, sceneArg.size() - 4);
+    return sceneArg;
+}
+
+bool TryReadPackVersion(const fs::path& packPath, u32& outVersion)
+{
+    outVersion = 0;
+    std::ifstream file(packPath, std::ios::binary);
+    PackHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !MagicOk(header.magic))
+        return false;
+    outVersion = header.version;
+    return true;
+}
+
+template <typename T> Vector<T> CopyChunkArray(const ChunkRecord* chunk, const Vector<u8>& bytes, const char* what)
+{
+    Vector<T> out;
+    if (!chunk)
+        return out;
+    if (chunk->size % sizeof(T) != 0)
+    {
+        std::println("Error: Malformed {} chunk", what);
+        std::exit(EXIT_FAILURE);
+    }
+    out.resize(static_cast<size_t>(chunk->size / sizeof(T)));
+    if (!out.empty())
+        std::memcpy(out.data(), bytes.data() + chunk->offset, static_cast<size_t>(chunk->size));
+    return out;
+}
+
+i32 MapTexture(i32 textureIndex, size_t textureCount)
+{
+    if (textureIndex < 0)
+        return -1;
+    Require(static_cast<size_t>(textureIndex) < textureCount, "Material references a missing texture");
+    return textureIndex;
+}
+
+i32 MapSampler(u32 samplerIndex, i32 textureIndex, size_t samplerCount)
+{
+    if (textureIndex < 0 || samplerIndex == UINT32_MAX)
+        return -1;
+    Require(samplerIndex < samplerCount, "Material references a missing sampler");
+    return static_cast<i32>(samplerIndex);
+}
+
+PackMaterial MakeMaterial(const MaterialRecord& mr, size_t textureCount, size_t samplerCount)
+{
+    PackMaterial m{};
+    m.baseColorFactor = {mr.baseColorFactor[0], mr.baseColorFactor[1], mr.baseColorFactor[2], mr.baseColorFactor[3]};
+    m.emissiveFactor = {mr.emissiveFactor[0], mr.emissiveFactor[1], mr.emissiveFactor[2]};
+    m.metallicFactor = mr.metallicFactor;
+    m.roughnessFactor = mr.roughnessFactor;
+    m.normalScale = mr.normalScale;
+    m.alphaCutoff = mr.alphaCutoff;
+    m.alphaMasked = (mr.flags & (MATF_ALPHA_MASK | MATF_ALPHA_BLEND)) != 0;
+    m.doubleSided = (mr.flags & MATF_DOUBLE_SIDED) != 0;
+
+    m.baseColorTextureIndex = MapTexture(mr.baseColorTx, textureCount);
+    m.baseColorSamplerIndex = MapSampler(mr.baseColorSampler, mr.baseColorTx, samplerCount);
+    m.metallicRoughnessTextureIndex = MapTexture(mr.metallicRoughTx, textureCount);
+    m.metallicRoughnessSamplerIndex = MapSampler(mr.metallicRoughSampler, mr.metallicRoughTx, samplerCount);
+    m.normalTextureIndex = MapTexture(mr.normalTx, textureCount);
+    m.normalSamplerIndex = MapSampler(mr.normalSampler, mr.normalTx, samplerCount);
+    m.emissiveTextureIndex = MapTexture(mr.emissiveTx, textureCount);
+    m.emissiveSamplerIndex = MapSampler(mr.emissiveSampler, mr.emissiveTx, samplerCount);
+    return m;
+}
+} // namespace
+
+Vector<PackSceneEntry> EnumeratePackScenes()
+{
+    const fs::path baseDir = fs::path("data") / "scenes";
+    Vector<PackSceneEntry> scenes;
+    if (!fs::is_directory(baseDir))
+        return scenes;
+
+    for (const fs::directory_entry& de : fs::directory_iterator(baseDir))
+    {
+        if (!de.is_regular_file() || !IsPackFile(de.path()))
+            continue;
+
+        PackSceneEntry scene{};
+        scene.name = de.path().stem().string();
+        scene.path = de.path();
+        if (!TryReadPackVersion(de.path(), scene.packVersion))
+            continue;
+        scene.outOfDate = scene.packVersion != PACK_VERSION_LATEST;
+        scenes.push_back(std::move(scene));
+    }
+
+    std::sort(scenes.begin(), scenes.end(), [](const PackSceneEntry& a, const PackSceneEntry& b) { return ToLowerAscii(a.name) < ToLowerAscii(b.name); });
+    return scenes;
+}
+
+const PackSceneEntry* FindPackScene(const std::string& sceneArg, const Vector<PackSceneEntry>& scenes)
+{
+    const std::string stem = SceneStemFromArg(sceneArg);
+    for (const PackSceneEntry& scene : scenes)
+    {
+        if (EqualsIgnoreCaseAscii(scene.name, stem))
+            return &scene;
+    }
+    return nullptr;
+}
+
+PackScene LoadPackScene(const fs::path& packPath)
+{
+    PackScene scene{};
+    {
+        std::ifstream file(packPath, std::ios::binary | std::ios::ate);
+        Require(file.is_open(), "Failed to open scene pack");
+        const std::streamoff size = file.tellg();
+        Require(size > 0, "Scene pack is empty");
+        scene.fileBytes.resize(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+        Require(static_cast<bool>(file.read(reinterpret_cast<char*>(scene.fileBytes.data()), size)), "Failed to read scene pack");
+    }
+
+    const Vector<u8>& bytes = scene.fileBytes;
+    const u64 blobSize = bytes.size();
+    Require(blobSize >= sizeof(PackHeader), "Scene pack is truncated");
+
+    PackHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    Require(MagicOk(header.magic), "Not a scene pack");
+    Require(header.version == PACK_VERSION_LATEST, "Scene pack is out of date; re-run IskurScenePacker");
+    Require(header.chunkTableOffset <= blobSize && header.chunkCount <= (blobSize - header.chunkTableOffset) / sizeof(ChunkRecord), "Scene pack chunk table is out of range");
+
+    Vector<ChunkRecord> chunks(header.chunkCount);
+    if (!chunks.empty())
+        std::memcpy(chunks.data(), bytes.data() + header.chunkTableOffset, chunks.size() * sizeof(ChunkRecord));
+    for (const ChunkRecord& chunk : chunks)
+        Require(IsSubrangeValid(chunk.offset, chunk.size, blobSize), "Scene pack chunk is out of range");
+
+    auto findChunk = [&](u32 id) -> const ChunkRecord* {
+        for (const ChunkRecord& chunk : chunks)
+            if (chunk.id == id)
+                return &chunk;
+        return nullptr;
+    };
+    const ChunkRecord* cPRIM = findChunk(CH_PRIM);
+    const ChunkRecord* cVERT = findChunk(CH_VERT);
+    const ChunkRecord* cINDX = findChunk(CH_INDX);
+    const ChunkRecord* cTXHD = findChunk(CH_TXHD);
+    const ChunkRecord* cTXSR = findChunk(CH_TXSR);
+    const ChunkRecord* cTXTB = findChunk(CH_TXTB);
+    Require(cPRIM && cVERT && cINDX, "Scene pack is missing geometry chunks");
+    Require(header.primCount <= cPRIM->size / sizeof(PrimRecord), "Scene pack primitive table is out of range");
+
+    // Textures.
+    Vector<TextureRecord> texTable;
+    if (cTXHD && cTXTB)
+    {
+        Require(cTXSR != nullptr, "Scene pack is missing the texture subresource chunk");
+        texTable = CopyChunkArray<TextureRecord>(cTXHD, bytes, "TXHD");
+        scene.subresources = CopyChunkArray<TextureSubresourceRecord>(cTXSR, bytes, "TXSR");
+    }
+    scene.textures.resize(texTable.size());
+    for (size_t i = 0; i < texTable.size(); ++i)
+    {
+        const TextureRecord& tr = texTable[i];
+        Require(IsSubrangeValid(tr.byteOffset, tr.byteSize, cTXTB->size), "Texture bytes are out of range");
+        Require(static_cast<size_t>(tr.subresourceOffset) + tr.subresourceCount <= scene.subresources.size(), "Texture subresources are out of range");
+
+        PackTexture& texture = scene.textures[i];
+        texture.format = tr.format;
+        texture.dimension = tr.dimension;
+        texture.width = tr.width;
+        texture.height = tr.height;
+        texture.mip0 = tr.subresourceCount ? &scene.subresources[tr.subresourceOffset] : nullptr;
+        texture.texelBytes = bytes.data() + cTXTB->offset + tr.byteOffset;
+        texture.texelByteCount = static_cast<size_t>(tr.byteSize);
+    }
+
+    scene.samplers = CopyChunkArray<SamplerRecord>(findChunk(CH_SAMP), bytes, "SAMP");
+
+    // Materials, with the single fallback material SceneLoader uses for packs without any.
+    const Vector<MaterialRecord> matTable = CopyChunkArray<MaterialRecord>(findChunk(CH_MATL), bytes, "MATL");
+    for (const MaterialRecord& mr : matTable)
+        scene.materials.push_back(MakeMaterial(mr, scene.textures.size(), scene.samplers.size()));
+    if (scene.materials.empty())
+        scene.materials.emplace_back();
+
+    // Primitives point straight into the vertex and index chunks.
+    Vector<PrimRecord> prims(header.primCount);
+    if (!prims.empty())
+        std::memcpy(prims.data(), bytes.data() + cPRIM->offset, prims.size() * sizeof(PrimRecord));
+    scene.primitives.reserve(prims.size());
+    for (const PrimRecord& r : prims)
+    {
+        Require(r.indexCount % 3 == 0, "Primitive index count is not a multiple of 3");
+        Require(r.vertexByteOffset <= cVERT->size && r.vertexCount <= (cVERT->size - r.vertexByteOffset) / sizeof(Vertex), "Primitive vertices are out of range");
+        Require(r.indexByteOffset <= cINDX->size && r.indexCount <= (cINDX->size - r.indexByteOffset) / sizeof(u32), "Primitive indices are out of range");
+
+        PackPrimitive prim{};
+        prim.vertices = reinterpret_cast<const Vertex*>(bytes.data() + cVERT->offset + r.vertexByteOffset);
+        prim.vertexCount = r.vertexCount;
+        prim.indices = reinterpret_cast<const u32*>(bytes.data() + cINDX->offset + r.indexByteOffset);
+        prim.indexCount = r.indexCount;
+        for (u32 i = 0; i < prim.indexCount; ++i)
+            Require(prim.indices[i] < prim.vertexCount, "Primitive index is out of range");
+        scene.primitives.push_back(prim);
+    }
+
+    const Vector<InstanceRecord> instances = CopyChunkArray<InstanceRecord>(findChunk(CH_INST), bytes, "INST");
+    scene.instances.reserve(instances.size());
+    for (const InstanceRecord& ir : instances)
+    {
+        Require(ir.primIndex < scene.primitives.size(), "Instance references a missing primitive");
+        Require(ir.materialIndex < scene.materials.size(), "Instance references a missing material");
+
+        PackInstance inst{};
+        inst.primIndex = ir.primIndex;
+        inst.materialIndex = ir.materialIndex;
+        std::memcpy(inst.world.m, ir.world, sizeof(inst.world.m));
+        for (u32 i = 0; i < 16; ++i)
+            Require(std::isfinite((&inst.world.m[0][0])[i]), "Instance transform is not finite");
+        scene.instances.push_back(inst);
+    }
+    return scene;
+}
@@ -0,0 +1,144 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "TracerMath.h"
+#include "common/IskurPackFormat.h"
+
+#include <filesystem>
+
+// Reads .ikp scene packs without the engine. The pack records come from common/IskurPackFormat.h; the records below mirror
+// D3D12 and shaders/CPUGPU.h types byte for byte, and loading follows SceneFileLoader and SceneLoader.
+namespace TracerPack
+{
+// D3D12_SAMPLER_DESC, as stored in the SAMP chunk.
+struct SamplerRecord
+{
+    u32 filter;
+    u32 addressU;
+    u32 addressV;
+    u32 addressW;
+    f32 mipLodBias;
+    u32 maxAnisotropy;
+    u32 comparisonFunc;
+    f32 borderColor[4];
+    f32 minLod;
+    f32 maxLod;
+};
+static_assert(sizeof(SamplerRecord) == 52);
+
+// shaders/CPUGPU.h Vertex.
+struct Vertex
+{
+    f32 position[3];
+    u32 normalPacked;
+    u32 texCoordPacked;
+    u32 colorPackedLo;
+    u32 colorPackedHi;
+    u32 tangentPacked;
+};
+static_assert(sizeof(Vertex) == 32);
+
+// D3D12_TEXTURE_ADDRESS_MODE values.
+enum AddressMode : u32
+{
+    AddressMode_Wrap = 1,
+    AddressMode_Mirror = 2,
+    AddressMode_Clamp = 3,
+    AddressMode_Border = 4,
+    AddressMode_MirrorOnce = 5,
+};
+
+inline constexpr u32 kTexDimensionTexture2D = 3; // DirectX::TEX_DIMENSION_TEXTURE2D
+inline constexpr u32 kFilterMinMagMipLinear = 0x15;
+
+// D3D12_DECODE_MAG_FILTER(filter) == D3D12_FILTER_TYPE_POINT.
+inline bool IsMagFilterPoint(u32 filter)
+{
+    return ((filter >> 2) & 3u) == 0;
+}
+} // namespace TracerPack
+
+struct PackTexture
+{
+    u32 format = 0;
+    u32 dimension = 0;
+    u32 width = 0;
+    u32 height = 0;
+    const IEPack::TextureSubresourceRecord* mip0 = nullptr; // null when the texture has no subresources
+    const u8* texelBytes = nullptr;
+    size_t texelByteCount = 0;
+};
+
+// LoadedMaterial, reduced to what the path tracer reads.
+struct PackMaterial
+{
+    Float4 baseColorFactor = {1.0f, 1.0f, 1.0f, 1.0f};
+    Float3 emissiveFactor = {0.0f, 0.0f, 0.0f};
+    f32 metallicFactor = 0.0f;
+    f32 roughnessFactor = 1.0f;
+    f32 normalScale = 1.0f;
+    f32 alphaCutoff = 0.5f;
+    bool alphaMasked = false; // blended materials are treated as masked, like SceneLoader
+    bool doubleSided = false;
+
+    i32 baseColorTextureIndex = -1;
+    i32 baseColorSamplerIndex = -1;
+    i32 metallicRoughnessTextureIndex = -1;
+    i32 metallicRoughnessSamplerIndex = -1;
+    i32 normalTextureIndex = -1;
+    i32 normalSamplerIndex = -1;
+    i32 emissiveTextureIndex = -1;
+    i32 emissiveSamplerIndex = -1;
+};
+
+struct PackPrimitive
+{
+    const TracerPack::Vertex* vertices = nullptr;
+    u32 vertexCount = 0;
+    const u32* indices = nullptr;
+    u32 indexCount = 0;
+};
+
+struct PackInstance
+{
+    u32 primIndex = 0;
+    u32 materialIndex = 0;
+    Float4x4 world;
+};
+
+struct PackScene
+{
+    PackScene() = default;
+    PackScene(const PackScene&) = delete;
+    PackScene& operator=(const PackScene&) = delete;
+    PackScene(PackScene&&) noexcept = default;
+    PackScene& operator=(PackScene&&) noexcept = default;
+
+    // Owns the pack bytes backing the texture and primitive views below.
+    Vector<u8> fileBytes;
+    Vector<IEPack::TextureSubresourceRecord> subresources;
+    Vector<PackTexture> textures;
+    Vector<TracerPack::SamplerRecord> samplers;
+    Vector<PackMaterial> materials;
+    Vector<PackPrimitive> primitives;
+    Vector<PackInstance> instances;
+};
+
+struct PackSceneEntry
+{
+    std::string name;
+    std::filesystem::path path;
+    u32 packVersion = 0;
+    bool outOfDate = false;
+};
+
+// Same lookup as SceneUtils: packs live in data/scenes and names match case-insensitively, with or without extension.
+Vector<PackSceneEntry> EnumeratePackScenes();
+const PackSceneEntry* FindPackScene(const std::string& sceneArg, const Vector<PackSceneEntry>& scenes);
+
+// Validates the pack like LoadSceneFile and exits with an error when it is malformed.
+PackScene LoadPackScene(const std::filesystem::path& packPath);
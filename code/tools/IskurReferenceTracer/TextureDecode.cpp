@@ -0,0 +1,324 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#include "TextureDecode.h"
+
+#include <cstring>
+
+namespace
+{
+// Partition and anchor tables of the BC7 specification (same data as DirectXTex's g_aPartitionTable and g_aFixUp),
+// packed to two bits of subset index per texel.
+constexpr u32 kPartitions2[64] = {
+    0x50505050, 0x40404040, 0x54545454, 0x54505040, 0x50404000, 0x55545450, 0x55545040, 0x54504000,
+    0x50400000, 0x55555450, 0x55544000, 0x54400000, 0x55555440, 0x55550000, 0x55555500, 0x55000000,
+    0x55150100, 0x00004054, 0x15010000, 0x00405054, 0x00004050, 0x15050100, 0x05010000, 0x40505054,
+    0x00404050, 0x05010100, 0x14141414, 0x05141450, 0x01155440, 0x00555500, 0x15014054, 0x05414150,
+    0x44444444, 0x55005500, 0x11441144, 0x05055050, 0x05500550, 0x11114444, 0x41144114, 0x44111144,
+    0x15055054, 0x01055040, 0x05041050, 0x05455150, 0x14414114, 0x50050550, 0x41411414, 0x00141400,
+    0x00041504, 0x00105410, 0x10541000, 0x04150400, 0x50410514, 0x41051450, 0x05415014, 0x14054150,
+    0x41050514, 0x41505014, 0x40011554, 0x54150140, 0x50505500, 0x00555050, 0x15151010, 0x54540404,
+};
+
+constexpr u32 kPartitions3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// Anchor texel of subset 1 for two subsets, and of subsets 1 and 2 for three; subset 0 is always anchored at texel 0.
+constexpr u8 kAnchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15, 2,  8,  2,  2,  8,  8,  15, 2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,  2,  15, 15, 6,
+    6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+};
+
+constexpr u8 kAnchors3a[64] = {
+    3,  3,  15, 15, 8,  3,  15, 15, 8,  8,  6,  6,  6,  5,  3,  3,
+    3,  3,  8,  15, 3,  3,  6,  10, 5,  8,  8,  6,  8,  5,  15, 15,
+    8,  15, 3,  5,  6,  10, 8,  15, 15, 3,  15, 5,  15, 15, 15, 15,
+    3,  15, 5,  5,  5,  8,  5,  10, 5,  10, 8,  13, 15, 12, 3,  3,
+};
+
+constexpr u8 kAnchors3b[64] = {
+    15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,
+    15, 8,  15, 3,  15, 8,  15, 8,  3,  15, 6,  10, 15, 15, 10, 8,
+    15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15, 3,  6,  6,  8,
+    15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+};
+
+constexpr u8 kWeights2[4] = {0, 21, 43, 64};
+constexpr u8 kWeights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+constexpr u8 kWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Bc7ModeInfo
+{
+    u8 subsetCount;
+    u8 partitionBits;
+    u8 rotationBits;
+    u8 indexSelectionBits;
+    u8 colorBits;
+    u8 alphaBits;
+    u8 endpointPBits; // one p-bit per endpoint
+    u8 sharedPBits;   // one p-bit per subset
+    u8 indexBits;
+    u8 secondaryIndexBits;
+};
+
+constexpr Bc7ModeInfo kBc7Modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0}, {2, 6, 0, 0, 6, 0, 0, 1, 3, 0}, {3, 6, 0, 0, 5, 0, 0, 0, 2, 0}, {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3}, {1, 0, 2, 0, 7, 8, 0, 0, 2, 2}, {1, 0, 0, 0, 7, 7, 1, 0, 4, 0}, {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+class BlockBitReader
+{
+  public:
+    explicit BlockBitReader(const u8* block) { std::memcpy(m_Bytes, block, 16); }
+
+    u32 Read(u32 count)
+    {
+        u32 value = 0;
+        for (u32 i = 0; i < count; ++i, ++m_Position)
+            value |= static_cast<u32>((m_Bytes[m_Position >> 3] >> (m_Position & 7)) & 1u) << i;
+        return value;
+    }
+
+  private:
+    u8 m_Bytes[16];
+    u32 m_Position = 0;
+};
+
+u8 ExpandBits(u32 value, u32 precision)
+{
+    value <<= 8 - precision;
+    return static_cast<u8>(value | (value >> precision));
+}
+
+const u8* WeightsForBits(u32 bits)
+{
+    return (bits == 2) ? kWeights2 : (bits == 3) ? kWeights3 : kWeights4;
+}
+
+u8 Interpolate(u8 e0, u8 e1, u32 weight)
+{
+    return static_cast<u8>(((64u - weight) * e0 + weight * e1 + 32u) >> 6);
+}
+
+void DecodeBc7Block(const u8* block, u8 out[16][4])
+{
+    u32 mode = 0;
+    while (mode < 8 && (block[0] & (1u << mode)) == 0)
+        ++mode;
+    if (mode == 8)
+    {
+        // Reserved mode: the spec decodes it to transparent black.
+        std::memset(out, 0, 16 * 4);
+        return;
+    }
+
+    const Bc7ModeInfo& info = kBc7Modes[mode];
+    BlockBitReader bits(block);
+    bits.Read(mode + 1);
+    const u32 partition = bits.Read(info.partitionBits);
+    const u32 rotation = bits.Read(info.rotationBits);
+    const u32 indexSelection = bits.Read(info.indexSelectionBits);
+
+    const u32 endpointCount = info.subsetCount * 2u;
+    u32 endpoints[6][4] = {};
+    for (u32 c = 0; c < 3; ++c)
+        for (u32 e = 0; e < endpointCount; ++e)
+            endpoints[e][c] = bits.Read(info.colorBits);
+    for (u32 e = 0; e < endpointCount; ++e)
+        endpoints[e][3] = info.alphaBits ? bits.Read(info.alphaBits) : 255u;
+
+    u32 colorPrecision = info.colorBits;
+    u32 alphaPrecision = info.alphaBits;
+    if (info.endpointPBits || info.sharedPBits)
+    {
+        u32 pBits[6] = {};
+        if (info.endpointPBits)
+        {
+            for (u32 e = 0; e < endpointCount; ++e)
+                pBits[e] = bits.Read(1);
+        }
+        else
+        {
+            for (u32 s = 0; s < info.subsetCount; ++s)
+                pBits[s * 2] = pBits[s * 2 + 1] = bits.Read(1);
+        }
+        for (u32 e = 0; e < endpointCount; ++e)
+            for (u32 c = 0; c < 4; ++c)
+                endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+        ++colorPrecision;
+        if (alphaPrecision)
+            ++alphaPrecision;
+    }
+
+    u8 expanded[6][4] = {};
+    for (u32 e = 0; e < endpointCount; ++e)
+    {
+        for (u32 c = 0; c < 3; ++c)
+            expanded[e][c] = ExpandBits(endpoints[e][c], colorPrecision);
+        expanded[e][3] = alphaPrecision ? ExpandBits(endpoints[e][3], alphaPrecision) : 255u;
+    }
+
+    auto subsetOf = [&](u32 texel) -> u32 {
+        if (info.subsetCount == 2)
+            return (kPartitions2[partition] >> (texel * 2)) & 3u;
+        if (info.subsetCount == 3)
+            return (kPartitions3[partition] >> (texel * 2)) & 3u;
+        return 0u;
+    };
+    auto isAnchor = [&](u32 texel) {
+        if (texel == 0)
+            return true;
+        if (info.subsetCount == 2)
+            return texel == kAnchors2[partition];
+        if (info.subsetCount == 3)
+            return texel == kAnchors3a[partition] || texel == kAnchors3b[partition];
+        return false;
+    };
+
+    u32 indices[16] = {};
+    u32 secondaryIndices[16] = {};
+    for (u32 t = 0; t < 16; ++t)
+        indices[t] = bits.Read(info.indexBits - (isAnchor(t) ? 1u : 0u));
+    if (info.secondaryIndexBits)
+    {
+        for (u32 t = 0; t < 16; ++t)
+            secondaryIndices[t] = bits.Read(info.secondaryIndexBits - ((t == 0) ? 1u : 0u));
+    }
+
+    for (u32 t = 0; t < 16; ++t)
+    {
+        const u32 subset = subsetOf(t);
+        const u8* e0 = expanded[subset * 2];
+        const u8* e1 = expanded[subset * 2 + 1];
+
+        u32 colorWeight = WeightsForBits(info.indexBits)[indices[t]];
+        u32 alphaWeight = colorWeight;
+        if (info.secondaryIndexBits)
+        {
+            // The index selection bit of mode 4 swaps which index set drives color and which drives alpha.
+            const u32 secondaryWeight = WeightsForBits(info.secondaryIndexBits)[secondaryIndices[t]];
+            colorWeight = indexSelection ? secondaryWeight : colorWeight;
+            alphaWeight = indexSelection ? WeightsForBits(info.indexBits)[indices[t]] : secondaryWeight;
+        }
+
+        u8* texel = out[t];
+        for (u32 c = 0; c < 3; ++c)
+            texel[c] = Interpolate(e0[c], e1[c], colorWeight);
+        texel[3] = Interpolate(e0[3], e1[3], alphaWeight);
+        if (rotation)
+            std::swap(texel[3], texel[rotation - 1]);
+    }
+}
+
+void DecodeBc4Block(const u8* block, u8 out[16])
+{
+    const u32 r0 = block[0];
+    const u32 r1 = block[1];
+    u8 palette[8] = {static_cast<u8>(r0), static_cast<u8>(r1)};
+    if (r0 > r1)
+    {
+        for (u32 i = 1; i < 7; ++i)
+            palette[i + 1] = static_cast<u8>(((7 - i) * r0 + i * r1 + 3) / 7);
+    }
+    else
+    {
+        for (u32 i = 1; i < 5; ++i)
+            palette[i + 1] = static_cast<u8>(((5 - i) * r0 + i * r1 + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    u64 selectors = 0;
+    for (u32 i = 0; i < 6; ++i)
+        selectors |= static_cast<u64>(block[2 + i]) << (8 * i);
+    for (u32 t = 0; t < 16; ++t)
+        out[t] = palette[(selectors >> (3 * t)) & 7u];
+}
+
+template <typename DecodeBlockFn> bool DecodeBlocks(u32 width, u32 height, const u8* bytes, size_t byteCount, u32 rowPitch, u32 blockBytes, DecodedTexture& out, DecodeBlockFn&& decodeBlock)
+{
+    const u32 blocksX = (width + 3) / 4;
+    const u32 blocksY = (height + 3) / 4;
+    if (rowPitch < blocksX * blockBytes || static_cast<size_t>(rowPitch) * (blocksY - 1) + static_cast<size_t>(blocksX) * blockBytes > byteCount)
+        return false;
+
+    for (u32 by = 0; by < blocksY; ++by)
+    {
+        for (u32 bx = 0; bx < blocksX; ++bx)
+        {
+            u8 block[16][4];
+            decodeBlock(bytes + static_cast<size_t>(by) * rowPitch + static_cast<size_t>(bx) * blockBytes, block);
+            for (u32 t = 0; t < 16; ++t)
+            {
+                const u32 x = bx * 4 + (t & 3);
+                const u32 y = by * 4 + (t >> 2);
+                if (x < width && y < height)
+                    std::memcpy(out.texels.data() + (static_cast<size_t>(y) * width + x) * 4, block[t], 4);
+            }
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool DecodeTextureMip0(u32 format, u32 width, u32 height, const u8* bytes, size_t byteCount, u32 rowPitch, DecodedTexture& out)
+{
+    out = DecodedTexture{};
+    if (width == 0 || height == 0 || bytes == nullptr)
+        return false;
+
+    DecodedTexture decoded{};
+    decoded.width = width;
+    decoded.height = height;
+    decoded.texels.resize(static_cast<size_t>(width) * height * 4);
+
+    bool ok = false;
+    switch (format)
+    {
+    case TextureFormat_BC7_UNORM:
+    case TextureFormat_BC7_UNORM_SRGB:
+        decoded.srgb = format == TextureFormat_BC7_UNORM_SRGB;
+        ok = DecodeBlocks(width, height, bytes, byteCount, rowPitch, 16, decoded, DecodeBc7Block);
+        break;
+    case TextureFormat_BC5_UNORM:
+        ok = DecodeBlocks(width, height, bytes, byteCount, rowPitch, 16, decoded, [](const u8* block, u8 texels[16][4]) {
+            u8 red[16];
+            u8 green[16];
+            DecodeBc4Block(block, red);
+            DecodeBc4Block(block + 8, green);
+            for (u32 t = 0; t < 16; ++t)
+            {
+                texels[t][0] = red[t];
+                texels[t][1] = green[t];
+                texels[t][2] = 0;
+                texels[t][3] = 255;
+            }
+        });
+        break;
+    case TextureFormat_R8G8B8A8_UNORM:
+    case TextureFormat_R8G8B8A8_UNORM_SRGB:
+        decoded.srgb = format == TextureFormat_R8G8B8A8_UNORM_SRGB;
+        ok = rowPitch >= width * 4 && static_cast<size_t>(rowPitch) * (height - 1) + static_cast<size_t>(width) * 4 <= byteCount;
+        for (u32 y = 0; ok && y < height; ++y)
+            std::memcpy(decoded.texels.data() + static_cast<size_t>(y) * width * 4, bytes + static_cast<size_t>(y) * rowPitch, static_cast<size_t>(width) * 4);
+        break;
+    default:
+        break;
+    }
+
+    if (ok)
+        out = std::move(decoded);
+    return ok;
+}
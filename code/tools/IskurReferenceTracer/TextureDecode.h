@@ -0,0 +1,30 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "TracerCommon.h"
+
+// DXGI_FORMAT values of the formats the scene packer writes, plus uncompressed RGBA8.
+enum TextureFormat : u32
+{
+    TextureFormat_R8G8B8A8_UNORM = 28,
+    TextureFormat_R8G8B8A8_UNORM_SRGB = 29,
+    TextureFormat_BC5_UNORM = 83,
+    TextureFormat_BC7_UNORM = 98,
+    TextureFormat_BC7_UNORM_SRGB = 99,
+};
+
+struct DecodedTexture
+{
+    u32 width = 0;
+    u32 height = 0;
+    bool srgb = false;
+    // Mip 0 only: every texture read in path_trace.rt.hlsl uses SampleLevel(..., 0).
+    Vector<u8> texels; // RGBA8, still sRGB-encoded when srgb is set
+};
+
+// Decodes mip 0 to RGBA8 the way the GPU would. Returns false for formats it does not know; BC5 decodes to (r, g, 0, 1).
+bool DecodeTextureMip0(u32 format, u32 width, u32 height, const u8* bytes, size_t byteCount, u32 rowPitch, DecodedTexture& out);
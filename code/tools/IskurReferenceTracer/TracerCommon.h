@@ -0,0 +1,56 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+// The tracer only depends on the standard library so golden images can be rendered on Linux CI. It therefore does not use
+// common/Types.h (which pulls in WRL) and keeps its own copies of the handful of engine definitions it needs.
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <vector>
+
+using u8 = std::uint8_t;
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+
+using i16 = std::int16_t;
+using i32 = std::int32_t;
+using i64 = std::int64_t;
+
+using f32 = float;
+using f64 = double;
+
+template <class T> using Vector = std::vector<T>;
+template <class T, std::size_t N> using Array = std::array<T, N>;
+
+[[noreturn]] inline void Fatal(const char* msg)
+{
+    std::println("Error: {}", msg);
+    std::exit(EXIT_FAILURE);
+}
+
+inline void Require(bool cond, const char* msg)
+{
+    if (!cond)
+        Fatal(msg);
+}
+
+inline std::string ToLowerAscii(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+inline bool EqualsIgnoreCaseAscii(const std::string& a, const std::string& b)
+{
+    return ToLowerAscii(a) == ToLowerAscii(b);
+}
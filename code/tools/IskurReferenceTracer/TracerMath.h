@@ -0,0 +1,441 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+#pragma once
+
+#include "TracerCommon.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define IE_TRACER_SSE2 1
+#else
+#define IE_TRACER_SSE2 0
+#endif
+
+// Same values as common/MathUtils.h.
+inline constexpr f32 kPi = 3.14159265358979323846f;
+inline constexpr f32 kInvPi = 0.318309886183790671538f;
+
+constexpr f32 ToRadians(f32 degrees)
+{
+    return degrees * (kPi / 180.0f);
+}
+
+inline f32 Saturate(f32 v)
+{
+    return std::clamp(v, 0.0f, 1.0f);
+}
+
+inline f32 SmoothStep(f32 edge0, f32 edge1, f32 x)
+{
+    const f32 t = Saturate((x - edge0) / (edge1 - edge0));
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Vectors and matrices, with the same conventions as the DirectXMath code they replace (row vectors, row-major matrices)
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Float2
+{
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+};
+
+struct Float3
+{
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+    f32 z = 0.0f;
+
+    Float3& operator+=(const Float3& o)
+    {
+        x += o.x;
+        y += o.y;
+        z += o.z;
+        return *this;
+    }
+    Float3& operator*=(const Float3& o)
+    {
+        x *= o.x;
+        y *= o.y;
+        z *= o.z;
+        return *this;
+    }
+    Float3& operator/=(f32 s)
+    {
+        x /= s;
+        y /= s;
+        z /= s;
+        return *this;
+    }
+};
+
+inline Float3 operator+(const Float3& a, const Float3& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+inline Float3 operator-(const Float3& a, const Float3& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+inline Float3 operator-(const Float3& a)
+{
+    return {-a.x, -a.y, -a.z};
+}
+inline Float3 operator*(const Float3& a, const Float3& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z};
+}
+inline Float3 operator*(const Float3& a, f32 s)
+{
+    return {a.x * s, a.y * s, a.z * s};
+}
+inline Float3 operator/(const Float3& a, f32 s)
+{
+    return {a.x / s, a.y / s, a.z / s};
+}
+
+inline f32 Dot(const Float3& a, const Float3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Float3 Cross(const Float3& a, const Float3& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline f32 Length(const Float3& v)
+{
+    return std::sqrt(Dot(v, v));
+}
+
+// A zero vector stays zero, like XMVector3Normalize.
+inline Float3 Normalize(const Float3& v)
+{
+    const f32 length = Length(v);
+    return (length > 0.0f) ? v / length : Float3{};
+}
+
+inline Float3 Min(const Float3& a, const Float3& b)
+{
+    return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+}
+
+inline Float3 Max(const Float3& a, const Float3& b)
+{
+    return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+}
+
+inline Float3 Clamp(const Float3& v, f32 lo, f32 hi)
+{
+    return {std::clamp(v.x, lo, hi), std::clamp(v.y, lo, hi), std::clamp(v.z, lo, hi)};
+}
+
+inline Float3 Saturate(const Float3& v)
+{
+    return Clamp(v, 0.0f, 1.0f);
+}
+
+inline Float3 Lerp(const Float3& a, const Float3& b, f32 t)
+{
+    return a + (b - a) * t;
+}
+
+inline Float3 Exp(const Float3& v)
+{
+    return {std::exp(v.x), std::exp(v.y), std::exp(v.z)};
+}
+
+inline f32 MaxComponent(const Float3& v)
+{
+    return std::max(v.x, std::max(v.y, v.z));
+}
+
+inline Float3 Reflect(const Float3& incident, const Float3& normal)
+{
+    return incident - normal * (2.0f * Dot(incident, normal));
+}
+
+inline f32 Axis(const Float3& v, u32 axis)
+{
+    return (axis == 0) ? v.x : (axis == 1) ? v.y : v.z;
+}
+
+struct Float4
+{
+    f32 x = 0.0f;
+    f32 y = 0.0f;
+    f32 z = 0.0f;
+    f32 w = 0.0f;
+
+    Float3 Xyz() const { return {x, y, z}; }
+};
+
+inline Float4 operator+(const Float4& a, const Float4& b)
+{
+    return {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w};
+}
+inline Float4 operator*(const Float4& a, const Float4& b)
+{
+    return {a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w};
+}
+inline Float4 operator*(const Float4& a, f32 s)
+{
+    return {a.x * s, a.y * s, a.z * s, a.w * s};
+}
+
+inline Float4 Lerp(const Float4& a, const Float4& b, f32 t)
+{
+    return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+}
+
+struct Float4x4
+{
+    f32 m[4][4] = {};
+};
+
+// Point with perspective divide, like XMVector3TransformCoord.
+inline Float3 TransformPoint(const Float3& p, const Float4x4& mat)
+{
+    const f32(&m)[4][4] = mat.m;
+    const f32 x = p.x * m[0][0] + p.y * m[1][0] + p.z * m[2][0] + m[3][0];
+    const f32 y = p.x * m[0][1] + p.y * m[1][1] + p.z * m[2][1] + m[3][1];
+    const f32 z = p.x * m[0][2] + p.y * m[1][2] + p.z * m[2][2] + m[3][2];
+    const f32 w = p.x * m[0][3] + p.y * m[1][3] + p.z * m[2][3] + m[3][3];
+    return {x / w, y / w, z / w};
+}
+
+// Direction without translation, like XMVector3TransformNormal.
+inline Float3 TransformVector(const Float3& v, const Float4x4& mat)
+{
+    const f32(&m)[4][4] = mat.m;
+    return {v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0], v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1], v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2]};
+}
+
+inline Float4x4 Transpose(const Float4x4& mat)
+{
+    Float4x4 out{};
+    for (u32 r = 0; r < 4; ++r)
+        for (u32 c = 0; c < 4; ++c)
+            out.m[r][c] = mat.m[c][r];
+    return out;
+}
+
+inline f32 Determinant3x3(const Float4x4& mat)
+{
+    const f32(&m)[4][4] = mat.m;
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+// General inverse by cofactors; a singular matrix yields infinities, as XMMatrixInverse does.
+inline Float4x4 Inverse(const Float4x4& mat)
+{
+    const f32* a = &mat.m[0][0];
+    f32 inv[16];
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    const f32 invDet = 1.0f / (a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12]);
+    Float4x4 out{};
+    for (u32 i = 0; i < 16; ++i)
+        (&out.m[0][0])[i] = inv[i] * invDet;
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Four f32 lanes: SSE2 where the target has it, plain arrays elsewhere. Comparisons return a 4-bit lane mask.
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Lane4
+{
+#if IE_TRACER_SSE2
+    __m128 v;
+#else
+    f32 v[4];
+#endif
+};
+
+#if IE_TRACER_SSE2
+
+inline Lane4 LaneSplat(f32 s)
+{
+    return {_mm_set1_ps(s)};
+}
+inline Lane4 LaneLoad(const f32* aligned)
+{
+    return {_mm_load_ps(aligned)};
+}
+inline void LaneStore(f32* aligned, Lane4 a)
+{
+    _mm_store_ps(aligned, a.v);
+}
+inline Lane4 operator+(Lane4 a, Lane4 b)
+{
+    return {_mm_add_ps(a.v, b.v)};
+}
+inline Lane4 operator-(Lane4 a, Lane4 b)
+{
+    return {_mm_sub_ps(a.v, b.v)};
+}
+inline Lane4 operator*(Lane4 a, Lane4 b)
+{
+    return {_mm_mul_ps(a.v, b.v)};
+}
+inline Lane4 operator/(Lane4 a, Lane4 b)
+{
+    return {_mm_div_ps(a.v, b.v)};
+}
+// Returns b when either lane is NaN, like std::min(b, a) and XMVectorMin.
+inline Lane4 LaneMin(Lane4 a, Lane4 b)
+{
+    return {_mm_min_ps(a.v, b.v)};
+}
+inline Lane4 LaneMax(Lane4 a, Lane4 b)
+{
+    return {_mm_max_ps(a.v, b.v)};
+}
+inline Lane4 LaneAbs(Lane4 a)
+{
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+inline u32 LaneLess(Lane4 a, Lane4 b)
+{
+    return static_cast<u32>(_mm_movemask_ps(_mm_cmplt_ps(a.v, b.v)));
+}
+inline u32 LaneLessEqual(Lane4 a, Lane4 b)
+{
+    return static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(a.v, b.v)));
+}
+inline u32 LaneGreater(Lane4 a, Lane4 b)
+{
+    return static_cast<u32>(_mm_movemask_ps(_mm_cmpgt_ps(a.v, b.v)));
+}
+inline u32 LaneGreaterEqual(Lane4 a, Lane4 b)
+{
+    return static_cast<u32>(_mm_movemask_ps(_mm_cmpge_ps(a.v, b.v)));
+}
+
+#else
+
+template <typename Op> inline Lane4 LaneMap(Lane4 a, Lane4 b, Op op)
+{
+    Lane4 r{};
+    for (u32 i = 0; i < 4; ++i)
+        r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+}
+template <typename Op> inline u32 LaneCompare(Lane4 a, Lane4 b, Op op)
+{
+    u32 mask = 0;
+    for (u32 i = 0; i < 4; ++i)
+        mask |= op(a.v[i], b.v[i]) ? (1u << i) : 0u;
+    return mask;
+}
+
+inline Lane4 LaneSplat(f32 s)
+{
+    return {{s, s, s, s}};
+}
+inline Lane4 LaneLoad(const f32* aligned)
+{
+    return {{aligned[0], aligned[1], aligned[2], aligned[3]}};
+}
+inline void LaneStore(f32* aligned, Lane4 a)
+{
+    for (u32 i = 0; i < 4; ++i)
+        aligned[i] = a.v[i];
+}
+inline Lane4 operator+(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return x + y; });
+}
+inline Lane4 operator-(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return x - y; });
+}
+inline Lane4 operator*(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return x * y; });
+}
+inline Lane4 operator/(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return x / y; });
+}
+inline Lane4 LaneMin(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return (x < y) ? x : y; });
+}
+inline Lane4 LaneMax(Lane4 a, Lane4 b)
+{
+    return LaneMap(a, b, [](f32 x, f32 y) { return (x > y) ? x : y; });
+}
+inline Lane4 LaneAbs(Lane4 a)
+{
+    return LaneMap(a, a, [](f32 x, f32) { return std::abs(x); });
+}
+inline u32 LaneLess(Lane4 a, Lane4 b)
+{
+    return LaneCompare(a, b, [](f32 x, f32 y) { return x < y; });
+}
+inline u32 LaneLessEqual(Lane4 a, Lane4 b)
+{
+    return LaneCompare(a, b, [](f32 x, f32 y) { return x <= y; });
+}
+inline u32 LaneGreater(Lane4 a, Lane4 b)
+{
+    return LaneCompare(a, b, [](f32 x, f32 y) { return x > y; });
+}
+inline u32 LaneGreaterEqual(Lane4 a, Lane4 b)
+{
+    return LaneCompare(a, b, [](f32 x, f32 y) { return x >= y; });
+}
+
+#endif
+
+// Three lanes of positions or directions, one ray per lane.
+struct Lane4x3
+{
+    Lane4 x;
+    Lane4 y;
+    Lane4 z;
+};
+
+inline Lane4 Dot(const Lane4x3& a, const Lane4x3& b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+inline Lane4x3 Cross(const Lane4x3& a, const Lane4x3& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline Lane4x3 operator-(const Lane4x3& a, const Lane4x3& b)
+{
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline Lane4x3 LaneSplat(const Float3& v)
+{
+    return {LaneSplat(v.x), LaneSplat(v.y), LaneSplat(v.z)};
+}
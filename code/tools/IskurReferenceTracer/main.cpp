@@ -0,0 +1,2654 @@
+// Iskur Engine - Reference Tracer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+// Headless CPU path tracer for golden images. It reads packed scenes directly, uses the same camera and environment presets
+// as the renderer, and ports the estimator of path_trace.rt.hlsl (sun cone MIS, GGX VNDF, Russian roulette, RNG seeding)
+// so its output converges to what the GPU path tracer accumulates. The paths of a 2x2 pixel quad advance in lockstep, so
+// the primary, sun shadow and continuation rays of every bounce are traced as 4-ray packets.
+
+#include "PackReader.h"
+#include "TextureDecode.h"
+#include "TracerCommon.h"
+#include "TracerMath.h"
+
+#include <atomic>
+#include <bit>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+using TracerPack::Vertex;
+
+// Mirrors path_trace.rt.hlsl and rt_shared.hlsli.
+static constexpr f32 kRayEps = 0.001f;
+static constexpr f32 kRayTMax = 1e6f;
+static constexpr f32 kPrimaryBounceContinuationRayOriginBias = 0.025f;
+static constexpr f32 kDirectShadowRayTMin = 1e-4f;
+static constexpr f32 kDirectShadowRayMinBias = 1e-3f;
+static constexpr f32 kDirectShadowRayViewBiasScale = 3e-5f;
+static constexpr u32 kRussianRouletteMinBounce = 1u;
+
+// Mirrors sky_cube_gen.cs.hlsl and Sky.cpp.
+static constexpr u32 kAtmosphereViewSteps = 64;
+static constexpr u32 kAtmosphereSunSteps = 16;
+static constexpr f32 kSunDiskSoftness = 1.4f;
+
+static constexpr u32 kBvhWidth = 4;
+static constexpr u32 kBvhMaxLeafItems = 4;
+static constexpr u32 kBvhSahBins = 16;
+static constexpr f32 kBvhTraversalCost = 1.0f;
+static constexpr u32 kBvhStackSize = 128;
+static constexpr u32 kPacketSize = 4;
+static constexpr u32 kTileSize = 16;
+static_assert(kTileSize % 2 == 0, "Tiles are walked in 2x2 pixel quads");
+
+struct TracerOptions
+{
+    std::string scene;
+    std::string environment;
+    fs::path outPath;
+    u32 width = 960;
+    u32 height = 540;
+    u32 frames = 64;
+    u32 spp = 0;
+    u32 maxBounces = 0;
+    u32 threadCount = 0;
+    u32 skyCubeSize = 512;
+    bool singleRays = false;
+};
+
+// The RuntimeState defaults and environment preset values the estimator reads; Environments::ApplyPreset overrides the
+// lighting ones from the selected preset, exactly as below.
+struct TracerSettings
+{
+    f32 cameraFov = 58.71550709f;
+    u32 rtPathTraceSpp = 1;
+    u32 rtMaxBounces = 12;
+    bool rtShadowsEnabled = true;
+    f32 sunIntensity = 1.0f;
+    f32 skyIntensity = 5.0f;
+    f32 shadowMinVisibility = 0.0f;
+    f32 specularShadowMinVisibility = 0.0f;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Environment presets (Environments.h/.cpp)
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Environment
+{
+    Float3 sunDir = {0.3f, 1.f, 0.75f};
+
+    struct SkySettings
+    {
+        struct AtmosphereSettings
+        {
+            Float3 rayleighScattering = {0.0058f, 0.0135f, 0.0331f};
+            f32 rayleighScaleHeightKm = 8.0f;
+            Float3 mieScattering = {0.021f, 0.021f, 0.021f};
+            f32 mieScaleHeightKm = 1.2f;
+            f32 mieG = 0.76f;
+            f32 atmosphereThicknessKm = 80.0f;
+            f32 sunIntensityScale = 4.0f;
+            Float3 ozoneAbsorption = {0.00065f, 0.001881f, 0.000085f};
+            f32 ozoneLayerCenterKm = 25.0f;
+            f32 ozoneLayerWidthKm = 15.0f;
+            f32 multiScatteringStrength = 0.35f;
+        } atmosphere{};
+
+        Float3 sunColor = {1.0f, 0.95f, 0.85f};
+        f32 sunDiskAngleDeg = 0.12f;
+        f32 sunGlowPower = 64.0f;
+        f32 sunGlowIntensity = 0.05f;
+        f32 sunDiskIntensityScale = 3.0f;
+    } sky{};
+};
+
+struct EnvironmentPreset
+{
+    std::string name = "Default";
+    Environment environment{};
+    f32 sunAzimuthDeg = 210.0f;
+    f32 sunElevationDeg = 240.0f;
+    f32 sunIntensity = 1.0f;
+    f32 skyIntensity = 5.0f;
+    f32 shadowMinVisibility = 0.0f;
+    f32 specularShadowMinVisibility = 0.0f;
+    f32 exposureCompensationEV = 0.0f;
+};
+
+static bool TryParsePresetLine(const std::string& line, EnvironmentPreset& outPreset)
+{
+    if (line.empty() || line[0] == '#')
+    {
+        return false;
+    }
+
+    Environment env{};
+    Environment::SkySettings& sky = env.sky;
+    Environment::SkySettings::AtmosphereSettings& atm = sky.atmosphere;
+    std::istringstream stream(line);
+    if (!(stream >> outPreset.name >> outPreset.sunAzimuthDeg >> outPreset.sunElevationDeg >> outPreset.sunIntensity >> outPreset.skyIntensity >> outPreset.shadowMinVisibility >>
+          outPreset.specularShadowMinVisibility >> outPreset.exposureCompensationEV >> sky.sunColor.x >> sky.sunColor.y >> sky.sunColor.z >> sky.sunDiskAngleDeg >> sky.sunGlowPower >>
+          sky.sunGlowIntensity >> sky.sunDiskIntensityScale >> atm.rayleighScattering.x >> atm.rayleighScattering.y >> atm.rayleighScattering.z >> atm.rayleighScaleHeightKm >>
+          atm.mieScattering.x >> atm.mieScattering.y >> atm.mieScattering.z >> atm.mieScaleHeightKm >> atm.mieG >> atm.atmosphereThicknessKm >> atm.sunIntensityScale >>
+          atm.ozoneAbsorption.x >> atm.ozoneAbsorption.y >> atm.ozoneAbsorption.z >> atm.ozoneLayerCenterKm >> atm.ozoneLayerWidthKm >> atm.multiScatteringStrength))
+    {
+        return false;
+    }
+
+    const f32 azimuth = ToRadians(outPreset.sunAzimuthDeg);
+    const f32 elevation = ToRadians(outPreset.sunElevationDeg);
+    env.sunDir = Normalize({std::cos(elevation) * std::cos(azimuth), std::sin(elevation), std::cos(elevation) * std::sin(azimuth)});
+    outPreset.environment = env;
+    return true;
+}
+
+// Same file, fallback, and default selection as Environments::Load.
+static Vector<EnvironmentPreset> LoadEnvironmentPresets()
+{
+    Vector<EnvironmentPreset> presets;
+    std::ifstream file("data/environment_presets.txt");
+    if (!file.is_open())
+        std::println("  warning: failed to open 'data/environment_presets.txt', using the built-in default environment");
+
+    std::string line;
+    while (file.is_open() && std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        EnvironmentPreset preset{};
+        if (TryParsePresetLine(line, preset))
+            presets.push_back(preset);
+    }
+    if (presets.empty())
+        presets.emplace_back();
+    return presets;
+}
+
+static const EnvironmentPreset* FindEnvironmentPreset(const Vector<EnvironmentPreset>& presets, const std::string& name)
+{
+    for (const EnvironmentPreset& preset : presets)
+    {
+        if (EqualsIgnoreCaseAscii(preset.name, name))
+            return &preset;
+    }
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Small math helpers
+// ---------------------------------------------------------------------------------------------------------------------
+
+static f32 Luminance(const Float3& c)
+{
+    return Dot(c, {0.2126f, 0.7152f, 0.0722f});
+}
+
+static bool IsInvalid(f32 v)
+{
+    // Also catches NaN, since NaN fails the comparison.
+    return !(std::abs(v) <= 1e20f);
+}
+
+static bool AnyInvalid3(const Float3& v)
+{
+    return IsInvalid(v.x) || IsInvalid(v.y) || IsInvalid(v.z);
+}
+
+static bool AnyInvalid4(const Float4& v)
+{
+    return AnyInvalid3(v.Xyz()) || IsInvalid(v.w);
+}
+
+static u32 HashUint(u32 x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static f32 Rand(u32& seed)
+{
+    seed = HashUint(seed);
+    return static_cast<f32>(seed & 0x00FFFFFFu) * (1.0f / 16777216.0f);
+}
+
+static void BuildOrthonormalBasis(const Float3& n, Float3& t, Float3& b)
+{
+    const f32 sign = (n.z >= 0.0f) ? 1.0f : -1.0f;
+    const f32 a = -1.0f / (sign + n.z);
+    const f32 bb = n.x * n.y * a;
+
+    t = {1.0f + sign * n.x * n.x * a, sign * bb, -sign * n.x};
+    b = {bb, sign + n.y * n.y * a, -n.y};
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Vertex decoding (normal.hlsli)
+// ---------------------------------------------------------------------------------------------------------------------
+
+static f32 SignNotZero(f32 v)
+{
+    return (v >= 0.0f) ? 1.0f : -1.0f;
+}
+
+static Float3 DecodePackedNormalOct(u32 packed)
+{
+    const f32 ex = std::max(static_cast<f32>(static_cast<i16>(packed & 0xFFFFu)) / 32767.0f, -1.0f);
+    const f32 ey = std::max(static_cast<f32>(static_cast<i16>(packed >> 16)) / 32767.0f, -1.0f);
+    f32 nx = ex;
+    f32 ny = ey;
+    const f32 nz = 1.0f - std::abs(ex) - std::abs(ey);
+    if (nz < 0.0f)
+    {
+        nx = (1.0f - std::abs(ey)) * SignNotZero(ex);
+        ny = (1.0f - std::abs(ex)) * SignNotZero(ey);
+    }
+    return Normalize({nx, ny, nz});
+}
+
+static f32 HalfToFloat(u32 half)
+{
+    const u32 sign = (half & 0x8000u) << 16;
+    const u32 exponent = (half >> 10) & 0x1Fu;
+    u32 mantissa = half & 0x3FFu;
+    if (exponent == 0x1Fu)
+        return std::bit_cast<f32>(sign | 0x7F800000u | (mantissa << 13));
+    if (exponent != 0)
+        return std::bit_cast<f32>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+    if (mantissa == 0)
+        return std::bit_cast<f32>(sign);
+
+    // Subnormal half: renormalize into a float exponent.
+    u32 floatExponent = 113;
+    while ((mantissa & 0x400u) == 0)
+    {
+        mantissa <<= 1;
+        --floatExponent;
+    }
+    return std::bit_cast<f32>(sign | (floatExponent << 23) | ((mantissa & 0x3FFu) << 13));
+}
+
+static Float2 DecodePackedHalf2(u32 packed)
+{
+    return {HalfToFloat(packed & 0xFFFFu), HalfToFloat(packed >> 16)};
+}
+
+static Float4 DecodePackedColorRGBA16Unorm(u32 packedLo, u32 packedHi)
+{
+    constexpr f32 kInvUnorm16 = 1.0f / 65535.0f;
+    return {static_cast<f32>(packedLo & 0xFFFFu) * kInvUnorm16, static_cast<f32>(packedLo >> 16) * kInvUnorm16, static_cast<f32>(packedHi & 0xFFFFu) * kInvUnorm16,
+            static_cast<f32>(packedHi >> 16) * kInvUnorm16};
+}
+
+static Float3 DecodePackedTangentR10G10B10A2(u32 packed, f32& handedness)
+{
+    const f32 x = static_cast<f32>(packed & 1023u) * (1.0f / 1023.0f);
+    const f32 y = static_cast<f32>((packed >> 10) & 1023u) * (1.0f / 1023.0f);
+    const f32 z = static_cast<f32>((packed >> 20) & 1023u) * (1.0f / 1023.0f);
+    handedness = (((packed >> 30) & 3u) >= 2u) ? 1.0f : -1.0f;
+    return Normalize({x * 2.0f - 1.0f, y * 2.0f - 1.0f, z * 2.0f - 1.0f});
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Textures
+// ---------------------------------------------------------------------------------------------------------------------
+
+static const Array<f32, 256>& SrgbToLinearTable()
+{
+    static const Array<f32, 256> table = [] {
+        Array<f32, 256> t{};
+        for (u32 i = 0; i < 256; ++i)
+        {
+            const f32 c = static_cast<f32>(i) / 255.0f;
+            t[i] = (c <= 0.04045f) ? (c / 12.92f) : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return t;
+    }();
+    return table;
+}
+
+static DecodedTexture DecodeTexture(const PackTexture& src)
+{
+    DecodedTexture out{};
+    if (src.dimension != TracerPack::kTexDimensionTexture2D || src.mip0 == nullptr || src.texelBytes == nullptr)
+    {
+        return out;
+    }
+
+    const IEPack::TextureSubresourceRecord& mip0 = *src.mip0;
+    Require(static_cast<size_t>(mip0.byteOffset) + static_cast<size_t>(mip0.byteSize) <= src.texelByteCount, "Texture subresource out of range");
+
+    // Texels stay sRGB-encoded; the sampler linearizes them like the GPU would.
+    if (!DecodeTextureMip0(src.format, src.width, src.height, src.texelBytes + static_cast<size_t>(mip0.byteOffset), static_cast<size_t>(mip0.byteSize), mip0.rowPitch, out))
+    {
+        std::println("  warning: failed to decode texture ({}x{}, format {}), treating it as white", src.width, src.height, src.format);
+    }
+    return out;
+}
+
+static i32 ApplyAddressMode(i32 coord, i32 size, u32 mode)
+{
+    switch (mode)
+    {
+    case TracerPack::AddressMode_Wrap: {
+        const i32 m = coord % size;
+        return (m < 0) ? m + size : m;
+    }
+    case TracerPack::AddressMode_Mirror: {
+        const i32 period = size * 2;
+        i32 m = coord % period;
+        if (m < 0)
+            m += period;
+        return (m < size) ? m : period - 1 - m;
+    }
+    case TracerPack::AddressMode_MirrorOnce:
+        return std::min((coord < 0) ? -coord - 1 : coord, size - 1);
+    default:
+        // CLAMP, and BORDER approximated as CLAMP.
+        return std::clamp(coord, 0, size - 1);
+    }
+}
+
+static Float4 FetchTexel(const DecodedTexture& tex, i32 x, i32 y)
+{
+    const size_t index = static_cast<size_t>(y) * tex.width + static_cast<size_t>(x);
+    const u8* texel = tex.texels.data() + index * 4;
+    if (tex.srgb)
+    {
+        const Array<f32, 256>& lut = SrgbToLinearTable();
+        return {lut[texel[0]], lut[texel[1]], lut[texel[2]], static_cast<f32>(texel[3]) / 255.0f};
+    }
+    return Float4{static_cast<f32>(texel[0]), static_cast<f32>(texel[1]), static_cast<f32>(texel[2]), static_cast<f32>(texel[3])} * (1.0f / 255.0f);
+}
+
+static Float4 SampleTexture(const DecodedTexture& tex, const TracerPack::SamplerRecord& sampler, const Float2& uv)
+{
+    if (tex.width == 0 || tex.height == 0)
+    {
+        return {1.0f, 1.0f, 1.0f, 1.0f};
+    }
+
+    const i32 w = static_cast<i32>(tex.width);
+    const i32 h = static_cast<i32>(tex.height);
+    const f32 u = std::isfinite(uv.x) ? std::clamp(uv.x, -1e6f, 1e6f) : 0.0f;
+    const f32 v = std::isfinite(uv.y) ? std::clamp(uv.y, -1e6f, 1e6f) : 0.0f;
+
+    // At LOD 0 the hardware uses the magnification filter.
+    if (TracerPack::IsMagFilterPoint(sampler.filter))
+    {
+        const i32 x = ApplyAddressMode(static_cast<i32>(std::floor(u * w)), w, sampler.addressU);
+        const i32 y = ApplyAddressMode(static_cast<i32>(std::floor(v * h)), h, sampler.addressV);
+        return FetchTexel(tex, x, y);
+    }
+
+    const f32 fx = u * w - 0.5f;
+    const f32 fy = v * h - 0.5f;
+    const f32 x0f = std::floor(fx);
+    const f32 y0f = std::floor(fy);
+    const f32 tx = fx - x0f;
+    const f32 ty = fy - y0f;
+    const i32 x0 = ApplyAddressMode(static_cast<i32>(x0f), w, sampler.addressU);
+    const i32 x1 = ApplyAddressMode(static_cast<i32>(x0f) + 1, w, sampler.addressU);
+    const i32 y0 = ApplyAddressMode(static_cast<i32>(y0f), h, sampler.addressV);
+    const i32 y1 = ApplyAddressMode(static_cast<i32>(y0f) + 1, h, sampler.addressV);
+
+    const Float4 top = Lerp(FetchTexel(tex, x0, y0), FetchTexel(tex, x1, y0), tx);
+    const Float4 bottom = Lerp(FetchTexel(tex, x0, y1), FetchTexel(tex, x1, y1), tx);
+    return Lerp(top, bottom, ty);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Procedural sky (sky_cube_gen.cs.hlsl), baked into a cube with the same face layout and sampled bilinearly
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct SkyCube
+{
+    u32 size = 0;
+    Vector<Float3> texels; // 6 faces of size * size
+};
+
+static Float3 CubeFaceUvToDir(u32 face, f32 u, f32 v)
+{
+    switch (face)
+    {
+    case 0:
+        return Normalize({1.0f, -v, -u}); // +X
+    case 1:
+        return Normalize({-1.0f, -v, u}); // -X
+    case 2:
+        return Normalize({u, 1.0f, v}); // +Y
+    case 3:
+        return Normalize({u, -1.0f, -v}); // -Y
+    case 4:
+        return Normalize({u, -v, 1.0f}); // +Z
+    default:
+        return Normalize({-u, -v, -1.0f}); // -Z
+    }
+}
+
+// Inverse of CubeFaceUvToDir.
+static u32 DirToCubeFaceUv(const Float3& dir, f32& u, f32& v)
+{
+    const f32 ax = std::abs(dir.x);
+    const f32 ay = std::abs(dir.y);
+    const f32 az = std::abs(dir.z);
+
+    if (ax >= ay && ax >= az)
+    {
+        u = (dir.x > 0.0f ? -dir.z : dir.z) / ax;
+        v = -dir.y / ax;
+        return dir.x > 0.0f ? 0u : 1u;
+    }
+    if (ay >= az)
+    {
+        u = dir.x / ay;
+        v = (dir.y > 0.0f ? dir.z : -dir.z) / ay;
+        return dir.y > 0.0f ? 2u : 3u;
+    }
+    u = (dir.z > 0.0f ? dir.x : -dir.x) / az;
+    v = -dir.y / az;
+    return dir.z > 0.0f ? 4u : 5u;
+}
+
+static void RaySphereIntersect(const Float3& rayOrigin, const Float3& rayDir, f32 radius, f32& tNear, f32& tFar)
+{
+    const f32 b = Dot(rayOrigin, rayDir);
+    const f32 c = Dot(rayOrigin, rayOrigin) - radius * radius;
+    f32 h = b * b - c;
+    if (h < 0.0f)
+    {
+        tNear = 1.0f;
+        tFar = -1.0f;
+        return;
+    }
+    h = std::sqrt(h);
+    tNear = -b - h;
+    tFar = -b + h;
+}
+
+static Float3 IntegrateAtmosphereSingleScattering(const Float3& viewDir, const Float3& sunDir, f32 sunIntensity, const Environment::SkySettings::AtmosphereSettings& atmosphere, bool withMie)
+{
+    const Float3 betaR = Max(atmosphere.rayleighScattering, Float3{});
+    const Float3 betaM = withMie ? Max(atmosphere.mieScattering, Float3{}) : Float3{};
+    const f32 Hr = std::max(atmosphere.rayleighScaleHeightKm, 0.05f);
+    const f32 Hm = std::max(atmosphere.mieScaleHeightKm, 0.02f);
+    const Float3 betaO = Max(atmosphere.ozoneAbsorption, Float3{});
+    const f32 ozoneCenter = std::max(atmosphere.ozoneLayerCenterKm, 0.0f);
+    const f32 ozoneWidth = std::max(atmosphere.ozoneLayerWidthKm, 0.1f);
+    const f32 g = withMie ? std::clamp(atmosphere.mieG, -0.98f, 0.98f) : 0.0f;
+    const f32 thicknessKm = std::max(atmosphere.atmosphereThicknessKm, 1.0f);
+    const f32 sunScale = std::max(atmosphere.sunIntensityScale, 0.0f);
+    const f32 msStrength = std::max(atmosphere.multiScatteringStrength, 0.0f);
+
+    constexpr f32 planetRadiusKm = 6360.0f;
+    constexpr f32 cameraAltitudeKm = 0.001f;
+    const f32 atmosphereRadiusKm = planetRadiusKm + thicknessKm;
+
+    const Float3 rayOrigin = {0.0f, planetRadiusKm + cameraAltitudeKm, 0.0f};
+    const Float3 rayDir = Normalize(viewDir);
+    const Float3 sunViewDir = Normalize(-sunDir);
+
+    f32 atmNear = 0.0f;
+    f32 atmFar = 0.0f;
+    RaySphereIntersect(rayOrigin, rayDir, atmosphereRadiusKm, atmNear, atmFar);
+    if (atmNear > atmFar)
+    {
+        return {};
+    }
+
+    const f32 tMin = std::max(atmNear, 0.0f);
+    f32 tMax = std::max(atmFar, 0.0f);
+    if (tMax <= tMin)
+    {
+        return {};
+    }
+
+    f32 groundNear = 0.0f;
+    f32 groundFar = 0.0f;
+    RaySphereIntersect(rayOrigin, rayDir, planetRadiusKm, groundNear, groundFar);
+    if (groundNear > 0.0f)
+    {
+        tMax = std::min(tMax, groundNear);
+    }
+    if (tMax <= tMin)
+    {
+        return {};
+    }
+
+    const f32 mu = Dot(rayDir, sunViewDir);
+    const f32 phaseR = (3.0f / (16.0f * kPi)) * (1.0f + mu * mu);
+    const f32 g2 = g * g;
+    const f32 denomM = std::pow(std::max(1e-4f, 1.0f + g2 - 2.0f * g * mu), 1.5f);
+    const f32 phaseM = (1.0f - g2) / (4.0f * kPi * denomM);
+
+    const f32 segmentLength = (tMax - tMin) / static_cast<f32>(kAtmosphereViewSteps);
+    f32 opticalDepthR = 0.0f;
+    f32 opticalDepthM = 0.0f;
+    f32 opticalDepthO = 0.0f;
+    Float3 radiance{};
+    Float3 multiScatterAccum{};
+
+    for (u32 i = 0; i < kAtmosphereViewSteps; ++i)
+    {
+        const f32 t = tMin + (static_cast<f32>(i) + 0.5f) * segmentLength;
+        const Float3 samplePos = rayOrigin + rayDir * t;
+        const f32 heightKm = std::max(0.0f, Length(samplePos) - planetRadiusKm);
+        const f32 densityR = std::exp(-heightKm / Hr);
+        const f32 densityM = std::exp(-heightKm / Hm);
+        const f32 ozoneX = (heightKm - ozoneCenter) / ozoneWidth;
+        const f32 densityO = std::exp(-0.5f * ozoneX * ozoneX);
+
+        opticalDepthR += densityR * segmentLength;
+        opticalDepthM += densityM * segmentLength;
+        opticalDepthO += densityO * segmentLength;
+
+        const f32 towardPlanet = (Dot(samplePos, sunViewDir) <= 0.0f) ? 1.0f : 0.0f;
+        const f32 lineClearanceKm = Length(Cross(samplePos, sunViewDir)) - planetRadiusKm;
+        const f32 sunBlocked = towardPlanet * (1.0f - SmoothStep(-1.5f, 1.5f, lineClearanceKm));
+        const f32 sunVisibility = Saturate(1.0f - sunBlocked);
+        if (sunVisibility <= 1e-4f)
+        {
+            continue;
+        }
+
+        f32 sunAtmNear = 0.0f;
+        f32 sunAtmFar = 0.0f;
+        RaySphereIntersect(samplePos, sunViewDir, atmosphereRadiusKm, sunAtmNear, sunAtmFar);
+        const f32 tSunMax = std::max(sunAtmFar, 0.0f);
+        if (tSunMax <= 0.0f)
+        {
+            continue;
+        }
+
+        const f32 sunSegmentLength = tSunMax / static_cast<f32>(kAtmosphereSunSteps);
+        f32 opticalDepthRToSun = 0.0f;
+        f32 opticalDepthMToSun = 0.0f;
+        f32 opticalDepthOToSun = 0.0f;
+        for (u32 j = 0; j < kAtmosphereSunSteps; ++j)
+        {
+            const f32 tSun = (static_cast<f32>(j) + 0.5f) * sunSegmentLength;
+            const f32 sunHeightKm = std::max(0.0f, Length(samplePos + sunViewDir * tSun) - planetRadiusKm);
+            opticalDepthRToSun += std::exp(-sunHeightKm / Hr) * sunSegmentLength;
+            opticalDepthMToSun += std::exp(-sunHeightKm / Hm) * sunSegmentLength;
+            const f32 ozoneXSun = (sunHeightKm - ozoneCenter) / ozoneWidth;
+            opticalDepthOToSun += std::exp(-0.5f * ozoneXSun * ozoneXSun) * sunSegmentLength;
+        }
+
+        const Float3 tau = betaR * (opticalDepthR + opticalDepthRToSun) + betaM * (opticalDepthM + opticalDepthMToSun) + betaO * (opticalDepthO + opticalDepthOToSun);
+        const Float3 transmittance = Exp(-tau);
+        const Float3 scattering = betaR * (densityR * phaseR) + betaM * (densityM * phaseM);
+        const Float3 single = transmittance * scattering * (segmentLength * sunVisibility);
+        radiance += single;
+        multiScatterAccum += single * (Float3{1.0f, 1.0f, 1.0f} - transmittance);
+    }
+
+    const f32 sunStrength = std::max(0.0f, sunIntensity) * sunScale;
+    const Float3 result = Max((radiance + multiScatterAccum * msStrength) * sunStrength, Float3{});
+    return AnyInvalid3(result) ? Float3{} : result;
+}
+
+static Float3 EvaluateSkyTexel(const Float3& viewDir, const Environment& env, f32 sunIntensity, u32 skyCubeSize)
+{
+    const Environment::SkySettings& sky = env.sky;
+    const Float3 dir = Normalize(viewDir);
+    const bool isUpperHemisphere = dir.y >= 0.0f;
+
+    // Mirror the lower hemisphere and suppress Mie there, like EvaluateProceduralSkyBase.
+    const Float3 mirroredDir = {dir.x, std::abs(dir.y), dir.z};
+    Float3 base = IntegrateAtmosphereSingleScattering(mirroredDir, env.sunDir, sunIntensity, sky.atmosphere, isUpperHemisphere);
+
+    if (isUpperHemisphere)
+    {
+        const Float3 sunColor = Max(sky.sunColor, Float3{});
+        const f32 sunDiskCosAngle = std::cos(ToRadians(std::clamp(sky.sunDiskAngleDeg, 0.001f, 12.0f)));
+        const f32 sunDot = Saturate(Dot(dir, Normalize(-env.sunDir)));
+
+        const f32 baseWidth = std::max(1e-5f, (1.0f - sunDiskCosAngle) * 0.5f);
+        const f32 minTexelAngleDeg = 22.5f / std::max(static_cast<f32>(skyCubeSize), 1.0f);
+        const f32 minTexelWidth = std::max(1e-8f, (1.0f - std::cos(ToRadians(minTexelAngleDeg))) * 0.5f);
+        const f32 diskWidth = std::max(baseWidth * std::max(kSunDiskSoftness, 0.01f), minTexelWidth);
+        const f32 sunDisk = SmoothStep(sunDiskCosAngle - diskWidth, sunDiskCosAngle + diskWidth, sunDot);
+        const f32 sunGlow = std::pow(sunDot, std::max(sky.sunGlowPower, 1.0f));
+
+        const f32 sunStrength = std::max(0.0f, sunIntensity) * std::max(0.0f, sky.sunDiskIntensityScale);
+        base += sunColor * (sunStrength * sunDisk + std::max(0.0f, sky.sunGlowIntensity) * sunStrength * sunGlow);
+    }
+    return Max(base, Float3{});
+}
+
+template <typename Fn> static void ParallelFor(u32 count, u32 threadCount, Fn&& fn)
+{
+    std::atomic<u32> next{0};
+    auto worker = [&](u32 threadIndex) {
+        for (;;)
+        {
+            const u32 i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count)
+                break;
+            fn(i, threadIndex);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+    for (u32 t = 1; t < threadCount; ++t)
+        threads.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& t : threads)
+        t.join();
+}
+
+static SkyCube BakeSkyCube(const Environment& env, f32 sunIntensity, u32 size, u32 threadCount)
+{
+    SkyCube cube{};
+    cube.size = size;
+    cube.texels.resize(static_cast<size_t>(size) * size * 6);
+    ParallelFor(size * 6, threadCount, [&](u32 row, u32) {
+        const u32 face = row / size;
+        const u32 y = row % size;
+        for (u32 x = 0; x < size; ++x)
+        {
+            const f32 u = (static_cast<f32>(x) + 0.5f) / static_cast<f32>(size) * 2.0f - 1.0f;
+            const f32 v = (static_cast<f32>(y) + 0.5f) / static_cast<f32>(size) * 2.0f - 1.0f;
+            cube.texels[(static_cast<size_t>(face) * size + y) * size + x] = EvaluateSkyTexel(CubeFaceUvToDir(face, u, v), env, sunIntensity, size);
+        }
+    });
+    return cube;
+}
+
+static Float3 SampleSkyCube(const SkyCube& cube, const Float3& dir)
+{
+    f32 u = 0.0f;
+    f32 v = 0.0f;
+    const u32 face = DirToCubeFaceUv(dir, u, v);
+    const i32 size = static_cast<i32>(cube.size);
+    const f32 fx = (u * 0.5f + 0.5f) * cube.size - 0.5f;
+    const f32 fy = (v * 0.5f + 0.5f) * cube.size - 0.5f;
+    const f32 x0f = std::floor(fx);
+    const f32 y0f = std::floor(fy);
+    const f32 tx = fx - x0f;
+    const f32 ty = fy - y0f;
+    const i32 x0 = std::clamp(static_cast<i32>(x0f), 0, size - 1);
+    const i32 x1 = std::clamp(static_cast<i32>(x0f) + 1, 0, size - 1);
+    const i32 y0 = std::clamp(static_cast<i32>(y0f), 0, size - 1);
+    const i32 y1 = std::clamp(static_cast<i32>(y0f) + 1, 0, size - 1);
+
+    const Float3* faceTexels = cube.texels.data() + static_cast<size_t>(face) * cube.size * cube.size;
+    auto texel = [&](i32 x, i32 y) { return faceTexels[static_cast<size_t>(y) * cube.size + x]; };
+    return Lerp(Lerp(texel(x0, y0), texel(x1, y0), tx), Lerp(texel(x0, y1), texel(x1, y1), tx), ty);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// BVH4: binned SAH binary build collapsed into 4-wide nodes. Single rays test the four children of a node in one SIMD
+// slab test; 4-ray packets test one child against all four rays instead.
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct Aabb
+{
+    Float3 min = {FLT_MAX, FLT_MAX, FLT_MAX};
+    Float3 max = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+};
+
+static void Grow(Aabb& box, const Float3& p)
+{
+    box.min = Min(box.min, p);
+    box.max = Max(box.max, p);
+}
+
+static void Grow(Aabb& box, const Aabb& other)
+{
+    Grow(box, other.min);
+    Grow(box, other.max);
+}
+
+static f32 SurfaceArea(const Aabb& box)
+{
+    const f32 dx = std::max(box.max.x - box.min.x, 0.0f);
+    const f32 dy = std::max(box.max.y - box.min.y, 0.0f);
+    const f32 dz = std::max(box.max.z - box.min.z, 0.0f);
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+struct alignas(16) Bvh4Node
+{
+    f32 minX[kBvhWidth];
+    f32 minY[kBvhWidth];
+    f32 minZ[kBvhWidth];
+    f32 maxX[kBvhWidth];
+    f32 maxY[kBvhWidth];
+    f32 maxZ[kBvhWidth];
+    u32 child[kBvhWidth];     // node index for inner slots, first entry of itemIndices for leaf slots
+    u32 itemCount[kBvhWidth]; // 0 for inner slots
+    u32 childCount;
+};
+
+struct Bvh4
+{
+    Vector<Bvh4Node> nodes;
+    Vector<u32> itemIndices;
+    Aabb bounds;
+};
+
+struct BinaryBvhNode
+{
+    Aabb bounds;
+    u32 left = 0;
+    u32 right = 0;
+    u32 first = 0;
+    u32 count = 0; // > 0 for leaves
+};
+
+struct BvhBuildContext
+{
+    const Vector<Aabb>* itemBounds = nullptr;
+    Vector<Float3> centroids;
+    Vector<u32> items;
+    Vector<BinaryBvhNode> nodes;
+};
+
+static u32 BuildBinaryNode(BvhBuildContext& ctx, u32 first, u32 count)
+{
+    const Vector<Aabb>& itemBounds = *ctx.itemBounds;
+    const u32 nodeIndex = static_cast<u32>(ctx.nodes.size());
+    ctx.nodes.emplace_back();
+
+    Aabb bounds{};
+    Aabb centroidBounds{};
+    for (u32 i = first; i < first + count; ++i)
+    {
+        Grow(bounds, itemBounds[ctx.items[i]]);
+        Grow(centroidBounds, ctx.centroids[ctx.items[i]]);
+    }
+    ctx.nodes[nodeIndex].bounds = bounds;
+
+    auto makeLeaf = [&] {
+        ctx.nodes[nodeIndex].first = first;
+        ctx.nodes[nodeIndex].count = count;
+        return nodeIndex;
+    };
+    if (count == 1)
+    {
+        return makeLeaf();
+    }
+
+    f32 bestCost = FLT_MAX;
+    u32 bestAxis = 0;
+    u32 bestSplit = 0;
+    for (u32 axis = 0; axis < 3; ++axis)
+    {
+        const f32 cmin = Axis(centroidBounds.min, axis);
+        const f32 extent = Axis(centroidBounds.max, axis) - cmin;
+        if (extent <= 1e-12f)
+        {
+            continue;
+        }
+
+        Array<Aabb, kBvhSahBins> binBounds{};
+        Array<u32, kBvhSahBins> binCounts{};
+        const f32 scale = static_cast<f32>(kBvhSahBins) / extent;
+        for (u32 i = first; i < first + count; ++i)
+        {
+            const u32 item = ctx.items[i];
+            const u32 bin = std::min(kBvhSahBins - 1, static_cast<u32>((Axis(ctx.centroids[item], axis) - cmin) * scale));
+            ++binCounts[bin];
+            Grow(binBounds[bin], itemBounds[item]);
+        }
+
+        Array<f32, kBvhSahBins - 1> leftArea{};
+        Array<u32, kBvhSahBins - 1> leftCount{};
+        Aabb acc{};
+        u32 n = 0;
+        for (u32 b = 0; b < kBvhSahBins - 1; ++b)
+        {
+            Grow(acc, binBounds[b]);
+            n += binCounts[b];
+            leftArea[b] = n ? SurfaceArea(acc) : 0.0f;
+            leftCount[b] = n;
+        }
+
+        acc = Aabb{};
+        n = 0;
+        for (u32 b = kBvhSahBins - 1; b > 0; --b)
+        {
+            Grow(acc, binBounds[b]);
+            n += binCounts[b];
+            if (leftCount[b - 1] == 0 || n == 0)
+            {
+                continue;
+            }
+            const f32 cost = static_cast<f32>(leftCount[b - 1]) * leftArea[b - 1] + static_cast<f32>(n) * SurfaceArea(acc);
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = b;
+            }
+        }
+    }
+
+    u32 mid = first + count / 2;
+    if (bestCost < FLT_MAX)
+    {
+        const f32 splitCost = kBvhTraversalCost + bestCost / std::max(SurfaceArea(bounds), 1e-20f);
+        if (count <= kBvhMaxLeafItems && static_cast<f32>(count) <= splitCost)
+        {
+            return makeLeaf();
+        }
+
+        const f32 cmin = Axis(centroidBounds.min, bestAxis);
+        const f32 scale = static_cast<f32>(kBvhSahBins) / (Axis(centroidBounds.max, bestAxis) - cmin);
+        auto* splitIt = std::partition(ctx.items.data() + first, ctx.items.data() + first + count, [&](u32 item) {
+            return std::min(kBvhSahBins - 1, static_cast<u32>((Axis(ctx.centroids[item], bestAxis) - cmin) * scale)) < bestSplit;
+        });
+        mid = static_cast<u32>(splitIt - ctx.items.data());
+    }
+    else if (count <= kBvhMaxLeafItems)
+    {
+        // All centroids coincide; only an arbitrary split is left.
+        return makeLeaf();
+    }
+
+    const u32 left = BuildBinaryNode(ctx, first, mid - first);
+    const u32 right = BuildBinaryNode(ctx, mid, first + count - mid);
+    ctx.nodes[nodeIndex].left = left;
+    ctx.nodes[nodeIndex].right = right;
+    return nodeIndex;
+}
+
+static u32 CollapseToBvh4(const BvhBuildContext& ctx, u32 binaryIndex, Bvh4& out)
+{
+    Array<u32, kBvhWidth> slots{};
+    u32 slotCount = 0;
+    const BinaryBvhNode& root = ctx.nodes[binaryIndex];
+    if (root.count > 0)
+    {
+        slots[slotCount++] = binaryIndex;
+    }
+    else
+    {
+        slots[slotCount++] = root.left;
+        slots[slotCount++] = root.right;
+        while (slotCount < kBvhWidth)
+        {
+            // Open the inner child with the largest surface area.
+            i32 best = -1;
+            f32 bestArea = -1.0f;
+            for (u32 s = 0; s < slotCount; ++s)
+            {
+                const BinaryBvhNode& n = ctx.nodes[slots[s]];
+                const f32 area = SurfaceArea(n.bounds);
+                if (n.count == 0 && area > bestArea)
+                {
+                    best = static_cast<i32>(s);
+                    bestArea = area;
+                }
+            }
+            if (best < 0)
+            {
+                break;
+            }
+            const BinaryBvhNode& opened = ctx.nodes[slots[best]];
+            slots[best] = opened.left;
+            slots[slotCount++] = opened.right;
+        }
+    }
+
+    const u32 wideIndex = static_cast<u32>(out.nodes.size());
+    out.nodes.emplace_back();
+    out.nodes[wideIndex] = Bvh4Node{};
+    for (u32 s = 0; s < slotCount; ++s)
+    {
+        const BinaryBvhNode& n = ctx.nodes[slots[s]];
+        const u32 child = (n.count > 0) ? n.first : CollapseToBvh4(ctx, slots[s], out);
+
+        // Re-fetch: the recursion above may have reallocated the node array.
+        Bvh4Node& wide = out.nodes[wideIndex];
+        wide.minX[s] = n.bounds.min.x;
+        wide.minY[s] = n.bounds.min.y;
+        wide.minZ[s] = n.bounds.min.z;
+        wide.maxX[s] = n.bounds.max.x;
+        wide.maxY[s] = n.bounds.max.y;
+        wide.maxZ[s] = n.bounds.max.z;
+        wide.child[s] = child;
+        wide.itemCount[s] = n.count;
+    }
+    out.nodes[wideIndex].childCount = slotCount;
+    return wideIndex;
+}
+
+static Bvh4 BuildBvh4(const Vector<Aabb>& itemBounds)
+{
+    Bvh4 bvh{};
+    if (itemBounds.empty())
+    {
+        return bvh;
+    }
+
+    const u32 itemCount = static_cast<u32>(itemBounds.size());
+    BvhBuildContext ctx{};
+    ctx.itemBounds = &itemBounds;
+    ctx.centroids.resize(itemCount);
+    for (u32 i = 0; i < itemCount; ++i)
+    {
+        ctx.centroids[i] = (itemBounds[i].min + itemBounds[i].max) * 0.5f;
+    }
+    ctx.items.resize(itemCount);
+    std::iota(ctx.items.begin(), ctx.items.end(), 0u);
+    ctx.nodes.reserve(static_cast<size_t>(itemCount) * 2);
+
+    const u32 root = BuildBinaryNode(ctx, 0, itemCount);
+    bvh.bounds = ctx.nodes[root].bounds;
+    bvh.nodes.reserve(ctx.nodes.size() / 2 + 1);
+    CollapseToBvh4(ctx, root, bvh);
+    bvh.itemIndices = std::move(ctx.items);
+    return bvh;
+}
+
+// Avoid infinities so 0 * inf never turns a slab into NaN.
+static f32 SafeInverse(f32 v)
+{
+    return 1.0f / ((std::abs(v) > 1e-20f) ? v : std::copysign(1e-20f, v));
+}
+
+struct RayBoxSetup
+{
+    Lane4 ox, oy, oz;
+    Lane4 invX, invY, invZ;
+    Lane4 tMin;
+};
+
+static RayBoxSetup MakeRayBoxSetup(const Float3& origin, const Float3& dir, f32 tMin)
+{
+    return {LaneSplat(origin.x), LaneSplat(origin.y), LaneSplat(origin.z), LaneSplat(SafeInverse(dir.x)), LaneSplat(SafeInverse(dir.y)), LaneSplat(SafeInverse(dir.z)), LaneSplat(tMin)};
+}
+
+// Slab test shared by both traversals: lanes are children for single rays and rays for packets.
+static u32 IntersectSlabs(const RayBoxSetup& ray, Lane4 minX, Lane4 minY, Lane4 minZ, Lane4 maxX, Lane4 maxY, Lane4 maxZ, Lane4 tMax, Lane4& outEntry)
+{
+    const Lane4 t0x = (minX - ray.ox) * ray.invX;
+    const Lane4 t1x = (maxX - ray.ox) * ray.invX;
+    const Lane4 t0y = (minY - ray.oy) * ray.invY;
+    const Lane4 t1y = (maxY - ray.oy) * ray.invY;
+    const Lane4 t0z = (minZ - ray.oz) * ray.invZ;
+    const Lane4 t1z = (maxZ - ray.oz) * ray.invZ;
+
+    const Lane4 tNear = LaneMax(LaneMax(LaneMin(t0x, t1x), LaneMin(t0y, t1y)), LaneMax(LaneMin(t0z, t1z), ray.tMin));
+    const Lane4 tFar = LaneMin(LaneMin(LaneMax(t0x, t1x), LaneMax(t0y, t1y)), LaneMin(LaneMax(t0z, t1z), tMax));
+    outEntry = tNear;
+    return LaneLessEqual(tNear, tFar);
+}
+
+// Visits leaf items front to back. visitItem(itemIndex, tMax) may shrink tMax and returns true to stop the traversal.
+template <typename VisitFn> static bool TraverseBvh4(const Bvh4& bvh, const Float3& origin, const Float3& dir, f32 tMin, f32& tMax, VisitFn&& visitItem)
+{
+    if (bvh.nodes.empty())
+    {
+        return false;
+    }
+
+    const RayBoxSetup setup = MakeRayBoxSetup(origin, dir, tMin);
+    Array<u32, kBvhStackSize> stack;
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0)
+    {
+        const Bvh4Node& node = bvh.nodes[stack[--stackSize]];
+        Lane4 entry{};
+        const u32 hitMask = IntersectSlabs(setup, LaneLoad(node.minX), LaneLoad(node.minY), LaneLoad(node.minZ), LaneLoad(node.maxX), LaneLoad(node.maxY), LaneLoad(node.maxZ),
+                                           LaneSplat(tMax), entry) &
+                            ((1u << node.childCount) - 1u);
+        if (hitMask == 0)
+        {
+            continue;
+        }
+
+        alignas(16) f32 entryLanes[kBvhWidth];
+        LaneStore(entryLanes, entry);
+        Array<u32, kBvhWidth> order{};
+        u32 orderCount = 0;
+        for (u32 s = 0; s < kBvhWidth; ++s)
+        {
+            if ((hitMask & (1u << s)) == 0)
+            {
+                continue;
+            }
+            u32 k = orderCount++;
+            while (k > 0 && entryLanes[order[k - 1]] > entryLanes[s])
+            {
+                order[k] = order[k - 1];
+                --k;
+            }
+            order[k] = s;
+        }
+
+        Array<u32, kBvhWidth> inner{};
+        u32 innerCount = 0;
+        for (u32 i = 0; i < orderCount; ++i)
+        {
+            const u32 s = order[i];
+            if (entryLanes[s] > tMax)
+            {
+                continue;
+            }
+            if (node.itemCount[s] == 0)
+            {
+                inner[innerCount++] = node.child[s];
+                continue;
+            }
+            for (u32 k = 0; k < node.itemCount[s]; ++k)
+            {
+                if (visitItem(bvh.itemIndices[node.child[s] + k], tMax))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Push far to near so the nearest child is popped first.
+        Require(stackSize + innerCount <= kBvhStackSize, "BVH traversal stack overflow");
+        for (u32 i = innerCount; i-- > 0;)
+        {
+            stack[stackSize++] = inner[i];
+        }
+    }
+    return false;
+}
+
+// Four rays in structure-of-arrays form; lanes outside the active mask are ignored.
+struct alignas(16) RayPacket
+{
+    f32 ox[kPacketSize];
+    f32 oy[kPacketSize];
+    f32 oz[kPacketSize];
+    f32 dx[kPacketSize];
+    f32 dy[kPacketSize];
+    f32 dz[kPacketSize];
+    f32 tMin[kPacketSize];
+    f32 tMax[kPacketSize];
+
+    Float3 Origin(u32 lane) const { return {ox[lane], oy[lane], oz[lane]}; }
+    Float3 Direction(u32 lane) const { return {dx[lane], dy[lane], dz[lane]}; }
+    void SetRay(u32 lane, const Float3& origin, const Float3& dir, f32 rayTMin, f32 rayTMax)
+    {
+        ox[lane] = origin.x;
+        oy[lane] = origin.y;
+        oz[lane] = origin.z;
+        dx[lane] = dir.x;
+        dy[lane] = dir.y;
+        dz[lane] = dir.z;
+        tMin[lane] = rayTMin;
+        tMax[lane] = rayTMax;
+    }
+};
+
+// Packet counterpart of TraverseBvh4. visitItem(itemIndex, laneMask) may shrink packet.tMax for those lanes and returns
+// the lanes that are done (any-hit queries), which are dropped from the rest of the traversal.
+template <typename VisitFn> static void TraverseBvh4Packet(const Bvh4& bvh, RayPacket& packet, u32 laneMask, VisitFn&& visitItem)
+{
+    if (bvh.nodes.empty() || laneMask == 0)
+    {
+        return;
+    }
+
+    alignas(16) f32 inv[3][kPacketSize];
+    for (u32 lane = 0; lane < kPacketSize; ++lane)
+    {
+        inv[0][lane] = SafeInverse(packet.dx[lane]);
+        inv[1][lane] = SafeInverse(packet.dy[lane]);
+        inv[2][lane] = SafeInverse(packet.dz[lane]);
+    }
+    const RayBoxSetup setup = {LaneLoad(packet.ox), LaneLoad(packet.oy), LaneLoad(packet.oz), LaneLoad(inv[0]), LaneLoad(inv[1]), LaneLoad(inv[2]), LaneLoad(packet.tMin)};
+
+    struct StackEntry
+    {
+        u32 node;
+        u32 laneMask;
+    };
+    Array<StackEntry, kBvhStackSize> stack;
+    u32 stackSize = 0;
+    stack[stackSize++] = {0, laneMask};
+    u32 activeMask = laneMask;
+
+    while (stackSize > 0)
+    {
+        const StackEntry top = stack[--stackSize];
+        const u32 nodeMask = top.laneMask & activeMask;
+        if (nodeMask == 0)
+        {
+            continue;
+        }
+
+        const Bvh4Node& node = bvh.nodes[top.node];
+        const Lane4 tMax = LaneLoad(packet.tMax);
+        Array<u32, kBvhWidth> childMask{};
+        Array<f32, kBvhWidth> childEntry{};
+        Array<u32, kBvhWidth> order{};
+        u32 orderCount = 0;
+        for (u32 s = 0; s < node.childCount; ++s)
+        {
+            Lane4 entry{};
+            childMask[s] = IntersectSlabs(setup, LaneSplat(node.minX[s]), LaneSplat(node.minY[s]), LaneSplat(node.minZ[s]), LaneSplat(node.maxX[s]), LaneSplat(node.maxY[s]),
+                                          LaneSplat(node.maxZ[s]), tMax, entry) &
+                           nodeMask;
+            if (childMask[s] == 0)
+            {
+                continue;
+            }
+
+            // Order children by the nearest entry among the rays that hit them.
+            alignas(16) f32 entryLanes[kPacketSize];
+            LaneStore(entryLanes, entry);
+            childEntry[s] = FLT_MAX;
+            for (u32 lane = 0; lane < kPacketSize; ++lane)
+            {
+                if (childMask[s] & (1u << lane))
+                    childEntry[s] = std::min(childEntry[s], entryLanes[lane]);
+            }
+            u32 k = orderCount++;
+            while (k > 0 && childEntry[order[k - 1]] > childEntry[s])
+            {
+                order[k] = order[k - 1];
+                --k;
+            }
+            order[k] = s;
+        }
+
+        Array<StackEntry, kBvhWidth> inner{};
+        u32 innerCount = 0;
+        for (u32 i = 0; i < orderCount; ++i)
+        {
+            const u32 s = order[i];
+            if (node.itemCount[s] == 0)
+            {
+                inner[innerCount++] = {node.child[s], childMask[s]};
+                continue;
+            }
+            for (u32 k = 0; k < node.itemCount[s]; ++k)
+            {
+                const u32 itemMask = childMask[s] & activeMask;
+                if (itemMask == 0)
+                {
+                    break;
+                }
+                activeMask &= ~visitItem(bvh.itemIndices[node.child[s] + k], itemMask);
+                if (activeMask == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        Require(stackSize + innerCount <= kBvhStackSize, "BVH traversal stack overflow");
+        for (u32 i = innerCount; i-- > 0;)
+        {
+            stack[stackSize++] = inner[i];
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Scene
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct TracerInstance
+{
+    Float4x4 world;
+    Float4x4 worldInv;
+    Float4x4 normalToWorld; // transpose(worldInv)
+    f32 worldSign = 1.0f;
+    u32 primIndex = 0;
+    u32 materialIndex = 0;
+};
+
+struct TracerScene
+{
+    PackScene loaded;
+    Vector<DecodedTexture> textures;
+    Vector<TracerInstance> instances;
+    Vector<Bvh4> blases; // per primitive, object space
+    Bvh4 tlas;           // over instance world bounds
+    SkyCube sky;
+    Environment environment;
+};
+
+struct TraceHit
+{
+    f32 t = 0.0f;
+    u32 instanceIndex = 0;
+    u32 triangleIndex = 0;
+    f32 b1 = 0.0f;
+    f32 b2 = 0.0f;
+    bool frontFace = true;
+};
+
+enum TraceFlags : u32
+{
+    TraceFlags_None = 0,
+    TraceFlags_AcceptFirstHit = 1u << 0,
+    // Primary visibility comes from the rasterizer, which culls back faces of single-sided materials.
+    TraceFlags_CullBackFacingSingleSided = 1u << 1,
+};
+
+static const TracerPack::SamplerRecord& DefaultWrapSampler()
+{
+    static const TracerPack::SamplerRecord desc = [] {
+        TracerPack::SamplerRecord d{};
+        d.filter = TracerPack::kFilterMinMagMipLinear;
+        d.addressU = TracerPack::AddressMode_Wrap;
+        d.addressV = TracerPack::AddressMode_Wrap;
+        d.addressW = TracerPack::AddressMode_Wrap;
+        d.maxLod = FLT_MAX;
+        return d;
+    }();
+    return desc;
+}
+
+static Float4 SampleMaterialTexture(const TracerScene& scene, i32 textureIndex, i32 samplerIndex, const Float2& uv)
+{
+    const TracerPack::SamplerRecord& sampler = (samplerIndex >= 0) ? scene.loaded.samplers[static_cast<size_t>(samplerIndex)] : DefaultWrapSampler();
+    return SampleTexture(scene.textures[static_cast<size_t>(textureIndex)], sampler, uv);
+}
+
+static Float3 VertexPosition(const Vertex& v)
+{
+    return {v.position[0], v.position[1], v.position[2]};
+}
+
+struct TriangleAttributes
+{
+    const Vertex* v[3];
+    f32 w[3]; // barycentric weights of v[0..2]
+    Float2 uv;
+    Float4 vertexColor;
+};
+
+static TriangleAttributes FetchTriangleAttributes(const TracerScene& scene, const TracerInstance& inst, u32 tri, f32 b1, f32 b2)
+{
+    const PackPrimitive& prim = scene.loaded.primitives[inst.primIndex];
+    TriangleAttributes a{};
+    for (u32 k = 0; k < 3; ++k)
+        a.v[k] = &prim.vertices[prim.indices[tri * 3 + k]];
+    a.w[0] = 1.0f - b1 - b2;
+    a.w[1] = b1;
+    a.w[2] = b2;
+
+    a.uv = {0.0f, 0.0f};
+    a.vertexColor = {};
+    for (u32 k = 0; k < 3; ++k)
+    {
+        const Float2 uv = DecodePackedHalf2(a.v[k]->texCoordPacked);
+        a.uv.x += uv.x * a.w[k];
+        a.uv.y += uv.y * a.w[k];
+        a.vertexColor = a.vertexColor + DecodePackedColorRGBA16Unorm(a.v[k]->colorPackedLo, a.v[k]->colorPackedHi) * a.w[k];
+    }
+    return a;
+}
+
+static Float4 LoadBaseColor(const TracerScene& scene, const PackMaterial& material, const TriangleAttributes& attr)
+{
+    Float4 baseColor = material.baseColorFactor;
+    if (material.baseColorTextureIndex != -1)
+    {
+        baseColor = baseColor * SampleMaterialTexture(scene, material.baseColorTextureIndex, material.baseColorSamplerIndex, attr.uv);
+    }
+    baseColor = baseColor * attr.vertexColor;
+    return AnyInvalid4(baseColor) ? Float4{} : baseColor;
+}
+
+static bool PassesAlphaTest(const TracerScene& scene, const TracerInstance& inst, u32 tri, f32 b1, f32 b2)
+{
+    const PackMaterial& material = scene.loaded.materials[inst.materialIndex];
+    if (!material.alphaMasked)
+    {
+        return true;
+    }
+    const TriangleAttributes attr = FetchTriangleAttributes(scene, inst, tri, b1, b2);
+    return LoadBaseColor(scene, material, attr).w >= material.alphaCutoff;
+}
+
+static bool IntersectTriangle(const Float3& origin, const Float3& dir, const Float3& p0, const Float3& p1, const Float3& p2, f32 tMin, f32 tMax, f32& outT, f32& outB1, f32& outB2)
+{
+    const Float3 e1 = p1 - p0;
+    const Float3 e2 = p2 - p0;
+    const Float3 pvec = Cross(dir, e2);
+    const f32 det = Dot(e1, pvec);
+    if (std::abs(det) < 1e-20f)
+    {
+        return false;
+    }
+
+    const f32 invDet = 1.0f / det;
+    const Float3 tvec = origin - p0;
+    const f32 b1 = Dot(tvec, pvec) * invDet;
+    if (b1 < 0.0f || b1 > 1.0f)
+    {
+        return false;
+    }
+
+    const Float3 qvec = Cross(tvec, e1);
+    const f32 b2 = Dot(dir, qvec) * invDet;
+    if (b2 < 0.0f || b1 + b2 > 1.0f)
+    {
+        return false;
+    }
+
+    const f32 t = Dot(e2, qvec) * invDet;
+    if (t <= tMin || t >= tMax)
+    {
+        return false;
+    }
+
+    outT = t;
+    outB1 = b1;
+    outB2 = b2;
+    return true;
+}
+
+// IntersectTriangle for every ray of a packet at once, with the same reject tests so both paths agree on every hit.
+static u32 IntersectTrianglePacket(const Lane4x3& origin, const Lane4x3& dir, const Float3& p0, const Float3& p1, const Float3& p2, Lane4 tMin, Lane4 tMax, Lane4& outT, Lane4& outB1,
+                                   Lane4& outB2)
+{
+    const Lane4 zero = LaneSplat(0.0f);
+    const Lane4 one = LaneSplat(1.0f);
+    const Lane4x3 e1 = LaneSplat(p1 - p0);
+    const Lane4x3 e2 = LaneSplat(p2 - p0);
+    const Lane4x3 pvec = Cross(dir, e2);
+    const Lane4 det = Dot(e1, pvec);
+    u32 reject = LaneLess(LaneAbs(det), LaneSplat(1e-20f));
+
+    const Lane4 invDet = one / det;
+    const Lane4x3 tvec = origin - LaneSplat(p0);
+    const Lane4 b1 = Dot(tvec, pvec) * invDet;
+    reject |= LaneLess(b1, zero) | LaneGreater(b1, one);
+
+    const Lane4x3 qvec = Cross(tvec, e1);
+    const Lane4 b2 = Dot(dir, qvec) * invDet;
+    reject |= LaneLess(b2, zero) | LaneGreater(b1 + b2, one);
+
+    const Lane4 t = Dot(e2, qvec) * invDet;
+    reject |= LaneLessEqual(t, tMin) | LaneGreaterEqual(t, tMax);
+
+    outT = t;
+    outB1 = b1;
+    outB2 = b2;
+    return ~reject & ((1u << kPacketSize) - 1u);
+}
+
+static bool TraceScene(const TracerScene& scene, const Float3& origin, const Float3& dir, f32 tMin, f32 tMax, u32 flags, TraceHit& outHit)
+{
+    bool found = false;
+    f32 closest = tMax;
+    TraverseBvh4(scene.tlas, origin, dir, tMin, closest, [&](u32 instanceIndex, f32& instanceTMax) -> bool {
+        const TracerInstance& inst = scene.instances[instanceIndex];
+        const PackPrimitive& prim = scene.loaded.primitives[inst.primIndex];
+        const PackMaterial& material = scene.loaded.materials[inst.materialIndex];
+
+        // The direction is transformed but not renormalized, so hit distances stay in world units.
+        const Float3 objOrigin = TransformPoint(origin, inst.worldInv);
+        const Float3 objDir = TransformVector(dir, inst.worldInv);
+
+        return TraverseBvh4(scene.blases[inst.primIndex], objOrigin, objDir, tMin, instanceTMax, [&](u32 tri, f32& triTMax) -> bool {
+            const Float3 p0 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 0]]);
+            const Float3 p1 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 1]]);
+            const Float3 p2 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 2]]);
+            f32 t = 0.0f;
+            f32 b1 = 0.0f;
+            f32 b2 = 0.0f;
+            if (!IntersectTriangle(objOrigin, objDir, p0, p1, p2, tMin, triTMax, t, b1, b2))
+            {
+                return false;
+            }
+
+            // Counter-clockwise object-space winding is front facing; the mesh shaders flip winding for mirrored instances.
+            const bool frontFace = Dot(Cross(p1 - p0, p2 - p0), objDir) < 0.0f;
+            if ((flags & TraceFlags_CullBackFacingSingleSided) && !frontFace && !material.doubleSided)
+            {
+                return false;
+            }
+            if (!PassesAlphaTest(scene, inst, tri, b1, b2))
+            {
+                return false;
+            }
+
+            triTMax = t;
+            outHit = {t, instanceIndex, tri, b1, b2, frontFace};
+            found = true;
+            return (flags & TraceFlags_AcceptFirstHit) != 0;
+        });
+    });
+    return found;
+}
+
+// Packet counterpart of TraceScene over the lanes in laneMask. Returns the lanes that hit; their hits land in outHits.
+static u32 TraceScenePacket(const TracerScene& scene, RayPacket& packet, u32 laneMask, u32 flags, TraceHit (&outHits)[kPacketSize])
+{
+    u32 foundMask = 0;
+    TraverseBvh4Packet(scene.tlas, packet, laneMask, [&](u32 instanceIndex, u32 instanceMask) -> u32 {
+        const TracerInstance& inst = scene.instances[instanceIndex];
+        const PackPrimitive& prim = scene.loaded.primitives[inst.primIndex];
+        const PackMaterial& material = scene.loaded.materials[inst.materialIndex];
+
+        RayPacket objPacket = packet;
+        for (u32 lane = 0; lane < kPacketSize; ++lane)
+        {
+            if (instanceMask & (1u << lane))
+                objPacket.SetRay(lane, TransformPoint(packet.Origin(lane), inst.worldInv), TransformVector(packet.Direction(lane), inst.worldInv), packet.tMin[lane], packet.tMax[lane]);
+        }
+        const Lane4x3 objOrigin = {LaneLoad(objPacket.ox), LaneLoad(objPacket.oy), LaneLoad(objPacket.oz)};
+        const Lane4x3 objDir = {LaneLoad(objPacket.dx), LaneLoad(objPacket.dy), LaneLoad(objPacket.dz)};
+
+        u32 doneMask = 0;
+        TraverseBvh4Packet(scene.blases[inst.primIndex], objPacket, instanceMask, [&](u32 tri, u32 triMask) -> u32 {
+            const Float3 p0 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 0]]);
+            const Float3 p1 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 1]]);
+            const Float3 p2 = VertexPosition(prim.vertices[prim.indices[tri * 3 + 2]]);
+            Lane4 t{};
+            Lane4 b1{};
+            Lane4 b2{};
+            const u32 hitMask = IntersectTrianglePacket(objOrigin, objDir, p0, p1, p2, LaneLoad(objPacket.tMin), LaneLoad(objPacket.tMax), t, b1, b2) & triMask;
+            if (hitMask == 0)
+            {
+                return 0u;
+            }
+
+            alignas(16) f32 tLanes[kPacketSize];
+            alignas(16) f32 b1Lanes[kPacketSize];
+            alignas(16) f32 b2Lanes[kPacketSize];
+            LaneStore(tLanes, t);
+            LaneStore(b1Lanes, b1);
+            LaneStore(b2Lanes, b2);
+            const Float3 faceN = Cross(p1 - p0, p2 - p0);
+            u32 finished = 0;
+            for (u32 lane = 0; lane < kPacketSize; ++lane)
+            {
+                if ((hitMask & (1u << lane)) == 0)
+                {
+                    continue;
+                }
+                const bool frontFace = Dot(faceN, objPacket.Direction(lane)) < 0.0f;
+                if ((flags & TraceFlags_CullBackFacingSingleSided) && !frontFace && !material.doubleSided)
+                {
+                    continue;
+                }
+                if (!PassesAlphaTest(scene, inst, tri, b1Lanes[lane], b2Lanes[lane]))
+                {
+                    continue;
+                }
+
+                objPacket.tMax[lane] = tLanes[lane];
+                outHits[lane] = {tLanes[lane], instanceIndex, tri, b1Lanes[lane], b2Lanes[lane], frontFace};
+                foundMask |= 1u << lane;
+                if (flags & TraceFlags_AcceptFirstHit)
+                    finished |= 1u << lane;
+            }
+            doneMask |= finished;
+            return finished;
+        });
+
+        for (u32 lane = 0; lane < kPacketSize; ++lane)
+        {
+            if (instanceMask & (1u << lane))
+                packet.tMax[lane] = objPacket.tMax[lane];
+        }
+        return doneMask;
+    });
+    return foundMask;
+}
+
+static void BuildAccelerationStructures(TracerScene& scene, u32 threadCount)
+{
+    const PackScene& loaded = scene.loaded;
+
+    scene.blases.resize(loaded.primitives.size());
+    ParallelFor(static_cast<u32>(loaded.primitives.size()), threadCount, [&](u32 primIndex, u32) {
+        const PackPrimitive& prim = loaded.primitives[primIndex];
+        Vector<Aabb> triBounds(prim.indexCount / 3);
+        for (u32 tri = 0; tri < triBounds.size(); ++tri)
+        {
+            for (u32 k = 0; k < 3; ++k)
+                Grow(triBounds[tri], VertexPosition(prim.vertices[prim.indices[tri * 3 + k]]));
+        }
+        scene.blases[primIndex] = BuildBvh4(triBounds);
+    });
+
+    scene.instances.clear();
+    scene.instances.reserve(loaded.instances.size());
+    Vector<Aabb> instanceBounds;
+    instanceBounds.reserve(loaded.instances.size());
+    for (const PackInstance& src : loaded.instances)
+    {
+        const Bvh4& blas = scene.blases[src.primIndex];
+        if (blas.nodes.empty())
+        {
+            continue;
+        }
+
+        TracerInstance inst{};
+        inst.world = src.world;
+        inst.primIndex = src.primIndex;
+        inst.materialIndex = src.materialIndex;
+        // Instance transforms are affine, so the sign of the upper 3x3 determinant is the handedness.
+        inst.worldSign = (Determinant3x3(src.world) < 0.0f) ? -1.0f : 1.0f;
+        inst.worldInv = Inverse(src.world);
+        inst.normalToWorld = Transpose(inst.worldInv);
+
+        Aabb worldBounds{};
+        for (u32 corner = 0; corner < 8; ++corner)
+        {
+            const Float3 local = {(corner & 1) ? blas.bounds.max.x : blas.bounds.min.x, (corner & 2) ? blas.bounds.max.y : blas.bounds.min.y,
+                                  (corner & 4) ? blas.bounds.max.z : blas.bounds.min.z};
+            Grow(worldBounds, TransformPoint(local, src.world));
+        }
+
+        scene.instances.push_back(inst);
+        instanceBounds.push_back(worldBounds);
+    }
+    scene.tlas = BuildBvh4(instanceBounds);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Path tracing (path_trace.rt.hlsl)
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct SurfaceState
+{
+    Float3 pos;
+    Float3 geoN;
+    Float3 albedo;
+    Float3 emissive;
+    f32 metalness = 0.0f;
+    f32 roughness = 0.0f;
+    Float3 N;
+    Float3 V;
+};
+
+struct BsdfSample
+{
+    Float3 wi;
+    Float3 f;
+    f32 pdf = 0.0f;
+    bool wasSpecular = false;
+};
+
+struct BsdfMixtureWeights
+{
+    f32 pDiffuse;
+    f32 pSpecular;
+};
+
+struct SunLightData
+{
+    Float3 axis;
+    f32 cosThetaMax = 1.0f;
+    Float3 coneRadiance;
+    f32 conePdf = 0.0f;
+    bool visible = false;
+};
+
+struct PathContext
+{
+    const TracerScene& scene;
+    const TracerSettings& settings;
+    Float3 cameraPos;
+    SunLightData sun;
+    u32 maxBounces;
+    u64 rayCount;
+};
+
+static f32 Pow5(f32 x)
+{
+    const f32 x2 = x * x;
+    return x2 * x2 * x;
+}
+
+static Float3 FresnelSchlick(const Float3& F0, f32 cosTheta)
+{
+    return F0 + (Float3{1.0f, 1.0f, 1.0f} - F0) * Pow5(1.0f - cosTheta);
+}
+
+static Float3 ComputeF0(const Float3& albedo, f32 metalness)
+{
+    return Lerp(Float3{0.04f, 0.04f, 0.04f}, albedo, metalness);
+}
+
+static f32 ComputeRussianRouletteSurvivalProbability(const Float3& throughput)
+{
+    return std::clamp(Saturate(MaxComponent(throughput)), 0.05f, 0.95f);
+}
+
+static f32 NdfGGX(f32 cosLh, f32 roughness)
+{
+    const f32 alpha = std::max(roughness * roughness, 1e-4f);
+    const f32 alphaSq = alpha * alpha;
+    const f32 denom = (cosLh * cosLh) * (alphaSq - 1.0f) + 1.0f;
+    return alphaSq / std::max(kPi * denom * denom, 1e-7f);
+}
+
+static f32 SmithLambdaGGX(f32 cosTheta, f32 roughness)
+{
+    const f32 safeCosTheta = std::max(Saturate(cosTheta), 1e-4f);
+    const f32 alpha = std::max(roughness * roughness, 1e-4f);
+    const f32 sinThetaSq = Saturate(1.0f - safeCosTheta * safeCosTheta);
+    const f32 tanThetaSq = sinThetaSq / std::max(safeCosTheta * safeCosTheta, 1e-6f);
+    return 0.5f * (std::sqrt(1.0f + alpha * alpha * tanThetaSq) - 1.0f);
+}
+
+static f32 SmithG1GGX(f32 cosTheta, f32 roughness)
+{
+    return 1.0f / (1.0f + SmithLambdaGGX(cosTheta, roughness));
+}
+
+static f32 SmithGGX(f32 cosLi, f32 cosV, f32 roughness)
+{
+    return SmithG1GGX(cosLi, roughness) * SmithG1GGX(cosV, roughness);
+}
+
+static f32 ComputeShadowOriginBias(const PathContext& ctx, const Float3& hitPos, const Float3& geoNormal, const Float3& rayDir)
+{
+    const Float3 lightDir = Normalize(rayDir);
+    Float3 geoN = geoNormal;
+    if (Dot(geoN, lightDir) < 0.0f)
+    {
+        geoN = -geoN;
+    }
+
+    const f32 viewDist = Length(hitPos - ctx.cameraPos);
+    const f32 baseBias = std::max(kDirectShadowRayMinBias, kDirectShadowRayViewBiasScale * viewDist);
+    const f32 slopeScale = 1.0f + 2.0f * (1.0f - Saturate(Dot(geoN, lightDir)));
+    return baseBias * slopeScale;
+}
+
+static Float3 SampleSkyBackground(const PathContext& ctx, const Float3& dir)
+{
+    return SampleSkyCube(ctx.scene.sky, dir) * ctx.settings.skyIntensity;
+}
+
+static Float3 NormalizeSunTint(const Float3& sunColor)
+{
+    const Float3 tint = Max(sunColor, Float3{});
+    const f32 luminance = Luminance(tint);
+    return (luminance > 1e-4f) ? tint / luminance : Float3{};
+}
+
+static SunLightData BuildSunLightData(const Environment& env, const TracerSettings& settings)
+{
+    SunLightData sun{};
+    const Float3 sunColor = env.sky.sunColor;
+    sun.axis = Normalize(-env.sunDir);
+    sun.visible = settings.sunIntensity > 0.0f && MaxComponent(sunColor) > 0.0f && sun.axis.y > 0.0f;
+    sun.cosThetaMax = std::cos(ToRadians(std::clamp(env.sky.sunDiskAngleDeg, 0.001f, 12.0f)));
+    const f32 solidAngle = 2.0f * kPi * std::max(1.0f - sun.cosThetaMax, 1e-6f);
+    sun.coneRadiance = NormalizeSunTint(sunColor) * settings.sunIntensity / solidAngle;
+    sun.conePdf = 1.0f / solidAngle;
+    return sun;
+}
+
+static f32 CosineHemispherePdf(f32 cosTheta)
+{
+    return Saturate(cosTheta) * kInvPi;
+}
+
+static f32 PowerHeuristic(f32 pdfA, f32 pdfB)
+{
+    const f32 a2 = pdfA * pdfA;
+    const f32 b2 = pdfB * pdfB;
+    return a2 / std::max(a2 + b2, 1e-6f);
+}
+
+static Float3 SampleCosineHemisphereWorld(f32 u0, f32 u1, const Float3& n)
+{
+    Float3 t{};
+    Float3 b{};
+    BuildOrthonormalBasis(n, t, b);
+    const f32 r = std::sqrt(u0);
+    const f32 a = 2.0f * kPi * u1;
+    return t * (r * std::cos(a)) + b * (r * std::sin(a)) + n * std::sqrt(std::max(0.0f, 1.0f - u0));
+}
+
+static Float3 SampleGGXVNDFWorld(const Float3& V, const Float3& N, f32 roughness, f32 u0, f32 u1)
+{
+    Float3 T{};
+    Float3 B{};
+    BuildOrthonormalBasis(N, T, B);
+    const Float3 Vlocal = Normalize({Dot(V, T), Dot(V, B), Dot(V, N)});
+
+    const f32 alpha = std::max(roughness * roughness, 1e-4f);
+    const Float3 Vh = Normalize({alpha * Vlocal.x, alpha * Vlocal.y, Vlocal.z});
+    const f32 lensq = Vh.x * Vh.x + Vh.y * Vh.y;
+    const Float3 T1 = (lensq > 0.0f) ? Float3{-Vh.y, Vh.x, 0.0f} / std::sqrt(lensq) : Float3{1.0f, 0.0f, 0.0f};
+    const Float3 T2 = Cross(Vh, T1);
+
+    const f32 r = std::sqrt(u0);
+    const f32 phi = 2.0f * kPi * u1;
+    const f32 t1 = r * std::cos(phi);
+    f32 t2 = r * std::sin(phi);
+    const f32 s = 0.5f * (1.0f + Vh.z);
+    t2 = std::lerp(std::sqrt(Saturate(1.0f - t1 * t1)), t2, s);
+
+    const Float3 Nh = T1 * t1 + T2 * t2 + Vh * std::sqrt(Saturate(1.0f - t1 * t1 - t2 * t2));
+    const Float3 Hlocal = Normalize({alpha * Nh.x, alpha * Nh.y, std::max(Nh.z, 0.0f)});
+    return Normalize(T * Hlocal.x + B * Hlocal.y + N * Hlocal.z);
+}
+
+static Float3 EvaluateDiffuseBrdf(const SurfaceState& surface, const Float3& wi)
+{
+    const Float3 H = Normalize(wi + surface.V);
+    const Float3 F = FresnelSchlick(ComputeF0(surface.albedo, surface.metalness), Saturate(Dot(surface.V, H)));
+    const Float3 kd = (Float3{1.0f, 1.0f, 1.0f} - F) * (1.0f - surface.metalness);
+    return kd * surface.albedo * kInvPi;
+}
+
+static Float3 EvaluateSpecularBrdf(const SurfaceState& surface, const Float3& wi)
+{
+    const f32 cosL = Saturate(Dot(surface.N, wi));
+    const f32 cosV = Saturate(Dot(surface.N, surface.V));
+    if (cosL <= 0.0f || cosV <= 0.0f)
+    {
+        return {};
+    }
+
+    const Float3 H = Normalize(wi + surface.V);
+    const f32 cosLh = Saturate(Dot(surface.N, H));
+    const f32 VoH = Saturate(Dot(surface.V, H));
+    if (VoH <= 0.0f || cosLh <= 0.0f)
+    {
+        return {};
+    }
+
+    const Float3 F = FresnelSchlick(ComputeF0(surface.albedo, surface.metalness), VoH);
+    const f32 D = NdfGGX(cosLh, surface.roughness);
+    const f32 G = SmithGGX(cosL, cosV, surface.roughness);
+    return F * (D * G / std::max(1e-5f, 4.0f * cosL * cosV));
+}
+
+static f32 SpecularReflectionPdf(const SurfaceState& surface, const Float3& wi)
+{
+    const f32 cosL = Saturate(Dot(surface.N, wi));
+    const f32 cosV = Saturate(Dot(surface.N, surface.V));
+    if (cosL <= 0.0f || cosV <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    const Float3 H = Normalize(wi + surface.V);
+    const f32 cosLh = Saturate(Dot(surface.N, H));
+    const f32 VoH = Saturate(Dot(surface.V, H));
+    if (cosLh <= 0.0f || VoH <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    return (NdfGGX(cosLh, surface.roughness) * SmithG1GGX(cosV, surface.roughness)) / std::max(4.0f * cosV, 1e-6f);
+}
+
+static BsdfMixtureWeights ComputeBsdfMixtureWeights(const SurfaceState& surface)
+{
+    BsdfMixtureWeights weights{0.0f, 0.0f};
+    const f32 diffuseWeight = Luminance(EvaluateDiffuseBrdf(surface, surface.N));
+    const f32 specularWeight = Luminance(EvaluateSpecularBrdf(surface, Reflect(-surface.V, surface.N)));
+    const f32 totalWeight = diffuseWeight + specularWeight;
+    if (totalWeight > 1e-5f)
+    {
+        weights.pDiffuse = diffuseWeight / totalWeight;
+        weights.pSpecular = specularWeight / totalWeight;
+    }
+
+    const f32 smoothNonMetal = (1.0f - surface.metalness) * (1.0f - Saturate(surface.roughness * 4.0f));
+    const f32 minDiffuse = 0.05f * smoothNonMetal;
+    if (weights.pDiffuse < minDiffuse)
+    {
+        weights.pDiffuse = minDiffuse;
+        weights.pSpecular = 1.0f - minDiffuse;
+    }
+    return weights;
+}
+
+static f32 ComputePathEventPdf(const SurfaceState& surface, const Float3& wi, const BsdfMixtureWeights& weights)
+{
+    f32 pdf = 0.0f;
+    if (weights.pDiffuse > 0.0f)
+    {
+        pdf += weights.pDiffuse * CosineHemispherePdf(Saturate(Dot(surface.N, wi)));
+    }
+    if (weights.pSpecular > 0.0f)
+    {
+        pdf += weights.pSpecular * SpecularReflectionPdf(surface, wi);
+    }
+    return pdf;
+}
+
+static Float3 SampleSunDirection(f32 u0, f32 u1, const SunLightData& sun)
+{
+    const f32 phi = 2.0f * kPi * u0;
+    const f32 cosTheta = std::lerp(1.0f, sun.cosThetaMax, u1);
+    const f32 sinTheta = std::sqrt(Saturate(1.0f - cosTheta * cosTheta));
+
+    Float3 T{};
+    Float3 B{};
+    BuildOrthonormalBasis(sun.axis, T, B);
+    return Normalize(T * (std::cos(phi) * sinTheta) + B * (std::sin(phi) * sinTheta) + sun.axis * cosTheta);
+}
+
+static bool IsDirectionInsideSunCone(const Float3& dir, const SunLightData& sun)
+{
+    return sun.visible && Dot(dir, sun.axis) >= sun.cosThetaMax;
+}
+
+static Float3 BiasedOrigin(const Float3& pos, const Float3& surfaceN, f32 originBias)
+{
+    return pos + surfaceN * originBias;
+}
+
+// FillPayloadFromTriangleHit.
+static void SurfaceFromHit(const TracerScene& scene, const TraceHit& hit, const Float3& rayOrigin, const Float3& rayDir, SurfaceState& surface)
+{
+    const TracerInstance& inst = scene.instances[hit.instanceIndex];
+    const PackMaterial& m = scene.loaded.materials[inst.materialIndex];
+    const TriangleAttributes attr = FetchTriangleAttributes(scene, inst, hit.triangleIndex, hit.b1, hit.b2);
+
+    const Float3 p0 = VertexPosition(*attr.v[0]);
+    const Float3 faceNObj = Cross(VertexPosition(*attr.v[1]) - p0, VertexPosition(*attr.v[2]) - p0);
+    Float3 shadeNObj{};
+    for (u32 k = 0; k < 3; ++k)
+        shadeNObj += DecodePackedNormalOct(attr.v[k]->normalPacked) * attr.w[k];
+    shadeNObj = Normalize(shadeNObj);
+
+    Float3 geoN = Normalize(TransformVector((Dot(faceNObj, faceNObj) > 1e-8f) ? faceNObj : shadeNObj, inst.normalToWorld));
+    Float3 shadeN = Normalize(TransformVector(shadeNObj, inst.normalToWorld));
+    if (Dot(geoN, -rayDir) < 0.0f)
+    {
+        geoN = -geoN;
+        shadeN = -shadeN;
+    }
+
+    f32 metalness = Saturate(m.metallicFactor);
+    f32 roughness = Saturate(m.roughnessFactor);
+    if (m.metallicRoughnessTextureIndex != -1)
+    {
+        const Float4 metallicRoughness = SampleMaterialTexture(scene, m.metallicRoughnessTextureIndex, m.metallicRoughnessSamplerIndex, attr.uv);
+        metalness *= metallicRoughness.z;
+        roughness *= metallicRoughness.y;
+    }
+
+    Float3 emissive = Max(m.emissiveFactor, Float3{});
+    if (m.emissiveTextureIndex != -1)
+    {
+        emissive *= SampleMaterialTexture(scene, m.emissiveTextureIndex, m.emissiveSamplerIndex, attr.uv).Xyz();
+    }
+    if (AnyInvalid3(emissive))
+    {
+        emissive = {};
+    }
+
+    surface.pos = rayOrigin + rayDir * hit.t;
+    surface.geoN = geoN;
+    surface.albedo = Saturate(LoadBaseColor(scene, m, attr).Xyz());
+    surface.emissive = Max(emissive, Float3{});
+    surface.metalness = Saturate(metalness);
+    surface.roughness = Saturate(roughness);
+    surface.N = (Dot(shadeN, geoN) <= 0.0f) ? geoN : shadeN;
+    surface.V = -rayDir;
+}
+
+// The G-buffer surface the GPU path tracer starts from (gbuffer.ms.hlsl + gbuffer.ps.hlsl).
+static void PrimarySurfaceFromHit(const TracerScene& scene, const TraceHit& hit, const Float3& rayOrigin, const Float3& rayDir, SurfaceState& surface)
+{
+    const TracerInstance& inst = scene.instances[hit.instanceIndex];
+    const PackMaterial& m = scene.loaded.materials[inst.materialIndex];
+    const TriangleAttributes attr = FetchTriangleAttributes(scene, inst, hit.triangleIndex, hit.b1, hit.b2);
+
+    Float3 interpN{};
+    Float3 interpT{};
+    f32 interpTw = 0.0f;
+    for (u32 k = 0; k < 3; ++k)
+    {
+        const Float3 Nw = Normalize(TransformVector(DecodePackedNormalOct(attr.v[k]->normalPacked), inst.normalToWorld));
+        f32 tangentSign = 1.0f;
+        const Float3 Tt = TransformVector(DecodePackedTangentR10G10B10A2(attr.v[k]->tangentPacked, tangentSign), inst.world);
+        interpN += Nw * attr.w[k];
+        interpT += Normalize(Tt - Nw * Dot(Tt, Nw)) * attr.w[k];
+        interpTw += tangentSign * inst.worldSign * attr.w[k];
+    }
+
+    const Float4 baseColor = LoadBaseColor(scene, m, attr);
+
+    f32 metallic = m.metallicFactor;
+    f32 roughness = m.roughnessFactor;
+    if (m.metallicRoughnessTextureIndex != -1)
+    {
+        const Float4 metallicRoughness = SampleMaterialTexture(scene, m.metallicRoughnessTextureIndex, m.metallicRoughnessSamplerIndex, attr.uv);
+        metallic *= metallicRoughness.z;
+        roughness *= metallicRoughness.y;
+    }
+
+    Float3 geoN = Normalize(interpN);
+    const bool flipBackFaceForDoubleSided = m.doubleSided && !hit.frontFace;
+    Float3 N = geoN;
+    if (m.normalTextureIndex != -1)
+    {
+        const Float4 sampled = SampleMaterialTexture(scene, m.normalTextureIndex, m.normalSamplerIndex, attr.uv);
+        const f32 rx = (sampled.x * 2.0f - 1.0f) * m.normalScale;
+        const f32 ry = (sampled.y * 2.0f - 1.0f) * m.normalScale;
+        const f32 rz = std::sqrt(Saturate(1.0f - (rx * rx + ry * ry)));
+
+        Float3 Ng = geoN;
+        Float3 T = Normalize(interpT);
+        T = Normalize(T - Ng * Dot(Ng, T));
+        Float3 B = Normalize(Cross(Ng, T));
+        if (interpTw < 0.0f)
+        {
+            B = -B;
+        }
+        if (flipBackFaceForDoubleSided)
+        {
+            Ng = -Ng;
+            T = -T;
+            B = -B;
+        }
+        N = Normalize(T * rx + B * ry + Ng * rz);
+    }
+    else if (flipBackFaceForDoubleSided)
+    {
+        N = -N;
+    }
+    if (flipBackFaceForDoubleSided)
+    {
+        geoN = -geoN;
+    }
+
+    Float3 emissive = Max(m.emissiveFactor, Float3{});
+    if (m.emissiveTextureIndex != -1)
+    {
+        emissive *= SampleMaterialTexture(scene, m.emissiveTextureIndex, m.emissiveSamplerIndex, attr.uv).Xyz();
+    }
+
+    surface.pos = rayOrigin + rayDir * hit.t;
+    surface.geoN = geoN;
+    surface.N = N;
+    surface.albedo = baseColor.Xyz();
+    surface.emissive = emissive;
+    surface.metalness = Saturate(metallic);
+    surface.roughness = Saturate(roughness);
+    surface.V = -rayDir;
+}
+
+// The sun sample of a bounce up to its shadow ray, so the shadow rays of a whole packet can be traced together.
+struct SunShadowRay
+{
+    Float3 L;
+    Float3 origin;
+    f32 cosL = 0.0f;
+    bool active = false; // false when the sample contributes nothing
+    bool traced = false; // needs a visibility ray
+};
+
+static SunShadowRay PrepareSunDirect(const PathContext& ctx, const SurfaceState& surface, const BsdfMixtureWeights& weights, u32& seed)
+{
+    SunShadowRay ray{};
+    const SunLightData& sun = ctx.sun;
+    if (!sun.visible || (weights.pDiffuse <= 0.0f && weights.pSpecular <= 0.0f))
+    {
+        return ray;
+    }
+
+    const f32 u0 = Rand(seed);
+    const f32 u1 = Rand(seed);
+    ray.L = SampleSunDirection(u0, u1, sun);
+    ray.cosL = Saturate(Dot(surface.N, ray.L));
+    if (ray.cosL <= 0.0f)
+    {
+        return ray;
+    }
+
+    ray.active = true;
+    if (ctx.settings.rtShadowsEnabled)
+    {
+        ray.traced = true;
+        ray.origin = BiasedOrigin(surface.pos, surface.geoN, ComputeShadowOriginBias(ctx, surface.pos, surface.geoN, ray.L));
+    }
+    return ray;
+}
+
+static Float3 ShadeSunDirect(const PathContext& ctx, const SurfaceState& surface, const BsdfMixtureWeights& weights, const SunShadowRay& ray, f32 rawVisibility)
+{
+    if (!ray.active)
+    {
+        return {};
+    }
+
+    f32 diffuseVisibility = 1.0f;
+    f32 specularVisibility = 1.0f;
+    if (ray.traced)
+    {
+        diffuseVisibility = std::lerp(Saturate(ctx.settings.shadowMinVisibility), 1.0f, rawVisibility);
+        specularVisibility = std::lerp(Saturate(ctx.settings.specularShadowMinVisibility), 1.0f, rawVisibility);
+    }
+
+    const SunLightData& sun = ctx.sun;
+    const Float3 brdf = EvaluateDiffuseBrdf(surface, ray.L) * diffuseVisibility + EvaluateSpecularBrdf(surface, ray.L) * specularVisibility;
+    const f32 bsdfPdf = ComputePathEventPdf(surface, ray.L, weights);
+    const f32 lightPdf = sun.conePdf;
+    const f32 misWeight = PowerHeuristic(lightPdf, bsdfPdf);
+    return brdf * sun.coneRadiance * (ray.cosL * misWeight / std::max(lightPdf, 1e-6f));
+}
+
+static bool SamplePathEvent(const SurfaceState& surface, const BsdfMixtureWeights& weights, u32& seed, BsdfSample& sample)
+{
+    if (weights.pDiffuse <= 0.0f && weights.pSpecular <= 0.0f)
+    {
+        return false;
+    }
+
+    if (weights.pSpecular > 0.0f && Rand(seed) < weights.pSpecular)
+    {
+        const f32 u0 = Rand(seed);
+        const f32 u1 = Rand(seed);
+        const Float3 H = SampleGGXVNDFWorld(surface.V, surface.N, surface.roughness, u0, u1);
+        sample.wi = Reflect(-surface.V, H);
+
+        const f32 NoL = Saturate(Dot(surface.N, sample.wi));
+        const f32 VoH = Saturate(Dot(surface.V, H));
+        if (NoL <= 0.0f || VoH <= 0.0f)
+        {
+            return false;
+        }
+
+        sample.f = EvaluateSpecularBrdf(surface, sample.wi);
+        sample.pdf = std::max(weights.pSpecular * SpecularReflectionPdf(surface, sample.wi), 1e-6f);
+        sample.wasSpecular = true;
+        return true;
+    }
+
+    if (weights.pDiffuse <= 0.0f)
+    {
+        return false;
+    }
+
+    const f32 u0 = Rand(seed);
+    const f32 u1 = Rand(seed);
+    sample.wi = SampleCosineHemisphereWorld(u0, u1, surface.N);
+    const f32 NoL = Saturate(Dot(surface.N, sample.wi));
+    if (NoL <= 0.0f)
+    {
+        return false;
+    }
+
+    sample.f = EvaluateDiffuseBrdf(surface, sample.wi);
+    sample.pdf = std::max(weights.pDiffuse * CosineHemispherePdf(NoL), 1e-6f);
+    sample.wasSpecular = false;
+    return true;
+}
+
+static u32 PixelSeed(u32 px, u32 py, u32 frameIndex)
+{
+    return HashUint(px * 1973u + py * 9277u + 89173u + frameIndex * 26699u);
+}
+
+// One sample of IntegratePath, advanced one bounce at a time so the paths of a quad trace their rays together. Each
+// lane consumes its random numbers in IntegratePath's order (sun sample, path event, Russian roulette) whatever the
+// other lanes do, so stepping the lanes in lockstep does not change the image.
+struct PathState
+{
+    u32 seed = 0;
+    SurfaceState surface;
+    BsdfMixtureWeights weights{0.0f, 0.0f};
+    SunShadowRay sunRay;
+    Float3 throughput = {1.0f, 1.0f, 1.0f};
+    Float3 radiance = {0.0f, 0.0f, 0.0f};
+    Float3 rayOrigin;
+    Float3 rayDir;
+};
+
+static PathState BeginPath(const PathContext& ctx, const SurfaceState& firstSurface, u32 baseSeed, u32 sampleIndex)
+{
+    PathState path{};
+    path.seed = baseSeed ^ (sampleIndex * 0x9E3779B9u);
+    path.surface = firstSurface;
+    path.radiance = firstSurface.emissive;
+    path.weights = ComputeBsdfMixtureWeights(path.surface);
+    path.sunRay = PrepareSunDirect(ctx, path.surface, path.weights, path.seed);
+    return path;
+}
+
+// Shades the bounce's sun sample and samples the continuation ray. Returns false when the path ends here.
+static bool ScatterPath(const PathContext& ctx, PathState& path, u32 bounce, f32 sunVisibility)
+{
+    const SurfaceState& surface = path.surface;
+    path.radiance += path.throughput * ShadeSunDirect(ctx, surface, path.weights, path.sunRay, sunVisibility);
+
+    BsdfSample sample{};
+    if (!SamplePathEvent(surface, path.weights, path.seed, sample))
+    {
+        return false;
+    }
+
+    const f32 NoL = Saturate(Dot(surface.N, sample.wi));
+    path.throughput *= sample.f * (NoL / sample.pdf);
+    if (MaxComponent(path.throughput) <= 1e-4f)
+    {
+        return false;
+    }
+
+    const f32 originBias = (bounce == 0u) ? kPrimaryBounceContinuationRayOriginBias : kRayEps;
+    path.rayOrigin = BiasedOrigin(surface.pos, surface.geoN, originBias);
+    path.rayDir = sample.wi;
+    return true;
+}
+
+// Moves the path to the continuation ray's hit (null on a miss) and prepares the next bounce's sun sample. Returns
+// false when the path ends here.
+static bool AdvancePath(const PathContext& ctx, PathState& path, u32 bounce, const TraceHit* hit)
+{
+    const SunLightData& sun = ctx.sun;
+    if (hit == nullptr)
+    {
+        const bool hitSun = IsDirectionInsideSunCone(path.rayDir, sun);
+        const f32 lightPdf = hitSun ? sun.conePdf : 0.0f;
+        const f32 bsdfPdf = ComputePathEventPdf(path.surface, path.rayDir, path.weights);
+        const f32 misWeight = (lightPdf > 0.0f) ? PowerHeuristic(bsdfPdf, lightPdf) : 1.0f;
+        const Float3 missRadiance = hitSun ? sun.coneRadiance * misWeight : SampleSkyBackground(ctx, path.rayDir);
+        path.radiance += path.throughput * missRadiance;
+        return false;
+    }
+
+    SurfaceFromHit(ctx.scene, *hit, path.rayOrigin, path.rayDir, path.surface);
+    path.radiance += path.throughput * path.surface.emissive;
+
+    if (bounce >= kRussianRouletteMinBounce)
+    {
+        const f32 survivalProbability = ComputeRussianRouletteSurvivalProbability(path.throughput);
+        if (Rand(path.seed) > survivalProbability)
+        {
+            return false;
+        }
+        path.throughput /= survivalProbability;
+    }
+
+    if (bounce + 1 >= ctx.maxBounces)
+    {
+        return false;
+    }
+    path.weights = ComputeBsdfMixtureWeights(path.surface);
+    path.sunRay = PrepareSunDirect(ctx, path.surface, path.weights, path.seed);
+    return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Camera, output, and driver
+// ---------------------------------------------------------------------------------------------------------------------
+
+struct TracerCamera
+{
+    Float3 position = {0.0f, 0.0f, 0.0f};
+    Float3 front = {0.0f, 0.0f, -1.0f};
+    Float3 right = {1.0f, 0.0f, 0.0f};
+    Float3 up = {0.0f, 1.0f, 0.0f};
+    f32 tanHalfFovY = 1.0f;
+    f32 aspect = 1.0f;
+};
+
+// Same file and conventions as Camera::LoadSceneConfig; without a preset the camera keeps its defaults.
+static TracerCamera LoadCamera(const std::string& sceneName, const TracerSettings& settings, u32 width, u32 height)
+{
+    TracerCamera camera{};
+    std::ifstream file("data/camera_presets.txt");
+    const std::string sceneNameLower = ToLowerAscii(sceneName);
+    std::string line;
+    bool found = false;
+    while (file.is_open() && std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream stream(line);
+        std::string name;
+        Float3 position{};
+        f32 yaw = 0.0f;
+        f32 pitch = 0.0f;
+        if (!(stream >> name >> position.x >> position.y >> position.z >> yaw >> pitch) || ToLowerAscii(name) != sceneNameLower)
+            continue;
+
+        camera.position = position;
+        const f32 yawRad = ToRadians(yaw);
+        const f32 pitchRad = ToRadians(pitch);
+        camera.front = Normalize({std::cos(yawRad) * std::cos(pitchRad), std::sin(pitchRad), std::sin(yawRad) * std::cos(pitchRad)});
+        found = true;
+        break;
+    }
+    if (!found)
+        std::println("  warning: no camera preset for '{}', using the default camera", sceneName);
+
+    // XMMatrixLookToRH basis.
+    camera.right = Normalize(Cross(camera.front, {0.0f, 1.0f, 0.0f}));
+    camera.up = Cross(camera.right, camera.front);
+    camera.tanHalfFovY = std::tan(ToRadians(settings.cameraFov) * 0.5f);
+    camera.aspect = static_cast<f32>(width) / static_cast<f32>(height);
+    return camera;
+}
+
+static Float3 PrimaryRayDirection(const TracerCamera& camera, u32 px, u32 py, u32 width, u32 height)
+{
+    const f32 ndcX = (static_cast<f32>(px) + 0.5f) / static_cast<f32>(width) * 2.0f - 1.0f;
+    const f32 ndcY = 1.0f - (static_cast<f32>(py) + 0.5f) / static_cast<f32>(height) * 2.0f;
+    return Normalize(camera.front + camera.right * (ndcX * camera.tanHalfFovY * camera.aspect) + camera.up * (ndcY * camera.tanHalfFovY));
+}
+
+// Traces the rays of laneMask as one packet, or one at a time when singleRays is set. Returns the lanes that hit.
+static u32 TraceQuadRays(PathContext& ctx, bool singleRays, RayPacket& packet, u32 laneMask, u32 flags, TraceHit (&outHits)[kPacketSize])
+{
+    ctx.rayCount += std::popcount(laneMask);
+    if (!singleRays)
+    {
+        return TraceScenePacket(ctx.scene, packet, laneMask, flags, outHits);
+    }
+
+    u32 hitMask = 0;
+    for (u32 lane = 0; lane < kPacketSize; ++lane)
+    {
+        if ((laneMask & (1u << lane)) && TraceScene(ctx.scene, packet.Origin(lane), packet.Direction(lane), packet.tMin[lane], packet.tMax[lane], flags, outHits[lane]))
+            hitMask |= 1u << lane;
+    }
+    return hitMask;
+}
+
+// Renders the 2x2 pixel quad at (x0, y0). The four paths of a sample advance one bounce at a time, so every bounce's
+// sun shadow rays and continuation rays go through the packet traversal as well as the primary rays, unless
+// options.singleRays is set. Both modes consume the same random numbers, so they render the same image.
+static void RenderQuad(PathContext& ctx, const TracerCamera& camera, const TracerOptions& options, u32 x0, u32 y0, Vector<Float3>& pixels)
+{
+    static_assert(kPacketSize == 4, "A packet covers one 2x2 pixel quad");
+
+    u32 px[kPacketSize];
+    u32 py[kPacketSize];
+    Float3 dir[kPacketSize];
+    u32 laneMask = 0;
+    RayPacket packet{};
+    for (u32 lane = 0; lane < kPacketSize; ++lane)
+    {
+        px[lane] = x0 + (lane & 1u);
+        py[lane] = y0 + (lane >> 1);
+        if (px[lane] >= options.width || py[lane] >= options.height)
+        {
+            continue;
+        }
+        dir[lane] = PrimaryRayDirection(camera, px[lane], py[lane], options.width, options.height);
+        packet.SetRay(lane, camera.position, dir[lane], 0.0f, kRayTMax);
+        laneMask |= 1u << lane;
+    }
+
+    TraceHit hits[kPacketSize] = {};
+    const u32 hitMask = TraceQuadRays(ctx, options.singleRays, packet, laneMask, TraceFlags_CullBackFacingSingleSided, hits);
+
+    Float3 color[kPacketSize] = {};
+    SurfaceState surfaces[kPacketSize] = {};
+    for (u32 lane = 0; lane < kPacketSize; ++lane)
+    {
+        if (hitMask & (1u << lane))
+            PrimarySurfaceFromHit(ctx.scene, hits[lane], camera.position, dir[lane], surfaces[lane]);
+        else if (laneMask & (1u << lane))
+            color[lane] = SampleSkyBackground(ctx, dir[lane]);
+    }
+
+    for (u32 frame = 0; frame < options.frames && hitMask != 0; ++frame)
+    {
+        Float3 frameSum[kPacketSize] = {};
+        for (u32 s = 0; s < options.spp; ++s)
+        {
+            PathState paths[kPacketSize];
+            for (u32 lane = 0; lane < kPacketSize; ++lane)
+            {
+                if (hitMask & (1u << lane))
+                    paths[lane] = BeginPath(ctx, surfaces[lane], PixelSeed(px[lane], py[lane], frame), s);
+            }
+
+            u32 activeMask = hitMask;
+            for (u32 bounce = 0; bounce < ctx.maxBounces && activeMask != 0; ++bounce)
+            {
+                RayPacket shadowPacket{};
+                u32 shadowMask = 0;
+                for (u32 lane = 0; lane < kPacketSize; ++lane)
+                {
+                    if ((activeMask & (1u << lane)) && paths[lane].sunRay.traced)
+                    {
+                        shadowPacket.SetRay(lane, paths[lane].sunRay.origin, paths[lane].sunRay.L, kDirectShadowRayTMin, kRayTMax);
+                        shadowMask |= 1u << lane;
+                    }
+                }
+                TraceHit shadowHits[kPacketSize];
+                const u32 occludedMask = TraceQuadRays(ctx, options.singleRays, shadowPacket, shadowMask, TraceFlags_AcceptFirstHit, shadowHits);
+
+                RayPacket bouncePacket{};
+                for (u32 lane = 0; lane < kPacketSize; ++lane)
+                {
+                    if ((activeMask & (1u << lane)) == 0)
+                    {
+                        continue;
+                    }
+                    if (ScatterPath(ctx, paths[lane], bounce, (occludedMask & (1u << lane)) ? 0.0f : 1.0f))
+                        bouncePacket.SetRay(lane, paths[lane].rayOrigin, paths[lane].rayDir, kRayEps, kRayTMax);
+                    else
+                        activeMask &= ~(1u << lane);
+                }
+                TraceHit bounceHits[kPacketSize];
+                const u32 bounceHitMask = TraceQuadRays(ctx, options.singleRays, bouncePacket, activeMask, TraceFlags_None, bounceHits);
+
+                for (u32 lane = 0; lane < kPacketSize; ++lane)
+                {
+                    if ((activeMask & (1u << lane)) && !AdvancePath(ctx, paths[lane], bounce, (bounceHitMask & (1u << lane)) ? &bounceHits[lane] : nullptr))
+                        activeMask &= ~(1u << lane);
+                }
+            }
+
+            for (u32 lane = 0; lane < kPacketSize; ++lane)
+            {
+                if (hitMask & (1u << lane))
+                    frameSum[lane] += paths[lane].radiance;
+            }
+        }
+
+        for (u32 lane = 0; lane < kPacketSize; ++lane)
+        {
+            if (hitMask & (1u << lane))
+                color[lane] += Clamp(frameSum[lane] / static_cast<f32>(options.spp), 0.0f, 65504.0f);
+        }
+    }
+
+    for (u32 lane = 0; lane < kPacketSize; ++lane)
+    {
+        if ((laneMask & (1u << lane)) == 0)
+        {
+            continue;
+        }
+        if (hitMask & (1u << lane))
+            color[lane] /= static_cast<f32>(options.frames);
+        pixels[static_cast<size_t>(py[lane]) * options.width + px[lane]] = color[lane];
+    }
+}
+
+static void WritePfm(const fs::path& path, const Vector<Float3>& pixels, u32 width, u32 height)
+{
+    std::ofstream file(path, std::ios::binary);
+    Require(file.is_open(), "Failed to open output file");
+    const std::string header = std::format("PF\n{} {}\n-1.0\n", width, height);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // PFM rows run bottom to top, little-endian RGB floats.
+    for (u32 y = height; y-- > 0;)
+    {
+        file.write(reinterpret_cast<const char*>(pixels.data() + static_cast<size_t>(y) * width), static_cast<std::streamsize>(static_cast<size_t>(width) * sizeof(Float3)));
+    }
+    Require(file.good(), "Failed to write output file");
+}
+
+static Array<u8, 4> EncodeRgbe(const Float3& c)
+{
+    const f32 v = std::max({c.x, c.y, c.z});
+    if (!(v >= 1e-32f))
+    {
+        return {0, 0, 0, 0};
+    }
+    int exponent = 0;
+    const f32 scale = std::frexp(v, &exponent) * 256.0f / v;
+    return {static_cast<u8>(std::max(c.x, 0.0f) * scale), static_cast<u8>(std::max(c.y, 0.0f) * scale), static_cast<u8>(std::max(c.z, 0.0f) * scale), static_cast<u8>(exponent + 128)};
+}
+
+// Radiance RGBE, top to bottom, with the run-length encoded scanlines most readers expect for widths in [8, 32767].
+static void WriteHdr(const fs::path& path, const Vector<Float3>& pixels, u32 width, u32 height)
+{
+    std::ofstream file(path, std::ios::binary);
+    Require(file.is_open(), "Failed to open output file");
+    const std::string header = std::format("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y {} +X {}\n", height, width);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    const bool rle = width >= 8 && width <= 0x7fff;
+    Vector<Array<u8, 4>> scanline(width);
+    Vector<u8> encoded;
+    for (u32 y = 0; y < height; ++y)
+    {
+        for (u32 x = 0; x < width; ++x)
+            scanline[x] = EncodeRgbe(pixels[static_cast<size_t>(y) * width + x]);
+
+        if (!rle)
+        {
+            file.write(reinterpret_cast<const char*>(scanline.data()), static_cast<std::streamsize>(scanline.size() * 4));
+            continue;
+        }
+
+        encoded.clear();
+        encoded.insert(encoded.end(), {2, 2, static_cast<u8>(width >> 8), static_cast<u8>(width & 0xff)});
+        for (u32 channel = 0; channel < 4; ++channel)
+        {
+            u32 x = 0;
+            while (x < width)
+            {
+                // A run of at least 3 equal bytes is worth a run record; everything before it goes out as literals.
+                u32 runStart = x;
+                u32 runLength = 0;
+                while (runStart < width)
+                {
+                    runLength = 1;
+                    while (runLength < 127 && runStart + runLength < width && scanline[runStart + runLength][channel] == scanline[runStart][channel])
+                        ++runLength;
+                    if (runLength >= 3)
+                        break;
+                    runStart += runLength;
+                }
+                while (x < runStart)
+                {
+                    const u32 count = std::min(runStart - x, 128u);
+                    encoded.push_back(static_cast<u8>(count));
+                    for (u32 i = 0; i < count; ++i)
+                        encoded.push_back(scanline[x + i][channel]);
+                    x += count;
+                }
+                if (runStart < width)
+                {
+                    encoded.push_back(static_cast<u8>(128 + runLength));
+                    encoded.push_back(scanline[runStart][channel]);
+                    x = runStart + runLength;
+                }
+            }
+        }
+        file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    }
+    Require(file.good(), "Failed to write output file");
+}
+
+static void WriteOutput(const fs::path& path, const Vector<Float3>& pixels, u32 width, u32 height)
+{
+    const std::string ext = ToLowerAscii(path.extension().string());
+    if (ext == ".pfm")
+    {
+        WritePfm(path, pixels, width, height);
+        return;
+    }
+
+    Require(ext == ".hdr", "Output must be .pfm or .hdr");
+    WriteHdr(path, pixels, width, height);
+}
+
+static fs::path FindRepoRoot(const fs::path& exePath)
+{
+#ifdef ISKUR_ROOT
+    fs::path root = fs::path(ISKUR_ROOT);
+    if (!root.empty() && fs::exists(root / "data"))
+        return root;
+#endif
+
+    fs::path cwd = fs::current_path();
+    if (fs::exists(cwd / "data"))
+        return cwd;
+
+    fs::path cur = exePath;
+    if (cur.has_filename())
+        cur = cur.parent_path();
+
+    for (int i = 0; i < 5 && !cur.empty(); ++i)
+    {
+        if (fs::exists(cur / "data"))
+            return cur;
+        cur = cur.parent_path();
+    }
+
+    return cwd;
+}
+
+static void PrintUsage()
+{
+    std::println("IskurReferenceTracer\nUsage:\n  IskurReferenceTracer --scene <scene> [--out <file.pfm|file.hdr>] [--width <px>] [--height <px>] [--frames <n>] [--spp <n>]\n"
+                 "                       [--bounces <n>] [--environment <name>] [--threads <n>] [--sky-size <px>] [--single-rays]");
+}
+
+static u32 ParseU32(const char* text, const char* what)
+{
+    char* end = nullptr;
+    const unsigned long v = std::strtoul(text, &end, 10);
+    if (end == text || *end != '\0' || v == 0 || v > UINT32_MAX)
+    {
+        std::println("Error: Invalid value '{}' for {}", text, what);
+        std::exit(EXIT_FAILURE);
+    }
+    return static_cast<u32>(v);
+}
+
+int main(int argc, char** argv)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+
+    TracerSettings settings{};
+    TracerOptions options{};
+    options.spp = settings.rtPathTraceSpp;
+    options.maxBounces = settings.rtMaxBounces;
+    options.threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = ToLowerAscii(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if ((a == "-i" || a == "--scene") && hasValue)
+            options.scene = argv[++i];
+        else if ((a == "-o" || a == "--out") && hasValue)
+            options.outPath = argv[++i];
+        else if (a == "--environment" && hasValue)
+            options.environment = argv[++i];
+        else if (a == "--width" && hasValue)
+            options.width = ParseU32(argv[++i], "--width");
+        else if (a == "--height" && hasValue)
+            options.height = ParseU32(argv[++i], "--height");
+        else if (a == "--frames" && hasValue)
+            options.frames = ParseU32(argv[++i], "--frames");
+        else if (a == "--spp" && hasValue)
+            options.spp = ParseU32(argv[++i], "--spp");
+        else if (a == "--bounces" && hasValue)
+            options.maxBounces = ParseU32(argv[++i], "--bounces");
+        else if (a == "--threads" && hasValue)
+            options.threadCount = ParseU32(argv[++i], "--threads");
+        else if (a == "--sky-size" && hasValue)
+            options.skyCubeSize = ParseU32(argv[++i], "--sky-size");
+        else if (a == "--single-rays")
+            options.singleRays = true;
+        else
+        {
+            PrintUsage();
+            std::println("Error: Unknown command-line argument '{}'", a);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.scene.empty())
+    {
+        PrintUsage();
+        Fatal("No scene specified; use --scene <name>");
+    }
+
+    // Scene, preset, and environment paths are relative to the repository root, as in the engine.
+    fs::current_path(FindRepoRoot(fs::path(argv[0])));
+
+    const Vector<PackSceneEntry> availableScenes = EnumeratePackScenes();
+    const PackSceneEntry* sceneEntry = FindPackScene(options.scene, availableScenes);
+    Require(sceneEntry != nullptr, "Scene pack not found in data/scenes; run IskurScenePacker first");
+    Require(!sceneEntry->outOfDate, "Scene pack is out of date; re-run IskurScenePacker");
+    const std::string sceneName = sceneEntry->name;
+    if (options.outPath.empty())
+        options.outPath = sceneName + "_reference.pfm";
+
+    const Vector<EnvironmentPreset> presets = LoadEnvironmentPresets();
+    const EnvironmentPreset* preset = FindEnvironmentPreset(presets, options.environment.empty() ? sceneName : options.environment);
+    if (!preset)
+    {
+        Require(options.environment.empty(), "Unknown environment preset");
+        preset = FindEnvironmentPreset(presets, "Afternoon");
+        if (!preset)
+            preset = &presets.front();
+    }
+    settings.sunIntensity = preset->sunIntensity;
+    settings.skyIntensity = preset->skyIntensity;
+    settings.shadowMinVisibility = preset->shadowMinVisibility;
+    settings.specularShadowMinVisibility = preset->specularShadowMinVisibility;
+
+    TracerScene scene{};
+    scene.environment = preset->environment;
+    scene.loaded = LoadPackScene(sceneEntry->path);
+    std::println("Loaded scene: {} ({} primitives, {} instances, {} textures), environment: {}", sceneName, scene.loaded.primitives.size(), scene.loaded.instances.size(),
+                 scene.loaded.textures.size(), preset->name);
+
+    const auto tPrepare = std::chrono::steady_clock::now();
+    scene.textures.resize(scene.loaded.textures.size());
+    ParallelFor(static_cast<u32>(scene.textures.size()), options.threadCount, [&](u32 i, u32) { scene.textures[i] = DecodeTexture(scene.loaded.textures[i]); });
+    BuildAccelerationStructures(scene, options.threadCount);
+    scene.sky = BakeSkyCube(scene.environment, settings.sunIntensity, options.skyCubeSize, options.threadCount);
+    const f64 prepareSec = std::chrono::duration<f64>(std::chrono::steady_clock::now() - tPrepare).count();
+    std::println("Prepared textures, BVHs ({} instances) and {}px sky cube in {:.3f} s", scene.instances.size(), options.skyCubeSize, prepareSec);
+
+    const TracerCamera camera = LoadCamera(sceneName, settings, options.width, options.height);
+    const SunLightData sun = BuildSunLightData(scene.environment, settings);
+
+    const u32 tilesX = (options.width + kTileSize - 1) / kTileSize;
+    const u32 tilesY = (options.height + kTileSize - 1) / kTileSize;
+    Vector<Float3> pixels(static_cast<size_t>(options.width) * options.height);
+    Vector<u64> rayCounts(options.threadCount, 0);
+
+    const auto tRender = std::chrono::steady_clock::now();
+    ParallelFor(tilesX * tilesY, options.threadCount, [&](u32 tile, u32 threadIndex) {
+        PathContext ctx{scene, settings, camera.position, sun, options.maxBounces, 0};
+        const u32 x0 = (tile % tilesX) * kTileSize;
+        const u32 y0 = (tile / tilesX) * kTileSize;
+        for (u32 qy = y0; qy < std::min(y0 + kTileSize, options.height); qy += 2)
+        {
+            for (u32 qx = x0; qx < std::min(x0 + kTileSize, options.width); qx += 2)
+                RenderQuad(ctx, camera, options, qx, qy, pixels);
+        }
+        rayCounts[threadIndex] += ctx.rayCount;
+    });
+    const f64 renderSec = std::chrono::duration<f64>(std::chrono::steady_clock::now() - tRender).count();
+    const u64 totalRays = std::accumulate(rayCounts.begin(), rayCounts.end(), u64{0});
+
+    WriteOutput(options.outPath, pixels, options.width, options.height);
+
+    std::println("Rendered {}x{}, {} frame(s) x {} spp, {} bounces on {} threads", options.width, options.height, options.frames, options.spp, options.maxBounces, options.threadCount);
+    std::println("  rays: {} in {:.3f} s ({:.2f} Mrays/s, {})", totalRays, renderSec, static_cast<f64>(totalRays) / std::max(renderSec, 1e-9) * 1e-6,
+                 options.singleRays ? "single rays" : "4-ray packets");
+    std::println("  output: {}", fs::absolute(options.outPath).string());
+
+    const f64 totalSec = std::chrono::duration<f64>(std::chrono::steady_clock::now() - t0).count();
+    std::println("Total time: {:.3f} s", totalSec);
+    return 0;
+}
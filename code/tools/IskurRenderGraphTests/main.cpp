@@ -0,0 +1,165 @@
+// Iskur Engine - Render Graph Tests
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+// CPU checks of the render graph: textures alive in the same pass never share heap bytes, a small aliasing chain gets exactly
+// the expected aliasing, transition and UAV barriers, and graphs with a texture that is never read, never written first or
+// never used fail validation. Allocation sizes are estimated, so no device is needed. Exits with a failure code when a check
+// does not hold; registered with CTest.
+
+#include "renderer/PostProcessGraph.h"
+#include "renderer/RenderGraph.h"
+
+#include <d3dx12/d3dx12.h>
+
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+
+static u32 g_CheckFailures = 0;
+
+static void Check(const bool condition, const std::string& what)
+{
+    if (!condition)
+    {
+        std::println("  FAILED: {}", what);
+        ++g_CheckFailures;
+    }
+}
+
+static RGTextureDesc MakeCheckTexture(const wchar_t* name, const u32 width, const u32 height)
+{
+    RGTextureDesc desc{};
+    desc.desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, width, height, 1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+    desc.name = name;
+    desc.createUav = true;
+    return desc;
+}
+
+// Two textures that are alive in the same pass must never share bytes, and every texture must sit aligned inside its heap.
+static void CheckPlacement(const RenderGraph& graph, const std::string& label)
+{
+    for (RGTexture a = 0; a < graph.GetTextureCount(); ++a)
+    {
+        const RenderGraph::TextureLayout& la = graph.GetTextureLayout(a);
+        Check(la.offset % la.alignment == 0 && la.offset + la.size <= graph.GetHeapSize(la.heapClass), std::format("{}: texture {} lies outside its heap", label, a));
+        for (RGTexture b = a + 1; b < graph.GetTextureCount(); ++b)
+        {
+            const RenderGraph::TextureLayout& lb = graph.GetTextureLayout(b);
+            const bool liveTogether = la.firstPass <= lb.lastPass && lb.firstPass <= la.lastPass;
+            const bool shareBytes = la.heapClass == lb.heapClass && la.offset < lb.offset + lb.size && lb.offset < la.offset + la.size;
+            Check(!(liveTogether && shareBytes), std::format("{}: textures {} and {} are alive together but share bytes", label, a, b));
+        }
+    }
+}
+
+static void CheckPostProcessGraph(const u32 presentHeight)
+{
+    const XMUINT2 presentSize(presentHeight * 16u / 9u, presentHeight);
+    const XMUINT2 renderSize(presentSize.x * 2u / 3u, presentSize.y * 2u / 3u);
+
+    RenderGraph graph;
+    PostProcessGraph postGraph{};
+    DeclarePostProcessGraph(graph, renderSize, presentSize, postGraph);
+    const String error = graph.Validate();
+    Check(error.empty(), std::format("post-processing graph at {}p is invalid: {}", presentHeight, error));
+    if (!error.empty())
+    {
+        return;
+    }
+    graph.Compile(EstimatePostProcessAllocationInfo);
+    CheckPlacement(graph, std::format("post-processing graph at {}p", presentHeight));
+    Check(graph.GetStats().heapBytes < graph.GetStats().textureBytes, std::format("post-processing graph at {}p aliases nothing", presentHeight));
+}
+
+// A is produced and consumed before C is produced, so C takes A's bytes while B, alive across both, gets its own.
+static void CheckAliasingChain()
+{
+    constexpr D3D12_RESOURCE_STATES kRead = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+    constexpr D3D12_RESOURCE_STATES kWrite = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+    RenderGraph graph;
+    const RGTexture a = graph.CreateTexture(MakeCheckTexture(L"A", 256, 256));
+    const RGTexture b = graph.CreateTexture(MakeCheckTexture(L"B", 256, 256));
+    const RGTexture c = graph.CreateTexture(MakeCheckTexture(L"C", 256, 256));
+    graph.AddPass("Write A", {{a, kWrite}});
+    graph.AddPass("A to B", {{a, kRead}, {b, kWrite}});
+    graph.AddPass("B to C", {{b, kRead}, {c, kWrite}});
+    graph.AddPass("Accumulate C", {{c, kWrite}});
+    graph.AddPass("Read C", {{c, kRead}});
+    graph.Compile(EstimatePostProcessAllocationInfo);
+    CheckPlacement(graph, "aliasing chain");
+
+    const RenderGraph::TextureLayout& la = graph.GetTextureLayout(a);
+    const RenderGraph::TextureLayout& lb = graph.GetTextureLayout(b);
+    const RenderGraph::TextureLayout& lc = graph.GetTextureLayout(c);
+    Check(la.aliased && lc.aliased && la.offset == lc.offset, "aliasing chain: C does not reuse A's bytes");
+    Check(!lb.aliased, "aliasing chain: B shares bytes although it is alive next to A and C");
+    Check(graph.GetStats().heapBytes == la.size + lb.size, "aliasing chain: the heaps do not hold exactly two textures");
+
+    // Every texture starts the frame in the state its last access left it in, i.e. kRead here.
+    const Array<Vector<RGBarrier>, 5> expected = {{
+        {{RGBarrierType_Aliasing, a, kWrite, kWrite}, {RGBarrierType_Transition, a, kRead, kWrite}},
+        {{RGBarrierType_Transition, a, kWrite, kRead}, {RGBarrierType_Transition, b, kRead, kWrite}},
+        {{RGBarrierType_Aliasing, c, kWrite, kWrite}, {RGBarrierType_Transition, b, kWrite, kRead}, {RGBarrierType_Transition, c, kRead, kWrite}},
+        {{RGBarrierType_Uav, c, kWrite, kWrite}},
+        {{RGBarrierType_Transition, c, kWrite, kRead}},
+    }};
+    for (RGPass p = 0; p < expected.size(); ++p)
+    {
+        const Vector<RGBarrier>& barriers = graph.GetPassBarriers(p);
+        bool matches = barriers.size() == expected[p].size();
+        for (size_t i = 0; matches && i < barriers.size(); ++i)
+        {
+            const RGBarrier& have = barriers[i];
+            const RGBarrier& want = expected[p][i];
+            matches = have.type == want.type && have.texture == want.texture && have.before == want.before && have.after == want.after;
+        }
+        Check(matches, std::format("aliasing chain: unexpected barriers before pass '{}'", graph.GetPassName(p)));
+    }
+}
+
+static void CheckValidation()
+{
+    constexpr D3D12_RESOURCE_STATES kRead = D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+    constexpr D3D12_RESOURCE_STATES kWrite = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+
+    RenderGraph graph;
+    const RGTexture unread = graph.CreateTexture(MakeCheckTexture(L"Unread", 64, 64));
+    graph.AddPass("Write", {{unread, kWrite}});
+    Check(!graph.Validate().empty(), "a texture nothing reads passes validation");
+
+    graph.Reset();
+    const RGTexture readFirst = graph.CreateTexture(MakeCheckTexture(L"Read First", 64, 64));
+    graph.AddPass("Read", {{readFirst, kRead}});
+    graph.AddPass("Write", {{readFirst, kWrite}});
+    Check(!graph.Validate().empty(), "a texture read before it is written passes validation");
+
+    graph.Reset();
+    graph.CreateTexture(MakeCheckTexture(L"Unused", 64, 64));
+    Check(!graph.Validate().empty(), "a texture no pass uses passes validation");
+
+    graph.Reset();
+    const RGTexture valid = graph.CreateTexture(MakeCheckTexture(L"Valid", 64, 64));
+    graph.AddPass("Write", {{valid, kWrite}});
+    graph.AddPass("Read", {{valid, kRead}});
+    Check(graph.Validate().empty(), "a written then read texture fails validation");
+}
+
+int main()
+{
+    std::println("Render graph checks");
+    CheckPostProcessGraph(1080);
+    CheckPostProcessGraph(2160);
+    CheckAliasingChain();
+    CheckValidation();
+    if (g_CheckFailures > 0)
+    {
+        std::println("{} checks failed", g_CheckFailures);
+        return EXIT_FAILURE;
+    }
+    std::println("All checks passed");
+    return EXIT_SUCCESS;
+}
@@ -5,7 +5,9 @@
 
 #include "common/IskurPackFormat.h"
 #include "common/Asserts.h"
+#include "common/Profiler.h"
 #include "common/StringUtils.h"
+#include "common/VertexPacking.h"
 #include "shaders/CPUGPU.h"
 #include <DirectXMath.h>
 #include <DirectXPackedVector.h>
@@ -13,21 +15,33 @@
 #include <Objbase.h>
 #include <chrono>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
 #include <d3d12.h>
 #include <fastgltf/base64.hpp>
 #include <fastgltf/core.hpp>
 #include <fastgltf/tools.hpp>
 #include <fastgltf/types.hpp>
 #include <filesystem>
+#include <format>
 #include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
 #include <meshoptimizer.h>
 #include <mikktspace.h>
+#include <mutex>
 #include <print>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -46,6 +60,87 @@ static void Require(bool cond, const char* msg)
         Fatal(msg);
 }
 
+enum PackStage : u8
+{
+    PackStage_ParseGltf,
+    PackStage_DecodeImages,
+    PackStage_GenerateMips,
+    PackStage_CompressBC,
+    PackStage_Tangents,
+    PackStage_OptimizeMesh,
+    PackStage_BuildMeshlets,
+    PackStage_BuildOMM,
+    PackStage_WritePack,
+
+    PackStage_Count
+};
+
+static constexpr const char* kPackStageNames[PackStage_Count] = {
+    "glTF parse", "Image decode", "Mip generation", "BC compression", "MikkTSpace", "Mesh optimize", "Meshlet build", "OMM build", "Pack write",
+};
+
+// Cumulative over every scene packed by this run. Stages are timed on the main thread only; their CPU time is the process's,
+// so it includes the worker threads a stage fans out to (the pack worker pool, parallel BC compression).
+struct PackStageStats
+{
+    f64 wallSeconds = 0.0;
+    f64 cpuSeconds = 0.0;
+    u64 items = 0;
+    u64 bytesIn = 0;
+    u64 bytesOut = 0;
+};
+
+static std::array<PackStageStats, PackStage_Count> g_PackStageStats;
+
+static f64 GetProcessCpuSeconds()
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+    auto toTicks = [](const FILETIME& ft) { return (static_cast<u64>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+    return static_cast<f64>(toTicks(kernelTime) + toTicks(userTime)) * 1e-7;
+}
+
+static void AddPackStageWork(PackStage stage, u64 items, u64 bytesIn, u64 bytesOut)
+{
+    PackStageStats& stats = g_PackStageStats[stage];
+    stats.items += items;
+    stats.bytesIn += bytesIn;
+    stats.bytesOut += bytesOut;
+}
+
+// Adds the wall and CPU time until Stop() or the end of the scope to the stage.
+class PackStageTimer
+{
+  public:
+    explicit PackStageTimer(PackStage stage) : m_Stage(stage), m_WallStart(std::chrono::steady_clock::now()), m_CpuStart(GetProcessCpuSeconds())
+    {
+    }
+    ~PackStageTimer()
+    {
+        Stop();
+    }
+
+    PackStageTimer(const PackStageTimer&) = delete;
+    PackStageTimer& operator=(const PackStageTimer&) = delete;
+
+    void Stop()
+    {
+        if (!m_Running)
+            return;
+        m_Running = false;
+        PackStageStats& stats = g_PackStageStats[m_Stage];
+        stats.wallSeconds += std::chrono::duration<f64>(std::chrono::steady_clock::now() - m_WallStart).count();
+        stats.cpuSeconds += GetProcessCpuSeconds() - m_CpuStart;
+    }
+
+  private:
+    PackStage m_Stage;
+    std::chrono::steady_clock::time_point m_WallStart;
+    f64 m_CpuStart;
+    bool m_Running = true;
+};
+
 static bool IsFiniteF32(f32 v)
 {
     return std::isfinite(v);
@@ -96,133 +191,6 @@ static XMMATRIX NodeLocalMatrix_Row(const fastgltf::Node& n)
     return RowMatFromColArray(Mc);
 }
 
-static f32 SignNotZeroF(f32 v)
-{
-    return (v >= 0.0f) ? 1.0f : -1.0f;
-}
-
-static XMFLOAT3 NormalizeSafe(const XMFLOAT3& n)
-{
-    const f32 len2 = n.x * n.x + n.y * n.y + n.z * n.z;
-    if (len2 <= 1e-20f)
-        return XMFLOAT3(0.0f, 0.0f, 1.0f);
-    const f32 invLen = 1.0f / std::sqrt(len2);
-    return XMFLOAT3(n.x * invLen, n.y * invLen, n.z * invLen);
-}
-
-static u32 PackNormalOctSnorm16(const XMFLOAT3& inNormal)
-{
-    XMFLOAT3 n = NormalizeSafe(inNormal);
-    const f32 invL1 = 1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z));
-    f32 ex = n.x * invL1;
-    f32 ey = n.y * invL1;
-    if (n.z < 0.0f)
-    {
-        const f32 ox = (1.0f - std::abs(ey)) * SignNotZeroF(ex);
-        const f32 oy = (1.0f - std::abs(ex)) * SignNotZeroF(ey);
-        ex = ox;
-        ey = oy;
-    }
-
-    const auto toSnorm16 = [](f32 v) -> i16 {
-        v = std::clamp(v, -1.0f, 1.0f);
-        int q = static_cast<int>(std::lround(v * 32767.0f));
-        q = std::clamp(q, -32767, 32767);
-        return static_cast<i16>(q);
-    };
-
-    const u16 qx = static_cast<u16>(toSnorm16(ex));
-    const u16 qy = static_cast<u16>(toSnorm16(ey));
-    return static_cast<u32>(qx) | (static_cast<u32>(qy) << 16);
-}
-
-static XMFLOAT3 UnpackNormalOctSnorm16(u32 packed)
-{
-    const i16 qx = static_cast<i16>(packed & 0xFFFFu);
-    const i16 qy = static_cast<i16>((packed >> 16) & 0xFFFFu);
-
-    f32 ex = static_cast<f32>(qx) / 32767.0f;
-    f32 ey = static_cast<f32>(qy) / 32767.0f;
-    ex = std::max(-1.0f, ex);
-    ey = std::max(-1.0f, ey);
-
-    f32 x = ex;
-    f32 y = ey;
-    f32 z = 1.0f - std::abs(x) - std::abs(y);
-    if (z < 0.0f)
-    {
-        const f32 ox = (1.0f - std::abs(y)) * SignNotZeroF(x);
-        const f32 oy = (1.0f - std::abs(x)) * SignNotZeroF(y);
-        x = ox;
-        y = oy;
-    }
-    return NormalizeSafe(XMFLOAT3(x, y, z));
-}
-
-static u32 PackTexCoordHalf2(const XMFLOAT2& uv)
-{
-    const u16 ux = DirectX::PackedVector::XMConvertFloatToHalf(uv.x);
-    const u16 uy = DirectX::PackedVector::XMConvertFloatToHalf(uv.y);
-    return static_cast<u32>(ux) | (static_cast<u32>(uy) << 16);
-}
-
-static XMFLOAT2 UnpackTexCoordHalf2(u32 packed)
-{
-    const u16 ux = static_cast<u16>(packed & 0xFFFFu);
-    const u16 uy = static_cast<u16>((packed >> 16) & 0xFFFFu);
-    return XMFLOAT2(DirectX::PackedVector::XMConvertHalfToFloat(ux), DirectX::PackedVector::XMConvertHalfToFloat(uy));
-}
-
-struct PackedColorRGBA16Unorm
-{
-    u32 lo;
-    u32 hi;
-};
-
-static PackedColorRGBA16Unorm PackColorRGBA16Unorm(const XMFLOAT4& color)
-{
-    const auto toUnorm16 = [](f32 v) -> u32 {
-        const f32 c = std::clamp(v, 0.0f, 1.0f);
-        const int q = static_cast<int>(std::lround(c * 65535.0f));
-        return static_cast<u32>(std::clamp(q, 0, 65535));
-    };
-
-    const u32 r = toUnorm16(color.x);
-    const u32 g = toUnorm16(color.y);
-    const u32 b = toUnorm16(color.z);
-    const u32 a = toUnorm16(color.w);
-    return PackedColorRGBA16Unorm{r | (g << 16), b | (a << 16)};
-}
-
-static u32 PackTangentR10G10B10A2(const XMFLOAT3& inTangent, f32 handedness)
-{
-    XMFLOAT3 t = inTangent;
-    const f32 len2 = t.x * t.x + t.y * t.y + t.z * t.z;
-    if (len2 <= 1e-20f)
-    {
-        t = XMFLOAT3(1.0f, 0.0f, 0.0f);
-    }
-    else
-    {
-        const f32 invLen = 1.0f / std::sqrt(len2);
-        t.x *= invLen;
-        t.y *= invLen;
-        t.z *= invLen;
-    }
-
-    const auto toUnorm10 = [](f32 v) -> u32 {
-        const f32 u = std::clamp(v * 0.5f + 0.5f, 0.0f, 1.0f);
-        const int q = static_cast<int>(std::lround(u * 1023.0f));
-        return static_cast<u32>(std::clamp(q, 0, 1023));
-    };
-
-    const u32 x = toUnorm10(t.x);
-    const u32 y = toUnorm10(t.y);
-    const u32 z = toUnorm10(t.z);
-    const u32 a2 = (handedness < 0.0f) ? 0u : 3u;
-    return x | (y << 10) | (z << 20) | (a2 << 30);
-}
-
 static bool IsGlbFile(const fs::path& p)
 {
     std::ifstream f(p, std::ios::binary);
@@ -319,6 +287,14 @@ static HRESULT LoadAnyImageMemory(const u8* bytes, size_t size, ScratchImage& ou
     return LoadFromWICMemory(bytes, size, wicFlags, nullptr, out);
 }
 
+static u64 GetImagesByteSize(const Image* images, size_t count)
+{
+    u64 bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+        bytes += images[i].slicePitch;
+    return bytes;
+}
+
 enum : u32
 {
     IMG_BASECOLOR = 1u << 0,
@@ -359,6 +335,134 @@ static std::vector<u32> BuildImageUsageFlags(const fastgltf::Asset& asset)
 constexpr int kOpacityMicromapStates = 4;
 constexpr int kOpacityMicromapMaxLevel = 6;
 constexpr f32 kOpacityMicromapTargetEdge = 3.0f;
+constexpr size_t kOpacityMicromapRasterizeChunk = 64;
+
+constexpr u64 kFnvOffsetBasis = 14695981039346656037ull;
+constexpr u64 kFnvPrime = 1099511628211ull;
+
+static void HashBytes(u64& hash, const void* data, size_t size)
+{
+    const u8* bytes = static_cast<const u8*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+}
+
+// Worker threads that live for the whole run. Every alpha-masked primitive rasterizes its micromaps through ParallelForChunks,
+// so creating threads per call cost more than the work itself on scenes with many small masked primitives.
+class PackWorkerPool
+{
+  public:
+    explicit PackWorkerPool(size_t workerCount)
+    {
+        m_Workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i)
+            m_Workers.emplace_back([this, i] { WorkerMain(i); });
+    }
+    ~PackWorkerPool()
+    {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_WakeCv.notify_all();
+        for (std::thread& t : m_Workers)
+            t.join();
+    }
+
+    PackWorkerPool(const PackWorkerPool&) = delete;
+    PackWorkerPool& operator=(const PackWorkerPool&) = delete;
+
+    size_t GetThreadCount() const
+    {
+        return m_Workers.size() + 1;
+    }
+
+    // Runs job on the calling thread and on up to helperCount workers, and returns once all of them have finished. Calls
+    // are serialized; a job must not call Run itself.
+    void Run(size_t helperCount, const std::function<void()>& job)
+    {
+        std::lock_guard runLock(m_RunMutex);
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Job = &job;
+            m_HelperCount = std::min(helperCount, m_Workers.size());
+            m_Pending = m_HelperCount;
+            ++m_Generation;
+        }
+        m_WakeCv.notify_all();
+        job();
+
+        std::unique_lock lock(m_Mutex);
+        m_DoneCv.wait(lock, [this] { return m_Pending == 0; });
+        m_Job = nullptr;
+    }
+
+  private:
+    void WorkerMain(size_t workerIndex)
+    {
+        Profiler::SetThreadName("Packer Worker");
+        u64 seenGeneration = 0;
+        std::unique_lock lock(m_Mutex);
+        for (;;)
+        {
+            m_WakeCv.wait(lock, [&] { return m_Stop || m_Generation != seenGeneration; });
+            if (m_Stop)
+                return;
+            seenGeneration = m_Generation;
+            if (workerIndex >= m_HelperCount)
+                continue;
+
+            const std::function<void()>* job = m_Job;
+            lock.unlock();
+            (*job)();
+            lock.lock();
+            if (--m_Pending == 0)
+                m_DoneCv.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_RunMutex;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeCv;
+    std::condition_variable m_DoneCv;
+    const std::function<void()>* m_Job = nullptr;
+    size_t m_HelperCount = 0;
+    size_t m_Pending = 0;
+    u64 m_Generation = 0;
+    bool m_Stop = false;
+};
+
+// Owned by main; null until it starts, in which case ParallelForChunks runs on the calling thread only.
+static PackWorkerPool* g_PackWorkers = nullptr;
+
+// Splits [0, count) into chunks of at least minChunkSize items and runs fn(begin, end) on them across the pack workers.
+template <typename Fn> static void ParallelForChunks(size_t count, size_t minChunkSize, Fn&& fn)
+{
+    const size_t threadCount = g_PackWorkers ? g_PackWorkers->GetThreadCount() : 1;
+    const size_t chunkSize = std::max<size_t>(std::max<size_t>(minChunkSize, 1), (count + threadCount * 4 - 1) / (threadCount * 4));
+    const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    if (chunkCount <= 1 || threadCount == 1)
+    {
+        if (count > 0)
+            fn(size_t{0}, count);
+        return;
+    }
+
+    std::atomic<size_t> nextChunk{0};
+    const std::function<void()> worker = [&] {
+        IE_PROFILE_SCOPE("Parallel Chunks");
+        for (size_t c = nextChunk.fetch_add(1, std::memory_order_relaxed); c < chunkCount; c = nextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            const size_t begin = c * chunkSize;
+            fn(begin, std::min(count, begin + chunkSize));
+        }
+    };
+    g_PackWorkers->Run(std::min(threadCount, chunkCount) - 1, worker);
+}
 
 struct DecodedRgba8Image
 {
@@ -374,16 +478,49 @@ struct MaskMaterialAlphaSource
     u32 imageIndex = UINT32_MAX;
     u32 width = 0;
     u32 height = 0;
-    u32 rowPitch = 0;
-    std::vector<u8> pixels;
+    // Tightly packed 8-bit alpha remapped to a 0.5 cutoff; shared by all materials with the same image, alpha factor, and cutoff.
+    std::shared_ptr<const std::vector<u8>> alpha;
 };
 
 struct OMMBuildStats
 {
     u32 maskedPrimitiveCount = 0;
+    u32 reusedPrimitiveCount = 0;
+    u32 sharedDataBlockCount = 0;
     u64 entryCount = 0;
     u64 dataBytesBeforeCompaction = 0;
     u64 dataBytesAfterCompaction = 0;
+    u64 dataBytesDeduplicated = 0;
+};
+
+// A primitive whose OMMs were already emitted, located through its triangle UVs in the scene vertex/index blobs.
+struct OMMPrimitiveBlock
+{
+    const std::vector<u8>* alpha = nullptr;
+    u64 vertexBase = 0;
+    u64 indexBase = 0;
+    u32 indexCount = 0;
+    u32 ommIndexOffset = 0;
+    u32 ommDescOffset = 0;
+    u32 ommDescCount = 0;
+    u64 ommDataByteOffset = 0;
+    u32 ommDataByteSize = 0;
+};
+
+// A run of OMM descriptors and data already present in the scene blobs.
+struct OMMDataBlock
+{
+    u32 descOffset = 0;
+    u32 descCount = 0;
+    u64 dataByteOffset = 0;
+    u32 dataByteSize = 0;
+};
+
+struct OMMBuildContext
+{
+    OMMBuildStats stats;
+    std::unordered_multimap<u64, OMMPrimitiveBlock> primitivesByInputHash;
+    std::unordered_multimap<u64, OMMDataBlock> dataBlocksByHash;
 };
 
 // ---- MikkTSpace ----
@@ -577,6 +714,7 @@ static bool LoadImageBytes(const fs::path& baseDir, const fastgltf::Asset& asset
 
 static DecodedRgba8Image DecodeImageToRgba8(const fs::path& glbPath, const fastgltf::Asset& asset, size_t imgIndex)
 {
+    PackStageTimer timer(PackStage_DecodeImages);
     const fs::path baseDir = glbPath.parent_path();
     const u8* raw = nullptr;
     size_t rawSize = 0;
@@ -615,6 +753,7 @@ static DecodedRgba8Image DecodeImageToRgba8(const fs::path& glbPath, const fastg
         std::memcpy(out.pixels.data() + static_cast<size_t>(y) * out.rowPitch, srcImage->pixels + static_cast<size_t>(y) * srcImage->rowPitch, out.rowPitch);
     }
 
+    AddPackStageWork(PackStage_DecodeImages, 1, rawSize, out.pixels.size());
     return out;
 }
 
@@ -636,8 +775,16 @@ static f32 RemapAlphaToHalfCutoff(f32 alpha, f32 alphaCutoff)
 
 static std::vector<MaskMaterialAlphaSource> BuildMaskMaterialAlphaSources(const fs::path& glbPath, const fastgltf::Asset& asset)
 {
+    struct DecodedAlpha
+    {
+        u32 width = 0;
+        u32 height = 0;
+        std::shared_ptr<const std::vector<u8>> alpha;
+    };
+
     std::vector<MaskMaterialAlphaSource> out(asset.materials.size());
-    std::unordered_map<u32, DecodedRgba8Image> imageCache;
+    std::unordered_map<u32, DecodedAlpha> imageCache;
+    std::map<std::tuple<u32, f32, f32>, std::shared_ptr<const std::vector<u8>>> remappedCache;
 
     for (size_t i = 0; i < asset.materials.size(); ++i)
     {
@@ -668,7 +815,19 @@ static std::vector<MaskMaterialAlphaSource> BuildMaskMaterialAlphaSources(const
         const u32 imageIndex = static_cast<u32>(*texture.imageIndex);
         auto cacheIt = imageCache.find(imageIndex);
         if (cacheIt == imageCache.end())
-            cacheIt = imageCache.emplace(imageIndex, DecodeImageToRgba8(glbPath, asset, imageIndex)).first;
+        {
+            // Keep only the alpha channel; the RGBA decode is released as soon as it has been extracted.
+            const DecodedRgba8Image image = DecodeImageToRgba8(glbPath, asset, imageIndex);
+            auto alpha = std::make_shared<std::vector<u8>>(static_cast<size_t>(image.width) * image.height);
+            for (u32 y = 0; y < image.height; ++y)
+            {
+                const u8* row = image.pixels.data() + static_cast<size_t>(y) * image.rowPitch;
+                u8* dst = alpha->data() + static_cast<size_t>(y) * image.width;
+                for (u32 x = 0; x < image.width; ++x)
+                    dst[x] = row[x * 4 + 3];
+            }
+            cacheIt = imageCache.emplace(imageIndex, DecodedAlpha{image.width, image.height, std::move(alpha)}).first;
+        }
 
         const f32 alphaScale = static_cast<f32>(material.pbrData.baseColorFactor.w());
         const f32 alphaCutoff = static_cast<f32>(material.alphaCutoff);
@@ -688,16 +847,22 @@ static std::vector<MaskMaterialAlphaSource> BuildMaskMaterialAlphaSources(const
         source.imageIndex = imageIndex;
         source.width = cacheIt->second.width;
         source.height = cacheIt->second.height;
-        source.rowPitch = cacheIt->second.rowPitch;
-        source.pixels = cacheIt->second.pixels;
+        source.alpha = cacheIt->second.alpha;
 
         if (alphaScale != 1.0f || alphaCutoff != 0.5f)
         {
-            for (size_t p = 3; p < source.pixels.size(); p += 4)
+            std::shared_ptr<const std::vector<u8>>& remapped = remappedCache[{imageIndex, alphaScale, alphaCutoff}];
+            if (!remapped)
             {
-                const f32 alpha = (static_cast<f32>(source.pixels[p]) / 255.0f) * alphaScale;
-                source.pixels[p] = QuantizeUnorm8(RemapAlphaToHalfCutoff(alpha, alphaCutoff));
+                auto pixels = std::make_shared<std::vector<u8>>(*source.alpha);
+                for (u8& a : *pixels)
+                {
+                    const f32 alpha = (static_cast<f32>(a) / 255.0f) * alphaScale;
+                    a = QuantizeUnorm8(RemapAlphaToHalfCutoff(alpha, alphaCutoff));
+                }
+                remapped = std::move(pixels);
             }
+            source.alpha = remapped;
         }
     }
 
@@ -733,6 +898,7 @@ static void BuildTexturesToMemory(const fs::path& glbPath, const fastgltf::Asset
                    },
                    img.data);
 
+        PackStageTimer decodeTimer(PackStage_DecodeImages);
         const u8* raw = nullptr;
         size_t rawSize = 0;
         std::vector<u8> owned;
@@ -778,6 +944,8 @@ static void BuildTexturesToMemory(const fs::path& glbPath, const fastgltf::Asset
             srcCount = loaded.GetImageCount();
             meta = loaded.GetMetadata();
         }
+        AddPackStageWork(PackStage_DecodeImages, 1, rawSize, GetImagesByteSize(srcImages, srcCount));
+        decodeTimer.Stop();
 
         ScratchImage mip;
         TEX_FILTER_FLAGS mipFilter = TEX_FILTER_LINEAR;
@@ -786,11 +954,16 @@ static void BuildTexturesToMemory(const fs::path& glbPath, const fastgltf::Asset
         if (isNonColor)
             mipFilter = static_cast<TEX_FILTER_FLAGS>(mipFilter | TEX_FILTER_FORCE_NON_WIC);
 
-        if (SUCCEEDED(GenerateMipMaps(srcImages, srcCount, meta, mipFilter, 0, mip)))
         {
-            srcImages = mip.GetImages();
-            srcCount = mip.GetImageCount();
-            meta = mip.GetMetadata();
+            PackStageTimer mipTimer(PackStage_GenerateMips);
+            const u64 baseBytes = GetImagesByteSize(srcImages, srcCount);
+            if (SUCCEEDED(GenerateMipMaps(srcImages, srcCount, meta, mipFilter, 0, mip)))
+            {
+                srcImages = mip.GetImages();
+                srcCount = mip.GetImageCount();
+                meta = mip.GetMetadata();
+            }
+            AddPackStageWork(PackStage_GenerateMips, 1, baseBytes, GetImagesByteSize(srcImages, srcCount));
         }
 
         DXGI_FORMAT compFmt = isNormal ? DXGI_FORMAT_BC5_UNORM : (isSRGB ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM);
@@ -799,12 +972,15 @@ static void BuildTexturesToMemory(const fs::path& glbPath, const fastgltf::Asset
             comp |= TEX_COMPRESS_BC7_QUICK;
 
         ScratchImage bc;
+        PackStageTimer compressTimer(PackStage_CompressBC);
         HRESULT hrComp = Compress(srcImages, srcCount, meta, compFmt, comp, 0.5f, bc);
         if (!IE_Try(hrComp) && (comp & TEX_COMPRESS_BC7_QUICK))
         {
             TEX_COMPRESS_FLAGS retryComp = static_cast<TEX_COMPRESS_FLAGS>(comp & ~TEX_COMPRESS_BC7_QUICK);
             hrComp = Compress(srcImages, srcCount, meta, compFmt, retryComp, 0.5f, bc);
         }
+        AddPackStageWork(PackStage_CompressBC, 1, GetImagesByteSize(srcImages, srcCount), bc.GetPixelsSize());
+        compressTimer.Stop();
 
         if (!IE_Try(hrComp))
             Fatal("BC compression failed");
@@ -1074,9 +1250,35 @@ static void BuildMaterialTable(const fastgltf::Asset& asset, const std::vector<T
     }
 }
 
+static u64 HashOpacityMicromapInputs(const MaskMaterialAlphaSource& source, const std::vector<Vertex>& vertices, const std::vector<u32>& indices)
+{
+    u64 hash = kFnvOffsetBasis;
+    const uintptr_t alphaId = reinterpret_cast<uintptr_t>(source.alpha.get());
+    HashBytes(hash, &alphaId, sizeof(alphaId));
+    for (u32 index : indices)
+        HashBytes(hash, &vertices[index].texCoordPacked, sizeof(u32));
+    return hash;
+}
+
+// Exact check behind a HashOpacityMicromapInputs hit: same alpha source and bit-identical UVs for every triangle corner.
+static bool HasSameOpacityMicromapInputs(const OMMPrimitiveBlock& block, const MaskMaterialAlphaSource& source, const std::vector<Vertex>& vertices, const std::vector<u32>& indices,
+                                         const std::vector<Vertex>& blobVertices, const std::vector<u32>& blobIndices)
+{
+    if (block.alpha != source.alpha.get() || block.indexCount != indices.size())
+        return false;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const Vertex& emitted = blobVertices[block.vertexBase + blobIndices[block.indexBase + i]];
+        if (emitted.texCoordPacked != vertices[indices[i]].texCoordPacked)
+            return false;
+    }
+    return true;
+}
+
 static void BuildPrimitiveOpacityMicromap(u32 materialIndex, size_t meshIdx, size_t primIdx, bool hasTexcoords, const std::vector<Vertex>& outVertices, const std::vector<u32>& outIndices,
-                                          const std::vector<MaskMaterialAlphaSource>& alphaSources, PrimRecord& outPrim, std::vector<i32>& blobOmmIndices,
-                                          std::vector<OpacityMicromapDescRecord>& blobOmmDescs, std::vector<u8>& blobOmmData, OMMBuildStats& stats)
+                                          const std::vector<Vertex>& blobVertices, const std::vector<u32>& blobIndices, const std::vector<MaskMaterialAlphaSource>& alphaSources,
+                                          PrimRecord& outPrim, std::vector<i32>& blobOmmIndices, std::vector<OpacityMicromapDescRecord>& blobOmmDescs, std::vector<u8>& blobOmmData,
+                                          OMMBuildContext& omm)
 {
     if (materialIndex >= alphaSources.size())
         return;
@@ -1097,11 +1299,34 @@ static void BuildPrimitiveOpacityMicromap(u32 materialIndex, size_t meshIdx, siz
     Require(blobOmmDescs.size() <= UINT32_MAX, "Scene OMM descriptor table exceeds pack format limits");
     Require(blobOmmData.size() <= UINT64_MAX, "Scene OMM data blob exceeds pack format limits");
 
+    const size_t triangleCount = outIndices.size() / 3;
+    OMMBuildStats& stats = omm.stats;
+
+    // Instanced foliage often repeats the same mesh as separate glTF primitives: reuse the whole OMM block when the UVs and alpha source match.
+    const u64 inputHash = HashOpacityMicromapInputs(source, outVertices, outIndices);
+    const auto [reuseBegin, reuseEnd] = omm.primitivesByInputHash.equal_range(inputHash);
+    for (auto it = reuseBegin; it != reuseEnd; ++it)
+    {
+        const OMMPrimitiveBlock& block = it->second;
+        if (!HasSameOpacityMicromapInputs(block, source, outVertices, outIndices, blobVertices, blobIndices))
+            continue;
+
+        outPrim.ommIndexOffset = block.ommIndexOffset;
+        outPrim.ommIndexCount = static_cast<u32>(triangleCount);
+        outPrim.ommDescOffset = block.ommDescOffset;
+        outPrim.ommDescCount = block.ommDescCount;
+        outPrim.ommDataByteOffset = block.ommDataByteOffset;
+        outPrim.ommDataByteSize = block.ommDataByteSize;
+        outPrim.ommFormat = kOpacityMicromapStates;
+        stats.maskedPrimitiveCount += 1;
+        stats.reusedPrimitiveCount += 1;
+        return;
+    }
+
     std::vector<XMFLOAT2> ommUvs(outVertices.size());
     for (size_t i = 0; i < outVertices.size(); ++i)
         ommUvs[i] = UnpackTexCoordHalf2(outVertices[i].texCoordPacked);
 
-    const size_t triangleCount = outIndices.size() / 3;
     std::vector<unsigned char> levels(triangleCount);
     std::vector<unsigned int> sources(triangleCount);
     std::vector<int> ommIndices(triangleCount);
@@ -1113,23 +1338,26 @@ static void BuildPrimitiveOpacityMicromap(u32 materialIndex, size_t meshIdx, siz
     size_t dataSizeBeforeCompaction = 0;
     for (size_t i = 0; i < ommCount; ++i)
     {
+        Require(sources[i] < triangleCount, "OMM source triangle index is out of range");
         Require(dataSizeBeforeCompaction <= UINT32_MAX, "Primitive OMM data exceeds pack format limits");
         offsets[i] = static_cast<unsigned int>(dataSizeBeforeCompaction);
         dataSizeBeforeCompaction += meshopt_opacityMapEntrySize(levels[i], kOpacityMicromapStates);
     }
     Require(dataSizeBeforeCompaction <= UINT32_MAX, "Primitive OMM data exceeds pack format limits");
 
+    // Entries write disjoint ranges of data, so they rasterize independently.
     std::vector<u8> data(dataSizeBeforeCompaction);
-    const u8* const alphaChannel = source.pixels.data() + 3;
-    for (size_t i = 0; i < ommCount; ++i)
-    {
-        const unsigned int tri = sources[i];
-        Require(tri < triangleCount, "OMM source triangle index is out of range");
-        const f32* uv0 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 0]]);
-        const f32* uv1 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 1]]);
-        const f32* uv2 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 2]]);
-        meshopt_opacityMapRasterize(data.data() + offsets[i], levels[i], kOpacityMicromapStates, uv0, uv1, uv2, alphaChannel, 4, source.rowPitch, source.width, source.height);
-    }
+    const u8* const alpha = source.alpha->data();
+    ParallelForChunks(ommCount, kOpacityMicromapRasterizeChunk, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const unsigned int tri = sources[i];
+            const f32* uv0 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 0]]);
+            const f32* uv1 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 1]]);
+            const f32* uv2 = reinterpret_cast<const f32*>(&ommUvs[outIndices[tri * 3 + 2]]);
+            meshopt_opacityMapRasterize(data.data() + offsets[i], levels[i], kOpacityMicromapStates, uv0, uv1, uv2, alpha, 1, source.width, source.width, source.height);
+        }
+    });
 
     size_t compactedCount = meshopt_opacityMapCompact(data.data(), data.size(), levels.data(), offsets.data(), ommCount, ommIndices.data(), triangleCount, kOpacityMicromapStates);
     const size_t dataSizeAfterCompaction =
@@ -1153,29 +1381,213 @@ static void BuildPrimitiveOpacityMicromap(u32 materialIndex, size_t meshIdx, siz
     for (int ommIndex : ommIndices)
         blobOmmIndices.push_back(static_cast<i32>(ommIndex));
 
-    for (size_t i = 0; i < compactedCount; ++i)
+    // Different UV layouts can still compact to identical micromaps (fully opaque cards, tiled atlases); share the descriptor and data runs.
+    u64 dataHash = kFnvOffsetBasis;
+    HashBytes(dataHash, levels.data(), compactedCount);
+    HashBytes(dataHash, data.data(), dataSizeAfterCompaction);
+    bool sharedData = false;
+    const auto [blockBegin, blockEnd] = omm.dataBlocksByHash.equal_range(dataHash);
+    for (auto it = blockBegin; it != blockEnd && !sharedData; ++it)
     {
-        const size_t entrySize = meshopt_opacityMapEntrySize(levels[i], kOpacityMicromapStates);
-        Require(offsets[i] <= UINT32_MAX && entrySize <= UINT32_MAX, "Primitive OMM entry exceeds pack format limits");
-        OpacityMicromapDescRecord desc{};
-        desc.dataByteOffset = offsets[i];
-        desc.dataByteSize = static_cast<u32>(entrySize);
-        desc.subdivisionLevel = levels[i];
-        desc.reserved = 0;
-        blobOmmDescs.push_back(desc);
+        const OMMDataBlock& block = it->second;
+        if (block.descCount != compactedCount || block.dataByteSize != dataSizeAfterCompaction)
+            continue;
+        bool same = std::memcmp(blobOmmData.data() + block.dataByteOffset, data.data(), dataSizeAfterCompaction) == 0;
+        for (size_t i = 0; same && i < compactedCount; ++i)
+            same = blobOmmDescs[block.descOffset + i].subdivisionLevel == levels[i];
+        if (!same)
+            continue;
+
+        outPrim.ommDescOffset = block.descOffset;
+        outPrim.ommDataByteOffset = block.dataByteOffset;
+        sharedData = true;
     }
-    blobOmmData.insert(blobOmmData.end(), data.begin(), data.begin() + dataSizeAfterCompaction);
+
+    if (!sharedData)
+    {
+        for (size_t i = 0; i < compactedCount; ++i)
+        {
+            const size_t entrySize = meshopt_opacityMapEntrySize(levels[i], kOpacityMicromapStates);
+            Require(offsets[i] <= UINT32_MAX && entrySize <= UINT32_MAX, "Primitive OMM entry exceeds pack format limits");
+            OpacityMicromapDescRecord desc{};
+            desc.dataByteOffset = offsets[i];
+            desc.dataByteSize = static_cast<u32>(entrySize);
+            desc.subdivisionLevel = levels[i];
+            desc.reserved = 0;
+            blobOmmDescs.push_back(desc);
+        }
+        blobOmmData.insert(blobOmmData.end(), data.begin(), data.begin() + dataSizeAfterCompaction);
+        omm.dataBlocksByHash.emplace(dataHash, OMMDataBlock{outPrim.ommDescOffset, outPrim.ommDescCount, outPrim.ommDataByteOffset, outPrim.ommDataByteSize});
+    }
+
+    OMMPrimitiveBlock reuse{};
+    reuse.alpha = source.alpha.get();
+    reuse.vertexBase = outPrim.vertexByteOffset / sizeof(Vertex);
+    reuse.indexBase = outPrim.indexByteOffset / sizeof(u32);
+    reuse.indexCount = static_cast<u32>(outIndices.size());
+    reuse.ommIndexOffset = outPrim.ommIndexOffset;
+    reuse.ommDescOffset = outPrim.ommDescOffset;
+    reuse.ommDescCount = outPrim.ommDescCount;
+    reuse.ommDataByteOffset = outPrim.ommDataByteOffset;
+    reuse.ommDataByteSize = outPrim.ommDataByteSize;
+    omm.primitivesByInputHash.emplace(inputHash, reuse);
 
     stats.maskedPrimitiveCount += 1;
     stats.entryCount += compactedCount;
     stats.dataBytesBeforeCompaction += dataSizeBeforeCompaction;
     stats.dataBytesAfterCompaction += dataSizeAfterCompaction;
+    if (sharedData)
+    {
+        stats.sharedDataBlockCount += 1;
+        stats.dataBytesDeduplicated += dataSizeAfterCompaction;
+    }
+}
+
+// Cyclic Jacobi on a symmetric 3x3 matrix. On return the columns of v are the eigenvectors of a.
+static void SymmetricEigenvectors3x3(f64 a[3][3], f64 v[3][3])
+{
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+
+    constexpr int pairs[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    for (int sweep = 0; sweep < 32; ++sweep)
+    {
+        const f64 offDiag = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        const f64 diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+        if (offDiag <= 1e-24 * std::max(diag, 1e-300))
+            break;
+
+        for (const auto& pq : pairs)
+        {
+            const int p = pq[0];
+            const int q = pq[1];
+            if (std::abs(a[p][q]) < 1e-300)
+                continue;
+
+            const f64 theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+            const f64 t = ((theta >= 0.0) ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+            const f64 c = 1.0 / std::sqrt(t * t + 1.0);
+            const f64 sn = t * c;
+
+            for (int k = 0; k < 3; ++k)
+            {
+                const f64 akp = a[k][p];
+                const f64 akq = a[k][q];
+                a[k][p] = c * akp - sn * akq;
+                a[k][q] = sn * akp + c * akq;
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                const f64 apk = a[p][k];
+                const f64 aqk = a[q][k];
+                a[p][k] = c * apk - sn * aqk;
+                a[q][k] = sn * apk + c * aqk;
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                const f64 vkp = v[k][p];
+                const f64 vkq = v[k][q];
+                v[k][p] = c * vkp - sn * vkq;
+                v[k][q] = sn * vkp + c * vkq;
+            }
+        }
+    }
+}
+
+struct LocalBoundingBox
+{
+    XMFLOAT3 center = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT3 halfExtents = XMFLOAT3(0.0f, 0.0f, 0.0f);
+    XMFLOAT4 rotation = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+};
+
+// Fits a PCA-oriented box to the vertex positions and keeps it only when it is tighter than the AABB.
+// Long, thin or diagonal geometry (rails, pipes, roads) is where the oriented fit pays off.
+static LocalBoundingBox ComputeLocalBoundingBox(const std::vector<Vertex>& verts, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax)
+{
+    LocalBoundingBox aabb{};
+    aabb.center = XMFLOAT3(0.5f * (aabbMin.x + aabbMax.x), 0.5f * (aabbMin.y + aabbMax.y), 0.5f * (aabbMin.z + aabbMax.z));
+    aabb.halfExtents = XMFLOAT3(0.5f * (aabbMax.x - aabbMin.x), 0.5f * (aabbMax.y - aabbMin.y), 0.5f * (aabbMax.z - aabbMin.z));
+    if (verts.size() < 4)
+        return aabb;
+
+    f64 mean[3] = {0.0, 0.0, 0.0};
+    for (const Vertex& v : verts)
+    {
+        mean[0] += v.position.x;
+        mean[1] += v.position.y;
+        mean[2] += v.position.z;
+    }
+    const f64 invCount = 1.0 / static_cast<f64>(verts.size());
+    for (f64& m : mean)
+        m *= invCount;
+
+    f64 cov[3][3] = {};
+    for (const Vertex& v : verts)
+    {
+        const f64 d[3] = {v.position.x - mean[0], v.position.y - mean[1], v.position.z - mean[2]};
+        for (int i = 0; i < 3; ++i)
+            for (int j = i; j < 3; ++j)
+                cov[i][j] += d[i] * d[j];
+    }
+    cov[1][0] = cov[0][1];
+    cov[2][0] = cov[0][2];
+    cov[2][1] = cov[1][2];
+
+    f64 eig[3][3];
+    SymmetricEigenvectors3x3(cov, eig);
+
+    XMFLOAT3 axes[3];
+    for (int i = 0; i < 3; ++i)
+        axes[i] = NormalizeSafe(XMFLOAT3(static_cast<f32>(eig[0][i]), static_cast<f32>(eig[1][i]), static_cast<f32>(eig[2][i])));
+
+    // Re-orthonormalize and force a right-handed basis so the frame converts to a rotation quaternion.
+    XMVECTOR a0 = XMLoadFloat3(&axes[0]);
+    XMVECTOR a1 = XMLoadFloat3(&axes[1]);
+    a1 = XMVector3Normalize(XMVectorSubtract(a1, XMVectorScale(a0, XMVectorGetX(XMVector3Dot(a0, a1)))));
+    const XMVECTOR a2 = XMVector3Cross(a0, a1);
+    if (!IsFiniteF32(XMVectorGetX(XMVector3LengthSq(a2))) || XMVectorGetX(XMVector3LengthSq(a2)) < 0.5f)
+        return aabb;
+    XMStoreFloat3(&axes[0], a0);
+    XMStoreFloat3(&axes[1], a1);
+    XMStoreFloat3(&axes[2], a2);
+
+    constexpr f32 maxF32 = std::numeric_limits<f32>::max();
+    f32 minProj[3] = {maxF32, maxF32, maxF32};
+    f32 maxProj[3] = {-maxF32, -maxF32, -maxF32};
+    for (const Vertex& v : verts)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const f32 d = v.position.x * axes[i].x + v.position.y * axes[i].y + v.position.z * axes[i].z;
+            minProj[i] = std::min(minProj[i], d);
+            maxProj[i] = std::max(maxProj[i], d);
+        }
+    }
+
+    LocalBoundingBox obb{};
+    obb.halfExtents = XMFLOAT3(0.5f * (maxProj[0] - minProj[0]), 0.5f * (maxProj[1] - minProj[1]), 0.5f * (maxProj[2] - minProj[2]));
+    const f32 mid[3] = {0.5f * (minProj[0] + maxProj[0]), 0.5f * (minProj[1] + maxProj[1]), 0.5f * (minProj[2] + maxProj[2])};
+    obb.center = XMFLOAT3(axes[0].x * mid[0] + axes[1].x * mid[1] + axes[2].x * mid[2], axes[0].y * mid[0] + axes[1].y * mid[1] + axes[2].y * mid[2],
+                          axes[0].z * mid[0] + axes[1].z * mid[1] + axes[2].z * mid[2]);
+
+    // Rows of the rotation are the box axes in object space (row-vector convention: objectPos = boxPos * R).
+    const XMMATRIX rotation = XMMatrixSet(axes[0].x, axes[0].y, axes[0].z, 0.0f, axes[1].x, axes[1].y, axes[1].z, 0.0f, axes[2].x, axes[2].y, axes[2].z, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    XMStoreFloat4(&obb.rotation, XMQuaternionNormalize(XMQuaternionRotationMatrix(rotation)));
+
+    // Compare volumes with a small floor on each extent so flat (planar) meshes still pick the better fit.
+    const f32 extentFloor = 1e-4f * std::max({aabb.halfExtents.x, aabb.halfExtents.y, aabb.halfExtents.z, 1e-6f});
+    const auto volume = [extentFloor](const XMFLOAT3& h) { return (h.x + extentFloor) * (h.y + extentFloor) * (h.z + extentFloor); };
+    if (!IsFiniteFloat3(obb.center) || !IsFiniteFloat3(obb.halfExtents) || !IsFiniteFloat4(obb.rotation) || volume(obb.halfExtents) >= volume(aabb.halfExtents))
+        return aabb;
+    return obb;
 }
 
 static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx, size_t primIdx, std::vector<Vertex>& blobVertices, std::vector<u32>& blobIndices,
                                     std::vector<IskurMeshlet>& blobMeshlets, std::vector<u32>& blobMLVerts, std::vector<u8>& blobMLTris,
                                     std::vector<MeshletBounds>& blobMLBounds, const std::vector<MaskMaterialAlphaSource>& alphaSources, std::vector<i32>& blobOmmIndices,
-                                    std::vector<OpacityMicromapDescRecord>& blobOmmDescs, std::vector<u8>& blobOmmData, OMMBuildStats& ommStats)
+                                    std::vector<OpacityMicromapDescRecord>& blobOmmDescs, std::vector<u8>& blobOmmData, OMMBuildContext& omm)
 {
     const auto& gltfPrim = asset.meshes[meshIdx].primitives[primIdx];
     if (gltfPrim.type != fastgltf::PrimitiveType::Triangles)
@@ -1335,8 +1747,13 @@ static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx
         }
     }
     if (!texcoords.empty())
+    {
+        PackStageTimer tangentTimer(PackStage_Tangents);
         ComputeTangentsMikk(initialIndices, initialVertices);
+        AddPackStageWork(PackStage_Tangents, 1, initialVertices.size() * sizeof(Vertex), initialVertices.size() * sizeof(Vertex));
+    }
 
+    PackStageTimer optimizeTimer(PackStage_OptimizeMesh);
     std::vector<u32> remap(initialIndices.size());
     const size_t totalVertices = meshopt_generateVertexRemap(remap.data(), initialIndices.data(), initialIndices.size(), initialVertices.data(), initialVertices.size(), sizeof(Vertex));
     std::vector<u32> outIndices(initialIndices.size());
@@ -1346,7 +1763,11 @@ static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx
     meshopt_optimizeVertexCache(outIndices.data(), outIndices.data(), outIndices.size(), outVertices.size());
     meshopt_optimizeOverdraw(outIndices.data(), outIndices.data(), outIndices.size(), &outVertices[0].position.x, outVertices.size(), sizeof(Vertex), 1.05f);
     meshopt_optimizeVertexFetch(outVertices.data(), outIndices.data(), outIndices.size(), outVertices.data(), outVertices.size(), sizeof(Vertex));
+    AddPackStageWork(PackStage_OptimizeMesh, 1, initialVertices.size() * sizeof(Vertex) + initialIndices.size() * sizeof(u32),
+                     outVertices.size() * sizeof(Vertex) + outIndices.size() * sizeof(u32));
+    optimizeTimer.Stop();
 
+    PackStageTimer meshletTimer(PackStage_BuildMeshlets);
     constexpr size_t maxVertices = 64, maxTriangles = 126;
     constexpr f32 coneWeight = 0.25f;
     const size_t maxMeshlets = meshopt_buildMeshletsBound(outIndices.size(), maxVertices, maxTriangles);
@@ -1392,9 +1813,13 @@ static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx
         meshlets[i].vertexCount = temp[i].vertex_count;
         meshlets[i].triangleCount = temp[i].triangle_count;
     }
+    AddPackStageWork(PackStage_BuildMeshlets, meshlets.size(), outIndices.size() * sizeof(u32),
+                     meshlets.size() * sizeof(IskurMeshlet) + mlVerts.size() * sizeof(u32) + mlTris.size() + mlBounds.size() * sizeof(MeshletBounds));
+    meshletTimer.Stop();
 
     XMFLOAT3 localBoundsCenter = XMFLOAT3(0.0f, 0.0f, 0.0f);
     f32 localBoundsRadius = 0.0f;
+    LocalBoundingBox localBox{};
     if (!outVertices.empty())
     {
         XMFLOAT3 minPos = outVertices[0].position;
@@ -1423,9 +1848,13 @@ static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx
             maxDistSq = std::max(maxDistSq, distSq);
         }
         localBoundsRadius = std::sqrt(maxDistSq);
+        localBox = ComputeLocalBoundingBox(outVertices, minPos, maxPos);
     }
     Require(IsFiniteFloat3(localBoundsCenter), "Primitive local bounds center contains NaN/Inf");
     Require(IsFiniteF32(localBoundsRadius) && localBoundsRadius >= 0.0f, "Primitive local bounds radius is invalid");
+    Require(IsFiniteFloat3(localBox.center) && IsFiniteFloat4(localBox.rotation), "Primitive local bounding box contains NaN/Inf");
+    Require(IsFiniteFloat3(localBox.halfExtents) && localBox.halfExtents.x >= 0.0f && localBox.halfExtents.y >= 0.0f && localBox.halfExtents.z >= 0.0f,
+            "Primitive local bounding box extents are invalid");
 
     PrimRecord r{};
     r.meshIndex = static_cast<u32>(meshIdx);
@@ -1447,9 +1876,19 @@ static PrimRecord BuildOnePrimitive(const fastgltf::Asset& asset, size_t meshIdx
     r.mlVertsByteOffset = blobMLVerts.size() * sizeof(u32);
     r.mlTrisByteOffset = blobMLTris.size();
     r.mlBoundsByteOffset = blobMLBounds.size() * sizeof(MeshletBounds);
-    r.localBoundsCenter = localBoundsCenter;
+    std::memcpy(r.localBoundsCenter, &localBoundsCenter, sizeof(r.localBoundsCenter));
     r.localBoundsRadius = localBoundsRadius;
-    BuildPrimitiveOpacityMicromap(materialIndex, meshIdx, primIdx, !texcoords.empty(), outVertices, outIndices, alphaSources, r, blobOmmIndices, blobOmmDescs, blobOmmData, ommStats);
+    std::memcpy(r.localBoxCenter, &localBox.center, sizeof(r.localBoxCenter));
+    std::memcpy(r.localBoxHalfExtents, &localBox.halfExtents, sizeof(r.localBoxHalfExtents));
+    std::memcpy(r.localBoxRotation, &localBox.rotation, sizeof(r.localBoxRotation));
+    {
+        PackStageTimer ommTimer(PackStage_BuildOMM);
+        const size_t ommBytesBefore = blobOmmIndices.size() * sizeof(i32) + blobOmmDescs.size() * sizeof(OpacityMicromapDescRecord) + blobOmmData.size();
+        BuildPrimitiveOpacityMicromap(materialIndex, meshIdx, primIdx, !texcoords.empty(), outVertices, outIndices, blobVertices, blobIndices, alphaSources, r, blobOmmIndices,
+                                      blobOmmDescs, blobOmmData, omm);
+        const size_t ommBytesAfter = blobOmmIndices.size() * sizeof(i32) + blobOmmDescs.size() * sizeof(OpacityMicromapDescRecord) + blobOmmData.size();
+        AddPackStageWork(PackStage_BuildOMM, r.ommDescCount, 0, ommBytesAfter - ommBytesBefore);
+    }
 
     blobVertices.insert(blobVertices.end(), outVertices.begin(), outVertices.end());
     blobIndices.insert(blobIndices.end(), outIndices.begin(), outIndices.end());
@@ -1497,8 +1936,10 @@ static void GatherInstances_Recursive(const fastgltf::Asset& asset, size_t nodeI
                 continue;
             InstanceRecord inst{};
             inst.primIndex = primIndex;
-            XMStoreFloat4x4(&inst.world, world);
-            Require(IsFiniteFloat4x4(inst.world), "Instance world matrix contains NaN/Inf");
+            XMFLOAT4X4 world4x4{};
+            XMStoreFloat4x4(&world4x4, world);
+            Require(IsFiniteFloat4x4(world4x4), "Instance world matrix contains NaN/Inf");
+            std::memcpy(inst.world, &world4x4, sizeof(inst.world));
             XMVECTOR det{};
             const XMMATRIX worldInv = XMMatrixInverse(&det, world);
             XMFLOAT4X4 worldInv4x4{};
@@ -1551,16 +1992,21 @@ static void ProcessAllMeshesAndWritePack(const fs::path& outPackPath, const fs::
     std::vector<i32> blobOmmIndices;
     std::vector<OpacityMicromapDescRecord> blobOmmDescs;
     std::vector<u8> blobOmmData;
-    const std::vector<MaskMaterialAlphaSource> alphaSources = BuildMaskMaterialAlphaSources(glbPath, asset);
-    OMMBuildStats ommStats{};
+    std::vector<MaskMaterialAlphaSource> alphaSources;
+    {
+        IE_PROFILE_SCOPE("Decode Alpha Sources");
+        alphaSources = BuildMaskMaterialAlphaSources(glbPath, asset);
+    }
+    OMMBuildContext omm{};
 
     for (size_t mi = 0; mi < asset.meshes.size(); ++mi)
     {
+        IE_PROFILE_SCOPE("Build Mesh");
         const auto& mesh = asset.meshes[mi];
         for (size_t pi = 0; pi < mesh.primitives.size(); ++pi)
         {
             PrimRecord r =
-                BuildOnePrimitive(asset, mi, pi, blobVertices, blobIndices, blobMeshlets, blobMLVerts, blobMLTris, blobMLBounds, alphaSources, blobOmmIndices, blobOmmDescs, blobOmmData, ommStats);
+                BuildOnePrimitive(asset, mi, pi, blobVertices, blobIndices, blobMeshlets, blobMLVerts, blobMLTris, blobMLBounds, alphaSources, blobOmmIndices, blobOmmDescs, blobOmmData, omm);
             prims.push_back(r);
         }
     }
@@ -1572,6 +2018,7 @@ static void ProcessAllMeshesAndWritePack(const fs::path& outPackPath, const fs::
     std::vector<TextureSubresourceRecord> texSubresources;
     std::vector<u8> texBlob;
     {
+        IE_PROFILE_SCOPE("Build Textures");
         auto imgUsage = BuildImageUsageFlags(asset);
         BuildTexturesToMemory(glbPath, asset, imgUsage, fastCompress, texTable, texSubresources, texBlob);
         if (!asset.textures.empty() && texTable.empty())
@@ -1675,6 +2122,8 @@ static void ProcessAllMeshesAndWritePack(const fs::path& outPackPath, const fs::
     hdr.mlTrisOffset = ofsMLTris;
     hdr.mlBoundsOffset = ofsMLBounds;
 
+    IE_PROFILE_SCOPE("Write Pack");
+    PackStageTimer writeTimer(PackStage_WritePack);
     std::ofstream out(outPackPath, std::ios::binary | std::ios::trunc);
     if (!out)
         Fatal("Failed to open output pack file");
@@ -1706,12 +2155,17 @@ static void ProcessAllMeshesAndWritePack(const fs::path& outPackPath, const fs::
 
     if (!out.good())
         Fatal("Error writing pack file");
+    AddPackStageWork(PackStage_WritePack, 1, 0, static_cast<u64>(out.tellp()));
+    out.close();
+    writeTimer.Stop();
 
     std::println("Meshes pack written: {}", outPackPath.string());
     std::println("  prims={}, verts={}, inds={}, meshlets={}, mlVerts={}, mlTris={} bytes, mlBounds={}", static_cast<size_t>(hdr.primCount), blobVertices.size(), blobIndices.size(),
                  blobMeshlets.size(), blobMLVerts.size(), blobMLTris.size(), blobMLBounds.size());
-    std::println("  omm: maskedPrims={}, indices={}, entries={}, bytes(before={} after={})", ommStats.maskedPrimitiveCount, blobOmmIndices.size(), ommStats.entryCount,
-                 ommStats.dataBytesBeforeCompaction, ommStats.dataBytesAfterCompaction);
+    const OMMBuildStats& ommStats = omm.stats;
+    std::println("  omm: maskedPrims={} (reused={}), indices={}, entries={}, bytes(before={} after={} shared={} in {} blocks)", ommStats.maskedPrimitiveCount,
+                 ommStats.reusedPrimitiveCount, blobOmmIndices.size(), ommStats.entryCount, ommStats.dataBytesBeforeCompaction, ommStats.dataBytesAfterCompaction,
+                 ommStats.dataBytesDeduplicated, ommStats.sharedDataBlockCount);
     if (!texTable.empty())
         std::println("  textures: {}", texTable.size());
     if (!sampTable.empty())
@@ -1724,7 +2178,8 @@ static void ProcessAllMeshesAndWritePack(const fs::path& outPackPath, const fs::
 
 static void PrintUsage()
 {
-    std::println("IskurScenePacker\nUsage:\n  IskurScenePacker --scene <scene> [--fast]\n  IskurScenePacker --all [--fast]");
+    std::println("IskurScenePacker\nUsage:\n  IskurScenePacker --scene <scene> [--fast] [--trace <file.json>] [--stats-json <file.json>]\n"
+                 "  IskurScenePacker --all [--fast] [--trace <file.json>] [--stats-json <file.json>]");
 }
 
 static void WriteIskurScene(const fs::path& inGlb, const fs::path& outPack, bool fastCompress)
@@ -1745,25 +2200,84 @@ static void WriteIskurScene(const fs::path& inGlb, const fs::path& outPack, bool
         model = std::move(asset.get());
     };
 
-    auto gltfFile = fastgltf::MappedGltfFile::FromPath(inGlb);
-    if (gltfFile)
-    {
-        loadAsset(gltfFile.get());
-    }
-    else
+    IE_PROFILE_SCOPE("Pack Scene");
     {
-        std::println("fastgltf mapped file open failed for '{}': {} ({})", inGlb.string(), fastgltf::getErrorName(gltfFile.error()),
-                     fastgltf::getErrorMessage(gltfFile.error()));
-        fastgltf::GltfFileStream gltfStream(inGlb);
-        if (!gltfStream.isOpen())
-            Fatal("Failed to open GLB file");
-        loadAsset(gltfStream);
+        IE_PROFILE_SCOPE("Load GLB");
+        PackStageTimer parseTimer(PackStage_ParseGltf);
+        std::error_code ec;
+        const uintmax_t glbBytes = fs::file_size(inGlb, ec);
+        AddPackStageWork(PackStage_ParseGltf, 1, ec ? 0 : static_cast<u64>(glbBytes), 0);
+        auto gltfFile = fastgltf::MappedGltfFile::FromPath(inGlb);
+        if (gltfFile)
+        {
+            loadAsset(gltfFile.get());
+        }
+        else
+        {
+            std::println("fastgltf mapped file open failed for '{}': {} ({})", inGlb.string(), fastgltf::getErrorName(gltfFile.error()),
+                         fastgltf::getErrorMessage(gltfFile.error()));
+            fastgltf::GltfFileStream gltfStream(inGlb);
+            if (!gltfStream.isOpen())
+                Fatal("Failed to open GLB file");
+            loadAsset(gltfStream);
+        }
     }
 
     std::println("Loaded GLB: {}", inGlb.string());
     ProcessAllMeshesAndWritePack(outPack, inGlb, model, fastCompress);
 }
 
+static void PrintPackStageStats(f64 totalSeconds)
+{
+    constexpr f64 mib = 1024.0 * 1024.0;
+    std::println("{:<16} {:>10} {:>10} {:>7} {:>10} {:>12} {:>12}", "Stage", "Wall (s)", "CPU (s)", "Wall %", "Items", "In (MiB)", "Out (MiB)");
+    f64 stagedSeconds = 0.0;
+    for (u32 i = 0; i < PackStage_Count; ++i)
+    {
+        const PackStageStats& stats = g_PackStageStats[i];
+        stagedSeconds += stats.wallSeconds;
+        const f64 wallPct = totalSeconds > 0.0 ? 100.0 * stats.wallSeconds / totalSeconds : 0.0;
+        std::println("{:<16} {:>10.3f} {:>10.3f} {:>6.1f}% {:>10} {:>12.2f} {:>12.2f}", kPackStageNames[i], stats.wallSeconds, stats.cpuSeconds, wallPct, stats.items,
+                     static_cast<f64>(stats.bytesIn) / mib, static_cast<f64>(stats.bytesOut) / mib);
+    }
+    const f64 otherSeconds = std::max(0.0, totalSeconds - stagedSeconds);
+    std::println("{:<16} {:>10.3f} {:>10} {:>6.1f}%", "Other", otherSeconds, "", totalSeconds > 0.0 ? 100.0 * otherSeconds / totalSeconds : 0.0);
+}
+
+static void WritePackStageStatsJson(const fs::path& statsPath, f64 totalSeconds, int sceneCount, bool fast)
+{
+    if (statsPath.empty())
+        return;
+
+    std::ofstream out(statsPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+        Fatal("Failed to open stats JSON file");
+
+    out << std::format("{{\n  \"scenes\": {},\n  \"fast\": {},\n  \"totalSeconds\": {:.6f},\n  \"stages\": [\n", sceneCount, fast ? "true" : "false", totalSeconds);
+    for (u32 i = 0; i < PackStage_Count; ++i)
+    {
+        const PackStageStats& stats = g_PackStageStats[i];
+        out << std::format("    {{\"name\": \"{}\", \"wallSeconds\": {:.6f}, \"cpuSeconds\": {:.6f}, \"items\": {}, \"bytesIn\": {}, \"bytesOut\": {}}}{}\n", kPackStageNames[i],
+                           stats.wallSeconds, stats.cpuSeconds, stats.items, stats.bytesIn, stats.bytesOut, (i + 1 < PackStage_Count) ? "," : "");
+    }
+    out << "  ]\n}\n";
+
+    if (!out.good())
+        Fatal("Error writing stats JSON file");
+    std::println("Stage stats written: {}", statsPath.string());
+}
+
+static void WriteTrace(const fs::path& tracePath)
+{
+    if (tracePath.empty())
+        return;
+
+    Profiler::EndCapture();
+    if (!Profiler::WriteChromeTrace(tracePath))
+        Fatal("Failed to write CPU trace");
+    std::println("CPU trace written: {}", tracePath.string());
+}
+
 int main(int argc, char** argv)
 {
     auto t0 = std::chrono::steady_clock::now();
@@ -1773,6 +2287,8 @@ int main(int argc, char** argv)
     fs::path inSceneName;
     bool processAll = false;
     bool fast = false;
+    fs::path tracePath;
+    fs::path statsPath;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -1783,6 +2299,10 @@ int main(int argc, char** argv)
             fast = true;
         else if (a == "--all")
             processAll = true;
+        else if (a == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (a == "--stats-json" && i + 1 < argc)
+            statsPath = argv[++i];
         else
         {
             std::println("Error: Unknown command-line argument '{}'", a);
@@ -1790,6 +2310,15 @@ int main(int argc, char** argv)
         }
     }
 
+    if (!tracePath.empty())
+    {
+        Profiler::SetThreadName("Packer Main");
+        Profiler::BeginCapture();
+    }
+
+    PackWorkerPool workers(std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+    g_PackWorkers = &workers;
+
     if (processAll)
     {
         const fs::path repoRoot = FindRepoRoot(fs::path(argv[0]));
@@ -1824,9 +2353,12 @@ int main(int argc, char** argv)
         }
         std::println("All-scenes: total={}, ok={}, skipped={} (fast={})", total, okc, skipped, fast ? "yes" : "no");
         CoUninitialize();
+        WriteTrace(tracePath);
 
         auto t1 = std::chrono::steady_clock::now();
         f64 sec = std::chrono::duration<f64>(t1 - t0).count();
+        PrintPackStageStats(sec);
+        WritePackStageStatsJson(statsPath, sec, okc, fast);
         std::println("Total time: {:.3f} s", sec);
         return 0;
     }
@@ -1861,9 +2393,12 @@ int main(int argc, char** argv)
     WriteIskurScene(glbPath, outPath, fast);
 
     CoUninitialize();
+    WriteTrace(tracePath);
 
     auto t1 = std::chrono::steady_clock::now();
     f64 sec = std::chrono::duration<f64>(t1 - t0).count();
+    PrintPackStageStats(sec);
+    WritePackStageStatsJson(statsPath, sec, 1, fast);
     std::println("Total time: {:.3f} s", sec);
 
     return 0;
@@ -0,0 +1,454 @@
+// Iskur Engine - Timeline Analyzer
+// Copyright (c) 2026 Tristan Marrec
+// Licensed under the MIT License.
+// See the LICENSE file in the project root for license information.
+
+// Reads a frame timeline capture (.iktl) and reports frame pacing, hitches, per-scope costs and GPU idle gaps.
+// Only the standard library is used so captures taken on Windows can be analyzed on any platform.
+
+#include "common/JsonUtils.h"
+#include "common/TimelineFormat.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <map>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace IETimeline;
+
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using i64 = std::int64_t;
+using f64 = double;
+
+[[noreturn]] static void Fatal(const char* msg)
+{
+    std::println("Error: {}", msg);
+    std::exit(EXIT_FAILURE);
+}
+
+static void Require(bool cond, const char* msg)
+{
+    if (!cond)
+        Fatal(msg);
+}
+
+struct Timeline
+{
+    TimelineHeader header{};
+    std::vector<FrameRecord> frames;
+    std::vector<CpuScopeRecord> cpuScopes;
+    std::vector<GpuPassRecord> gpuPasses;
+    std::vector<std::string> names;
+};
+
+template <typename T> static void ReadArray(std::ifstream& in, std::vector<T>& out, u32 count)
+{
+    out.resize(count);
+    in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    Require(in.good(), "Timeline file is truncated");
+}
+
+static Timeline LoadTimeline(const fs::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        Fatal("Failed to open timeline file");
+
+    Timeline t;
+    in.read(reinterpret_cast<char*>(&t.header), sizeof(t.header));
+    Require(in.good(), "Timeline file is truncated");
+    Require(std::equal(std::begin(TIMELINE_MAGIC), std::end(TIMELINE_MAGIC), t.header.magic), "Not a timeline capture file");
+    Require(t.header.version == TIMELINE_VERSION_LATEST, "Unsupported timeline version");
+
+    ReadArray(in, t.frames, t.header.frameCount);
+    ReadArray(in, t.cpuScopes, t.header.cpuScopeCount);
+    ReadArray(in, t.gpuPasses, t.header.gpuPassCount);
+
+    t.names.resize(t.header.nameCount);
+    for (std::string& name : t.names)
+    {
+        u16 length = 0;
+        in.read(reinterpret_cast<char*>(&length), sizeof(length));
+        name.resize(length);
+        in.read(name.data(), length);
+        Require(in.good(), "Timeline file is truncated");
+    }
+
+    for (const FrameRecord& f : t.frames)
+    {
+        Require(static_cast<u64>(f.firstCpuScope) + f.cpuScopeCount <= t.cpuScopes.size(), "Frame CPU scope range is out of bounds");
+        Require(static_cast<u64>(f.firstGpuPass) + f.gpuPassCount <= t.gpuPasses.size(), "Frame GPU pass range is out of bounds");
+    }
+    for (const CpuScopeRecord& s : t.cpuScopes)
+        Require(s.nameIndex < t.names.size(), "CPU scope name index is out of bounds");
+    for (const GpuPassRecord& p : t.gpuPasses)
+        Require(p.nameIndex < t.names.size(), "GPU pass name index is out of bounds");
+
+    return t;
+}
+
+static f64 NsToMs(i64 ns)
+{
+    return static_cast<f64>(ns) * 1e-6;
+}
+
+struct Stats
+{
+    size_t count = 0;
+    f64 mean = 0.0;
+    f64 p50 = 0.0;
+    f64 p95 = 0.0;
+    f64 p99 = 0.0;
+    f64 max = 0.0;
+};
+
+// Nearest-rank percentiles over the sorted samples.
+static Stats ComputeStats(std::vector<f64> samples)
+{
+    Stats s;
+    s.count = samples.size();
+    if (samples.empty())
+        return s;
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](f64 p) {
+        const size_t rank = static_cast<size_t>(p * static_cast<f64>(samples.size() - 1) + 0.5);
+        return samples[std::min(rank, samples.size() - 1)];
+    };
+
+    f64 sum = 0.0;
+    for (f64 v : samples)
+        sum += v;
+    s.mean = sum / static_cast<f64>(samples.size());
+    s.p50 = percentile(0.50);
+    s.p95 = percentile(0.95);
+    s.p99 = percentile(0.99);
+    s.max = samples.back();
+    return s;
+}
+
+static void PrintStatsRow(std::string_view label, const Stats& s)
+{
+    std::println("  {:<36} {:>7} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}", label, s.count, s.mean, s.p50, s.p95, s.p99, s.max);
+}
+
+static void PrintStatsHeader(std::string_view title)
+{
+    std::println("{}", title);
+    std::println("  {:<36} {:>7} {:>9} {:>9} {:>9} {:>9} {:>9}", "name", "count", "mean ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+}
+
+// GPU span of a frame, from the first pass begin to the last pass end.
+static bool GpuFrameRange(const Timeline& t, const FrameRecord& f, i64& outBegin, i64& outEnd)
+{
+    if (f.gpuPassCount == 0)
+        return false;
+    outBegin = INT64_MAX;
+    outEnd = INT64_MIN;
+    for (u32 i = 0; i < f.gpuPassCount; ++i)
+    {
+        const GpuPassRecord& p = t.gpuPasses[f.firstGpuPass + i];
+        outBegin = std::min(outBegin, p.beginNs);
+        outEnd = std::max(outEnd, p.endNs);
+    }
+    return true;
+}
+
+static void ReportFramePacing(const Timeline& t)
+{
+    std::vector<f64> cpuFrame, frameInterval, gpuFrame, gpuBusy, latency;
+    for (size_t i = 0; i < t.frames.size(); ++i)
+    {
+        const FrameRecord& f = t.frames[i];
+        cpuFrame.push_back(NsToMs(f.cpuEndNs - f.cpuBeginNs));
+        if (i + 1 < t.frames.size() && t.frames[i + 1].frame == f.frame + 1)
+            frameInterval.push_back(NsToMs(t.frames[i + 1].cpuBeginNs - f.cpuBeginNs));
+
+        i64 gpuBegin = 0, gpuEnd = 0;
+        if (!GpuFrameRange(t, f, gpuBegin, gpuEnd))
+            continue;
+        gpuFrame.push_back(NsToMs(gpuEnd - gpuBegin));
+        latency.push_back(NsToMs(gpuBegin - f.cpuBeginNs));
+
+        i64 busy = 0;
+        for (u32 p = 0; p < f.gpuPassCount; ++p)
+        {
+            const GpuPassRecord& pass = t.gpuPasses[f.firstGpuPass + p];
+            busy += std::max<i64>(0, pass.endNs - pass.beginNs);
+        }
+        gpuBusy.push_back(NsToMs(busy));
+    }
+
+    PrintStatsHeader("Frame pacing");
+    PrintStatsRow("CPU frame (Render)", ComputeStats(cpuFrame));
+    PrintStatsRow("Frame interval (CPU begin to begin)", ComputeStats(frameInterval));
+    PrintStatsRow("GPU frame (first to last pass)", ComputeStats(gpuFrame));
+    PrintStatsRow("GPU busy (sum of passes)", ComputeStats(gpuBusy));
+    PrintStatsRow("CPU begin to GPU begin", ComputeStats(latency));
+    std::println("");
+}
+
+static void ReportScopes(const Timeline& t, size_t top)
+{
+    std::map<std::string, std::vector<f64>> cpu;
+    std::map<std::string, std::vector<f64>> gpu;
+    for (const CpuScopeRecord& s : t.cpuScopes)
+    {
+        const std::string key = std::string(s.depth * 2, ' ') + t.names[s.nameIndex];
+        cpu[key].push_back(NsToMs(s.endNs - s.beginNs));
+    }
+    for (const GpuPassRecord& p : t.gpuPasses)
+        gpu[t.names[p.nameIndex]].push_back(NsToMs(p.endNs - p.beginNs));
+
+    auto printTable = [&](std::string_view title, const std::map<std::string, std::vector<f64>>& table) {
+        std::vector<std::pair<std::string, Stats>> rows;
+        for (const auto& [name, samples] : table)
+            rows.emplace_back(name, ComputeStats(samples));
+        std::sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second.mean > b.second.mean; });
+
+        PrintStatsHeader(title);
+        for (size_t i = 0; i < rows.size() && i < top; ++i)
+            PrintStatsRow(rows[i].first, rows[i].second);
+        std::println("");
+    };
+    printTable("CPU scopes (by mean)", cpu);
+    printTable("GPU passes (by mean)", gpu);
+}
+
+static void ReportHitches(const Timeline& t, f64 hitchFactor, size_t top)
+{
+    std::vector<f64> intervals;
+    for (size_t i = 0; i + 1 < t.frames.size(); ++i)
+        intervals.push_back(NsToMs(t.frames[i + 1].cpuBeginNs - t.frames[i].cpuBeginNs));
+    if (intervals.empty())
+        return;
+
+    const f64 median = ComputeStats(intervals).p50;
+    const f64 threshold = median * hitchFactor;
+
+    // Median duration per top-level CPU scope, so a hitch can be attributed to the scopes that ran long.
+    std::map<u32, std::vector<f64>> scopeSamples;
+    for (const CpuScopeRecord& s : t.cpuScopes)
+        if (s.depth == 0)
+            scopeSamples[s.nameIndex].push_back(NsToMs(s.endNs - s.beginNs));
+    std::map<u32, f64> scopeMedian;
+    for (const auto& [name, samples] : scopeSamples)
+        scopeMedian[name] = ComputeStats(samples).p50;
+
+    std::vector<size_t> hitches;
+    for (size_t i = 0; i < intervals.size(); ++i)
+        if (intervals[i] > threshold)
+            hitches.push_back(i);
+    std::sort(hitches.begin(), hitches.end(), [&](size_t a, size_t b) { return intervals[a] > intervals[b]; });
+
+    std::println("Hitches: {} of {} frame intervals above {:.3f} ms ({:.2f}x median {:.3f} ms)", hitches.size(), intervals.size(), threshold, hitchFactor, median);
+    for (size_t h = 0; h < hitches.size() && h < top; ++h)
+    {
+        const FrameRecord& f = t.frames[hitches[h]];
+        i64 gpuBegin = 0, gpuEnd = 0;
+        const bool hasGpu = GpuFrameRange(t, f, gpuBegin, gpuEnd);
+        std::println("  frame {:>8}: interval {:>8.3f} ms, cpu {:>8.3f} ms, gpu {}", f.frame, intervals[hitches[h]], NsToMs(f.cpuEndNs - f.cpuBeginNs),
+                     hasGpu ? std::format("{:.3f} ms", NsToMs(gpuEnd - gpuBegin)) : std::string("n/a"));
+
+        std::vector<std::pair<f64, u32>> excess;
+        for (u32 i = 0; i < f.cpuScopeCount; ++i)
+        {
+            const CpuScopeRecord& s = t.cpuScopes[f.firstCpuScope + i];
+            if (s.depth == 0)
+                excess.emplace_back(NsToMs(s.endNs - s.beginNs) - scopeMedian[s.nameIndex], f.firstCpuScope + i);
+        }
+        std::sort(excess.begin(), excess.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        for (size_t e = 0; e < excess.size() && e < 3 && excess[e].first > 0.0; ++e)
+        {
+            const CpuScopeRecord& s = t.cpuScopes[excess[e].second];
+            std::println("      {:<34} {:>8.3f} ms (+{:.3f} ms over median)", t.names[s.nameIndex], NsToMs(s.endNs - s.beginNs), excess[e].first);
+        }
+    }
+    std::println("");
+}
+
+static void ReportGpuBubbles(const Timeline& t, f64 bubbleUs, size_t top)
+{
+    struct Pass
+    {
+        i64 begin;
+        i64 end;
+        u32 nameIndex;
+        u64 frame;
+    };
+    std::vector<Pass> passes;
+    for (const FrameRecord& f : t.frames)
+        for (u32 i = 0; i < f.gpuPassCount; ++i)
+        {
+            const GpuPassRecord& p = t.gpuPasses[f.firstGpuPass + i];
+            passes.push_back({p.beginNs, p.endNs, p.nameIndex, f.frame});
+        }
+    if (passes.size() < 2)
+    {
+        std::println("GPU bubbles: not enough GPU passes in the capture\n");
+        return;
+    }
+    std::sort(passes.begin(), passes.end(), [](const Pass& a, const Pass& b) { return a.begin < b.begin; });
+
+    struct Gap
+    {
+        i64 ns;
+        size_t before; // index of the pass that ended last before the gap
+        size_t after;
+    };
+    // Gaps inside a frame point at GPU-side stalls, gaps between frames at the CPU or presentation not keeping the GPU fed.
+    std::vector<Gap> frameGaps;
+    std::vector<Gap> betweenGaps;
+    i64 idleInFrame = 0;
+    i64 idleBetweenFrames = 0;
+    i64 coveredEnd = passes[0].end;
+    size_t lastEnding = 0;
+    for (size_t i = 1; i < passes.size(); ++i)
+    {
+        const i64 gap = passes[i].begin - coveredEnd;
+        if (gap > 0)
+        {
+            const bool sameFrame = passes[i].frame == passes[lastEnding].frame;
+            (sameFrame ? idleInFrame : idleBetweenFrames) += gap;
+            if (static_cast<f64>(gap) >= bubbleUs * 1000.0)
+                (sameFrame ? frameGaps : betweenGaps).push_back({gap, lastEnding, i});
+        }
+        if (passes[i].end > coveredEnd)
+        {
+            coveredEnd = passes[i].end;
+            lastEnding = i;
+        }
+    }
+
+    const i64 span = coveredEnd - passes[0].begin;
+    std::println("GPU bubbles: idle {:.3f} ms within frames, {:.3f} ms between frames, over a {:.3f} ms GPU span ({:.1f}% idle)", NsToMs(idleInFrame), NsToMs(idleBetweenFrames),
+                 NsToMs(span), span > 0 ? 100.0 * static_cast<f64>(idleInFrame + idleBetweenFrames) / static_cast<f64>(span) : 0.0);
+
+    auto printGaps = [&](std::string_view label, std::vector<Gap>& gaps) {
+        std::sort(gaps.begin(), gaps.end(), [](const Gap& a, const Gap& b) { return a.ns > b.ns; });
+        std::println("  {} gaps of at least {:.0f} us {}", gaps.size(), bubbleUs, label);
+        for (size_t g = 0; g < gaps.size() && g < top; ++g)
+        {
+            const Pass& before = passes[gaps[g].before];
+            const Pass& after = passes[gaps[g].after];
+            std::println("  {:>9.3f} ms  after '{}' (frame {}) before '{}' (frame {})", NsToMs(gaps[g].ns), t.names[before.nameIndex], before.frame, t.names[after.nameIndex], after.frame);
+        }
+    };
+    printGaps("within frames", frameGaps);
+    printGaps("between frames", betweenGaps);
+    std::println("");
+}
+
+// CPU scopes and GPU passes as two tracks of a Chrome trace / Perfetto JSON file.
+static void WriteChromeTrace(const Timeline& t, const fs::path& path)
+{
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+    json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+    auto addComplete = [&](std::string_view name, i64 beginNs, i64 endNs, u32 tid, u64 frame) {
+        json += ",\n{\"name\":";
+        AppendJsonString(json, name);
+        json += std::format(",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"frame\":{}}}}}", static_cast<f64>(beginNs) * 1e-3,
+                            static_cast<f64>(std::max<i64>(0, endNs - beginNs)) * 1e-3, tid, frame);
+    };
+    for (const FrameRecord& f : t.frames)
+    {
+        addComplete("Frame", f.cpuBeginNs, f.cpuEndNs, 1, f.frame);
+        for (u32 i = 0; i < f.cpuScopeCount; ++i)
+        {
+            const CpuScopeRecord& s = t.cpuScopes[f.firstCpuScope + i];
+            addComplete(t.names[s.nameIndex], s.beginNs, s.endNs, 1, f.frame);
+        }
+        for (u32 i = 0; i < f.gpuPassCount; ++i)
+        {
+            const GpuPassRecord& p = t.gpuPasses[f.firstGpuPass + i];
+            addComplete(t.names[p.nameIndex], p.beginNs, p.endNs, 2, f.frame);
+        }
+    }
+    json += "\n]}\n";
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        Fatal("Failed to open Chrome trace output file");
+    out.write(json.data(), static_cast<std::streamsize>(json.size()));
+    if (!out.good())
+        Fatal("Error writing Chrome trace file");
+    std::println("Chrome trace written: {}", path.string());
+}
+
+static void PrintUsage()
+{
+    std::println("IskurTimelineAnalyzer\nUsage:\n  IskurTimelineAnalyzer <capture.iktl> [--hitch-factor <x>] [--bubble-us <us>] [--top <n>] [--chrome <file.json>]");
+}
+
+static f64 ParsePositive(const char* text, const char* what)
+{
+    char* end = nullptr;
+    const f64 v = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !(v > 0.0))
+    {
+        std::println("Error: Invalid value '{}' for {}", text, what);
+        std::exit(EXIT_FAILURE);
+    }
+    return v;
+}
+
+int main(int argc, char** argv)
+{
+    fs::path inPath;
+    fs::path chromePath;
+    f64 hitchFactor = 2.0;
+    f64 bubbleUs = 100.0;
+    size_t top = 10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string a = argv[i];
+        if (a == "--hitch-factor" && i + 1 < argc)
+            hitchFactor = ParsePositive(argv[++i], "--hitch-factor");
+        else if (a == "--bubble-us" && i + 1 < argc)
+            bubbleUs = ParsePositive(argv[++i], "--bubble-us");
+        else if (a == "--top" && i + 1 < argc)
+            top = static_cast<size_t>(ParsePositive(argv[++i], "--top"));
+        else if (a == "--chrome" && i + 1 < argc)
+            chromePath = argv[++i];
+        else if (inPath.empty() && !a.starts_with("--"))
+            inPath = a;
+        else
+        {
+            std::println("Error: Unknown command-line argument '{}'", a);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (inPath.empty())
+    {
+        PrintUsage();
+        Fatal("No timeline capture specified");
+    }
+
+    const Timeline t = LoadTimeline(inPath);
+    std::println("Timeline: {} ({} frames, {} CPU scopes, {} GPU passes)\n", inPath.string(), t.frames.size(), t.cpuScopes.size(), t.gpuPasses.size());
+    if (t.frames.empty())
+        return 0;
+
+    ReportFramePacing(t);
+    ReportHitches(t, hitchFactor, top);
+    ReportGpuBubbles(t, bubbleUs, top);
+    ReportScopes(t, top);
+
+    if (!chromePath.empty())
+        WriteChromeTrace(t, chromePath);
+
+    return 0;
+}
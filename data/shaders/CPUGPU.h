@@ -112,26 +112,41 @@ struct
 	XMFLOAT4X4 prevViewProjNoJ;
 };
 
-struct PrimitiveConstants
+struct DrawInstance
 {
 	XMFLOAT4X4 world;
 	XMFLOAT4X4 prevWorld;
 	XMFLOAT4X4 worldInv; // inverse (not transpose)
 
-	u32 meshletCount;
 	u32 materialIdx;
+	f32 maxWorldScale;
+	f32 worldSign;
+	u32 _padDrawInstance0;
+};
+
+// Per draw group: one primitive drawn for instancesBuffer[firstInstance .. firstInstance + dispatch.y).
+struct PrimitiveConstants
+{
+	u32 meshletCount;
 	u32 verticesBufferIndex;
 	u32 meshletsBufferIndex;
-
 	u32 meshletVerticesBufferIndex;
+
 	u32 meshletTrianglesBufferIndex;
 	u32 meshletBoundsBufferIndex;
 	u32 materialsBufferIndex;
-
 	u32 debugMeshletColorEnabled;
-	f32 maxWorldScale;
-	f32 worldSign;
+
+	u32 instancesBufferIndex;
+	u32 firstInstance;
 	u32 allowBackfaceConeCull;
+	u32 firstMeshlet; // into the meshlets and meshlet bounds buffers
+
+	// The geometry buffers are shared by every primitive of the scene; these locate this primitive's ranges.
+	u32 baseVertex;
+	u32 meshletVertexOffset;
+	u32 meshletTriangleOffset; // bytes
+	u32 _padPrimitiveConstants0;
 };
 
 struct DLSSRRGuideConstants
@@ -248,7 +263,12 @@ struct RTPrimInfo
 	u32 vbSrvIndex;
 	u32 ibSrvIndex;
 	u32 materialIdx;
-	u32 pad;
+	u32 baseVertex;
+
+	u32 firstIndex;
+	u32 pad0;
+	u32 pad1;
+	u32 pad2;
 };
 
 struct PathTraceConstants
@@ -16,10 +16,12 @@ struct VertexOut
     float3 T : TEXCOORD5;
     float3 N : TEXCOORD6;
     nointerpolation float Tw : TEXCOORD7;
+    uint materialIdx : TEXCOORD8;
 };
 
 struct Payload
 {
+    uint instanceIndex;
     uint meshletIndices[32];
 };
 
@@ -15,13 +15,14 @@ struct MeshletInfo
     uint triangleCount;
 };
 
-MeshletInfo LoadMeshletInfo(ByteAddressBuffer meshletsRaw, uint meshletIndex)
+// Meshlet offsets are stored relative to their primitive; the primitive's ranges in the scene geometry buffers rebase them.
+MeshletInfo LoadMeshletInfo(ByteAddressBuffer meshletsRaw, uint firstMeshlet, uint meshletIndex, uint meshletVertexOffset, uint meshletTriangleOffset)
 {
-    uint3 meshletRaw = meshletsRaw.Load3(meshletIndex * kMeshletByteSize);
+    uint3 meshletRaw = meshletsRaw.Load3((firstMeshlet + meshletIndex) * kMeshletByteSize);
 
     MeshletInfo meshletInfo;
-    meshletInfo.vertexOffset = meshletRaw.x;
-    meshletInfo.triangleOffset = meshletRaw.y;
+    meshletInfo.vertexOffset = meshletVertexOffset + meshletRaw.x;
+    meshletInfo.triangleOffset = meshletTriangleOffset + meshletRaw.y;
     meshletInfo.vertexCount = meshletRaw.z & 0xFFFF;
     meshletInfo.triangleCount = meshletRaw.z >> 16;
     return meshletInfo;
@@ -41,9 +42,9 @@ uint3 GetMeshletTriangle(ByteAddressBuffer meshletTrianglesBuffer, uint triangle
     return tri;
 }
 
-uint GetMeshletVertexIndex(StructuredBuffer<uint> meshletVerticesBuffer, uint vertexOffset, uint index)
+uint GetMeshletVertexIndex(StructuredBuffer<uint> meshletVerticesBuffer, uint vertexOffset, uint index, uint baseVertex)
 {
-    return meshletVerticesBuffer[vertexOffset + index];
+    return baseVertex + meshletVerticesBuffer[vertexOffset + index];
 }
 
 uint3 ApplyMeshletWinding(uint3 tri, float worldSign)
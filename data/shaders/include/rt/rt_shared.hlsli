@@ -142,9 +142,9 @@ void FetchTriangleMaterialDataExplicit(uint instanceId, uint primitiveIndex, flo
     StructuredBuffer<uint> ib = ResourceDescriptorHeap[info.ibSrvIndex];
 
     uint tri = primitiveIndex;
-    uint i0 = ib[tri * 3 + 0];
-    uint i1 = ib[tri * 3 + 1];
-    uint i2 = ib[tri * 3 + 2];
+    uint i0 = info.baseVertex + ib[info.firstIndex + tri * 3 + 0];
+    uint i1 = info.baseVertex + ib[info.firstIndex + tri * 3 + 1];
+    uint i2 = info.baseVertex + ib[info.firstIndex + tri * 3 + 2];
 
     Vertex v0 = vb[i0];
     Vertex v1 = vb[i1];
@@ -233,9 +233,9 @@ void FillPayloadFromTriangleHit(inout RayPayload payload, in BuiltInTriangleInte
     StructuredBuffer<uint> ib = ResourceDescriptorHeap[info.ibSrvIndex];
 
     uint tri = PrimitiveIndex();
-    uint i0 = ib[tri * 3 + 0];
-    uint i1 = ib[tri * 3 + 1];
-    uint i2 = ib[tri * 3 + 2];
+    uint i0 = info.baseVertex + ib[info.firstIndex + tri * 3 + 0];
+    uint i1 = info.baseVertex + ib[info.firstIndex + tri * 3 + 1];
+    uint i2 = info.baseVertex + ib[info.firstIndex + tri * 3 + 2];
 
     Vertex v0 = vb[i0];
     Vertex v1 = vb[i1];
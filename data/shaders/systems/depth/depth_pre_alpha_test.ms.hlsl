@@ -11,11 +11,12 @@ ConstantBuffer<VertexConstants> VertexConstants : register(b1);
 ConstantBuffer<PrimitiveConstants> Constants : register(b0);
 
 #define ROOT_SIG "RootFlags( CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | SAMPLER_HEAP_DIRECTLY_INDEXED ), \
-                  RootConstants(num32BitConstants=60, b0), \
+                  RootConstants(num32BitConstants=16, b0), \
                   CBV(b1)"
 
 struct Payload
 {
+    uint instanceIndex;
     uint meshletIndices[32];
 };
 
@@ -24,6 +25,7 @@ struct VertexOut
     float4 clipPos : SV_Position;
     float4 color : TEXCOORD0;
     float2 texCoord : TEXCOORD1;
+    uint materialIdx : TEXCOORD2;
 };
 
 [RootSignature(ROOT_SIG)]
@@ -48,8 +50,10 @@ void main(
     ByteAddressBuffer meshletTrianglesBuffer = ResourceDescriptorHeap[Constants.meshletTrianglesBufferIndex];
     StructuredBuffer<uint> meshletVerticesBuffer = ResourceDescriptorHeap[Constants.meshletVerticesBufferIndex];
     StructuredBuffer<Vertex> verticesBuffer = ResourceDescriptorHeap[Constants.verticesBufferIndex];
-    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, meshletIndex);
-    const float worldSign = Constants.worldSign;
+    StructuredBuffer<DrawInstance> instancesBuffer = ResourceDescriptorHeap[Constants.instancesBufferIndex];
+    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, Constants.firstMeshlet, meshletIndex, Constants.meshletVertexOffset, Constants.meshletTriangleOffset);
+    const DrawInstance instance = instancesBuffer[payload.instanceIndex];
+    const float worldSign = instance.worldSign;
 
     SetMeshOutputCounts(meshletInfo.vertexCount, meshletInfo.triangleCount);
 
@@ -60,13 +64,14 @@ void main(
 
     if (gtid < meshletInfo.vertexCount)
     {
-        Vertex v = verticesBuffer[GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid)];
-        float4 worldPos = mul(float4(v.position, 1.0f), Constants.world);
+        Vertex v = verticesBuffer[GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid, Constants.baseVertex)];
+        float4 worldPos = mul(float4(v.position, 1.0f), instance.world);
 
         VertexOut o;
         o.clipPos = mul(worldPos, VertexConstants.viewProj);
         o.color = DecodePackedColorRGBA16UNORM(v.colorPackedLo, v.colorPackedHi);
         o.texCoord = DecodePackedHalf2(v.texCoordPacked);
+        o.materialIdx = instance.materialIdx;
         verts[gtid] = o;
     }
 }
@@ -10,11 +10,12 @@ ConstantBuffer<VertexConstants> VertexConstants : register(b1);
 ConstantBuffer<PrimitiveConstants> Constants : register(b0);
 
 #define ROOT_SIG "RootFlags( CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | SAMPLER_HEAP_DIRECTLY_INDEXED ), \
-                  RootConstants(num32BitConstants=60, b0), \
+                  RootConstants(num32BitConstants=16, b0), \
                   CBV(b1)"
 
 struct Payload
 {
+    uint instanceIndex;
     uint meshletIndices[32];
 };
 
@@ -45,8 +46,10 @@ void main(
     ByteAddressBuffer meshletTrianglesBuffer = ResourceDescriptorHeap[Constants.meshletTrianglesBufferIndex];
     StructuredBuffer<uint> meshletVerticesBuffer = ResourceDescriptorHeap[Constants.meshletVerticesBufferIndex];
     StructuredBuffer<Vertex> verticesBuffer = ResourceDescriptorHeap[Constants.verticesBufferIndex];
-    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, meshletIndex);
-    const float worldSign = Constants.worldSign;
+    StructuredBuffer<DrawInstance> instancesBuffer = ResourceDescriptorHeap[Constants.instancesBufferIndex];
+    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, Constants.firstMeshlet, meshletIndex, Constants.meshletVertexOffset, Constants.meshletTriangleOffset);
+    const DrawInstance instance = instancesBuffer[payload.instanceIndex];
+    const float worldSign = instance.worldSign;
 
     SetMeshOutputCounts(meshletInfo.vertexCount, meshletInfo.triangleCount);
 
@@ -57,8 +60,8 @@ void main(
 
     if (gtid < meshletInfo.vertexCount)
     {
-        Vertex v = verticesBuffer[GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid)];
-        float4 worldPos = mul(float4(v.position, 1.0f), Constants.world);
+        Vertex v = verticesBuffer[GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid, Constants.baseVertex)];
+        float4 worldPos = mul(float4(v.position, 1.0f), instance.world);
 
         VertexOut o;
         o.clipPos = mul(worldPos, VertexConstants.viewProj);
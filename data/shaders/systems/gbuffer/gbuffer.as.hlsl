@@ -40,23 +40,29 @@ bool IsVisible(MeshletBounds bounds, float4x4 world, float scale, bool allowBack
     return true;
 }
 
+// Dispatched as (meshletGroups, instanceCount, 1): X walks the primitive's meshlets, Y selects the instance.
 [numthreads(32, 1, 1)]
-void main(uint dtid : SV_DispatchThreadID)
+void main(uint3 dtid : SV_DispatchThreadID)
 {
     bool visible = false;
     const bool allowBackfaceConeCull = (Constants.allowBackfaceConeCull != 0);
+    const uint meshletIndex = dtid.x;
+    const uint instanceIndex = Constants.firstInstance + dtid.y;
 
-    if (dtid < Constants.meshletCount)
+    if (meshletIndex < Constants.meshletCount)
     {
         StructuredBuffer<MeshletBounds> meshletBoundsBuffer = ResourceDescriptorHeap[Constants.meshletBoundsBufferIndex];
-        visible = IsVisible(meshletBoundsBuffer[dtid], Constants.world, Constants.maxWorldScale, allowBackfaceConeCull);
+        StructuredBuffer<DrawInstance> instancesBuffer = ResourceDescriptorHeap[Constants.instancesBufferIndex];
+        const DrawInstance instance = instancesBuffer[instanceIndex];
+        visible = IsVisible(meshletBoundsBuffer[Constants.firstMeshlet + meshletIndex], instance.world, instance.maxWorldScale, allowBackfaceConeCull);
     }
 
     if (visible)
     {
         uint index = WavePrefixCountBits(visible);
-        s_Payload.meshletIndices[index] = dtid;
+        s_Payload.meshletIndices[index] = meshletIndex;
     }
+    s_Payload.instanceIndex = instanceIndex;
 
     uint visibleCount = WaveActiveCountBits(visible);
     DispatchMesh(visibleCount, 1, 1, s_Payload);
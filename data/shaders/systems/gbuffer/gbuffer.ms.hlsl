@@ -12,16 +12,16 @@ ConstantBuffer<VertexConstants> VertexConstants : register(b1);
 ConstantBuffer<PrimitiveConstants> Constants : register(b0);
 
 #define ROOT_SIG "RootFlags( CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | SAMPLER_HEAP_DIRECTLY_INDEXED ), \
-                  RootConstants(num32BitConstants=60, b0), \
+                  RootConstants(num32BitConstants=16, b0), \
                   CBV(b1)"
 
-VertexOut GetVertexAttributes(StructuredBuffer<Vertex> verticesBuffer, uint meshletIndex, uint vertexIndex, float worldSign)
+VertexOut GetVertexAttributes(StructuredBuffer<Vertex> verticesBuffer, DrawInstance instance, uint meshletIndex, uint vertexIndex)
 {
     Vertex v = verticesBuffer[vertexIndex];
 
     float4 vpos = float4(v.position, 1.0);
-    float3x3 W = (float3x3)Constants.world;
-    float3x3 WInv = (float3x3)Constants.worldInv;
+    float3x3 W = (float3x3)instance.world;
+    float3x3 WInv = (float3x3)instance.worldInv;
 
     float3 Nw = normalize(mul(WInv, DecodePackedNormalOct(v.normalPacked)));
     float tangentSign = 1.0f;
@@ -29,8 +29,8 @@ VertexOut GetVertexAttributes(StructuredBuffer<Vertex> verticesBuffer, uint mesh
     float3 Tt = mul(Tobj, W);
     float3 Tw = normalize(Tt - Nw * dot(Tt, Nw));
     VertexOut o;
-    float4 worldPos = mul(vpos, Constants.world);
-    float4 prevWorldPos = mul(vpos, Constants.prevWorld);
+    float4 worldPos = mul(vpos, instance.world);
+    float4 prevWorldPos = mul(vpos, instance.prevWorld);
     float4 currentClipPosNoJ = mul(worldPos, VertexConstants.viewProjNoJ);
     float4 prevClipPosNoJ = mul(prevWorldPos, VertexConstants.prevViewProjNoJ);
     o.clipPos = mul(worldPos, VertexConstants.viewProj);
@@ -40,9 +40,10 @@ VertexOut GetVertexAttributes(StructuredBuffer<Vertex> verticesBuffer, uint mesh
 
     o.N = Nw;
     o.T = Tw;
-    o.Tw = tangentSign * worldSign;
+    o.Tw = tangentSign * instance.worldSign;
     o.meshletIndex = meshletIndex;
     o.texCoord = DecodePackedHalf2(v.texCoordPacked);
+    o.materialIdx = instance.materialIdx;
     return o;
 }
 
@@ -68,8 +69,10 @@ void main(
     ByteAddressBuffer meshletTrianglesBuffer = ResourceDescriptorHeap[Constants.meshletTrianglesBufferIndex];
     StructuredBuffer<uint> meshletVerticesBuffer = ResourceDescriptorHeap[Constants.meshletVerticesBufferIndex];
     StructuredBuffer<Vertex> verticesBuffer = ResourceDescriptorHeap[Constants.verticesBufferIndex];
-    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, meshletIndex);
-    const float worldSign = Constants.worldSign;
+    StructuredBuffer<DrawInstance> instancesBuffer = ResourceDescriptorHeap[Constants.instancesBufferIndex];
+    MeshletInfo meshletInfo = LoadMeshletInfo(meshletsRaw, Constants.firstMeshlet, meshletIndex, Constants.meshletVertexOffset, Constants.meshletTriangleOffset);
+    const DrawInstance instance = instancesBuffer[payload.instanceIndex];
+    const float worldSign = instance.worldSign;
     
     SetMeshOutputCounts(meshletInfo.vertexCount, meshletInfo.triangleCount);
     
@@ -80,8 +83,8 @@ void main(
 
     if (gtid < meshletInfo.vertexCount)
     {
-        const uint vertexIndex = GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid);
-        verts[gtid] = GetVertexAttributes(verticesBuffer, meshletIndex, vertexIndex, worldSign);
+        const uint vertexIndex = GetMeshletVertexIndex(meshletVerticesBuffer, meshletInfo.vertexOffset, gtid, Constants.baseVertex);
+        verts[gtid] = GetVertexAttributes(verticesBuffer, instance, meshletIndex, vertexIndex);
     }
 }
 
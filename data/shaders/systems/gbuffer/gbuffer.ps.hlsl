@@ -42,7 +42,7 @@ float3 HashColor(uint seed)
 PSOut main(VertexOut input, bool isFrontFace : SV_IsFrontFace)
 {
     StructuredBuffer<Material> materialsBuffer = ResourceDescriptorHeap[Constants.materialsBufferIndex];
-    Material material = materialsBuffer[Constants.materialIdx];
+    Material material = materialsBuffer[input.materialIdx];
 
     float4 baseColor = material.baseColorFactor;
     if (material.baseColorTextureIndex != -1)
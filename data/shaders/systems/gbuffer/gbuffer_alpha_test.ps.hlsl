@@ -9,7 +9,7 @@ ConstantBuffer<PrimitiveConstants> Constants : register(b0);
 ConstantBuffer<VertexConstants> VertexConstants : register(b1);
 
 #define ROOT_SIG "RootFlags( CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED | SAMPLER_HEAP_DIRECTLY_INDEXED ), \
-                  RootConstants(num32BitConstants=60, b0), \
+                  RootConstants(num32BitConstants=16, b0), \
                   CBV(b1)"
 
 struct VertexOut
@@ -17,13 +17,14 @@ struct VertexOut
     float4 clipPos : SV_Position;
     float4 color : TEXCOORD0;
     float2 texCoord : TEXCOORD1;
+    uint materialIdx : TEXCOORD2;
 };
 
 [RootSignature(ROOT_SIG)]
 void main(VertexOut input)
 {
     StructuredBuffer<Material> materialsBuffer = ResourceDescriptorHeap[Constants.materialsBufferIndex];
-    Material material = materialsBuffer[Constants.materialIdx];
+    Material material = materialsBuffer[input.materialIdx];
 
     float4 baseColor = material.baseColorFactor;
     if (material.baseColorTextureIndex != -1)
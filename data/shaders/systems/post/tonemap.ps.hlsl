@@ -68,12 +68,15 @@ float3 LinearToSRGB(float3 color)
 float4 main(VSOut input) : SV_TARGET
 {
     Texture2D<float4> hdrTexture = ResourceDescriptorHeap[Constants.srvIndex];
-    Texture2D<float4> bloomTexture = ResourceDescriptorHeap[Constants.bloomTextureIndex];
     SamplerState linearSampler = SamplerDescriptorHeap[Constants.samplerIndex];
     uint2 px = uint2(input.position.xy);
     float3 hdr = hdrTexture.Load(int3(px, 0)).rgb;
-    float3 bloom = bloomTexture.SampleLevel(linearSampler, input.uv, 0).rgb * max(Constants.bloomIntensity, 0.0f);
-    hdr += bloom;
+    // Without bloom the chain is not written this frame and its memory may hold other aliased textures.
+    if (Constants.bloomIntensity > 0.0f)
+    {
+        Texture2D<float4> bloomTexture = ResourceDescriptorHeap[Constants.bloomTextureIndex];
+        hdr += bloomTexture.SampleLevel(linearSampler, input.uv, 0).rgb * Constants.bloomIntensity;
+    }
 
     Texture2D<float> exposureTexture = ResourceDescriptorHeap[Constants.exposureTextureIndex];
     float exposure = exposureTexture.Load(int3(0, 0, 0));